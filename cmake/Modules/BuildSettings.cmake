@@ -139,6 +139,10 @@ if(CMAKE_CXX_COMPILER_IS_CLANG)
     add_target_flag_if_avail(timemory-xray "-fxray-instrument" "-fxray-instruction-threshold=1")
     if(NOT cxx_timemory_xray_fxray_instrument)
         add_disabled_interface(timemory-xray)
+    else()
+        # links the XRay runtime and exports it to the timemory-xray library
+        set_target_properties(timemory-xray PROPERTIES
+            INTERFACE_LINK_OPTIONS "-fxray-instrument;-rdynamic")
     endif()
 else()
     add_disabled_interface(timemory-xray)
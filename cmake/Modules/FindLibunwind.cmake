@@ -0,0 +1,45 @@
+#------------------------------------------------------------------------------#
+#
+#       Finds headers and libraries for libunwind library
+#
+#------------------------------------------------------------------------------#
+
+include(FindPackageHandleStandardArgs)
+
+#------------------------------------------------------------------------------#
+
+find_path(Libunwind_INCLUDE_DIR
+    NAMES libunwind.h
+    PATH_SUFFIXES include
+    HINTS ${Libunwind_ROOT_DIR}
+    PATHS ${Libunwind_ROOT_DIR}
+)
+
+#------------------------------------------------------------------------------#
+
+find_library(Libunwind_LIBRARY
+    NAMES unwind
+    PATH_SUFFIXES lib lib64 lib 64 lib/64
+    HINTS ${Libunwind_ROOT_DIR}
+    PATHS ${Libunwind_ROOT_DIR}
+)
+
+#------------------------------------------------------------------------------#
+
+if(Libunwind_INCLUDE_DIR)
+    set(Libunwind_INCLUDE_DIRS ${Libunwind_INCLUDE_DIR})
+endif()
+
+#------------------------------------------------------------------------------#
+
+if(Libunwind_LIBRARY)
+    set(Libunwind_LIBRARIES ${Libunwind_LIBRARY})
+endif()
+
+#------------------------------------------------------------------------------#
+
+mark_as_advanced(Libunwind_INCLUDE_DIR Libunwind_LIBRARY)
+find_package_handle_standard_args(Libunwind REQUIRED_VARS
+    Libunwind_INCLUDE_DIR Libunwind_LIBRARY)
+
+#------------------------------------------------------------------------------#
@@ -315,6 +315,8 @@ add_option(TIMEMORY_USE_ALLINEA_MAP
     "Enable control for AllineaMAP sampler" ${_ALLINEA_MAP} CMAKE_DEFINE)
 add_option(TIMEMORY_USE_CRAYPAT
     "Enable CrayPAT support" ${_CRAYPAT} CMAKE_DEFINE)
+add_option(TIMEMORY_USE_LIBUNWIND
+    "Enable libunwind for call-stack sampling" OFF CMAKE_DEFINE)
 add_option(TIMEMORY_USE_OMPT
     "Enable OpenMP tooling" ${_OMPT} CMAKE_DEFINE)
 add_option(TIMEMORY_USE_LIKWID
@@ -371,12 +373,27 @@ if(_NCCLP AND (NOT BUILD_SHARED_LIBS OR NOT TIMEMORY_USE_GOTCHA))
     set(_NCCLP OFF)
 endif()
 
+set(_XRAY OFF)
+if(BUILD_SHARED_LIBS AND CMAKE_CXX_COMPILER_ID MATCHES "Clang" AND
+    CMAKE_SYSTEM_NAME MATCHES "Linux")
+    set(_XRAY ${TIMEMORY_BUILD_TOOLS})
+endif()
+
+set(_COMPILER_INSTR OFF)
+if(BUILD_SHARED_LIBS AND NOT WIN32)
+    set(_COMPILER_INSTR ${TIMEMORY_BUILD_TOOLS})
+endif()
+
 set(_TIMEM ${TIMEMORY_BUILD_TOOLS})
 if(_TIMEM AND WIN32)
     set(_TIMEM OFF)
 endif()
 
 add_option(TIMEMORY_BUILD_AVAIL "Build the timemory-avail tool" ${TIMEMORY_BUILD_TOOLS})
+add_option(TIMEMORY_BUILD_COMPARE "Build the timemory-compare tool" ${TIMEMORY_BUILD_TOOLS})
+add_option(TIMEMORY_BUILD_COLLECTOR "Build the timemory-collector tool" ${TIMEMORY_BUILD_TOOLS})
+add_option(TIMEMORY_BUILD_TOP "Build the timemory-top tool" ${TIMEMORY_BUILD_TOOLS})
+add_option(TIMEMORY_BUILD_ERT_TOOL "Build the timemory-ert tool" ${TIMEMORY_BUILD_TOOLS})
 add_option(TIMEMORY_BUILD_TIMEM "Build the timem tool" ${_TIMEM})
 add_option(TIMEMORY_BUILD_KOKKOS_TOOLS "Build the kokkos-tools libraries" OFF)
 add_option(TIMEMORY_BUILD_DYNINST_TOOLS
@@ -384,10 +401,15 @@ add_option(TIMEMORY_BUILD_DYNINST_TOOLS
 add_option(TIMEMORY_BUILD_MPIP_LIBRARY "Build the mpiP library" ${_MPIP})
 add_option(TIMEMORY_BUILD_OMPT_LIBRARY "Build the OMPT library" ${_OMPT})
 add_option(TIMEMORY_BUILD_NCCLP_LIBRARY "Build the ncclP library" ${_NCCLP})
+add_option(TIMEMORY_BUILD_XRAY_LIBRARY "Build the XRay instrumentation library" ${_XRAY})
+add_option(TIMEMORY_BUILD_COMPILER_INSTRUMENTATION
+    "Build the -finstrument-functions instrumentation library" ${_COMPILER_INSTR})
 
 unset(_MPIP)
 unset(_OMPT)
 unset(_DYNINST)
+unset(_XRAY)
+unset(_COMPILER_INSTR)
 
 if(TIMEMORY_BUILD_MPIP_LIBRARY AND (NOT BUILD_SHARED_LIBS OR
     NOT TIMEMORY_USE_MPI OR NOT TIMEMORY_USE_GOTCHA))
@@ -409,6 +431,20 @@ if(TIMEMORY_BUILD_NCCLP_LIBRARY AND (NOT BUILD_SHARED_LIBS OR
     set(TIMEMORY_BUILD_NCCLP_LIBRARY OFF CACHE BOOL "Build the ncclP library" FORCE)
 endif()
 
+if(TIMEMORY_BUILD_XRAY_LIBRARY AND NOT BUILD_SHARED_LIBS)
+    message(AUTHOR_WARNING
+        "TIMEMORY_BUILD_XRAY_LIBRARY requires BUILD_SHARED_LIBS=ON...")
+    set(TIMEMORY_BUILD_XRAY_LIBRARY OFF CACHE BOOL
+        "Build the XRay instrumentation library" FORCE)
+endif()
+
+if(TIMEMORY_BUILD_COMPILER_INSTRUMENTATION AND (NOT BUILD_SHARED_LIBS OR WIN32))
+    message(AUTHOR_WARNING
+        "TIMEMORY_BUILD_COMPILER_INSTRUMENTATION requires BUILD_SHARED_LIBS=ON and UNIX...")
+    set(TIMEMORY_BUILD_COMPILER_INSTRUMENTATION OFF CACHE BOOL
+        "Build the -finstrument-functions instrumentation library" FORCE)
+endif()
+
 if(NOT BUILD_SHARED_LIBS AND TIMEMORY_BUILD_KOKKOS_TOOLS)
     message(AUTHOR_WARNING
         "TIMEMORY_BUILD_KOKKOS_TOOLS requires BUILD_SHARED_LIBS=ON...")
@@ -78,6 +78,8 @@ add_interface_library(timemory-allinea-map
     "Enables Allinea-MAP support")
 add_interface_library(timemory-craypat
     "Enables CrayPAT support")
+add_interface_library(timemory-libunwind
+    "Enables libunwind support (call-stack sampling)")
 
 add_interface_library(timemory-coverage
     "Enables code-coverage flags")
@@ -149,6 +151,7 @@ set(TIMEMORY_EXTENSION_INTERFACES
     timemory-tau
     timemory-ompt
     timemory-craypat
+    timemory-libunwind
     timemory-allinea-map)
 
 set(TIMEMORY_EXTERNAL_SHARED_INTERFACES
@@ -167,6 +170,7 @@ set(TIMEMORY_EXTERNAL_SHARED_INTERFACES
     timemory-tau
     timemory-ompt
     timemory-craypat
+    timemory-libunwind
     timemory-allinea-map
     timemory-plotting
     ${_DMP_LIBRARIES})
@@ -185,6 +189,7 @@ set(TIMEMORY_EXTERNAL_STATIC_INTERFACES
     timemory-tau
     timemory-ompt
     timemory-craypat
+    timemory-libunwind
     timemory-allinea-map
     timemory-plotting
     ${_DMP_LIBRARIES})
@@ -1364,6 +1369,29 @@ else()
 endif()
 
 
+#----------------------------------------------------------------------------------------#
+#
+#                               libunwind
+#
+#----------------------------------------------------------------------------------------#
+
+if(TIMEMORY_USE_LIBUNWIND)
+    find_package(Libunwind ${TIMEMORY_FIND_QUIETLY} ${TIMEMORY_FIND_REQUIREMENT})
+endif()
+
+if(Libunwind_FOUND)
+    add_rpath(${Libunwind_LIBRARIES})
+    target_link_libraries(timemory-libunwind INTERFACE ${Libunwind_LIBRARIES})
+    target_include_directories(timemory-libunwind SYSTEM INTERFACE
+        ${Libunwind_INCLUDE_DIRS})
+    timemory_target_compile_definitions(timemory-libunwind INTERFACE
+        TIMEMORY_USE_LIBUNWIND)
+else()
+    set(TIMEMORY_USE_LIBUNWIND OFF)
+    inform_empty_interface(timemory-libunwind "libunwind")
+endif()
+
+
 #----------------------------------------------------------------------------------------#
 #
 #                       Include customizable UserPackages file
@@ -0,0 +1,153 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "timemory/timemory.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace tim::component;
+
+using bundle_t = tim::component_bundle<TIMEMORY_API, wall_clock>;
+using clock_type = std::chrono::steady_clock;
+
+//======================================================================================//
+//  a small amount of work with some variation between calls
+//
+int64_t
+work(int64_t n)
+{
+    volatile int64_t _val = 0;
+    for(int64_t i = 0; i < n; ++i)
+        _val = _val + i;
+    return _val;
+}
+
+//======================================================================================//
+
+struct result
+{
+    uint64_t interval = 1;
+    double   overhead = 0.0;  // ns per call
+    int64_t  laps     = 0;
+    double   mean     = 0.0;  // ns per call
+    double   stddev   = 0.0;  // ns
+    uint64_t measured = 0;
+};
+
+//======================================================================================//
+
+result
+run(uint64_t _interval, int64_t _ncalls, double _baseline)
+{
+    tim::settings::sample_interval() = _interval;
+    tim::subsample::configure();
+
+    auto _label = std::string{ "sampled/" } + std::to_string(_interval);
+    auto _hash  = tim::add_hash_id(_label);
+    auto _beg   = clock_type::now();
+    for(int64_t i = 0; i < _ncalls; ++i)
+    {
+        bundle_t _obj{ _hash };
+        _obj.start();
+        work(10 + (i % 20));
+        _obj.stop();
+    }
+    auto _end = clock_type::now();
+
+    result _ret{};
+    _ret.interval = _interval;
+    _ret.overhead = (std::chrono::duration<double, std::nano>(_end - _beg).count() /
+                     _ncalls) -
+                    _baseline;
+
+    // the accumulated value is in nanoseconds and the statistics are in display units
+    for(const auto& itr : tim::storage<wall_clock>::instance()->get())
+    {
+        if(itr.hash() != _hash || itr.data().get_laps() == 0)
+            continue;
+        auto _accum = static_cast<double>(itr.data().get_accum());
+        auto _disp  = itr.data().get();
+        _ret.laps   = itr.data().get_laps();
+        _ret.mean   = _accum / _ret.laps;
+        _ret.stddev = (_disp > 0.0) ? (itr.stats().get_stddev() * _accum / _disp) : 0.0;
+    }
+    for(const auto& itr : tim::subsample::get_records())
+    {
+        if(itr.hash == _hash)
+            _ret.measured = itr.measured;
+    }
+    if(_ret.measured == 0)
+        _ret.measured = _ret.laps;
+    return _ret;
+}
+
+//======================================================================================//
+
+int
+main(int argc, char** argv)
+{
+    tim::timemory_init(argc, argv);
+
+    int64_t _ncalls = (argc > 1) ? atol(argv[1]) : 1000000;
+
+    // cost of the loop without instrumentation
+    auto _beg = clock_type::now();
+    for(int64_t i = 0; i < _ncalls; ++i)
+        work(10 + (i % 20));
+    auto _end      = clock_type::now();
+    auto _baseline = std::chrono::duration<double, std::nano>(_end - _beg).count() /
+                     _ncalls;
+
+    std::vector<result> _results{};
+    for(uint64_t _interval : { 1, 10, 100 })
+        _results.emplace_back(run(_interval, _ncalls, _baseline));
+
+    tim::settings::sample_interval() = 1;
+    tim::subsample::configure();
+
+    const auto& _ref = _results.front();
+    printf("\n# calls: %lli, uninstrumented: %.1f ns/call\n\n", (long long) _ncalls,
+           _baseline);
+    printf("%10s | %16s | %12s | %12s | %12s | %12s | %10s\n", "interval",
+           "overhead/call", "measured", "est. calls", "mean (ns)", "stddev (ns)",
+           "error");
+    for(const auto& itr : _results)
+    {
+        auto _err = (_ref.mean > 0.0) ? (itr.mean - _ref.mean) / _ref.mean : 0.0;
+        printf("%10llu | %13.1f ns | %12llu | %12lli | %12.1f | %12.1f | %9.2f%%\n",
+               (unsigned long long) itr.interval, itr.overhead,
+               (unsigned long long) itr.measured, (long long) itr.laps, itr.mean,
+               itr.stddev, 100.0 * _err);
+    }
+    printf("\n");
+
+    tim::timemory_finalize();
+    return EXIT_SUCCESS;
+}
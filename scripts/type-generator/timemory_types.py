@@ -34,6 +34,7 @@ components = [
     "cuda_profiler",
     "papi_array_t",
     "papi_vector",
+    "perf_counters",
     "caliper",
     "trip_count",
     "read_bytes",
@@ -95,6 +96,7 @@ mangled_strings = {
     "system_clock": ["sys_clock"],
     "papi_array_t": ["papi_array"],
     "papi_vector": ["papi"],
+    "perf_counters": ["perf"],
     "cpu_roofline_flops": ["cpu_roofline"],
     "gpu_roofline_flops": ["gpu_roofline"],
     "cpu_roofline_sp_flops": ["cpu_roofline_sp", "cpu_roofline_single"],
@@ -118,6 +118,65 @@ private:
 //
 //--------------------------------------------------------------------------------------//
 //
+/// \class component_list_handle
+/// \brief Created once per decorated call-site. The hash id and the component
+/// configuration are computed at construction and start/stop reuse a pool of
+/// initialized bundles so repeated calls do not allocate. The pool grows to the
+/// maximum number of simultaneously active calls (recursion, threads) and
+/// start() returns the index of the bundle to pass to stop(). All members are
+/// accessed while holding the GIL.
+class component_list_handle
+{
+public:
+    using pool_type = std::vector<std::unique_ptr<component_list_t>>;
+    using free_type = std::vector<int64_t>;
+
+    component_list_handle(const component_enum_vec& _components, const std::string& _key)
+    : m_hash(tim::add_hash_id(_key))
+    , m_components(_components)
+    {}
+
+    int64_t start()
+    {
+        if(!tim::settings::enabled())
+            return -1;
+
+        if(m_free.empty())
+        {
+            auto* _obj = new component_list_t(m_hash, true);
+            tim::initialize(*_obj, m_components);
+            m_free.reserve(m_pool.size() + 1);
+            m_free.emplace_back(m_pool.size());
+            m_pool.emplace_back(_obj);
+        }
+
+        auto _idx = m_free.back();
+        m_free.pop_back();
+        // start() resets the previous measurement when it pushes into storage
+        m_pool[_idx]->start();
+        return _idx;
+    }
+
+    void stop(int64_t _idx)
+    {
+        if(_idx < 0 || _idx >= static_cast<int64_t>(m_pool.size()))
+            return;
+        m_pool[_idx]->stop();
+        m_free.emplace_back(_idx);
+    }
+
+    uint64_t hash() const { return m_hash; }
+    size_t   size() const { return m_pool.size(); }
+
+private:
+    uint64_t           m_hash       = 0;
+    component_enum_vec m_components = {};
+    pool_type          m_pool       = {};
+    free_type          m_free       = {};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
 namespace init
 {
 //
@@ -137,6 +196,12 @@ component_decorator(py::list components, const std::string& key)
     return &(*_ptr = create_component_list(key, components_enum_to_vec(components)));
 }
 //
+component_list_handle*
+component_handle(py::list components, const std::string& key)
+{
+    return new component_list_handle(components_enum_to_vec(components), key);
+}
+//
 }  // namespace init
 //
 //--------------------------------------------------------------------------------------//
@@ -150,6 +215,10 @@ generate(py::module& _pymod)
     py::class_<component_list_decorator> comp_decorator(
         _pymod, "component_decorator", "Component list used in decorators");
 
+    py::class_<component_list_handle> comp_handle(
+        _pymod, "component_handle",
+        "Pooled component list for a decorated call-site which is reused by every call");
+
     //==================================================================================//
     //
     //                      TIMEMORY COMPONENT_TUPLE
@@ -207,6 +276,22 @@ generate(py::module& _pymod)
     //----------------------------------------------------------------------------------//
     comp_decorator.def(py::init(&init::component_decorator), "Initialization",
                        py::return_value_policy::automatic);
+    //----------------------------------------------------------------------------------//
+    comp_handle.def(py::init(&init::component_handle), "Initialization",
+                    py::arg("components") = py::list(), py::arg("key") = "",
+                    py::return_value_policy::take_ownership);
+    //----------------------------------------------------------------------------------//
+    comp_handle.def("start", &component_list_handle::start,
+                    "Start a pooled component list. Returns the index to pass to stop");
+    //----------------------------------------------------------------------------------//
+    comp_handle.def("stop", &component_list_handle::stop,
+                    "Stop the pooled component list returned by start", py::arg("index"));
+    //----------------------------------------------------------------------------------//
+    comp_handle.def_property_readonly("hash", &component_list_handle::hash,
+                                      "Hash identifier of the call-site");
+    //----------------------------------------------------------------------------------//
+    comp_handle.def("__len__", &component_list_handle::size,
+                    "Number of pooled component lists");
 }
 }  // namespace pycomponent_list
 //
@@ -268,3 +268,16 @@ py::module
 generate(py::module& _pymod);
 //
 }  // namespace pytrace
+//
+//--------------------------------------------------------------------------------------//
+//
+//                                      STORAGE
+//
+//--------------------------------------------------------------------------------------//
+//
+namespace pystorage
+{
+void
+generate(py::module& _pymod);
+//
+}  // namespace pystorage
@@ -0,0 +1,261 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#if !defined(TIMEMORY_PYSTORAGE_SOURCE)
+#    define TIMEMORY_PYSTORAGE_SOURCE
+#endif
+
+#include "libpytimemory-components.hpp"
+#include "libpytimemory.hpp"
+#include "timemory/components.hpp"
+#include "timemory/components/extern.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//======================================================================================//
+//
+//  One row of the structured arrays, i.e. one entry of the result_array_t of a
+//  component for one rank. The prefix is an index into the shared string table.
+//  The value and accum fields are the unscaled values, i.e. the "value" and "accum"
+//  of the JSON, and the statistics are computed from get()
+//
+namespace pystorage
+{
+struct record
+{
+    uint64_t hash;
+    uint64_t rolling_hash;
+    uint64_t prefix;
+    int64_t  depth;
+    int64_t  rank;
+    int64_t  tid;
+    int64_t  pid;
+    int64_t  laps;
+    double   value;
+    double   accum;
+    int64_t  count;
+    double   sum;
+    double   min;
+    double   max;
+    double   sqr;
+    double   mean;
+    double   stddev;
+};
+}  // namespace pystorage
+
+PYBIND11_NUMPY_DTYPE(pystorage::record, hash, rolling_hash, prefix, depth, rank, tid,
+                     pid, laps, value, accum, count, sum, min, max, sqr, mean, stddev);
+
+//======================================================================================//
+//
+namespace pystorage
+{
+namespace impl
+{
+//
+template <size_t Idx>
+using enumerator_t = typename tim::component::enumerator<Idx>::type;
+//
+using record_array_t = std::vector<record>;
+using array_map_t    = std::map<std::string, py::array>;
+//
+//--------------------------------------------------------------------------------------//
+//
+//  the unique prefixes of all the components, the records store the index
+//
+struct string_table
+{
+    uint64_t insert(const std::string& _str)
+    {
+        auto itr = m_index.find(_str);
+        if(itr != m_index.end())
+            return itr->second;
+        auto _idx = static_cast<uint64_t>(m_data.size());
+        m_index.emplace(_str, _idx);
+        m_data.emplace_back(_str);
+        return _idx;
+    }
+
+    const std::vector<std::string>& get() const { return m_data; }
+
+private:
+    std::vector<std::string>                  m_data  = {};
+    std::unordered_map<std::string, uint64_t> m_index = {};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+//  only scalar values are exported, everything else (arrays, tuples, etc.) is NaN
+//
+template <typename Tp>
+double
+as_double(const Tp& _val)
+{
+    return tim::as_double(_val, std::numeric_limits<double>::quiet_NaN());
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename StatsT>
+auto
+get_stats(record& _rec, const StatsT& _stats, int)
+    -> decltype(_stats.get_sum(), _stats.get_sqr(), _stats.get_count(), void())
+{
+    _rec.count = _stats.get_count();
+    _rec.sum   = as_double(_stats.get_sum());
+    _rec.min   = as_double(_stats.get_min());
+    _rec.max   = as_double(_stats.get_max());
+    _rec.sqr   = as_double(_stats.get_sqr());
+    if(_rec.count > 0)
+        _rec.mean = _rec.sum / _rec.count;
+    if(_rec.count > 1)
+    {
+        // same as statistics<Tp>::get_variance()
+        auto _var   = (_rec.sqr - (_rec.sum * _rec.mean)) / (_rec.count - 1);
+        _rec.stddev = std::sqrt(std::abs(_var));
+    }
+}
+//
+template <typename StatsT>
+void
+get_stats(record&, const StatsT&, long)
+{}
+//
+//--------------------------------------------------------------------------------------//
+//
+//  the array owns the vector so numpy reads the C++ buffer without a copy
+//
+inline py::array
+as_array(record_array_t&& _data)
+{
+    auto* _ptr     = new record_array_t(std::move(_data));
+    auto  _capsule = py::capsule(
+        _ptr, [](void* _p) { delete static_cast<record_array_t*>(_p); });
+    return py::array_t<record>({ _ptr->size() }, { sizeof(record) }, _ptr->data(),
+                               _capsule);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp, typename ValueT = typename Tp::value_type,
+          tim::enable_if_t<tim::trait::is_available<Tp>::value &&
+                           !tim::concepts::is_null_type<ValueT>::value> = 0>
+auto
+get_arrays(array_map_t& _arrays, string_table& _strings, int)
+    -> decltype(tim::storage<Tp>::instance()->dmp_get(), void())
+{
+    constexpr auto _nan = std::numeric_limits<double>::quiet_NaN();
+
+    auto _storage = tim::storage<Tp>::instance();
+    if(!_storage)
+        return;
+
+    auto _results = _storage->dmp_get();
+
+    size_t _n = 0;
+    for(const auto& itr : _results)
+        _n += itr.size();
+
+    if(_n == 0 || tim::dmp::rank() > 0)
+        return;
+
+    record_array_t _data{};
+    _data.reserve(_n);
+    for(size_t i = 0; i < _results.size(); ++i)
+    {
+        for(const auto& itr : _results.at(i))
+        {
+            record _rec{};
+            _rec.hash         = itr.hash();
+            _rec.rolling_hash = itr.rolling_hash();
+            _rec.prefix       = _strings.insert(itr.prefix());
+            _rec.depth        = itr.depth();
+            _rec.rank         = static_cast<int64_t>(i);
+            _rec.tid          = itr.tid();
+            _rec.pid          = itr.pid();
+            _rec.laps         = itr.data().get_laps();
+            _rec.value        = as_double(itr.data().get_value());
+            _rec.accum        = as_double(itr.data().get_accum());
+            _rec.sum          = _nan;
+            _rec.min          = _nan;
+            _rec.max          = _nan;
+            _rec.sqr          = _nan;
+            _rec.mean         = _nan;
+            _rec.stddev       = _nan;
+            get_stats(_rec, itr.stats(), 0);
+            _data.emplace_back(_rec);
+        }
+    }
+
+    _arrays.emplace(Tp::get_label(), as_array(std::move(_data)));
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+void
+get_arrays(array_map_t&, string_table&, long)
+{}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <size_t... Idx>
+void
+get_arrays(array_map_t& _arrays, string_table& _strings, std::index_sequence<Idx...>)
+{
+    TIMEMORY_FOLD_EXPRESSION(
+        get_arrays<tim::decay_t<enumerator_t<Idx>>>(_arrays, _strings, 0));
+}
+//
+}  // namespace impl
+//
+//--------------------------------------------------------------------------------------//
+//
+void
+generate(py::module& _pymod)
+{
+    auto _get_arrays = []() {
+        impl::array_map_t  _arrays{};
+        impl::string_table _strings{};
+        impl::get_arrays(_arrays, _strings,
+                         std::make_index_sequence<TIMEMORY_COMPONENTS_END>{});
+        return py::make_tuple(_arrays, _strings.get());
+    };
+
+    _pymod.def("get_arrays", _get_arrays,
+               "Get the storage data as a tuple of (dict of numpy structured arrays "
+               "keyed by the component label, list of strings). The 'prefix' field of "
+               "the arrays is an index into the list of strings");
+}
+}  // namespace pystorage
+//
+//======================================================================================//
@@ -246,6 +246,7 @@ PYBIND11_MODULE(libpytimemory, tim)
     pyenumeration::generate(pycomp);
     pyprofile::generate(tim);
     pytrace::generate(tim);
+    pystorage::generate(tim);
 
     //==================================================================================//
     //
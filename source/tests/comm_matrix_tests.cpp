@@ -0,0 +1,198 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/data/comm_matrix.hpp"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using comm_matrix = tim::data::comm_matrix;
+using buffer_t    = comm_matrix::buffer_type;
+
+//--------------------------------------------------------------------------------------//
+
+class comm_matrix_tests : public ::testing::Test
+{};
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(comm_matrix_tests, buckets)
+{
+    EXPECT_EQ(comm_matrix::bucket(0), 0);
+    EXPECT_EQ(comm_matrix::bucket(1), 1);
+    EXPECT_EQ(comm_matrix::bucket(2), 2);
+    EXPECT_EQ(comm_matrix::bucket(3), 2);
+    EXPECT_EQ(comm_matrix::bucket(4), 3);
+    EXPECT_EQ(comm_matrix::bucket(1023), 10);
+    EXPECT_EQ(comm_matrix::bucket(1024), 11);
+    EXPECT_EQ(comm_matrix::bucket(UINT64_MAX), comm_matrix::num_buckets - 1);
+    for(size_t i = 1; i < comm_matrix::num_buckets; ++i)
+        EXPECT_EQ(comm_matrix::bucket(comm_matrix::bucket_size(i)), i) << "bucket " << i;
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(comm_matrix_tests, threads)
+{
+    constexpr size_t nranks   = 4;
+    constexpr size_t nthreads = 4;
+    constexpr size_t nitr     = 1000;
+
+    comm_matrix _matrix{ nranks, { "MPI_Send", "MPI_Recv" } };
+    EXPECT_EQ(_matrix.index("MPI_Send"), 0);
+    EXPECT_EQ(_matrix.index("MPI_Recv"), 1);
+    EXPECT_EQ(_matrix.index("MPI_Barrier"), -1);
+
+    auto _func = [&_matrix](size_t _tid) {
+        for(size_t i = 0; i < nitr; ++i)
+        {
+            _matrix.add_message(0, _tid % nranks, 64 * (_tid + 1));
+            _matrix.add_size(1, 100);
+        }
+    };
+
+    std::vector<std::thread> _threads{};
+    for(size_t i = 0; i < nthreads; ++i)
+        _threads.emplace_back(_func, i);
+    for(auto& itr : _threads)
+        itr.join();
+
+    // out-of-range destinations and functions are ignored
+    _matrix.add_message(0, nranks, 8);
+    _matrix.add_size(2, 8);
+
+    auto _packed = _matrix.pack();
+    ASSERT_EQ(_packed.size(), _matrix.packed_size());
+    EXPECT_TRUE(_matrix.is_valid(buffer_t(nranks * _packed.size(), 0)));
+    EXPECT_FALSE(_matrix.is_valid(_packed));
+
+    // treat the local counters as rank 1 of a gathered buffer
+    buffer_t _gathered(nranks * _packed.size(), 0);
+    std::copy(_packed.begin(), _packed.end(), _gathered.begin() + _packed.size());
+
+    for(size_t i = 0; i < nranks; ++i)
+    {
+        EXPECT_EQ(_matrix.bytes(_gathered, 0, i), 0);
+        EXPECT_EQ(_matrix.messages(_gathered, 1, i), nitr) << "dst " << i;
+        EXPECT_EQ(_matrix.bytes(_gathered, 1, i), nitr * 64 * (i + 1)) << "dst " << i;
+    }
+
+    EXPECT_EQ(_matrix.calls(_gathered, 0), nthreads * nitr + 1);
+    EXPECT_EQ(_matrix.calls(_gathered, 1), nthreads * nitr);
+    EXPECT_EQ(_matrix.total_bytes(_gathered, 1), nthreads * nitr * 100);
+
+    auto _hist = _matrix.histogram(_gathered, 0);
+    EXPECT_EQ(_hist.at(comm_matrix::bucket(8)), 1);
+    EXPECT_EQ(_hist.at(comm_matrix::bucket(64)), nitr);
+    // 128 and 192 bytes share a bucket
+    EXPECT_EQ(_hist.at(comm_matrix::bucket(128)), 2 * nitr);
+    EXPECT_EQ(_hist.at(comm_matrix::bucket(256)), nitr);
+    EXPECT_EQ(_matrix.histogram(_gathered, 1).at(comm_matrix::bucket(100)),
+              nthreads * nitr);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(comm_matrix_tests, instances)
+{
+    constexpr size_t nranks = 2;
+    constexpr size_t nitr   = 1000;
+
+    comm_matrix _lhs{ nranks, { "MPI_Send" } };
+    comm_matrix _rhs{ nranks, { "MPI_Send" } };
+
+    // a thread which alternates between two instances records into one block of each
+    auto _func = [&]() {
+        for(size_t i = 0; i < nitr; ++i)
+        {
+            _lhs.add_message(0, 0, 8);
+            _rhs.add_message(0, 1, 16);
+        }
+    };
+
+    _func();
+    std::thread{ _func }.join();
+
+    EXPECT_EQ(_lhs.num_threads(), 2);
+    EXPECT_EQ(_rhs.num_threads(), 2);
+
+    auto _lpacked = _lhs.pack();
+    auto _rpacked = _rhs.pack();
+    EXPECT_EQ(_lpacked.at(0), 2 * nitr * 8);
+    EXPECT_EQ(_lpacked.at(nranks), 2 * nitr);
+    EXPECT_EQ(_rpacked.at(1), 2 * nitr * 16);
+    EXPECT_EQ(_rpacked.at(nranks + 1), 2 * nitr);
+
+    // a new instance does not reuse the block of a destroyed one
+    {
+        comm_matrix _tmp{ nranks, { "MPI_Send" } };
+        _tmp.add_message(0, 0, 8);
+        EXPECT_EQ(_tmp.num_threads(), 1);
+        EXPECT_EQ(_tmp.pack().at(nranks), 1);
+    }
+    _lhs.add_message(0, 0, 8);
+    EXPECT_EQ(_lhs.num_threads(), 2);
+    EXPECT_EQ(_lhs.pack().at(nranks), 2 * nitr + 1);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(comm_matrix_tests, write)
+{
+    constexpr size_t nranks = 2;
+
+    comm_matrix _matrix{ nranks, { "MPI_Send", "MPI_Bcast", "MPI_Recv" } };
+    _matrix.add_message(0, 1, 1024);
+    _matrix.add_message(0, 1, 1024);
+    _matrix.add_message(1, 0, 0);
+    _matrix.add_transfer(1, 24);
+
+    auto     _packed = _matrix.pack();
+    buffer_t _gathered(nranks * _packed.size(), 0);
+    std::copy(_packed.begin(), _packed.end(), _gathered.begin());
+
+    std::stringstream _ss{};
+    _matrix.write(_ss, _gathered);
+    auto _str = _ss.str();
+    std::cout << _str;
+
+    EXPECT_NE(_str.find("# ranks: 2\n"), std::string::npos);
+    EXPECT_NE(_str.find("\n0 2072\n0 0\n"), std::string::npos);
+    EXPECT_NE(_str.find("\n1 3\n0 0\n"), std::string::npos);
+    EXPECT_NE(_str.find("\nMPI_Send 2 2048 1024:2\n"), std::string::npos);
+    EXPECT_NE(_str.find("\nMPI_Bcast 1 0 0:1\n"), std::string::npos);
+    EXPECT_EQ(_str.find("MPI_Recv"), std::string::npos);
+
+    std::stringstream _err{};
+    _matrix.write(_err, _packed);
+    EXPECT_NE(_err.str().find("invalid"), std::string::npos);
+}
+
+//--------------------------------------------------------------------------------------//
@@ -0,0 +1,255 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "gtest/gtest.h"
+
+#include "timemory/data/compare.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace compare = tim::data::compare;
+using verdict     = compare::verdict;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+// builds a record with "n" samples normally distributed-ish around "mean"
+inline compare::record
+make_record(uint64_t hash, int64_t depth, const std::string& prefix, int64_t n,
+            double mean, double stddev)
+{
+    compare::record _rec{};
+    _rec.rolling_hash = hash;
+    _rec.depth        = depth;
+    _rec.prefix       = prefix;
+    _rec.count        = n;
+    double _sum       = 0.0;
+    double _sqr       = 0.0;
+    for(int64_t i = 0; i < n; ++i)
+    {
+        auto _val = mean + ((i % 2 == 0) ? stddev : -stddev);
+        _sum += _val;
+        _sqr += _val * _val;
+    }
+    _rec.sum = { _sum };
+    _rec.sqr = { _sqr };
+    return _rec;
+}
+
+inline compare::result_set
+make_result_set(std::vector<compare::record>&& _records)
+{
+    compare::result_set _data{};
+    _data.label = "wall";
+    _data.units = "sec";
+    _data.ranks.emplace_back(std::move(_records));
+    return _data;
+}
+
+inline const compare::entry*
+find(const compare::summary& _summary, uint64_t _hash)
+{
+    for(const auto& itr : _summary.entries)
+    {
+        if(itr.get()->rolling_hash == _hash)
+            return &itr;
+    }
+    return nullptr;
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class compare_tests : public ::testing::Test
+{};
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(compare_tests, unchanged)
+{
+    auto _base = details::make_result_set(
+        { details::make_record(1, 0, "a", 100, 1.0, 0.1),
+          details::make_record(2, 1, "b", 100, 2.0, 0.1) });
+    auto _curr = details::make_result_set(
+        { details::make_record(1, 0, "a", 100, 1.01, 0.1),
+          details::make_record(2, 1, "b", 100, 1.99, 0.1) });
+
+    auto _summary = compare::compare(_base, _curr);
+    EXPECT_EQ(_summary.entries.size(), 2);
+    EXPECT_EQ(_summary.count(verdict::unchanged), 2);
+    EXPECT_TRUE(_summary.passed(compare::config{}));
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(compare_tests, regression)
+{
+    auto _base = details::make_result_set(
+        { details::make_record(1, 0, "a", 100, 1.0, 0.1),
+          details::make_record(2, 1, "b", 100, 2.0, 0.1) });
+    auto _curr = details::make_result_set(
+        { details::make_record(1, 0, "a", 100, 1.5, 0.1),
+          details::make_record(2, 1, "b", 100, 1.5, 0.1) });
+
+    auto _summary = compare::compare(_base, _curr);
+    EXPECT_EQ(_summary.count(verdict::regressed), 1);
+    EXPECT_EQ(_summary.count(verdict::improved), 1);
+    EXPECT_FALSE(_summary.passed(compare::config{}));
+
+    auto* _a = details::find(_summary, 1);
+    ASSERT_TRUE(_a != nullptr);
+    EXPECT_EQ(_a->result, verdict::regressed);
+    EXPECT_NEAR(_a->relative, 0.5, 1.0e-6);
+    EXPECT_GT(_a->tscore, 3.0);
+
+    std::stringstream _ss{};
+    compare::write(_ss, _summary);
+    std::cout << _ss.str();
+    EXPECT_NE(_ss.str().find("regressed"), std::string::npos);
+
+    compare::config _cfg{};
+    _cfg.higher_is_better = true;
+    _summary              = compare::compare(_base, _curr, _cfg);
+    EXPECT_EQ(details::find(_summary, 1)->result, verdict::improved);
+    EXPECT_EQ(details::find(_summary, 2)->result, verdict::regressed);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(compare_tests, noisy)
+{
+    // a 20% shift is not significant when the spread is much larger than the shift
+    auto _base =
+        details::make_result_set({ details::make_record(1, 0, "a", 4, 1.0, 2.0) });
+    auto _curr =
+        details::make_result_set({ details::make_record(1, 0, "a", 4, 1.2, 2.0) });
+
+    auto _summary = compare::compare(_base, _curr);
+    EXPECT_EQ(_summary.count(verdict::unchanged), 1);
+
+    compare::config _cfg{};
+    _cfg.tscore = 0.0;
+    _summary    = compare::compare(_base, _curr, _cfg);
+    EXPECT_EQ(_summary.count(verdict::regressed), 1);
+
+    _cfg.relative = 0.25;
+    _summary      = compare::compare(_base, _curr, _cfg);
+    EXPECT_EQ(_summary.count(verdict::unchanged), 1);
+
+    _cfg.relative  = 0.0;
+    _cfg.min_count = 10;
+    _summary       = compare::compare(_base, _curr, _cfg);
+    EXPECT_EQ(_summary.count(verdict::unchanged), 1);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(compare_tests, added_removed)
+{
+    auto _base = details::make_result_set(
+        { details::make_record(1, 0, "a", 10, 1.0, 0.0),
+          details::make_record(2, 1, "b", 10, 1.0, 0.0) });
+    // same hash at a different depth is a different node
+    auto _curr = details::make_result_set(
+        { details::make_record(1, 0, "a", 10, 1.0, 0.0),
+          details::make_record(2, 2, "b", 10, 1.0, 0.0) });
+
+    auto _summary = compare::compare(_base, _curr);
+    EXPECT_EQ(_summary.count(verdict::added), 1);
+    EXPECT_EQ(_summary.count(verdict::removed), 1);
+    EXPECT_EQ(_summary.count(verdict::unchanged), 1);
+
+    compare::config _cfg{};
+    EXPECT_TRUE(_summary.passed(_cfg));
+    _cfg.fail_on_removed = true;
+    EXPECT_FALSE(_summary.passed(_cfg));
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(compare_tests, merge_ranks)
+{
+    compare::result_set _data{};
+    _data.ranks.resize(4);
+    for(auto& itr : _data.ranks)
+    {
+        itr.emplace_back(details::make_record(1, 0, "a", 10, 1.0, 0.0));
+        itr.emplace_back(details::make_record(2, 1, "b", 10, 2.0, 0.0));
+    }
+    _data.ranks.back().emplace_back(details::make_record(3, 1, "c", 10, 3.0, 0.0));
+
+    _data.merge_ranks();
+    ASSERT_EQ(_data.ranks.size(), 1);
+    ASSERT_EQ(_data.ranks.front().size(), 3);
+    EXPECT_EQ(_data.ranks.front().at(0).count, 40);
+    EXPECT_NEAR(_data.ranks.front().at(0).mean(0), 1.0, 1.0e-9);
+    EXPECT_NEAR(_data.ranks.front().at(1).mean(0), 2.0, 1.0e-9);
+    EXPECT_EQ(_data.ranks.front().at(2).count, 10);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(compare_tests, read_json)
+{
+    auto _json = [](double _sum) {
+        std::stringstream _ss{};
+        _ss << R"({ "timemory": { "num_ranks": 1, "ranks": [ { "rank": 0, )"
+            << R"("type": "wall", "unit_repr": "sec", "graph_size": 2, "graph": [ )"
+            << R"({ "hash": 10, "prefix": ">>> main", "depth": 0, "rolling_hash": 10, )"
+            << R"("entry": { "laps": 1, "repr_data": 5.0 }, )"
+            << R"("stats": { "sum": 5.0, "count": 1, "min": 5.0, "max": 5.0, )"
+            << R"("sqr": 25.0 } }, )"
+            << R"({ "hash": 11, "prefix": ">>> |_foo", "depth": 1, "rolling_hash": 21, )"
+            << R"("entry": { "laps": 4, "repr_data": )" << _sum << " } } ] } ] } }";
+        return _ss.str();
+    };
+
+    compare::result_set _base{};
+    compare::result_set _curr{};
+    std::stringstream   _bss{ _json(4.0) };
+    std::stringstream   _css{ _json(8.0) };
+    ASSERT_TRUE(compare::read_json(_bss, _base, &std::cerr));
+    ASSERT_TRUE(compare::read_json(_css, _curr, &std::cerr));
+
+    EXPECT_EQ(_base.label, "wall");
+    EXPECT_EQ(_base.units, "sec");
+    ASSERT_EQ(_base.size(), 2);
+    EXPECT_EQ(_base.ranks.front().at(1).count, 4);
+    EXPECT_NEAR(_base.ranks.front().at(1).mean(0), 1.0, 1.0e-9);
+
+    auto _summary = compare::compare(_base, _curr);
+    EXPECT_EQ(_summary.count(verdict::unchanged), 1);
+    EXPECT_EQ(_summary.count(verdict::regressed), 1);
+    EXPECT_EQ(details::find(_summary, 21)->result, verdict::regressed);
+
+    std::stringstream _bad{ "{ \"timemory\": " };
+    EXPECT_FALSE(compare::read_json(_bad, _base));
+}
+
+//--------------------------------------------------------------------------------------//
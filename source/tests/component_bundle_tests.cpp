@@ -536,6 +536,36 @@ TEST_F(component_bundle_tests, custom_type_count_w_init)
 
 //--------------------------------------------------------------------------------------//
 
+TEST_F(component_bundle_tests, literal_keys)
+{
+    using bundle_t = tim::component_bundle<TIMEMORY_API, wall_clock>;
+    using auto_t   = tim::auto_bundle<TIMEMORY_API, wall_clock>;
+
+    // ids computed at compile-time match the ids of dynamic strings
+    constexpr auto _hash = tim::get_hash_id("component_bundle_tests/literal_keys");
+    EXPECT_EQ(_hash,
+              tim::get_hash_id(std::string{ "component_bundle_tests/literal_keys" }));
+    EXPECT_EQ(TIMEMORY_LITERAL_HASH_ID("component_bundle_tests/literal_keys"), _hash);
+
+    bundle_t _literal{ "component_bundle_tests/literal_keys" };
+    bundle_t _string{ std::string{ "component_bundle_tests/literal_keys" } };
+    auto_t   _auto{ "component_bundle_tests/literal_keys" };
+
+    EXPECT_EQ(_literal.hash(), _hash);
+    EXPECT_EQ(_string.hash(), _hash);
+    EXPECT_EQ(_auto.hash(), _hash);
+    EXPECT_EQ(_literal.key(), std::string{ "component_bundle_tests/literal_keys" });
+    EXPECT_EQ(tim::get_hash_identifier(_hash),
+              std::string{ "component_bundle_tests/literal_keys" });
+
+#if TIMEMORY_STRING_VIEW > 0
+    tim::string_view_t _view{ "component_bundle_tests/literal_keys/view" };
+    bundle_t           _viewed{ _view };
+    EXPECT_EQ(_viewed.hash(), tim::get_hash_id(std::string{ _view }));
+    EXPECT_EQ(_viewed.key(), std::string{ _view });
+#endif
+}
+
 int
 main(int argc, char** argv)
 {
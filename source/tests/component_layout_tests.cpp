@@ -0,0 +1,196 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/timemory.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+
+using namespace tim::component;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+static constexpr size_t cache_line_size = 64;
+
+// the size a component with an int64_t value would have if every member was laid
+// out back-to-back (the flags and empty types rounded up to one word)
+template <typename Tp>
+constexpr size_t
+expected_size()
+{
+    using base_type = typename Tp::base_type;
+    return sizeof(typename base_type::value_type) + sizeof(int64_t) +
+           sizeof(typename base_type::graph_iterator) +
+           (base_type::has_accum_v ? sizeof(typename base_type::value_type) : 0) +
+           (base_type::has_last_v ? sizeof(typename base_type::value_type) : 0) +
+           sizeof(int64_t);
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+struct dynamic_layout_component;
+
+namespace tim
+{
+namespace trait
+{
+template <>
+struct dynamic_base<dynamic_layout_component> : std::true_type
+{
+    using type = component::dynamic_base;
+};
+}  // namespace trait
+}  // namespace tim
+
+struct dynamic_layout_component : base<dynamic_layout_component, int64_t>
+{
+    using base_type = base<dynamic_layout_component, int64_t>;
+
+    static std::string label() { return "dynamic_layout_component"; }
+    static std::string description() { return "polymorphic component"; }
+
+    void start() override { ++value; }
+    void stop() override { ++value; }
+
+    static int64_t& destroyed()
+    {
+        static int64_t _instance = 0;
+        return _instance;
+    }
+
+    ~dynamic_layout_component() { ++destroyed(); }
+};
+
+struct void_layout_component : base<void_layout_component, void>
+{
+    void start() {}
+    void stop() {}
+};
+
+//--------------------------------------------------------------------------------------//
+//  size regression checks: these fail at compile-time
+//
+static_assert(!std::is_polymorphic<wall_clock>::value,
+              "components without a dynamic base should not have a vtable");
+static_assert(!std::is_polymorphic<peak_rss>::value,
+              "components without a dynamic base should not have a vtable");
+static_assert(!std::is_polymorphic<void_layout_component>::value,
+              "components without a dynamic base should not have a vtable");
+static_assert(std::is_polymorphic<dynamic_layout_component>::value,
+              "components with a dynamic base should have a vtable");
+static_assert(std::has_virtual_destructor<dynamic_base>::value,
+              "dynamic_base should have a virtual destructor");
+
+static_assert(sizeof(wall_clock) <= details::expected_size<wall_clock>(),
+              "wall_clock is larger than its packed layout");
+static_assert(sizeof(cpu_clock) <= details::expected_size<cpu_clock>(),
+              "cpu_clock is larger than its packed layout");
+static_assert(sizeof(peak_rss) <= details::expected_size<peak_rss>(),
+              "peak_rss is larger than its packed layout");
+static_assert(sizeof(void_layout_component) <= sizeof(int64_t),
+              "void components should only hold their flags");
+
+static_assert(sizeof(tim::component_tuple<wall_clock, cpu_clock>) <=
+                  2 * details::cache_line_size,
+              "a two timer bundle should not span more than two cache lines");
+static_assert(sizeof(tim::lightweight_tuple<wall_clock, cpu_clock>) <=
+                  2 * details::cache_line_size,
+              "a two timer bundle should not span more than two cache lines");
+
+//--------------------------------------------------------------------------------------//
+
+class component_layout_tests : public ::testing::Test
+{};
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(component_layout_tests, sizes)
+{
+    auto _print = [](const char* _name, size_t _size) {
+        std::cout << "    " << _name << " : " << _size << " bytes" << std::endl;
+    };
+
+    _print("wall_clock", sizeof(wall_clock));
+    _print("cpu_clock", sizeof(cpu_clock));
+    _print("peak_rss", sizeof(peak_rss));
+    _print("void component", sizeof(void_layout_component));
+    _print("dynamic component", sizeof(dynamic_layout_component));
+    _print("component_tuple<wall_clock, cpu_clock>",
+           sizeof(tim::component_tuple<wall_clock, cpu_clock>));
+
+    EXPECT_EQ(sizeof(dynamic_layout_component),
+              sizeof(void*) + sizeof(base<wall_clock, int64_t>));
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(component_layout_tests, flags)
+{
+    wall_clock _obj{};
+    EXPECT_FALSE(_obj.get_is_running());
+    EXPECT_FALSE(_obj.get_is_on_stack());
+    EXPECT_FALSE(_obj.get_is_transient());
+    EXPECT_EQ(_obj.get_laps(), 0);
+
+    _obj.start();
+    _obj.stop();
+    _obj.set_is_transient(true);
+    _obj.set_laps(2);
+
+    auto _cpy = _obj;
+    EXPECT_TRUE(_cpy.get_is_transient());
+    EXPECT_EQ(_cpy.get_laps(), 2);
+    EXPECT_EQ(_cpy.get_value(), _obj.get_value());
+    EXPECT_EQ(_cpy.get_accum(), _obj.get_accum());
+
+    _cpy.reset();
+    EXPECT_FALSE(_cpy.get_is_transient());
+    EXPECT_EQ(_cpy.get_laps(), 0);
+    EXPECT_EQ(_cpy.get_value(), 0);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(component_layout_tests, dynamic_delete)
+{
+    dynamic_layout_component::destroyed() = 0;
+    {
+        std::unique_ptr<dynamic_base> _obj{ new dynamic_layout_component{} };
+        _obj->start();
+        _obj->stop();
+        std::unique_ptr<dynamic_base> _cpy{ _obj->create() };
+        EXPECT_TRUE(_cpy != nullptr);
+    }
+    EXPECT_EQ(dynamic_layout_component::destroyed(), 2);
+}
+
+//--------------------------------------------------------------------------------------//
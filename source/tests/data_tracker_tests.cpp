@@ -24,8 +24,10 @@
 
 #include "gtest/gtest.h"
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdlib>
 #include <iostream>
 #include <mutex>
 #include <random>
@@ -133,10 +135,36 @@ random_entry(const std::vector<Tp>& v)
     return v.at(get_random_value(0, v.size() - 1));
 }
 
+
+// the number of calls to the global operator new
+static std::atomic<int64_t> allocations{ 0 };
 }  // namespace details
 
 //--------------------------------------------------------------------------------------//
 
+void*
+operator new(size_t _n)
+{
+    ++details::allocations;
+    if(void* _ptr = malloc((_n > 0) ? _n : 1))
+        return _ptr;
+    throw std::bad_alloc{};
+}
+
+void
+operator delete(void* _ptr) noexcept
+{
+    free(_ptr);
+}
+
+void
+operator delete(void* _ptr, size_t) noexcept
+{
+    free(_ptr);
+}
+
+//--------------------------------------------------------------------------------------//
+
 class data_tracker_tests : public ::testing::Test
 {
 protected:
@@ -205,6 +233,128 @@ TEST_F(data_tracker_tests, iteration_tracker)
 
 //--------------------------------------------------------------------------------------//
 
+TEST_F(data_tracker_tests, secondary)
+{
+    struct secondary_tag
+    {};
+
+    using tracker_t = data_tracker<uint64_t, secondary_tag>;
+    using bundle_t  = tim::component_tuple<tracker_t>;
+
+    tracker_t::label()       = "secondary_count";
+    tracker_t::description() = "Secondary count tracker";
+
+    tracker_t _obj{};
+    EXPECT_TRUE(_obj.get_secondary().empty());
+
+    // keys beyond the inline capacity spill into the heap-allocated storage
+    auto _ninline = tracker_t::secondary_data_t::inline_capacity();
+    for(uint64_t i = 0; i < _ninline + 2; ++i)
+    {
+        auto* _val = _obj.add_secondary(TIMEMORY_JOIN("_", "secondary", i), i + 1);
+        ASSERT_TRUE(_val != nullptr);
+        EXPECT_EQ(*_val, i + 1);
+    }
+    EXPECT_EQ(_obj.get_secondary().size(), _ninline + 2);
+    EXPECT_FALSE(_obj.get_secondary().is_inline());
+
+    // the first value for a key is retained
+    EXPECT_EQ(*_obj.add_secondary("secondary_0", 100), 1);
+    EXPECT_EQ(_obj.get_secondary().size(), _ninline + 2);
+
+    // literal labels and strings intern to the same id
+    auto* _lit = _obj.add_secondary(TIMEMORY_LITERAL_HASH_ID("secondary_1"), 100);
+    EXPECT_EQ(*_lit, 2);
+    EXPECT_EQ(_obj.find_secondary(tim::get_hash_id("secondary_1")), _lit);
+    EXPECT_TRUE(_obj.find_secondary(tim::get_hash_id("secondary_x")) == nullptr);
+
+    uint64_t _n = 0;
+    for(const auto& itr : _obj.get_secondary())
+    {
+        EXPECT_EQ(tim::get_hash_identifier(itr.first),
+                  TIMEMORY_JOIN("_", "secondary", _n));
+        EXPECT_EQ(itr.second, ++_n);
+    }
+
+    // secondary entries become children of the region in the call-graph, including
+    // the ones added before the tracker is started, and they are cleared once they
+    // are appended to the storage
+    auto _bsize = tim::storage<tracker_t>::instance()->size();
+    for(int i = 0; i < 3; ++i)
+    {
+        bundle_t _bundle{ details::get_test_name() };
+        _bundle.get<tracker_t>()->add_secondary("secondary_c", 1);
+        _bundle.start();
+        _bundle.store(std::plus<uint64_t>{}, 1);
+        _bundle.get<tracker_t>()->add_secondary("secondary_a", 2);
+        _bundle.get<tracker_t>()->add_secondary("secondary_b", 3);
+        _bundle.stop();
+        EXPECT_TRUE(_bundle.get<tracker_t>()->get_secondary().empty());
+    }
+
+    auto _data = tim::storage<tracker_t>::instance()->get();
+    ASSERT_EQ(_data.size() - _bsize, 4);
+    EXPECT_EQ(_data.at(_bsize).data().get(), 3);
+
+    auto _find = [&](const std::string& _key) -> const tracker_t* {
+        for(size_t i = _bsize + 1; i < _data.size(); ++i)
+        {
+            if(_data.at(i).prefix().find(_key) != std::string::npos)
+                return &_data.at(i).data();
+        }
+        return nullptr;
+    };
+
+    ASSERT_TRUE(_find("secondary_a") != nullptr);
+    ASSERT_TRUE(_find("secondary_b") != nullptr);
+    ASSERT_TRUE(_find("secondary_c") != nullptr);
+    EXPECT_EQ(_find("secondary_a")->get(), 6);
+    EXPECT_EQ(_find("secondary_a")->get_laps(), 3);
+    EXPECT_EQ(_find("secondary_b")->get(), 9);
+    EXPECT_EQ(_find("secondary_c")->get(), 3);
+    EXPECT_EQ(_find("secondary_c")->get_laps(), 3);
+}
+
+//--------------------------------------------------------------------------------------//
+// adding secondary values by hash id does not allocate once the capacity of the
+// container was reached
+//
+TEST_F(data_tracker_tests, secondary_allocations)
+{
+    struct allocations_tag
+    {};
+
+    using tracker_t = data_tracker<uint64_t, allocations_tag>;
+
+    const int64_t                      nitr = 1000;
+    std::vector<tim::hash_result_type> _ids{};
+    for(int i = 0; i < 16; ++i)
+        _ids.emplace_back(tim::add_hash_id(TIMEMORY_JOIN("_", "allocations", i)));
+
+    auto _measure = [&](size_t _nsecondary) {
+        tracker_t _obj{};
+        int64_t   _beg = 0;
+        // the first iteration grows the heap-allocated storage past the inline capacity
+        for(int64_t i = 0; i <= nitr; ++i)
+        {
+            if(i == 1)
+                _beg = details::allocations.load();
+            for(size_t j = 0; j < _nsecondary; ++j)
+                _obj.add_secondary(_ids.at(j), j);
+            if(i < nitr)
+                _obj.clear_secondary();
+        }
+        auto _n = details::allocations.load() - _beg;
+        EXPECT_EQ(_obj.get_secondary().size(), _nsecondary);
+        return _n;
+    };
+
+    EXPECT_EQ(_measure(tracker_t::secondary_data_t::inline_capacity()), 0);
+    EXPECT_EQ(_measure(_ids.size()), 0);
+}
+
+//--------------------------------------------------------------------------------------//
+
 int
 main(int argc, char** argv)
 {
@@ -0,0 +1,196 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/components/timing/wall_clock.hpp"
+#include "timemory/ert/cache.hpp"
+#include "timemory/settings/declaration.hpp"
+#include "timemory/version.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+namespace cache  = tim::ert::cache;
+namespace device = tim::device;
+using settings   = tim::settings;
+
+using counter_type = tim::component::wall_clock;
+using ert_data_t   = tim::ert::exec_data<counter_type>;
+using config_type  = tim::ert::configuration<device::cpu, double, counter_type>;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+inline ert_data_t
+make_data(uint64_t _nentries)
+{
+    ert_data_t _data{};
+    for(uint64_t i = 0; i < _nentries; ++i)
+    {
+        tim::ert::exec_params  _params{ 16, 1024 };
+        ert_data_t::value_type _entry{ "vector_fma",   16 * (i + 1), 10,    1024,
+                                       2048,           16,           counter_type{},
+                                       "cpu",          "double",     _params };
+        _data += _entry;
+    }
+    return _data;
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class ert_cache_tests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_cache_dir               = settings::ert_cache_dir();
+        settings::ert_cache_dir() = std::string{ "ert-cache-tests-" } +
+                                    std::to_string(getpid());
+        cache::clear();
+    }
+
+    void TearDown() override
+    {
+        cache::clear();
+        rmdir(settings::ert_cache_dir().c_str());
+        settings::ert_cache_dir() = m_cache_dir;
+    }
+
+    std::string m_cache_dir = {};
+};
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(ert_cache_tests, fingerprint)
+{
+    config_type _config{};
+    auto        _fp  = cache::get_fingerprint(_config);
+    auto        _cpy = _fp;
+
+    EXPECT_FALSE(_fp.cpu_model.empty());
+    EXPECT_EQ(_fp.timemory_version, TIMEMORY_VERSION_STRING);
+    EXPECT_EQ(_fp.device, "cpu");
+    EXPECT_EQ(_fp.num_threads, _config.num_threads());
+    EXPECT_EQ(_fp.hash(), _cpy.hash());
+    EXPECT_EQ(_fp.filename(), _cpy.filename());
+    // ert-<16 hex digits>.json
+    EXPECT_EQ(_fp.filename().length(), 25);
+
+    _cpy.num_threads += 1;
+    EXPECT_NE(_fp, _cpy);
+    EXPECT_NE(_fp.hash(), _cpy.hash());
+
+    _cpy = _fp;
+    _cpy.kernels += " simd=scalar";
+    EXPECT_NE(_fp.filename(), _cpy.filename());
+
+    // the kernels may change between releases
+    _cpy = _fp;
+    _cpy.timemory_version += ".1";
+    EXPECT_NE(_fp, _cpy);
+    EXPECT_NE(_fp.filename(), _cpy.filename());
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(ert_cache_tests, save_load)
+{
+    config_type _config{};
+    auto        _fp = cache::get_fingerprint(_config);
+
+    ert_data_t _data{};
+    EXPECT_FALSE(cache::load(_fp, _data));
+    EXPECT_EQ(_data.size(), 0);
+
+    ASSERT_TRUE(cache::save(_fp, details::make_data(3)));
+    ASSERT_EQ(cache::list().size(), 1);
+
+    cache::fingerprint _stored{};
+    EXPECT_TRUE(cache::read_fingerprint(cache::list().front(), _stored));
+    EXPECT_EQ(_stored, _fp);
+
+    ASSERT_TRUE(cache::load(_fp, _data));
+    ASSERT_EQ(_data.size(), 3);
+    EXPECT_EQ(std::get<0>(*_data.begin()), "vector_fma");
+    EXPECT_EQ(std::get<1>(*_data.begin()), 16);
+
+    // a different configuration is a miss
+    auto _other = _fp;
+    _other.max_data_size *= 2;
+    ert_data_t _other_data{};
+    EXPECT_FALSE(cache::load(_other, _other_data));
+    EXPECT_EQ(_other_data.size(), 0);
+
+    // an entry written by another timemory version is a miss
+    auto _upgrade = _fp;
+    _upgrade.timemory_version += ".1";
+    EXPECT_FALSE(cache::load(_upgrade, _other_data));
+    EXPECT_EQ(_other_data.size(), 0);
+
+    // and it is not returned even if it ends up at the path of the current version
+    ASSERT_TRUE(cache::save(_upgrade, details::make_data(2)));
+    ASSERT_EQ(rename(cache::get_path(_upgrade).c_str(), cache::get_path(_fp).c_str()),
+              0);
+    EXPECT_FALSE(cache::load(_fp, _other_data));
+    EXPECT_EQ(_other_data.size(), 0);
+
+    // and the entry of the current version is a hit again once it is re-stored
+    ASSERT_TRUE(cache::save(_fp, details::make_data(3)));
+    EXPECT_TRUE(cache::load(_fp, _other_data));
+    EXPECT_EQ(_other_data.size(), 3);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(ert_cache_tests, invalidate)
+{
+    config_type _config{};
+    auto        _fp    = cache::get_fingerprint(_config);
+    auto        _other = _fp;
+    _other.num_threads += 1;
+
+    ASSERT_TRUE(cache::save(_fp, details::make_data(1)));
+    ASSERT_TRUE(cache::save(_other, details::make_data(1)));
+    EXPECT_EQ(cache::list().size(), 2);
+
+    EXPECT_TRUE(cache::invalidate(_fp));
+    EXPECT_FALSE(cache::invalidate(_fp));
+    EXPECT_EQ(cache::list().size(), 1);
+
+    ert_data_t _data{};
+    EXPECT_FALSE(cache::load(_fp, _data));
+    EXPECT_TRUE(cache::load(_other, _data));
+
+    EXPECT_EQ(cache::clear(), 1);
+    EXPECT_EQ(cache::list().size(), 0);
+}
+
+//--------------------------------------------------------------------------------------//
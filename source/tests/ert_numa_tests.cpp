@@ -0,0 +1,255 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/components/timing/wall_clock.hpp"
+#include "timemory/ert/configuration.hpp"
+#include "timemory/ert/topology.hpp"
+#include "timemory/settings/declaration.hpp"
+#include "timemory/tpls/cereal/archives.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace topology = tim::ert::topology;
+namespace device   = tim::device;
+using settings     = tim::settings;
+
+using counter_type  = tim::component::wall_clock;
+using ert_data_t    = tim::ert::exec_data<counter_type>;
+using config_type   = tim::ert::configuration<device::cpu, double, counter_type>;
+using executor_type = tim::ert::executor<device::cpu, double, counter_type>;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+// creates a fake /sys/devices/system/node with two nodes
+inline std::string
+make_sysfs()
+{
+    auto _root = std::string{ "ert-numa-tests-" } + std::to_string(getpid());
+    mkdir(_root.c_str(), 0755);
+    for(auto itr : { "node0", "node1", "has_cpu" })
+        mkdir((_root + "/" + itr).c_str(), 0755);
+    std::ofstream{ _root + "/node0/cpulist" } << "0-3,8-11\n";
+    std::ofstream{ _root + "/node1/cpulist" } << "4-7,12-15\n";
+    return _root;
+}
+
+inline void
+remove_sysfs(const std::string& _root)
+{
+    for(auto itr : { "node0", "node1" })
+        unlink((_root + "/" + itr + "/cpulist").c_str());
+    for(auto itr : { "node0", "node1", "has_cpu" })
+        rmdir((_root + "/" + itr).c_str());
+    rmdir(_root.c_str());
+}
+
+inline ert_data_t::value_type
+make_entry(uint64_t _working_set)
+{
+    tim::ert::exec_params _params{ 16, 1024 };
+    return ert_data_t::value_type{ "vector_fma", _working_set, 10,     1024,  2048,
+                                   16,           counter_type{}, "cpu", "double",
+                                   _params };
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class ert_numa_tests : public ::testing::Test
+{};
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(ert_numa_tests, cpu_list)
+{
+    auto _cpus = topology::parse_cpu_list("8,0-3,10-11,2\n");
+    EXPECT_EQ(_cpus, (topology::cpu_list_t{ 0, 1, 2, 3, 8, 10, 11 }));
+    EXPECT_EQ(topology::as_cpu_list(_cpus), "0-3,8,10-11");
+    EXPECT_EQ(topology::as_cpu_list({ 5 }), "5");
+    EXPECT_TRUE(topology::parse_cpu_list("\n").empty());
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(ert_numa_tests, nodes)
+{
+    auto _root  = details::make_sysfs();
+    auto _nodes = topology::get_numa_nodes(_root, topology::parse_cpu_list("0-15"));
+    ASSERT_EQ(_nodes.size(), 2);
+    EXPECT_EQ(_nodes.at(0).id, 0);
+    EXPECT_EQ(_nodes.at(1).id, 1);
+    EXPECT_EQ(topology::as_cpu_list(_nodes.at(1).cpus), "4-7,12-15");
+
+    // nodes without any allowed cpus are omitted
+    _nodes = topology::get_numa_nodes(_root, topology::parse_cpu_list("4-5"));
+    ASSERT_EQ(_nodes.size(), 1);
+    EXPECT_EQ(_nodes.at(0).id, 1);
+    EXPECT_EQ(topology::as_cpu_list(_nodes.at(0).cpus), "4-5");
+
+    // no topology is a single node with all the allowed cpus
+    _nodes = topology::get_numa_nodes(_root + "/missing", { 0, 1 });
+    ASSERT_EQ(_nodes.size(), 1);
+    EXPECT_EQ(_nodes.at(0).id, 0);
+    EXPECT_EQ(_nodes.at(0).cpus.size(), 2);
+
+    details::remove_sysfs(_root);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(ert_numa_tests, placement)
+{
+    auto _root  = details::make_sysfs();
+    auto _nodes = topology::get_numa_nodes(_root, topology::parse_cpu_list("0-15"));
+    details::remove_sysfs(_root);
+
+    auto _place = topology::get_placement(5, _nodes);
+    ASSERT_EQ(_place.size(), 5);
+    std::cout << "placement: " << topology::as_string(_place) << std::endl;
+    EXPECT_EQ(topology::as_string(_place), "n0:0,n1:4,n0:1,n1:5,n0:2");
+
+    // threads are spread across the nodes and the leader of each node is rank zero
+    EXPECT_EQ(_place.at(0).size, 3);
+    EXPECT_EQ(_place.at(1).size, 2);
+    EXPECT_EQ(_place.at(1).rank, 0);
+    EXPECT_EQ(_place.at(3).rank, 1);
+    EXPECT_EQ(_place.at(4).index, 0);
+    EXPECT_EQ(_place.at(1).cpus, "4-7,12-15");
+
+    // fewer threads than nodes
+    _place = topology::get_placement(1, _nodes);
+    ASSERT_EQ(_place.size(), 1);
+    EXPECT_EQ(_place.at(0).size, 1);
+    EXPECT_EQ(_place.at(0).node, 0);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(ert_numa_tests, affinity)
+{
+    auto _allowed = topology::get_affinity();
+    ASSERT_FALSE(_allowed.empty());
+
+    // only the pinned thread is affected
+    std::thread{ [_allowed]() {
+        EXPECT_TRUE(topology::set_affinity(_allowed.back()));
+        EXPECT_EQ(topology::get_affinity(), topology::cpu_list_t{ _allowed.back() });
+    } }.join();
+    EXPECT_EQ(topology::get_affinity(), _allowed);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(ert_numa_tests, serialize)
+{
+    ert_data_t _data{};
+    _data += details::make_entry(64);
+    _data.add_numa(1, "4-7", details::make_entry(32));
+    _data.add_numa(0, "0-3", details::make_entry(32));
+    _data.add_numa(1, "4-7", details::make_entry(48));
+
+    ASSERT_EQ(_data.get_numa().size(), 2);
+    EXPECT_EQ(_data.get_numa().at(0).node, 1);
+    EXPECT_EQ(_data.get_numa().at(0).values.size(), 2);
+
+    std::stringstream _ss{};
+    {
+        cereal::JSONOutputArchive _oa{ _ss };
+        _oa(cereal::make_nvp("roofline", _data));
+    }
+
+    ert_data_t _loaded{};
+    {
+        cereal::JSONInputArchive _ia{ _ss };
+        _ia(cereal::make_nvp("roofline", _loaded));
+    }
+
+    ASSERT_EQ(_loaded.size(), 1);
+    ASSERT_EQ(_loaded.get_numa().size(), 2);
+    EXPECT_EQ(_loaded.get_numa().at(0).cpus, "4-7");
+    ASSERT_EQ(_loaded.get_numa().at(0).values.size(), 2);
+    EXPECT_EQ(std::get<1>(_loaded.get_numa().at(0).values.at(1)), 48);
+
+    // merging combines the entries of the same node
+    _loaded += _data;
+    EXPECT_EQ(_loaded.size(), 2);
+    EXPECT_EQ(_loaded.get_numa().size(), 2);
+    EXPECT_EQ(_loaded.get_numa().at(0).values.size(), 4);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(ert_numa_tests, execute)
+{
+    auto _numa_aware = settings::ert_numa_aware();
+    auto _nthreads   = settings::ert_num_threads();
+    auto _max_size   = settings::ert_max_data_size();
+    auto _min_size   = settings::ert_min_working_size();
+
+    settings::ert_numa_aware()       = true;
+    settings::ert_num_threads()      = 2;
+    settings::ert_max_data_size()    = 64 * 1024;
+    settings::ert_min_working_size() = 1024;
+
+    auto        _data = std::make_shared<ert_data_t>();
+    config_type _config{};
+    executor_type(_config, _data);
+
+    settings::ert_numa_aware()       = _numa_aware;
+    settings::ert_num_threads()      = _nthreads;
+    settings::ert_max_data_size()    = _max_size;
+    settings::ert_min_working_size() = _min_size;
+
+    auto _nodes = std::min<size_t>(topology::get_numa_nodes().size(), 2);
+    ASSERT_GT(_data->size(), 0);
+    ASSERT_EQ(_data->get_numa().size(), _nodes);
+
+    // every aggregate entry has an entry per node and the working sets of the nodes
+    // sum to the aggregate working set
+    std::vector<uint64_t> _working_set(_data->size(), 0);
+    for(const auto& itr : _data->get_numa())
+    {
+        ASSERT_EQ(itr.values.size(), _data->size());
+        for(size_t i = 0; i < itr.values.size(); ++i)
+            _working_set.at(i) += std::get<1>(itr.values.at(i));
+    }
+
+    size_t i = 0;
+    for(const auto& itr : *_data)
+        EXPECT_EQ(std::get<1>(itr), _working_set.at(i++)) << std::get<0>(itr);
+}
+
+//--------------------------------------------------------------------------------------//
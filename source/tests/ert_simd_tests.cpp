@@ -0,0 +1,184 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/ert/simd.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace simd = tim::ert::simd;
+using isa_t    = simd::isa;
+using kernel_t = simd::fma_kernel;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+// all the instruction sets which can be executed on this CPU
+inline std::vector<isa_t>
+get_isa_list()
+{
+    std::vector<isa_t> _list{};
+    for(auto itr : { isa_t::scalar, isa_t::sse2, isa_t::avx2, isa_t::avx512 })
+    {
+        if(itr <= simd::get_supported_isa())
+            _list.emplace_back(itr);
+    }
+    return _list;
+}
+
+// reference implementation which performs exactly Nrep FLOPs per element
+template <size_t Nrep, typename Tp>
+inline Tp
+reference(Tp _val, Tp _alpha)
+{
+    Tp _beta = (Nrep % 2 == 1) ? (_val + _alpha) : static_cast<Tp>(0.8);
+    for(size_t i = 0; i < Nrep / 2; ++i)
+        _beta = _beta * _val + _alpha;
+    return _beta;
+}
+
+// with A[i] == 1 every FMA adds alpha so any missing or extra operation changes
+// the result by exactly alpha, regardless of rounding differences between the
+// fused and unfused operations
+template <size_t Nrep, typename Tp>
+inline void
+check_flops(isa_t _isa, int32_t _nsize)
+{
+    std::vector<Tp> _data(_nsize, static_cast<Tp>(1.0));
+    kernel_t{ _isa }.execute<Nrep>(1, _nsize, _data.data());
+
+    auto _expected = reference<Nrep>(static_cast<Tp>(1.0), static_cast<Tp>(0.5));
+    for(int32_t i = 0; i < _nsize; ++i)
+    {
+        ASSERT_EQ(_data.at(i), _expected)
+            << "isa = " << simd::as_string(_isa) << ", Nrep = " << Nrep
+            << ", i = " << i << ", nsize = " << _nsize;
+    }
+}
+
+template <typename Tp>
+inline void
+check_flops(isa_t _isa)
+{
+    // sizes which exercise the vector loop and the remainder loop
+    for(int32_t _nsize : { 1, 7, 64, 1031 })
+    {
+        check_flops<1, Tp>(_isa, _nsize);
+        check_flops<2, Tp>(_isa, _nsize);
+        check_flops<3, Tp>(_isa, _nsize);
+        check_flops<8, Tp>(_isa, _nsize);
+        check_flops<16, Tp>(_isa, _nsize);
+        check_flops<33, Tp>(_isa, _nsize);
+        check_flops<64, Tp>(_isa, _nsize);
+    }
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class ert_simd_tests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        auto _name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        std::cout << "[" << _name << "]> supported instruction set: "
+                  << simd::as_string(simd::get_supported_isa()) << std::endl;
+    }
+};
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(ert_simd_tests, flops_per_element)
+{
+    EXPECT_EQ(kernel_t::flops_per_element<1>(), 1);
+    EXPECT_EQ(kernel_t::flops_per_element<2>(), 2);
+    EXPECT_EQ(kernel_t::flops_per_element<3>(), 3);
+    EXPECT_EQ(kernel_t::flops_per_element<16>(), 16);
+    EXPECT_EQ(kernel_t::flops_per_element<33>(), 33);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(ert_simd_tests, isa_selection)
+{
+    EXPECT_EQ(simd::get_isa("scalar"), isa_t::scalar);
+    EXPECT_EQ(simd::get_isa("none"), isa_t::scalar);
+    EXPECT_EQ(simd::get_isa("auto"), simd::get_supported_isa());
+    EXPECT_EQ(simd::get_isa("AVX512"), simd::get_isa("avx512"));
+    EXPECT_EQ(simd::get_isa("unknown"), simd::get_supported_isa());
+    // requests are never wider than what is supported
+    for(auto itr : { "sse2", "avx2", "avx512" })
+        EXPECT_LE(simd::get_isa(itr), simd::get_supported_isa()) << itr;
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(ert_simd_tests, flops_double)
+{
+    for(auto itr : details::get_isa_list())
+        details::check_flops<double>(itr);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(ert_simd_tests, flops_float)
+{
+    for(auto itr : details::get_isa_list())
+        details::check_flops<float>(itr);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(ert_simd_tests, consistency)
+{
+    constexpr int32_t nsize   = 1000;
+    constexpr int32_t ntrials = 1;
+
+    std::mt19937_64                        _rng{ 1 };
+    std::uniform_real_distribution<double> _dist{ 0.1, 0.9 };
+    std::vector<double>                    _init(nsize);
+    for(auto& itr : _init)
+        itr = _dist(_rng);
+
+    auto _scalar = _init;
+    kernel_t{ isa_t::scalar }.execute<16>(ntrials, nsize, _scalar.data());
+
+    for(auto itr : details::get_isa_list())
+    {
+        auto _data = _init;
+        kernel_t{ itr }.execute<16>(ntrials, nsize, _data.data());
+        for(int32_t i = 0; i < nsize; ++i)
+            ASSERT_NEAR(_data.at(i), _scalar.at(i), 1.0e-10 * std::abs(_scalar.at(i)))
+                << "isa = " << simd::as_string(itr) << ", i = " << i;
+    }
+}
+
+//--------------------------------------------------------------------------------------//
@@ -266,6 +266,56 @@ TEST_F(flat_tests, general)
 
 //--------------------------------------------------------------------------------------//
 
+TEST_F(flat_tests, overhead)
+{
+    using bundle_t = tim::component_bundle<TIMEMORY_API, wall_clock>;
+
+    constexpr int64_t nregion = 32;
+    constexpr int64_t ncalls  = 100000;
+
+    auto _run = [](const std::string& _label, tim::scope::config _scope) {
+        std::vector<size_t> _hashes{};
+        for(int64_t i = 0; i < nregion; ++i)
+            _hashes.emplace_back(
+                tim::add_hash_id(TIMEMORY_JOIN("/", details::get_test_name(), _label, i)));
+
+        auto _beg = std::chrono::steady_clock::now();
+        for(int64_t i = 0; i < ncalls; ++i)
+        {
+            bundle_t _bundle{ _hashes.at(i % nregion), true, _scope };
+            _bundle.start();
+            _bundle.stop();
+        }
+        auto _end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(_end - _beg).count() / ncalls;
+    };
+
+    // warm-up so both modes start with initialized storage
+    _run("warmup", tim::scope::config{ tim::scope::flat{} });
+
+    auto _tree = _run("tree", tim::scope::config{ tim::scope::tree{} });
+    auto _flat = _run("flat", tim::scope::config{ tim::scope::flat{} });
+
+    printf("\npush/pop per call :: tree = %8.1f ns, flat = %8.1f ns\n\n", _tree, _flat);
+
+    int64_t _laps    = 0;
+    int64_t _regions = 0;
+    auto    _key     = TIMEMORY_JOIN("/", details::get_test_name(), "flat", "");
+    for(const auto& itr : tim::storage<wall_clock>::instance()->get())
+    {
+        if(itr.prefix().find(_key) == std::string::npos)
+            continue;
+        ++_regions;
+        _laps += itr.data().get_laps();
+        EXPECT_EQ(itr.depth(), 0) << itr.prefix();
+    }
+
+    EXPECT_EQ(_regions, nregion);
+    EXPECT_EQ(_laps, ncalls);
+}
+
+//--------------------------------------------------------------------------------------//
+
 int
 main(int argc, char** argv)
 {
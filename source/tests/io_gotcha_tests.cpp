@@ -0,0 +1,350 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/components/gotcha/io_gotcha.hpp"
+#include "timemory/timemory.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+using namespace tim::component;
+using bundle_t = tim::component_tuple<wall_clock, io_gotcha>;
+using entry_t  = io_gotcha::entry;
+
+static int    _argc = 0;
+static char** _argv = nullptr;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+//  Get the current tests name
+inline std::string
+get_test_name()
+{
+    return ::testing::UnitTest::GetInstance()->current_test_info()->name();
+}
+
+// the accumulated I/O of the files ending with the given name, optionally restricted
+// to one region
+inline entry_t
+get_io(const std::string& _file, const std::string& _region = "")
+{
+    entry_t _total{};
+    for(auto& itr : io_gotcha::get_entries())
+    {
+        auto _path = io_gotcha::get_path(itr.path);
+        if(_path.length() < _file.length() ||
+           _path.substr(_path.length() - _file.length()) != _file)
+            continue;
+        if(!_region.empty() && io_gotcha::get_region(itr.region) != _region)
+            continue;
+        _total.path = itr.path;
+        for(size_t i = 0; i < _total.calls.size(); ++i)
+            _total.calls.at(i) += itr.calls.at(i);
+        _total.read_bytes += itr.read_bytes;
+        _total.write_bytes += itr.write_bytes;
+        _total.time += itr.time;
+        for(size_t i = 0; i < _total.latency.size(); ++i)
+            _total.latency.at(i) += itr.latency.at(i);
+        for(size_t i = 0; i < _total.size.size(); ++i)
+            _total.size.at(i) += itr.size.at(i);
+    }
+    return _total;
+}
+
+// the total number of calls in the given histogram
+template <typename Tp>
+inline uint64_t
+get_sum(const Tp& _hist)
+{
+    uint64_t _sum = 0;
+    for(auto& itr : _hist)
+        _sum += itr;
+    return _sum;
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class io_gotcha_tests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        if(!configured)
+        {
+            configured                   = true;
+            tim::settings::verbose()     = 0;
+            tim::settings::debug()       = false;
+            tim::settings::json_output() = false;
+            tim::settings::mpi_thread()  = false;
+            tim::settings::banner()      = false;
+            tim::dmp::initialize(_argc, _argv);
+            tim::timemory_init(_argc, _argv);
+        }
+    }
+
+public:
+    static bool configured;
+};
+
+bool io_gotcha_tests::configured = false;
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(io_gotcha_tests, write_and_read)
+{
+    const uint64_t nblocks = 256;
+    const uint64_t nbytes  = 4096;
+    const auto     _file   = details::get_test_name() + ".dat";
+
+    std::vector<char> _buffer(nbytes, 'a');
+
+    bundle_t _write{ details::get_test_name() + "/write" };
+    _write.start();
+    int _fd = open(_file.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    ASSERT_GE(_fd, 0);
+    for(uint64_t i = 0; i < nblocks; ++i)
+        EXPECT_EQ(write(_fd, _buffer.data(), nbytes), static_cast<ssize_t>(nbytes));
+    struct iovec _iov[2] = { { _buffer.data(), 100 }, { _buffer.data(), 28 } };
+    EXPECT_EQ(writev(_fd, _iov, 2), 128);
+    EXPECT_EQ(fsync(_fd), 0);
+    EXPECT_EQ(close(_fd), 0);
+    _write.stop();
+
+    bundle_t _read{ details::get_test_name() + "/read" };
+    _read.start();
+    _fd = open(_file.c_str(), O_RDONLY);
+    ASSERT_GE(_fd, 0);
+    uint64_t _nread = 0;
+    ssize_t  _n     = 0;
+    while((_n = read(_fd, _buffer.data(), nbytes)) > 0)
+        _nread += _n;
+    EXPECT_EQ(pread(_fd, _buffer.data(), 10, 5), 10);
+    EXPECT_EQ(close(_fd), 0);
+    _read.stop();
+
+    unlink(_file.c_str());
+
+    auto _writes = details::get_io(_file, details::get_test_name() + "/write");
+    auto _reads  = details::get_io(_file, details::get_test_name() + "/read");
+
+    std::stringstream ss;
+    io_gotcha::print_report(ss);
+    std::cout << ss.str() << std::endl;
+
+    EXPECT_EQ(_nread, nblocks * nbytes + 128);
+
+    EXPECT_EQ(_writes.calls.at(io_gotcha::open_kind), 1u);
+    EXPECT_EQ(_writes.calls.at(io_gotcha::write_kind), nblocks + 1);
+    EXPECT_EQ(_writes.calls.at(io_gotcha::sync_kind), 1u);
+    EXPECT_EQ(_writes.calls.at(io_gotcha::close_kind), 1u);
+    EXPECT_EQ(_writes.calls.at(io_gotcha::read_kind), 0u);
+    EXPECT_EQ(_writes.write_bytes, nblocks * nbytes + 128);
+    EXPECT_EQ(_writes.read_bytes, 0u);
+
+    // the final read returns zero bytes at the end of the file
+    EXPECT_EQ(_reads.calls.at(io_gotcha::open_kind), 1u);
+    EXPECT_EQ(_reads.calls.at(io_gotcha::read_kind), nblocks + 3);
+    EXPECT_EQ(_reads.calls.at(io_gotcha::close_kind), 1u);
+    EXPECT_EQ(_reads.calls.at(io_gotcha::write_kind), 0u);
+    EXPECT_EQ(_reads.read_bytes, nblocks * nbytes + 128 + 10);
+    EXPECT_EQ(_reads.write_bytes, 0u);
+
+    // every call has a latency and every read or write has a size
+    EXPECT_EQ(details::get_sum(_writes.latency), nblocks + 4);
+    EXPECT_EQ(details::get_sum(_writes.size), nblocks + 1);
+    EXPECT_EQ(details::get_sum(_reads.latency), nblocks + 5);
+    EXPECT_EQ(details::get_sum(_reads.size), nblocks + 3);
+
+    // 4096 bytes are in the [4 KiB, 8 KiB) bin
+    EXPECT_EQ(io_gotcha::get_bin(nbytes), 13u);
+    EXPECT_EQ(_writes.size.at(13), nblocks);
+    EXPECT_EQ(_reads.size.at(13), nblocks);
+
+    EXPECT_GT(_writes.time, 0u);
+    EXPECT_GT(_write.get<io_gotcha>()->get(), 0.0);
+    EXPECT_GT(_read.get<io_gotcha>()->get(), 0.0);
+
+    // the report lists the file and the regions which accessed it
+    EXPECT_NE(ss.str().find(_file), std::string::npos);
+    EXPECT_NE(ss.str().find(details::get_test_name() + "/write"), std::string::npos);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(io_gotcha_tests, threads)
+{
+    const uint64_t nthreads = 4;
+    const uint64_t nblocks  = 100;
+    const uint64_t nbytes   = 512;
+
+    std::vector<std::thread> _threads{};
+    for(uint64_t i = 0; i < nthreads; ++i)
+    {
+        _threads.emplace_back([=]() {
+            auto _file = details::get_test_name() + "_" + std::to_string(i) + ".dat";
+            std::vector<char> _buffer(nbytes, 'b');
+            bundle_t          _obj{ details::get_test_name() };
+            _obj.start();
+            int _fd = open(_file.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+            for(uint64_t j = 0; j < nblocks; ++j)
+                (void) pwrite(_fd, _buffer.data(), nbytes, j * nbytes);
+            close(_fd);
+            _obj.stop();
+            unlink(_file.c_str());
+        });
+    }
+
+    for(auto& itr : _threads)
+        itr.join();
+
+    for(uint64_t i = 0; i < nthreads; ++i)
+    {
+        auto _file = details::get_test_name() + "_" + std::to_string(i) + ".dat";
+        auto _io   = details::get_io(_file, details::get_test_name());
+        // calls which arrive during the bookkeeping of another thread are not recorded
+        EXPECT_GT(_io.calls.at(io_gotcha::write_kind), 0u) << _file;
+        EXPECT_LE(_io.calls.at(io_gotcha::write_kind), nblocks) << _file;
+        EXPECT_EQ(_io.write_bytes, _io.calls.at(io_gotcha::write_kind) * nbytes)
+            << _file;
+        EXPECT_EQ(_io.size.at(io_gotcha::get_bin(nbytes)),
+                  _io.calls.at(io_gotcha::write_kind))
+            << _file;
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(io_gotcha_tests, exited_threads)
+{
+    const uint64_t nthreads = 16;
+    const uint64_t nblocks  = 50;
+    const uint64_t nbytes   = 256;
+
+    auto _file = details::get_test_name() + ".dat";
+    int  _fd   = open(_file.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+
+    // the table of each thread is folded into the process-wide entries when the thread
+    // exits and the threads run one at a time so every call is recorded
+    for(uint64_t i = 0; i < nthreads; ++i)
+    {
+        std::thread{ [=]() {
+            std::vector<char> _buffer(nbytes, 'c');
+            bundle_t          _obj{ details::get_test_name() };
+            _obj.start();
+            for(uint64_t j = 0; j < nblocks; ++j)
+                (void) pwrite(_fd, _buffer.data(), nbytes, (i * nblocks + j) * nbytes);
+            _obj.stop();
+        } }.join();
+    }
+
+    close(_fd);
+    unlink(_file.c_str());
+
+    auto _io = details::get_io(_file, details::get_test_name());
+    EXPECT_EQ(_io.calls.at(io_gotcha::write_kind), nthreads * nblocks);
+    EXPECT_EQ(_io.write_bytes, nthreads * nblocks * nbytes);
+    EXPECT_EQ(details::get_sum(_io.latency), nthreads * nblocks);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(io_gotcha_tests, reused_descriptor)
+{
+    auto _file = details::get_test_name() + ".dat";
+    char _buffer[64];
+    memset(_buffer, 'd', sizeof(_buffer));
+
+    bundle_t _obj{ details::get_test_name() };
+    _obj.start();
+
+    int _fd = open(_file.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    ASSERT_GE(_fd, 0);
+    EXPECT_EQ(write(_fd, _buffer, sizeof(_buffer)), 64);
+
+    // fclose closes the descriptor within libc, i.e. without the close wrapper
+    FILE* _fp = fdopen(_fd, "w");
+    ASSERT_TRUE(_fp != nullptr);
+    EXPECT_EQ(fclose(_fp), 0);
+
+    // the lowest free descriptor is reused by the pipe
+    int _pipe[2] = { -1, -1 };
+    ASSERT_EQ(pipe(_pipe), 0);
+    ASSERT_TRUE(_pipe[0] == _fd || _pipe[1] == _fd);
+    EXPECT_EQ(write(_pipe[1], _buffer, 16), 16);
+    EXPECT_EQ(read(_pipe[0], _buffer, 16), 16);
+    close(_pipe[0]);
+    close(_pipe[1]);
+
+    _obj.stop();
+    unlink(_file.c_str());
+
+    // the pipe I/O is not attributed to the file
+    auto _io = details::get_io(_file, details::get_test_name());
+    EXPECT_EQ(_io.calls.at(io_gotcha::write_kind), 1u);
+    EXPECT_EQ(_io.write_bytes, 64u);
+    EXPECT_EQ(_io.calls.at(io_gotcha::read_kind), 0u);
+    EXPECT_EQ(_io.read_bytes, 0u);
+
+    // the file descriptor resolves to the pipe, e.g. "pipe:[12345]"
+    uint64_t _pipe_bytes = 0;
+    for(auto& itr : io_gotcha::get_entries())
+    {
+        if(io_gotcha::get_region(itr.region) != details::get_test_name())
+            continue;
+        if(io_gotcha::get_path(itr.path).find("pipe:") == 0)
+            _pipe_bytes += itr.read_bytes + itr.write_bytes;
+    }
+    EXPECT_EQ(_pipe_bytes, 32u);
+}
+
+//--------------------------------------------------------------------------------------//
+
+int
+main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    _argc = argc;
+    _argv = argv;
+    auto ret = RUN_ALL_TESTS();
+    tim::timemory_finalize();
+    return ret;
+}
+
+//--------------------------------------------------------------------------------------//
@@ -0,0 +1,273 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/storage/live_view.hpp"
+#include "timemory/timemory.hpp"
+#include "timemory/utility/live_view.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace tim::component;
+namespace live_view = tim::live_view;
+
+using bundle_t = tim::component_tuple<wall_clock, peak_rss>;
+
+static int    _argc = 0;
+static char** _argv = nullptr;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+//  Get the current tests name
+inline std::string
+get_test_name()
+{
+    return ::testing::UnitTest::GetInstance()->current_test_info()->name();
+}
+
+// the published entries of the live-view of this process
+inline std::vector<live_view::snapshot>
+read_all()
+{
+    std::vector<live_view::snapshot> _ret{};
+    live_view::segment               _seg{};
+    if(!_seg.attach(tim::process::get_id()))
+        return _ret;
+    for(uint32_t i = 0; i < _seg.size(); ++i)
+    {
+        live_view::snapshot _snap{};
+        if(live_view::read(*_seg.get_slot(i), _snap))
+            _ret.emplace_back(_snap);
+    }
+    return _ret;
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class live_view_tests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        if(!configured)
+        {
+            configured                   = true;
+            tim::settings::verbose()     = 0;
+            tim::settings::debug()       = false;
+            tim::settings::json_output() = false;
+            tim::settings::mpi_thread()  = false;
+            tim::settings::banner()      = false;
+            // must be set before the first measurement
+            tim::settings::live_view()            = true;
+            tim::settings::live_view_components() = "wall_clock";
+            tim::dmp::initialize(_argc, _argv);
+            tim::timemory_init(_argc, _argv);
+        }
+    }
+
+public:
+    static bool configured;
+};
+
+bool live_view_tests::configured = false;
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(live_view_tests, seqlock)
+{
+    // a separate segment so this does not interfere with the segment of the process
+    int32_t            _id = tim::process::get_id() + 1000000;
+    live_view::segment _writer{};
+    ASSERT_TRUE(_writer.create(_id, 4));
+
+    auto* _slot = _writer.claim("wall", "seqlock", 1, 0, 0);
+    ASSERT_TRUE(_slot != nullptr);
+    EXPECT_TRUE(_writer.claim("wall", "a", 2, 0, 0) != nullptr);
+    EXPECT_TRUE(_writer.claim("wall", "b", 3, 0, 0) != nullptr);
+    EXPECT_TRUE(_writer.claim("wall", "c", 4, 0, 0) != nullptr);
+    // full
+    EXPECT_TRUE(_writer.claim("wall", "d", 5, 0, 0) == nullptr);
+
+    // only the user running the process can read the segment
+    struct stat _stat {};
+    int         _fd = shm_open(live_view::get_name(_id).c_str(), O_RDONLY, 0);
+    ASSERT_GE(_fd, 0);
+    ASSERT_EQ(fstat(_fd, &_stat), 0);
+    close(_fd);
+    EXPECT_EQ(_stat.st_mode & 0777, 0600u);
+
+    live_view::segment _reader{};
+    ASSERT_TRUE(_reader.attach(_id));
+    EXPECT_FALSE(_reader.is_owner());
+    EXPECT_EQ(_reader.size(), 4);
+
+    live_view::snapshot _snap{};
+    // never published
+    EXPECT_FALSE(live_view::read(*_reader.get_slot(0), _snap));
+
+    live_view::publish(*_slot, 0, 0.0, 0.0);
+    ASSERT_TRUE(live_view::read(*_reader.get_slot(0), _snap));
+    EXPECT_EQ(_snap.name, "seqlock");
+    EXPECT_EQ(_snap.component, "wall");
+
+    // a reader never observes a partially written update
+    std::atomic<bool> _done{ false };
+    std::thread       _thread{ [&]() {
+        for(int64_t i = 1; i <= 1000000; ++i)
+            live_view::publish(*_slot, i, 2.0 * i, 3.0 * i);
+        _done.store(true);
+    } };
+
+    int64_t _reads = 0;
+    int64_t _torn  = 0;
+    while(!_done.load())
+    {
+        if(!live_view::read(*_reader.get_slot(0), _snap))
+            continue;
+        ++_reads;
+        if(_snap.accum != 2.0 * _snap.laps || _snap.last != 3.0 * _snap.laps)
+            ++_torn;
+    }
+    _thread.join();
+
+    EXPECT_EQ(_torn, 0) << " of " << _reads << " reads";
+    ASSERT_TRUE(live_view::read(*_reader.get_slot(0), _snap));
+    EXPECT_EQ(_snap.laps, 1000000);
+
+    // the writer removes the segment
+    _writer.close();
+    live_view::segment _missing{};
+    EXPECT_FALSE(_missing.attach(_id));
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(live_view_tests, storage)
+{
+    auto _name = details::get_test_name();
+    for(int i = 0; i < 10; ++i)
+    {
+        bundle_t _outer{ _name };
+        _outer.start();
+        for(int j = 0; j < 3; ++j)
+        {
+            bundle_t _inner{ _name + "/inner" };
+            _inner.start();
+            _inner.stop();
+        }
+        _outer.stop();
+    }
+
+    EXPECT_TRUE(live_view::is_enabled<wall_clock>());
+    EXPECT_FALSE(live_view::is_enabled<peak_rss>());
+
+    auto _data = details::read_all();
+    ASSERT_FALSE(_data.empty());
+
+    int64_t _outer = 0;
+    int64_t _inner = 0;
+    for(const auto& itr : _data)
+    {
+        // only the selected component is published
+        EXPECT_EQ(itr.component, wall_clock::get_label());
+        if(itr.name == _name)
+        {
+            _outer += itr.laps;
+            EXPECT_EQ(itr.depth, 0);
+            EXPECT_GT(itr.accum, 0.0);
+            EXPECT_GE(itr.accum, itr.last);
+        }
+        else if(itr.name == _name + "/inner")
+        {
+            _inner += itr.laps;
+            EXPECT_EQ(itr.depth, 1);
+        }
+    }
+
+    EXPECT_EQ(_outer, 10);
+    EXPECT_EQ(_inner, 30);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(live_view_tests, threads)
+{
+    auto _name = details::get_test_name();
+    auto _func = [&_name]() {
+        for(int i = 0; i < 5; ++i)
+        {
+            bundle_t _obj{ _name };
+            _obj.start();
+            _obj.stop();
+        }
+    };
+
+    std::vector<std::thread> _threads{};
+    for(int i = 0; i < 4; ++i)
+        _threads.emplace_back(_func);
+    for(auto& itr : _threads)
+        itr.join();
+
+    // one entry per thread, each with a single writer
+    int64_t _laps    = 0;
+    size_t  _entries = 0;
+    for(const auto& itr : details::read_all())
+    {
+        if(itr.name != _name)
+            continue;
+        _laps += itr.laps;
+        ++_entries;
+    }
+
+    EXPECT_EQ(_laps, 20);
+    EXPECT_EQ(_entries, 4);
+}
+
+//--------------------------------------------------------------------------------------//
+
+int
+main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    _argc = argc;
+    _argv = argv;
+    return RUN_ALL_TESTS();
+}
+
+//--------------------------------------------------------------------------------------//
@@ -0,0 +1,336 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/components/gotcha/lock_gotcha.hpp"
+#include "timemory/timemory.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <semaphore.h>
+
+using namespace tim::component;
+using bundle_t   = tim::component_tuple<wall_clock, lock_gotcha>;
+using entry_t    = lock_gotcha::entry;
+using clock_type = std::chrono::steady_clock;
+
+static int             _argc = 0;
+static char**          _argv = nullptr;
+static volatile double _sink = 0.0;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+//  Get the current tests name
+inline std::string
+get_test_name()
+{
+    return ::testing::UnitTest::GetInstance()->current_test_info()->name();
+}
+
+// busy-waits for the given number of microseconds
+inline void
+busy_wait(int64_t _usec)
+{
+    auto _end = clock_type::now() + std::chrono::microseconds{ _usec };
+    while(clock_type::now() < _end)
+        _sink = _sink + 1.0;
+}
+
+// the accumulated waits of the given lock, optionally restricted to one region
+inline entry_t
+get_waits(const void* _addr, const std::string& _region = "")
+{
+    entry_t _total{};
+    for(auto& itr : lock_gotcha::get_entries())
+    {
+        if(itr.address != _addr)
+            continue;
+        if(!_region.empty() && lock_gotcha::get_region(itr.region) != _region)
+            continue;
+        _total.address = itr.address;
+        _total.kind    = itr.kind;
+        _total.count += itr.count;
+        _total.contended += itr.contended;
+        _total.wait += itr.wait;
+    }
+    return _total;
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class lock_gotcha_tests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        if(!configured)
+        {
+            configured                   = true;
+            tim::settings::verbose()     = 0;
+            tim::settings::debug()       = false;
+            tim::settings::json_output() = false;
+            tim::settings::mpi_thread()  = false;
+            tim::settings::banner()      = false;
+            tim::dmp::initialize(_argc, _argv);
+            tim::timemory_init(_argc, _argv);
+        }
+    }
+
+public:
+    static bool configured;
+};
+
+bool lock_gotcha_tests::configured = false;
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(lock_gotcha_tests, contended_mutex)
+{
+    const uint64_t nthreads = 4;
+    const uint64_t nitr     = 500;
+
+    std::mutex               _shared{};
+    std::vector<std::mutex>  _private(nthreads);
+    std::vector<double>      _blocked(nthreads, 0.0);
+    std::vector<std::thread> _threads{};
+
+    for(uint64_t i = 0; i < nthreads; ++i)
+    {
+        _threads.emplace_back([&, i]() {
+            bundle_t _contended{ details::get_test_name() + "/contended" };
+            _contended.start();
+            for(uint64_t j = 0; j < nitr; ++j)
+            {
+                std::lock_guard<std::mutex> _lk{ _shared };
+                details::busy_wait(20);
+            }
+            _contended.stop();
+
+            bundle_t _uncontended{ details::get_test_name() + "/uncontended" };
+            _uncontended.start();
+            for(uint64_t j = 0; j < nitr; ++j)
+            {
+                std::lock_guard<std::mutex> _lk{ _private.at(i) };
+                _sink = _sink + 1.0;
+            }
+            _uncontended.stop();
+
+            _blocked.at(i) = _contended.get<lock_gotcha>()->get();
+        });
+    }
+
+    for(auto& itr : _threads)
+        itr.join();
+
+    auto _shared_waits = details::get_waits(
+        _shared.native_handle(), details::get_test_name() + "/contended");
+
+    std::stringstream ss;
+    lock_gotcha::print_report(ss);
+    std::cout << ss.str() << std::endl;
+
+    // calls which arrive during the bookkeeping of another thread are not recorded
+    EXPECT_GT(_shared_waits.count, 0u);
+    EXPECT_LE(_shared_waits.count, nthreads * nitr);
+    EXPECT_GT(_shared_waits.contended, 0u);
+    EXPECT_GT(_shared_waits.wait, 0u);
+    EXPECT_EQ(_shared_waits.kind, lock_gotcha::mutex_kind);
+
+    double _total_blocked = 0.0;
+    for(auto& itr : _blocked)
+        _total_blocked += itr;
+    EXPECT_GT(_total_blocked, 0.0);
+
+    // nothing else waits on the private mutexes
+    for(auto& itr : _private)
+    {
+        auto _private_waits = details::get_waits(
+            itr.native_handle(), details::get_test_name() + "/uncontended");
+        EXPECT_GT(_private_waits.count, 0u);
+        EXPECT_LE(_private_waits.contended, _private_waits.count / 20);
+        EXPECT_LT(_private_waits.wait, _shared_waits.wait);
+    }
+
+    // the report lists the regions which waited on the locks
+    EXPECT_NE(ss.str().find(details::get_test_name() + "/contended"), std::string::npos);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(lock_gotcha_tests, condition_variable)
+{
+    std::mutex              _mutex{};
+    std::condition_variable _cv{};
+    bool                    _ready = false;
+
+    bundle_t _obj{ details::get_test_name() };
+    _obj.start();
+
+    std::thread _producer{ [&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 50 });
+        {
+            std::lock_guard<std::mutex> _lk{ _mutex };
+            _ready = true;
+        }
+        _cv.notify_one();
+    } };
+
+    {
+        std::unique_lock<std::mutex> _lk{ _mutex };
+        _cv.wait(_lk, [&_ready]() { return _ready; });
+    }
+
+    _producer.join();
+    _obj.stop();
+
+    auto _waits = details::get_waits(_cv.native_handle(), details::get_test_name());
+    EXPECT_GT(_waits.count, 0u);
+    EXPECT_EQ(_waits.kind, lock_gotcha::condition_kind);
+    // the wait includes most of the sleep of the producer
+    EXPECT_GT(_waits.wait, 25000000u);
+    EXPECT_GT(_obj.get<lock_gotcha>()->get(), 0.0);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(lock_gotcha_tests, rwlock_and_semaphore)
+{
+    pthread_rwlock_t _rwlock;
+    sem_t            _sem;
+    pthread_rwlock_init(&_rwlock, nullptr);
+    sem_init(&_sem, 0, 0);
+
+    bundle_t _obj{ details::get_test_name() };
+    _obj.start();
+
+    std::atomic<bool> _locked{ false };
+    std::thread       _writer{ [&]() {
+        pthread_rwlock_wrlock(&_rwlock);
+        _locked.store(true);
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+        pthread_rwlock_unlock(&_rwlock);
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+        sem_post(&_sem);
+    } };
+
+    while(!_locked.load())
+        std::this_thread::yield();
+
+    // blocks until the writer releases the lock
+    std::thread _reader{ [&]() {
+        bundle_t _robj{ details::get_test_name() + "/reader" };
+        _robj.start();
+        pthread_rwlock_rdlock(&_rwlock);
+        pthread_rwlock_unlock(&_rwlock);
+        _robj.stop();
+    } };
+
+    sem_wait(&_sem);
+    _writer.join();
+    _reader.join();
+    _obj.stop();
+
+    auto _rwlock_waits =
+        details::get_waits(&_rwlock, details::get_test_name() + "/reader");
+    auto _sem_waits = details::get_waits(&_sem, details::get_test_name());
+
+    EXPECT_EQ(_rwlock_waits.kind, lock_gotcha::rwlock_kind);
+    EXPECT_EQ(_rwlock_waits.count, 1u);
+    EXPECT_EQ(_rwlock_waits.contended, 1u);
+    EXPECT_EQ(_sem_waits.kind, lock_gotcha::semaphore_kind);
+    EXPECT_EQ(_sem_waits.count, 1u);
+    EXPECT_EQ(_sem_waits.contended, 1u);
+    EXPECT_GT(_sem_waits.wait, 20000000u);
+
+    sem_destroy(&_sem);
+    pthread_rwlock_destroy(&_rwlock);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(lock_gotcha_tests, exited_threads)
+{
+    const uint64_t nthreads = 32;
+    const uint64_t nitr     = 100;
+
+    std::mutex _mutex{};
+
+    // the table of each thread is folded into the process-wide entries when the thread
+    // exits and the threads run one at a time so every call is recorded
+    for(uint64_t i = 0; i < nthreads; ++i)
+    {
+        std::thread{ [&]() {
+            bundle_t _obj{ details::get_test_name() };
+            _obj.start();
+            for(uint64_t j = 0; j < nitr; ++j)
+            {
+                std::lock_guard<std::mutex> _lk{ _mutex };
+                _sink = _sink + 1.0;
+            }
+            _obj.stop();
+        } }.join();
+    }
+
+    size_t _n = 0;
+    for(auto& itr : lock_gotcha::get_entries())
+    {
+        if(itr.address == _mutex.native_handle())
+            ++_n;
+    }
+
+    auto _waits = details::get_waits(_mutex.native_handle(), details::get_test_name());
+    EXPECT_EQ(_n, 1u);
+    EXPECT_EQ(_waits.count, nthreads * nitr);
+    EXPECT_EQ(_waits.kind, lock_gotcha::mutex_kind);
+}
+
+//--------------------------------------------------------------------------------------//
+
+int
+main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    _argc = argc;
+    _argv = argv;
+    auto ret = RUN_ALL_TESTS();
+    tim::timemory_finalize();
+    return ret;
+}
+
+//--------------------------------------------------------------------------------------//
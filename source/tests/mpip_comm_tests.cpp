@@ -0,0 +1,174 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "test_macros.hpp"
+
+TIMEMORY_TEST_DEFAULT_MAIN
+
+#include "timemory/timemory.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+//  Get the current tests name
+inline std::string
+get_test_name()
+{
+    return ::testing::UnitTest::GetInstance()->current_test_info()->name();
+}
+
+// reads the "nrow" rows following the line which starts with "label"
+inline std::vector<std::vector<uint64_t>>
+read_matrix(const std::string& _fname, const std::string& _label, int nrow)
+{
+    std::vector<std::vector<uint64_t>> _data{};
+    std::ifstream                      _ifs{ _fname };
+    std::string                        _line{};
+    while(std::getline(_ifs, _line))
+    {
+        if(_line.find(_label) != 0)
+            continue;
+        for(int i = 0; i < nrow && std::getline(_ifs, _line); ++i)
+        {
+            std::stringstream     _ss{ _line };
+            std::vector<uint64_t> _row{};
+            uint64_t              _val = 0;
+            while(_ss >> _val)
+                _row.emplace_back(_val);
+            _data.emplace_back(std::move(_row));
+        }
+        break;
+    }
+    return _data;
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+extern "C"
+{
+    extern void timemory_mpip_library_ctor();
+    extern void timemory_register_mpip();
+    extern void timemory_deregister_mpip();
+    extern void timemory_mpip_write_comm_matrix();
+}
+
+//--------------------------------------------------------------------------------------//
+
+class mpip_comm_tests : public ::testing::Test
+{
+protected:
+    TIMEMORY_TEST_DEFAULT_SUITE_BODY
+};
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(mpip_comm_tests, ring)
+{
+    int rank = tim::mpi::rank();
+    int size = tim::mpi::size();
+
+    timemory_mpip_library_ctor();
+    timemory_register_mpip();
+
+    // rank "i" sends (i + 1) KB to rank "i + 1"
+    int              _dst = (rank + 1) % size;
+    int              _src = (rank + size - 1) % size;
+    std::vector<int> _send((rank + 1) * 256, rank);
+    std::vector<int> _recv((_src + 1) * 256, -1);
+    MPI_Request      _req{};
+    MPI_Isend(_send.data(), _send.size(), MPI_INT, _dst, 0, MPI_COMM_WORLD, &_req);
+    MPI_Recv(_recv.data(), _recv.size(), MPI_INT, _src, 0, MPI_COMM_WORLD,
+             MPI_STATUS_IGNORE);
+    MPI_Wait(&_req, MPI_STATUS_IGNORE);
+
+    // rank 0 sends 256 bytes to every other rank
+    std::vector<int> _bcast(64, rank);
+    MPI_Bcast(_bcast.data(), _bcast.size(), MPI_INT, 0, MPI_COMM_WORLD);
+
+    timemory_deregister_mpip();
+    timemory_mpip_write_comm_matrix();
+    tim::mpi::barrier();
+
+    EXPECT_EQ(_recv.front(), _src);
+    EXPECT_EQ(_bcast.back(), 0);
+
+    if(rank != 0)
+        return;
+
+    auto _fname = tim::settings::compose_output_filename("mpi_comm_matrix", ".txt");
+    auto _bytes = details::read_matrix(_fname, "# bytes sent", size);
+    auto _msgs  = details::read_matrix(_fname, "# messages sent", size);
+
+    auto _nranks = static_cast<size_t>(size);
+    ASSERT_EQ(_bytes.size(), _nranks);
+    ASSERT_EQ(_msgs.size(), _nranks);
+    for(int i = 0; i < size; ++i)
+    {
+        ASSERT_EQ(_bytes.at(i).size(), _nranks);
+        ASSERT_EQ(_msgs.at(i).size(), _nranks);
+        for(int j = 0; j < size; ++j)
+        {
+            uint64_t _nbytes = 0;
+            uint64_t _nmsgs  = 0;
+            if(j == (i + 1) % size && j != i)
+            {
+                _nbytes += (i + 1) * 256 * sizeof(int);
+                _nmsgs += 1;
+            }
+            if(i == 0 && j != 0)
+            {
+                _nbytes += 64 * sizeof(int);
+                _nmsgs += 1;
+            }
+            EXPECT_EQ(_bytes.at(i).at(j), _nbytes) << "src = " << i << ", dst = " << j;
+            EXPECT_EQ(_msgs.at(i).at(j), _nmsgs) << "src = " << i << ", dst = " << j;
+        }
+    }
+
+    std::ifstream _ifs{ _fname };
+    std::string   _line{};
+    bool          _found = false;
+    while(std::getline(_ifs, _line))
+    {
+        if(_line.find("MPI_Bcast ") == 0)
+        {
+            // every rank calls MPI_Bcast once with 256 bytes
+            std::stringstream _expected{};
+            _expected << "MPI_Bcast " << size << " " << size * 256 << " 256:" << size;
+            EXPECT_EQ(_line, _expected.str());
+            _found = true;
+        }
+    }
+    EXPECT_TRUE(_found);
+}
+
+//--------------------------------------------------------------------------------------//
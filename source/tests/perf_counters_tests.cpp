@@ -0,0 +1,270 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/timemory.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tim::component;
+
+#define CHECK_AVAILABLE(type)                                                            \
+    if(!tim::trait::is_available<type>::value)                                           \
+        return;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+inline std::string
+get_test_name()
+{
+    return ::testing::UnitTest::GetInstance()->current_test_info()->name();
+}
+
+// software events do not require a PMU or elevated privileges
+static const std::string software_events =
+    "task-clock,page-faults,context-switches,cpu-migrations";
+
+// burns cpu time and touches new pages
+inline int64_t
+consume(size_t _nbytes)
+{
+    std::vector<char> _data(_nbytes, 1);
+    int64_t           _sum = 0;
+    for(size_t i = 0; i < _nbytes; i += 64)
+        _sum += _data[i];
+    volatile int64_t _ret = _sum;
+    for(int64_t i = 0; i < 10000000; ++i)
+        _ret = _ret + (i % 3);
+    return _ret;
+}
+
+inline size_t
+index_of(const std::vector<std::string>& _names, const std::string& _name)
+{
+    for(size_t i = 0; i < _names.size(); ++i)
+    {
+        if(_names.at(i) == _name)
+            return i;
+    }
+    return _names.size();
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class perf_counters_tests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        tim::settings::perf_events() = details::software_events;
+        perf_counters::configure();
+    }
+};
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(perf_counters_tests, parse)
+{
+    CHECK_AVAILABLE(perf_counters);
+
+    auto _info = tim::perf::get_event_info("faults");
+    EXPECT_TRUE(_info.valid);
+    EXPECT_EQ(_info.name, "faults");
+    EXPECT_EQ(_info.type, PERF_TYPE_SOFTWARE);
+    EXPECT_EQ(_info.config, PERF_COUNT_SW_PAGE_FAULTS);
+
+    _info = tim::perf::get_event_info("task-clock");
+    EXPECT_EQ(_info.units, "nsec");
+
+    _info = tim::perf::get_event_info("instructions:u");
+    EXPECT_TRUE(_info.valid);
+    EXPECT_TRUE(_info.exclude_kern);
+    EXPECT_FALSE(_info.exclude_user);
+
+    _info = tim::perf::get_event_info("LLC-load-misses");
+    EXPECT_TRUE(_info.valid);
+    EXPECT_EQ(_info.type, PERF_TYPE_HW_CACHE);
+
+    _info = tim::perf::get_event_info("r01c2");
+    EXPECT_TRUE(_info.valid);
+    EXPECT_EQ(_info.type, PERF_TYPE_RAW);
+    EXPECT_EQ(_info.config, 0x1c2);
+
+    EXPECT_FALSE(tim::perf::get_event_info("not-an-event").valid);
+    EXPECT_FALSE(tim::perf::get_event_info("cycles:x").valid);
+
+    auto _list = tim::perf::get_event_info("cs, migrations;cs,bogus", nullptr);
+    ASSERT_EQ(_list.size(), 2);
+    EXPECT_EQ(_list.at(0).name, "cs");
+    EXPECT_EQ(_list.at(1).name, "migrations");
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(perf_counters_tests, group)
+{
+    CHECK_AVAILABLE(perf_counters);
+
+    tim::perf::event_group _group{};
+    ASSERT_TRUE(
+        _group.open(tim::perf::get_event_info(details::software_events, &std::cerr)));
+    EXPECT_TRUE(_group.is_grouped());
+    EXPECT_EQ(_group.size(), 4);
+    EXPECT_EQ(_group.num_open(), 4);
+
+    auto _beg = _group.read();
+    details::consume(8 * tim::units::MiB);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    auto _end = _group.read();
+
+    ASSERT_EQ(_beg.size(), 4);
+    ASSERT_EQ(_end.size(), 4);
+    EXPECT_GT(_end.at(0) - _beg.at(0), 0) << "task-clock";
+    EXPECT_GT(_end.at(1) - _beg.at(1), 0) << "page-faults";
+    EXPECT_GE(_end.at(2) - _beg.at(2), 1) << "context-switches";
+    EXPECT_GE(_end.at(3) - _beg.at(3), 0) << "cpu-migrations";
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(perf_counters_tests, inherit)
+{
+    CHECK_AVAILABLE(perf_counters);
+
+    tim::perf::event_group _group{};
+    ASSERT_TRUE(_group.open(tim::perf::get_event_info("task-clock", nullptr), true));
+    EXPECT_FALSE(_group.is_grouped());
+    EXPECT_FALSE(_group.uses_rdpmc());
+
+    auto        _beg = _group.read();
+    std::thread _thr{ []() { details::consume(tim::units::MiB); } };
+    _thr.join();
+    auto _end = _group.read();
+
+    // the child thread consumed at least a few milliseconds of cpu time
+    EXPECT_GT(_end.at(0) - _beg.at(0), 1000000);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(perf_counters_tests, unavailable_event)
+{
+    CHECK_AVAILABLE(perf_counters);
+
+    // an event which cannot be opened reads as zero and does not disable the others
+    std::vector<tim::perf::event_info> _info{ tim::perf::get_event_info("task-clock"),
+                                              tim::perf::get_event_info("r0") };
+    // no PMU is registered with this type
+    _info.back().type = 0xfffffff0;
+
+    tim::perf::event_group _group{};
+    ASSERT_TRUE(_group.open(_info, false, true, nullptr));
+    EXPECT_EQ(_group.num_open(), 1);
+
+    details::consume(tim::units::MiB);
+    auto _values = _group.read();
+    ASSERT_EQ(_values.size(), 2);
+    EXPECT_GT(_values.at(0), 0);
+    EXPECT_EQ(_values.at(1), 0);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(perf_counters_tests, component)
+{
+    CHECK_AVAILABLE(perf_counters);
+
+    perf_counters _obj{};
+    ASSERT_EQ(_obj.size(), 4);
+
+    for(int i = 0; i < 3; ++i)
+    {
+        _obj.start();
+        details::consume(4 * tim::units::MiB);
+        _obj.stop();
+    }
+
+    auto _names  = _obj.get_event_names();
+    auto _values = _obj.get<int64_t>();
+    ASSERT_EQ(_values.size(), 4);
+    EXPECT_GT(_values.at(details::index_of(_names, "task-clock")), 0);
+    EXPECT_GT(_values.at(details::index_of(_names, "page-faults")), 0);
+
+    auto _labels = _obj.label_array();
+    ASSERT_EQ(_labels.size(), 4);
+    EXPECT_EQ(_labels.at(0), "task_clock");
+    EXPECT_EQ(_obj.display_unit_array().at(0), "nsec");
+
+    auto _disp = _obj.get_display();
+    std::cout << "[" << tim::demangle<perf_counters>() << "]> " << _disp << std::endl;
+    EXPECT_NE(_disp.find("page-faults"), std::string::npos);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(perf_counters_tests, bundle)
+{
+    CHECK_AVAILABLE(perf_counters);
+
+    using bundle_t = tim::component_tuple<wall_clock, perf_counters>;
+
+    bundle_t _outer{ details::get_test_name() };
+    _outer.start();
+    for(int i = 0; i < 4; ++i)
+    {
+        bundle_t _inner{ details::get_test_name() + "/inner" };
+        _inner.start();
+        details::consume(tim::units::MiB);
+        _inner.stop();
+    }
+    _outer.stop();
+
+    auto* _outer_perf = _outer.get<perf_counters>();
+    ASSERT_TRUE(_outer_perf != nullptr);
+    auto _values = _outer_perf->get<int64_t>();
+    ASSERT_EQ(_values.size(), 4);
+    EXPECT_GT(_values.at(0), 0);
+
+    auto _storage = tim::storage<perf_counters>::instance()->get();
+    ASSERT_GE(_storage.size(), 2);
+    int64_t _inner_laps = 0;
+    for(const auto& itr : _storage)
+    {
+        if(itr.prefix().find("/inner") != std::string::npos)
+            _inner_laps += itr.data().get_laps();
+    }
+    EXPECT_EQ(_inner_laps, 4);
+}
+
+//--------------------------------------------------------------------------------------//
@@ -0,0 +1,307 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/timemory.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int    _argc = 0;
+static char** _argv = nullptr;
+
+//--------------------------------------------------------------------------------------//
+// a wall-clock which records the quantiles of the measurements
+//
+namespace tim
+{
+namespace component
+{
+struct quantile_clock : public base<quantile_clock, int64_t>
+{
+    using ratio_t    = std::nano;
+    using value_type = int64_t;
+    using this_type  = quantile_clock;
+    using base_type  = base<this_type, value_type>;
+    using string_t   = std::string;
+
+    static const short                   precision    = wall_clock::precision;
+    static const short                   width        = wall_clock::width;
+    static const std::ios_base::fmtflags format_flags = wall_clock::format_flags;
+
+    static int64_t    unit() { return wall_clock::unit(); }
+    static string_t   label() { return "quantile_clock"; }
+    static string_t   description() { return "wall time with quantiles"; }
+    static string_t   display_unit() { return wall_clock::display_unit(); }
+    static value_type record() { return wall_clock::record(); }
+
+    double get_display() const
+    {
+        auto val = (is_transient) ? accum : value;
+        return static_cast<double>(val / static_cast<double>(ratio_t::den) *
+                                   wall_clock::get_unit());
+    }
+
+    double get() const { return get_display(); }
+
+    void start() { value = record(); }
+
+    void stop()
+    {
+        auto tmp = record();
+        accum += (tmp - value);
+        value = tmp;
+    }
+};
+}  // namespace component
+}  // namespace tim
+
+TIMEMORY_STATISTICS_QUANTILES(component::quantile_clock, double)
+
+namespace tim
+{
+namespace trait
+{
+template <>
+struct record_statistics<component::quantile_clock> : std::true_type
+{};
+template <>
+struct is_timing_category<component::quantile_clock> : std::true_type
+{};
+template <>
+struct uses_timing_units<component::quantile_clock> : std::true_type
+{};
+}  // namespace trait
+}  // namespace tim
+
+using namespace tim::component;
+using bundle_t     = tim::component_tuple<quantile_clock>;
+using storage_t    = tim::storage<quantile_clock>;
+using get_t        = tim::operation::finalize::get<quantile_clock, true>;
+using basic_tree_t = typename get_t::basic_tree_type;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+//  Get the current tests name
+inline std::string
+get_test_name()
+{
+    return ::testing::UnitTest::GetInstance()->current_test_info()->name();
+}
+
+// a parent region with a child region where one in ten of the children is much
+// longer than the others so the tail of the distribution differs from the median
+void
+generate(int64_t nloop)
+{
+    for(int64_t i = 0; i < nloop; ++i)
+    {
+        bundle_t _parent{ "parent" };
+        _parent.start();
+        {
+            bundle_t _child{ "child" };
+            _child.start();
+            auto _usec = (i % 10 == 9) ? 2000 : 100;
+            std::this_thread::sleep_for(std::chrono::microseconds(_usec));
+            _child.stop();
+        }
+        _parent.stop();
+    }
+}
+
+// checks the inclusive and exclusive statistics of every node with children
+void
+check_tree(const basic_tree_t& _node, size_t& _nparents)
+{
+    const auto& _value = _node.get_value();
+    if(!_node.get_children().empty() && _value.inclusive().stats().get_count() > 0)
+    {
+        ++_nparents;
+        EXPECT_TRUE(_value.inclusive().stats().has_quantiles());
+        EXPECT_FALSE(_value.exclusive().stats().has_quantiles());
+        EXPECT_EQ(_value.exclusive().stats().get_quantile(0.99), 0.0);
+    }
+    for(const auto& itr : _node.get_children())
+        check_tree(itr, _nparents);
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class quantile_storage_tests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        static bool configured = false;
+        if(!configured)
+        {
+            configured                         = true;
+            tim::settings::verbose()           = 0;
+            tim::settings::debug()             = false;
+            tim::settings::mpi_thread()        = false;
+            tim::settings::cout_output()       = false;
+            tim::settings::text_output()       = true;
+            tim::settings::json_output()       = false;
+            tim::settings::flamegraph_output() = false;
+            tim::dmp::initialize(_argc, _argv);
+            tim::timemory_init(_argc, _argv);
+            tim::settings::banner() = false;
+
+            // the storage of the worker threads is merged into the main thread
+            details::generate(nloop);
+            std::vector<std::thread> _threads{};
+            for(int64_t i = 0; i < nthreads; ++i)
+                _threads.emplace_back(&details::generate, nloop);
+            for(auto& itr : _threads)
+                itr.join();
+        }
+    }
+
+public:
+    static constexpr int64_t nloop    = 50;
+    static constexpr int64_t nthreads = 2;
+};
+
+constexpr int64_t quantile_storage_tests::nloop;
+constexpr int64_t quantile_storage_tests::nthreads;
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(quantile_storage_tests, storage)
+{
+    auto _data = storage_t::instance()->get();
+
+    int64_t _nparent = 0;
+    int64_t _nchild  = 0;
+    for(const auto& itr : _data)
+    {
+        const auto& _stats = itr.stats();
+        bool        _child = (itr.prefix().find("child") != std::string::npos);
+        (_child) ? (_nchild += _stats.get_count()) : (_nparent += _stats.get_count());
+        EXPECT_EQ(_stats.get_count(), itr.data().get_laps()) << itr.prefix();
+        EXPECT_TRUE(_stats.has_quantiles()) << itr.prefix();
+        EXPECT_EQ(_stats.get_sketch().get_count(), _stats.get_count()) << itr.prefix();
+        EXPECT_LE(_stats.get_quantile(0.5), _stats.get_quantile(0.99)) << itr.prefix();
+        EXPECT_GE(_stats.get_quantile(0.5), _stats.get_min()) << itr.prefix();
+        EXPECT_LE(_stats.get_quantile(0.99), _stats.get_max()) << itr.prefix();
+    }
+
+    EXPECT_EQ(_nparent, nloop * (nthreads + 1));
+    EXPECT_EQ(_nchild, nloop * (nthreads + 1));
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(quantile_storage_tests, exclusive)
+{
+    std::vector<basic_tree_t> _vec{};
+    storage_t::instance()->get(_vec);
+
+    size_t _nparents = 0;
+    for(const auto& itr : _vec)
+        details::check_tree(itr, _nparents);
+
+    // the parent regions have the child regions
+    EXPECT_GE(_nparents, 1u);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(quantile_storage_tests, mpi_get)
+{
+    auto _data = storage_t::instance()->mpi_get();
+    if(tim::mpi::rank() > 0)
+        return;
+    ASSERT_FALSE(_data.empty());
+
+    int64_t _count = 0;
+    for(const auto& itr : _data.front())
+    {
+        _count += itr.stats().get_count();
+        EXPECT_TRUE(itr.stats().has_quantiles()) << itr.prefix();
+    }
+    EXPECT_EQ(_count, 2 * nloop * (nthreads + 1));
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(quantile_storage_tests, json)
+{
+    using archive_t = cereal::JSONOutputArchive;
+    using api_t     = TIMEMORY_API;
+
+    std::stringstream ss;
+    {
+        auto ar = tim::policy::output_archive<archive_t, api_t>::get(ss);
+        storage_t::instance()->get(*ar);
+    }
+
+    EXPECT_NE(ss.str().find("\"p50\""), std::string::npos);
+    EXPECT_NE(ss.str().find("\"p99\""), std::string::npos);
+    EXPECT_NE(ss.str().find("\"sketch\""), std::string::npos);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(quantile_storage_tests, text)
+{
+    tim::settings::output_path() = "quantile_storage_output";
+    storage_t::instance()->print();
+
+    auto fname = tim::settings::compose_output_filename(quantile_clock::label(), ".txt");
+    std::ifstream ifs{ fname };
+    ASSERT_TRUE(ifs) << fname;
+
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    std::cout << ss.str() << std::endl;
+
+    EXPECT_NE(ss.str().find("P50"), std::string::npos);
+    EXPECT_NE(ss.str().find("P99"), std::string::npos);
+}
+
+//--------------------------------------------------------------------------------------//
+
+int
+main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    _argc = argc;
+    _argv = argv;
+    auto ret = RUN_ALL_TESTS();
+    tim::timemory_finalize();
+    return ret;
+}
+
+//--------------------------------------------------------------------------------------//
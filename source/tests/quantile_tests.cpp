@@ -0,0 +1,215 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/data/quantile_sketch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using sketch_t      = tim::data::quantile_sketch;
+using quantile_t    = tim::quantile_statistics<double>;
+using doublevec_t   = std::vector<double>;
+using quantilevec_t = std::vector<double>;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+// log-normal latencies with a heavy tail
+inline doublevec_t
+generate(size_t n, uint64_t seed, double mu = 0.0, double sigma = 1.5)
+{
+    std::mt19937_64                     _rng{ seed };
+    std::lognormal_distribution<double> _dist{ mu, sigma };
+    doublevec_t                         _data(n);
+    for(auto& itr : _data)
+        itr = _dist(_rng);
+    return _data;
+}
+
+// exact quantile with the same rank convention as the sketch
+inline double
+exact(doublevec_t _data, double _q)
+{
+    std::sort(_data.begin(), _data.end());
+    auto _rank = static_cast<size_t>(_q * (_data.size() - 1));
+    return _data.at(_rank);
+}
+
+inline quantilevec_t
+quantiles()
+{
+    return { 0.0, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0 };
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class quantile_tests : public ::testing::Test
+{};
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(quantile_tests, accuracy)
+{
+    auto     _data = details::generate(100000, 1);
+    sketch_t _sketch{};
+    for(const auto& itr : _data)
+        _sketch += itr;
+
+    EXPECT_EQ(_sketch.get_count(), _data.size());
+    for(auto q : details::quantiles())
+    {
+        auto _exact = details::exact(_data, q);
+        auto _est   = _sketch.get_quantile(q);
+        EXPECT_NEAR(_est, _exact, _exact * _sketch.get_accuracy() * 1.0001)
+            << "quantile = " << q;
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(quantile_tests, signed_values)
+{
+    auto     _data = details::generate(10000, 2);
+    sketch_t _sketch{};
+    for(size_t i = 0; i < _data.size(); ++i)
+    {
+        if(i % 3 == 0)
+            _data.at(i) *= -1.0;
+        else if(i % 7 == 0)
+            _data.at(i) = 0.0;
+        _sketch.insert(_data.at(i));
+    }
+
+    for(auto q : details::quantiles())
+    {
+        auto _exact = details::exact(_data, q);
+        auto _est   = _sketch.get_quantile(q);
+        EXPECT_NEAR(_est, _exact, std::abs(_exact) * _sketch.get_accuracy() * 1.0001)
+            << "quantile = " << q;
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(quantile_tests, merge)
+{
+    auto _a = details::generate(20000, 3, 0.0, 1.0);
+    auto _b = details::generate(30000, 4, 2.0, 0.5);
+
+    sketch_t _sa{};
+    sketch_t _sb{};
+    sketch_t _sall{};
+    for(const auto& itr : _a)
+    {
+        _sa += itr;
+        _sall += itr;
+    }
+    for(const auto& itr : _b)
+    {
+        _sb += itr;
+        _sall += itr;
+    }
+
+    // merging is exact for sketches with the same accuracy
+    auto _merged = _sa + _sb;
+    EXPECT_EQ(_merged.get_count(), _sall.get_count());
+    for(auto q : details::quantiles())
+        EXPECT_DOUBLE_EQ(_merged.get_quantile(q), _sall.get_quantile(q))
+            << "quantile = " << q;
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(quantile_tests, bounded_memory)
+{
+    constexpr int32_t max_bins = 128;
+    sketch_t          _sketch{ 0.01, max_bins };
+    // 20 orders of magnitude would require ~2300 bins at 1% accuracy
+    for(int i = -10; i <= 10; ++i)
+        for(int j = 1; j < 10; ++j)
+            _sketch += j * std::pow(10.0, i);
+
+    EXPECT_LE(_sketch.get_size(), static_cast<size_t>(max_bins));
+    EXPECT_EQ(_sketch.get_count(), 21 * 9);
+    // the lowest bins are collapsed so the upper quantiles remain accurate
+    EXPECT_NEAR(_sketch.get_quantile(1.0), 9.0e10, 9.0e10 * 0.01);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(quantile_tests, statistics)
+{
+    auto _data = details::generate(5000, 5);
+
+    quantile_t _lhs{};
+    quantile_t _rhs{};
+    for(size_t i = 0; i < _data.size(); ++i)
+    {
+        if(i % 2 == 0)
+            _lhs += _data.at(i);
+        else
+            _rhs += _data.at(i);
+    }
+
+    auto _stats = _lhs + _rhs;
+    EXPECT_EQ(_stats.get_count(), _data.size());
+    EXPECT_EQ(_stats.get_sketch().get_count(), _data.size());
+    EXPECT_DOUBLE_EQ(_stats.get_min(), *std::min_element(_data.begin(), _data.end()));
+    EXPECT_DOUBLE_EQ(_stats.get_max(), *std::max_element(_data.begin(), _data.end()));
+    // quantiles are bounded by the exact extrema
+    EXPECT_DOUBLE_EQ(_stats.get_quantile(0.0), _stats.get_min());
+    EXPECT_DOUBLE_EQ(_stats.get_quantile(1.0), _stats.get_max());
+
+    for(const auto& itr : quantile_t::get_reported_quantiles())
+    {
+        auto _exact = details::exact(_data, itr.second);
+        EXPECT_NEAR(_stats.get_quantile(itr.second), _exact, _exact * 0.0101)
+            << itr.first;
+    }
+
+    // the distribution of a difference is unknown so the quantiles are discarded
+    auto _diff = _stats - _rhs;
+    EXPECT_FALSE(_diff.has_quantiles());
+    EXPECT_EQ(_diff.get_quantile(0.5), 0.0);
+    EXPECT_FALSE((_diff + _lhs).has_quantiles());
+    EXPECT_TRUE(_stats.has_quantiles());
+
+    // scaling, e.g. unit conversion
+    auto _p99 = _lhs.get_quantile(0.99);
+    _lhs *= 1000.0;
+    EXPECT_NEAR(_lhs.get_quantile(0.99), 1000.0 * _p99, 1000.0 * _p99 * 0.0201);
+
+    std::cout << _lhs << std::endl;
+}
+
+//--------------------------------------------------------------------------------------//
@@ -0,0 +1,285 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/sampling.hpp"
+#include "timemory/timemory.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using stack_sampler = tim::sampling::stack_sampler;
+using tracker_t     = stack_sampler::tracker_type;
+using clock_type    = std::chrono::steady_clock;
+
+static int             _argc = 0;
+static char**          _argv = nullptr;
+static volatile double _sink = 0.0;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+//  Get the current tests name
+inline std::string
+get_test_name()
+{
+    return ::testing::UnitTest::GetInstance()->current_test_info()->name();
+}
+
+__attribute__((noinline)) double
+stack_sampler_leaf(int64_t n)
+{
+    double _val = 0.0;
+    for(int64_t i = 0; i < n; ++i)
+        _val += std::sqrt(static_cast<double>(i) + _val);
+    return _val;
+}
+
+// busy-waits for the given number of milliseconds
+__attribute__((noinline)) double
+stack_sampler_burn(int64_t _msec)
+{
+    double _val = 0.0;
+    auto   _end = clock_type::now() + std::chrono::milliseconds{ _msec };
+    while(clock_type::now() < _end)
+        _val += stack_sampler_leaf(1000);
+    return _val + 1.0;
+}
+
+__attribute__((noinline)) double
+stack_sampler_parent(int64_t _msec)
+{
+    return stack_sampler_burn(_msec) + 1.0;
+}
+
+// the seconds of a fixed amount of work
+inline double
+timed_work(int64_t _niter)
+{
+    auto _beg = clock_type::now();
+    for(int64_t i = 0; i < _niter; ++i)
+        _sink = _sink + stack_sampler_leaf(1000);
+    return std::chrono::duration<double>(clock_type::now() - _beg).count();
+}
+
+// the samples of the entries whose name contains the given string
+inline int64_t
+get_samples(const std::string& _name, int64_t* _depth = nullptr)
+{
+    int64_t _laps = 0;
+    for(auto& itr : tim::storage<tracker_t>::instance()->get())
+    {
+        if(itr.prefix().find(_name) == std::string::npos)
+            continue;
+        _laps += itr.data().get_laps();
+        if(_depth)
+            *_depth = itr.depth();
+    }
+    return _laps;
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class stack_sampler_tests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        if(!configured)
+        {
+            configured                   = true;
+            tim::settings::verbose()     = 0;
+            tim::settings::debug()       = false;
+            tim::settings::json_output() = false;
+            tim::settings::mpi_thread()  = false;
+            tim::settings::banner()      = false;
+            tim::dmp::initialize(_argc, _argv);
+            tim::timemory_init(_argc, _argv);
+        }
+    }
+
+public:
+    static bool configured;
+};
+
+bool stack_sampler_tests::configured = false;
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(stack_sampler_tests, call_graph)
+{
+    stack_sampler::config _cfg{};
+    _cfg.frequency = 1000.0;
+    _cfg.cpu_time  = false;
+    ASSERT_TRUE(stack_sampler::start(_cfg));
+    EXPECT_TRUE(stack_sampler::is_active());
+    // already active
+    EXPECT_FALSE(stack_sampler::start(_cfg));
+
+    _sink = _sink + details::stack_sampler_parent(500);
+
+    auto _overhead = stack_sampler::get_overhead();
+    stack_sampler::finalize();
+    EXPECT_FALSE(stack_sampler::is_active());
+
+    std::cout << "[" << details::get_test_name() << "]> " << _overhead.as_string()
+              << std::endl;
+
+    EXPECT_EQ(_overhead.threads, 1);
+    EXPECT_GT(_overhead.samples, 100);
+    EXPECT_EQ(_overhead.dropped, 0);
+
+    int64_t _parent_depth = -1;
+    int64_t _burn_depth   = -1;
+    auto    _parent       = details::get_samples("stack_sampler_parent", &_parent_depth);
+    auto    _burn         = details::get_samples("stack_sampler_burn", &_burn_depth);
+    auto    _leaf         = details::get_samples("stack_sampler_leaf");
+
+    // the counts are inclusive: every sample in the leaf is a sample of its callers
+    EXPECT_GT(_leaf, 0);
+    EXPECT_GE(_burn, _leaf);
+    EXPECT_GE(_parent, _burn);
+    EXPECT_GT(_parent, static_cast<int64_t>(_overhead.samples) / 2);
+    EXPECT_LT(_parent_depth, _burn_depth);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(stack_sampler_tests, threads)
+{
+    auto _beg = details::get_samples("stack_sampler_burn");
+
+    ASSERT_TRUE(stack_sampler::start());
+
+    std::vector<std::thread> _threads{};
+    for(int i = 0; i < 2; ++i)
+    {
+        _threads.emplace_back([]() {
+            EXPECT_TRUE(stack_sampler::register_thread());
+            _sink = _sink + details::stack_sampler_burn(250);
+        });
+    }
+    for(auto& itr : _threads)
+        itr.join();
+
+    // the threads unregistered when they exited
+    auto _overhead = stack_sampler::get_overhead();
+    stack_sampler::finalize();
+
+    std::cout << "[" << details::get_test_name() << "]> " << _overhead.as_string()
+              << std::endl;
+
+    EXPECT_EQ(_overhead.threads, 3);
+    EXPECT_GT(_overhead.samples, 0);
+    EXPECT_GT(details::get_samples("stack_sampler_burn"), _beg);
+
+    // not active
+    EXPECT_FALSE(stack_sampler::register_thread());
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(stack_sampler_tests, sessions)
+{
+    stack_sampler::config _cfg{};
+    _cfg.frequency = 1000.0;
+    _cfg.cpu_time  = true;
+
+    ASSERT_TRUE(stack_sampler::start(_cfg));
+    _sink       = _sink + details::stack_sampler_burn(250);
+    auto _first = stack_sampler::get_overhead();
+    stack_sampler::finalize();
+
+    // the buffer of the first session is released when the thread registers again
+    // and its samples are not part of the second session
+    ASSERT_TRUE(stack_sampler::start(_cfg));
+    auto _second = stack_sampler::get_overhead();
+    stack_sampler::stop();
+    auto _stopped = stack_sampler::get_overhead();
+    stack_sampler::finalize();
+
+    std::cout << "[" << details::get_test_name() << "]> first: " << _first.as_string()
+              << std::endl;
+    std::cout << "[" << details::get_test_name() << "]> second: " << _second.as_string()
+              << std::endl;
+
+    EXPECT_GT(_first.samples, 100);
+    EXPECT_EQ(_second.threads, 1);
+    EXPECT_LT(_second.samples, _first.samples / 4);
+    EXPECT_LT(_stopped.samples, _first.samples / 4);
+    EXPECT_LT(_stopped.handler_ns, _first.handler_ns);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(stack_sampler_tests, overhead)
+{
+    const int64_t _niter = 20000;
+    // warm-up
+    details::timed_work(_niter / 10);
+
+    auto _base = details::timed_work(_niter);
+
+    stack_sampler::config _cfg{};
+    _cfg.frequency = 1000.0;
+    ASSERT_TRUE(stack_sampler::start(_cfg));
+    auto _sampled  = details::timed_work(_niter);
+    auto _overhead = stack_sampler::get_overhead();
+    stack_sampler::finalize();
+
+    auto _measured = (_sampled - _base) / _base;
+    std::cout << "[" << details::get_test_name() << "]> " << _overhead.as_string()
+              << std::endl;
+    std::cout << "[" << details::get_test_name() << "]> work: " << _base
+              << " sec without sampling, " << _sampled << " sec with sampling at "
+              << _cfg.frequency << " Hz = " << (100.0 * _measured) << "% overhead"
+              << std::endl;
+
+    EXPECT_GT(_overhead.samples, 0);
+    EXPECT_DOUBLE_EQ(_overhead.frequency, _cfg.frequency);
+    // the cost of the handler itself is well below one percent at 1 kHz
+    EXPECT_LT(_overhead.fraction(), 0.01);
+}
+
+//--------------------------------------------------------------------------------------//
+
+int
+main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    _argc = argc;
+    _argv = argv;
+    return RUN_ALL_TESTS();
+}
+
+//--------------------------------------------------------------------------------------//
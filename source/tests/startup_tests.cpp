@@ -0,0 +1,284 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/environment.hpp"
+#include "timemory/settings.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <iostream>
+#include <new>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using settings   = tim::settings;
+using clock_type = std::chrono::steady_clock;
+
+extern "C" char** environ;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+// the number of heap allocations
+std::atomic<int64_t> allocations{ 0 };
+
+// provides access to the arena of the settings
+struct arena_settings : settings
+{
+    size_t get_arena_blocks() const { return m_arena->num_blocks(); }
+};
+
+inline int64_t
+elapsed(clock_type::time_point _beg)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - _beg)
+        .count();
+}
+
+// in a fresh child process: dlopen the library and call the first enabled() query.
+// Returns the elapsed nanoseconds or -1 on failure
+inline int64_t
+dlopen_enabled(const char* _libpath)
+{
+    int _fd[2];
+    if(pipe(_fd) != 0)
+        return -1;
+
+    auto _pid = fork();
+    if(_pid < 0)
+        return -1;
+
+    if(_pid == 0)
+    {
+        close(_fd[0]);
+        int64_t _val = -1;
+        auto    _beg = clock_type::now();
+        auto*   _lib = dlopen(_libpath, RTLD_NOW | RTLD_LOCAL);
+        if(_lib)
+        {
+            using func_t = int (*)(void);
+            auto _func   = (func_t) dlsym(_lib, "cxx_timemory_enabled");
+            if(_func && _func() >= 0)
+                _val = elapsed(_beg);
+        }
+        if(write(_fd[1], &_val, sizeof(_val)) != sizeof(_val))
+            _val = -1;
+        close(_fd[1]);
+        // skip the library finalization, only the startup is measured
+        _exit((_val < 0) ? EXIT_FAILURE : EXIT_SUCCESS);
+    }
+
+    close(_fd[1]);
+    int64_t _val = -1;
+    if(read(_fd[0], &_val, sizeof(_val)) != sizeof(_val))
+        _val = -1;
+    close(_fd[0]);
+    int _status = 0;
+    waitpid(_pid, &_status, 0);
+    return _val;
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+void*
+operator new(size_t _n)
+{
+    ++details::allocations;
+    if(void* _ptr = malloc((_n > 0) ? _n : 1))
+        return _ptr;
+    throw std::bad_alloc{};
+}
+
+void
+operator delete(void* _ptr) noexcept
+{
+    free(_ptr);
+}
+
+void
+operator delete(void* _ptr, size_t) noexcept
+{
+    free(_ptr);
+}
+
+//--------------------------------------------------------------------------------------//
+
+class startup_tests : public ::testing::Test
+{};
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(startup_tests, environment_keys)
+{
+    tim::set_env<std::string>("TIMEMORY_STARTUP_TESTS_KEY", "ON", 1);
+    tim::set_env<std::string>("STARTUP_TESTS_KEY", "ON", 1);
+
+    auto _keys = settings::get_global_environment_keys("TIMEMORY_");
+    EXPECT_EQ(_keys.count("TIMEMORY_STARTUP_TESTS_KEY"), 1);
+    EXPECT_EQ(_keys.count("STARTUP_TESTS_KEY"), 0);
+    for(const auto& itr : _keys)
+        EXPECT_EQ(itr.find("TIMEMORY_"), 0) << itr;
+
+    unsetenv("TIMEMORY_STARTUP_TESTS_KEY");
+    unsetenv("STARTUP_TESTS_KEY");
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(startup_tests, parse)
+{
+    settings _obj{};
+
+    // the environment is copied on first request
+    tim::set_env<std::string>("STARTUP_TESTS_ENVIRON", "ON", 1);
+    auto& _environ = _obj.get_environment();
+    EXPECT_NE(std::find(_environ.begin(), _environ.end(), "STARTUP_TESTS_ENVIRON=ON"),
+              _environ.end());
+    unsetenv("STARTUP_TESTS_ENVIRON");
+
+    auto _precision = _obj.get_precision();
+    auto _verbose   = _obj.get_verbose();
+
+    tim::set_env<std::string>("TIMEMORY_PRECISION", "7", 1);
+    settings::parse(&_obj);
+    EXPECT_EQ(_obj.get_precision(), 7);
+    EXPECT_EQ(_obj.get_verbose(), _verbose);
+
+    // unset variables do not reset values
+    unsetenv("TIMEMORY_PRECISION");
+    settings::parse(&_obj);
+    EXPECT_EQ(_obj.get_precision(), 7);
+    _obj.get_precision() = _precision;
+
+    // settings without the prefix are not covered by the scan
+    _obj.insert<int>("STARTUP_TESTS_VALUE", "startup_tests_value", "For startup_tests",
+                     1);
+    tim::set_env<std::string>("STARTUP_TESTS_VALUE", "4", 1);
+    settings::parse(&_obj);
+    EXPECT_EQ(_obj.get<int>("STARTUP_TESTS_VALUE"), 4);
+    unsetenv("STARTUP_TESTS_VALUE");
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(startup_tests, construct)
+{
+    constexpr int64_t nitr = 50;
+
+    int64_t _ctor    = 0;
+    int64_t _allocs  = 0;
+    int64_t _parse   = 0;
+    int64_t _baseenv = 0;
+    int64_t _baseall = 0;
+    size_t  _nset    = 0;
+    size_t  _nblocks = 0;
+    for(int64_t i = 0; i < nitr; ++i)
+    {
+        using settings_t = details::arena_settings;
+
+        auto       _nalloc = details::allocations.load();
+        auto       _beg    = clock_type::now();
+        settings_t _obj{};
+        _ctor += details::elapsed(_beg);
+        _allocs += details::allocations.load() - _nalloc;
+        _nset    = _obj.ordering().size();
+        _nblocks = _obj.get_arena_blocks();
+
+        _beg = clock_type::now();
+        settings::parse(&_obj);
+        _parse += details::elapsed(_beg);
+
+        // baseline: the environment was copied at construction
+        _beg = clock_type::now();
+        std::vector<std::string> _environ{};
+        for(char** itr = environ; itr && *itr; ++itr)
+            _environ.emplace_back(*itr);
+        _baseenv += details::elapsed(_beg);
+
+        // baseline: parse searched the environment for every setting
+        _beg = clock_type::now();
+        for(auto& itr : _obj)
+            itr.second->parse();
+        _baseall += details::elapsed(_beg);
+
+        EXPECT_FALSE(_obj.ordering().empty());
+    }
+
+    // the settings are allocated from a few blocks instead of one allocation each
+    EXPECT_GT(_nblocks, 0u);
+    EXPECT_LT(_nblocks, _nset / 10);
+
+    auto _name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    std::cout << "[" << _name << "] " << _nset << " settings\n"
+              << "[" << _name << "] construction : " << (_ctor / nitr / 1000)
+              << " usec, " << (_allocs / nitr) << " heap allocations (" << _nblocks
+              << " arena blocks instead of " << _nset << " allocations)\n"
+              << "[" << _name << "] environment  : copied on first request, "
+              << (_baseenv / nitr / 1000) << " usec when copied at construction\n"
+              << "[" << _name << "] parse        : " << (_parse / nitr / 1000)
+              << " usec, " << (_baseall / nitr / 1000)
+              << " usec when every setting searches the environment" << std::endl;
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(startup_tests, dlopen)
+{
+#if defined(TIMEMORY_STARTUP_LIBRARY)
+    constexpr int nitr = 5;
+
+    std::vector<int64_t> _data{};
+    for(int i = 0; i < nitr; ++i)
+    {
+        auto _val = details::dlopen_enabled(TIMEMORY_STARTUP_LIBRARY);
+        ASSERT_GT(_val, 0) << "dlopen(\"" << TIMEMORY_STARTUP_LIBRARY << "\") failed";
+        _data.emplace_back(_val);
+    }
+
+    int64_t _sum = 0;
+    for(const auto& itr : _data)
+        _sum += itr;
+
+    std::cout << "[" << ::testing::UnitTest::GetInstance()->current_test_info()->name()
+              << "] dlopen + first enabled(): min = "
+              << (*std::min_element(_data.begin(), _data.end()) / 1000)
+              << " usec, mean = " << (_sum / nitr / 1000) << " usec" << std::endl;
+#else
+    std::cout << "[" << ::testing::UnitTest::GetInstance()->current_test_info()->name()
+              << "] no shared library to load" << std::endl;
+#endif
+}
+
+//--------------------------------------------------------------------------------------//
@@ -0,0 +1,378 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/storage/telemetry.hpp"
+#include "timemory/timemory.hpp"
+#include "timemory/utility/telemetry.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace tim::component;
+namespace telemetry = tim::telemetry;
+
+using exporter_t = telemetry::exporter<wall_clock>;
+using bundle_t   = tim::component_tuple<wall_clock>;
+
+static int    _argc = 0;
+static char** _argv = nullptr;
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+//  Get the current tests name
+inline std::string
+get_test_name()
+{
+    return ::testing::UnitTest::GetInstance()->current_test_info()->name();
+}
+
+inline void
+run_regions(const std::string& _name, int _n)
+{
+    for(int i = 0; i < _n; ++i)
+    {
+        bundle_t _outer{ _name };
+        _outer.start();
+        bundle_t _inner{ _name + "/inner" };
+        _inner.start();
+        _inner.stop();
+        _outer.stop();
+    }
+}
+
+// polls the collector until the condition is satisfied or ~5 seconds elapsed
+template <typename FuncT>
+inline bool
+wait_for(telemetry::collector& _collector, FuncT&& _func)
+{
+    for(int i = 0; i < 500 && !_func(); ++i)
+        _collector.poll(10);
+    return _func();
+}
+
+// the aggregated laps of the regions named _name
+inline uint64_t
+get_laps(const telemetry::collector&               _collector,
+         const telemetry::collector::entry_map_t& _entries, const std::string& _name)
+{
+    uint64_t _laps = 0;
+    for(const auto& itr : _entries)
+    {
+        if(_collector.get_name(itr.first.second) == _name)
+            _laps += itr.second.laps;
+    }
+    return _laps;
+}
+
+inline exporter_t::config
+get_config(const std::string& _endpoint, size_t _queue_size = 16)
+{
+    exporter_t::config _cfg{};
+    _cfg.endpoint   = _endpoint;
+    _cfg.interval   = 0.0;
+    _cfg.queue_size = _queue_size;
+    return _cfg;
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+class telemetry_tests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        if(!configured)
+        {
+            configured                   = true;
+            tim::settings::verbose()     = 0;
+            tim::settings::debug()       = false;
+            tim::settings::json_output() = false;
+            tim::settings::mpi_thread()  = false;
+            tim::settings::banner()      = false;
+            tim::dmp::initialize(_argc, _argv);
+            tim::timemory_init(_argc, _argv);
+        }
+    }
+
+public:
+    static bool configured;
+};
+
+bool telemetry_tests::configured = false;
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(telemetry_tests, message)
+{
+    telemetry::message _msg{};
+    _msg.pid      = 10;
+    _msg.rank     = 2;
+    _msg.sequence = 7;
+    _msg.dropped  = 3;
+    _msg.names.emplace_back(telemetry::name_entry{ telemetry::region_name, 42, "foo" });
+    _msg.records.emplace_back(telemetry::record{ 42, 1, 0, 5, 1.5 });
+    _msg.records.emplace_back(telemetry::record{ 43, 1, 1, 2, 0.5 });
+
+    auto _buff = telemetry::encode(_msg);
+    EXPECT_EQ(_buff.size(), telemetry::header_size + 16 + 3 + 2 * telemetry::record_size);
+    EXPECT_EQ(telemetry::peek_size(_buff.data(), _buff.size()), (int64_t) _buff.size());
+    EXPECT_EQ(telemetry::peek_size(_buff.data(), 4), 0);
+    EXPECT_EQ(telemetry::peek_size("not a message", 13), -1);
+
+    telemetry::message _data{};
+    ASSERT_TRUE(telemetry::decode(_buff.data(), _buff.size(), _data));
+    EXPECT_FALSE(telemetry::decode(_buff.data(), _buff.size() - 1, _data));
+    ASSERT_TRUE(telemetry::decode(_buff.data(), _buff.size(), _data));
+    EXPECT_EQ(_data.pid, 10);
+    EXPECT_EQ(_data.rank, 2);
+    EXPECT_EQ(_data.sequence, 7);
+    EXPECT_EQ(_data.dropped, 3);
+    ASSERT_EQ(_data.names.size(), 1);
+    EXPECT_EQ(_data.names.front().name, "foo");
+    ASSERT_EQ(_data.records.size(), 2);
+    EXPECT_EQ(_data.records.back().hash, 43);
+    EXPECT_EQ(_data.records.back().depth, 1);
+    EXPECT_EQ(_data.records.back().laps, 2);
+    EXPECT_NEAR(_data.records.back().value, 0.5, 1.0e-12);
+
+    auto _unix = telemetry::endpoint::parse("unix:/tmp/foo.sock");
+    auto _tcp  = telemetry::endpoint::parse("localhost:9000");
+    EXPECT_EQ(_unix.kind, telemetry::endpoint::unix_domain);
+    EXPECT_EQ(_unix.path, "/tmp/foo.sock");
+    EXPECT_EQ(_tcp.kind, telemetry::endpoint::tcp);
+    EXPECT_EQ(_tcp.host, "localhost");
+    EXPECT_EQ(_tcp.port, 9000);
+    EXPECT_FALSE(telemetry::endpoint::parse(""));
+    EXPECT_FALSE(telemetry::endpoint::parse("tcp:localhost"));
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(telemetry_tests, dropped)
+{
+    // nothing is listening: every message is either dropped or fails to send and the
+    // caller never waits on the connection
+    auto _path = std::string{ "/tmp/timemory-" } + details::get_test_name() + "-" +
+                 std::to_string(tim::process::get_id()) + ".sock";
+    telemetry::sender _sender{ telemetry::endpoint::parse(_path), 2 };
+
+    uint64_t _n   = 1000;
+    uint64_t _acc = 0;
+    auto     _beg = std::chrono::steady_clock::now();
+    for(uint64_t i = 0; i < _n; ++i)
+        _acc += (_sender.submit(std::string(64, 'x'))) ? 1 : 0;
+    auto _elapsed = std::chrono::steady_clock::now() - _beg;
+
+    EXPECT_TRUE(_sender.flush());
+    EXPECT_EQ(_sender.sent(), 0);
+    EXPECT_EQ(_sender.dropped(), _n - _acc);
+    EXPECT_EQ(_sender.failed(), _acc);
+    EXPECT_GT(_sender.dropped(), 0);
+    EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(_elapsed).count(),
+              1000);
+
+    // when an export is dropped, the changes are carried over to the next message
+    telemetry::collector _collector{};
+    ASSERT_TRUE(_collector.open("tcp:127.0.0.1:0"));
+
+    auto       _name = details::get_test_name();
+    exporter_t _exporter{ details::get_config(_collector.get_endpoint().as_string(), 1) };
+    uint64_t   _failed = 0;
+    for(int i = 0; i < 100; ++i)
+    {
+        details::run_regions(_name, 1);
+        _failed += (_exporter.collect()) ? 0 : 1;
+    }
+    _exporter.stop();
+
+    EXPECT_EQ(_exporter.dropped(), _failed);
+    ASSERT_TRUE(details::wait_for(_collector, [&]() {
+        return details::get_laps(_collector, _collector.entries(), _name) == 100;
+    }));
+    EXPECT_EQ(_collector.sources().begin()->second.dropped, _failed);
+
+    std::cout << "[" << _name << "]> " << _failed << " of 100 exports dropped"
+              << std::endl;
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(telemetry_tests, failed)
+{
+    // the collector is started after several messages failed to send: the changes in
+    // the failed messages are carried over to the first message which is delivered
+    auto _name = details::get_test_name();
+    auto _path = std::string{ "/tmp/timemory-" } + _name + "-" +
+                 std::to_string(tim::process::get_id()) + ".sock";
+
+    exporter_t _exporter{ details::get_config("unix:" + _path) };
+    for(int i = 0; i < 10; ++i)
+    {
+        details::run_regions(_name, 1);
+        EXPECT_TRUE(_exporter.collect());
+        EXPECT_TRUE(_exporter.flush());
+    }
+    EXPECT_EQ(_exporter.failed(), 10);
+
+    telemetry::collector _collector{};
+    ASSERT_TRUE(_collector.open("unix:" + _path));
+
+    // the connection is retried at most once per retry interval
+    details::run_regions(_name, 1);
+    EXPECT_TRUE(_exporter.collect());
+    EXPECT_TRUE(_exporter.flush());
+    for(int i = 0; i < 100 && _exporter.sent() == 0; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+        EXPECT_TRUE(_exporter.collect());
+        EXPECT_TRUE(_exporter.flush());
+    }
+    _exporter.stop();
+
+    ASSERT_TRUE(details::wait_for(_collector, [&]() {
+        return details::get_laps(_collector, _collector.entries(), _name) == 11;
+    }));
+    EXPECT_EQ(details::get_laps(_collector, _collector.entries(), _name + "/inner"), 11);
+    EXPECT_EQ(_collector.sources().size(), 1);
+    EXPECT_EQ(_collector.errors(), 0);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(telemetry_tests, tcp)
+{
+    telemetry::collector _collector{};
+    ASSERT_TRUE(_collector.open("tcp:127.0.0.1:0"));
+    ASSERT_GT(_collector.get_endpoint().port, 0);
+
+    auto       _name = details::get_test_name();
+    exporter_t _exporter{ details::get_config(_collector.get_endpoint().as_string()) };
+    ASSERT_TRUE(_exporter.enabled());
+
+    details::run_regions(_name, 10);
+    EXPECT_TRUE(_exporter.collect());
+    // nothing changed
+    EXPECT_FALSE(_exporter.collect());
+    EXPECT_TRUE(_exporter.flush());
+
+    ASSERT_TRUE(details::wait_for(_collector, [&]() {
+        return details::get_laps(_collector, _collector.entries(), _name) == 10;
+    }));
+    EXPECT_EQ(details::get_laps(_collector, _collector.entries(), _name + "/inner"), 10);
+
+    // only the deltas are sent
+    details::run_regions(_name, 5);
+    EXPECT_TRUE(_exporter.collect());
+    _exporter.stop();
+
+    ASSERT_TRUE(details::wait_for(_collector, [&]() {
+        return details::get_laps(_collector, _collector.entries(), _name) == 15;
+    }));
+    EXPECT_EQ(details::get_laps(_collector, _collector.entries(), _name + "/inner"), 15);
+    EXPECT_EQ(_collector.sources().size(), 1);
+    EXPECT_EQ(_collector.sources().begin()->second.missing, 0);
+    EXPECT_EQ(_collector.errors(), 0);
+    EXPECT_EQ(_exporter.dropped(), 0);
+
+    _collector.write(std::cout);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(telemetry_tests, unix_domain)
+{
+    // several processes streaming to one collector
+    auto _name = details::get_test_name();
+    auto _path = std::string{ "/tmp/timemory-" } + _name + "-" +
+                 std::to_string(tim::process::get_id()) + ".sock";
+
+    telemetry::collector _collector{};
+    ASSERT_TRUE(_collector.open("unix:" + _path));
+
+    int              _nproc = 4;
+    std::vector<int> _pids{};
+    for(int i = 0; i < _nproc; ++i)
+    {
+        auto _pid = fork();
+        ASSERT_GE(_pid, 0);
+        if(_pid == 0)
+        {
+            {
+                exporter_t _exporter{ details::get_config("unix:" + _path) };
+                for(int j = 0; j < 4; ++j)
+                {
+                    details::run_regions(_name, 5);
+                    _exporter.collect();
+                }
+            }
+            _exit(EXIT_SUCCESS);
+        }
+        _pids.emplace_back(_pid);
+    }
+
+    ASSERT_TRUE(details::wait_for(_collector, [&]() {
+        return details::get_laps(_collector, _collector.entries(), _name) == 20 * _nproc;
+    }));
+
+    for(auto itr : _pids)
+    {
+        int _status = 0;
+        waitpid(itr, &_status, 0);
+        EXPECT_EQ(WEXITSTATUS(_status), EXIT_SUCCESS);
+    }
+
+    EXPECT_EQ(_collector.sources().size(), _nproc);
+    for(const auto& itr : _collector.sources())
+    {
+        EXPECT_EQ(details::get_laps(_collector, itr.second.entries, _name), 20);
+        EXPECT_EQ(itr.second.missing, 0);
+    }
+
+    _collector.write(std::cout);
+}
+
+//--------------------------------------------------------------------------------------//
+
+int
+main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    _argc = argc;
+    _argv = argv;
+    return RUN_ALL_TESTS();
+}
+
+//--------------------------------------------------------------------------------------//
@@ -26,6 +26,7 @@
 
 #include <chrono>
 #include <iostream>
+#include <map>
 #include <random>
 #include <thread>
 #include <vector>
@@ -320,6 +321,167 @@ TEST_F(threading_tests, stl)
 
 //--------------------------------------------------------------------------------------//
 
+TEST_F(threading_tests, storage_pool)
+{
+    using bundle_t   = tim::component_tuple<wall_clock>;
+    using clock_type = std::chrono::steady_clock;
+
+    // threads are created and destroyed in batches, i.e. a thread-pool which does not
+    // keep its threads alive
+    uint64_t ncycles  = tim::get_env<uint64_t>("STORAGE_POOL_CYCLES", 10000);
+    uint64_t nthreads = 4;
+    auto     _label   = details::get_test_name() + "/cycle";
+    ncycles           = ((ncycles + nthreads - 1) / nthreads) * nthreads;
+
+    auto _run = [&](size_t _pool_size) {
+        tim::settings::storage_pool_size() = _pool_size;
+        auto _beg                          = clock_type::now();
+        for(uint64_t i = 0; i < ncycles; i += nthreads)
+        {
+            std::vector<std::thread> _threads{};
+            for(uint64_t j = 0; j < nthreads; ++j)
+            {
+                _threads.emplace_back([&_label]() {
+                    bundle_t _obj{ _label };
+                    _obj.start();
+                    _obj.stop();
+                });
+            }
+            for(auto& itr : _threads)
+                itr.join();
+        }
+        return std::chrono::duration<double>(clock_type::now() - _beg).count();
+    };
+
+    auto _count_laps = [&]() {
+        int64_t _laps = 0;
+        for(auto& itr : tim::storage<wall_clock>::instance()->get())
+        {
+            if(itr.prefix().find(_label) != std::string::npos)
+                _laps += itr.data().get_laps();
+        }
+        return _laps;
+    };
+
+    auto _base = _count_laps();
+    auto _tnew = _run(0);
+    EXPECT_EQ(tim::storage<wall_clock>::parked_count(), 0);
+    EXPECT_EQ(_count_laps() - _base, ncycles);
+
+    auto _tpool = _run(2 * nthreads);
+    EXPECT_GT(tim::storage<wall_clock>::parked_count(), 0);
+    EXPECT_LE(tim::storage<wall_clock>::parked_count(), 2 * nthreads);
+
+    // get() merges the parked storages into the master
+    EXPECT_EQ(_count_laps() - _base, 2 * ncycles);
+    EXPECT_EQ(tim::storage<wall_clock>::parked_count(), 0);
+
+    tim::settings::storage_pool_size() = 0;
+
+    printf("[%s]> %lu thread create/destroy cycles: %.3f sec without pool, %.3f sec "
+           "with pool (%.2fx)\n",
+           details::get_test_name().c_str(), static_cast<unsigned long>(ncycles), _tnew,
+           _tpool, _tnew / _tpool);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(threading_tests, storage_pool_workers_only)
+{
+    // monotonic_clock is never used on the main thread so the master storage is not
+    // initialized when the parked storages are merged
+    using bundle_t = tim::component_tuple<monotonic_clock>;
+
+    uint64_t nthreads = 4;
+    uint64_t nlaps    = 10;
+    auto     _label   = details::get_test_name();
+
+    tim::settings::storage_pool_size() = 2 * nthreads;
+
+    std::vector<std::thread> _threads{};
+    for(uint64_t i = 0; i < nthreads; ++i)
+    {
+        _threads.emplace_back([&_label, nlaps]() {
+            for(uint64_t j = 0; j < nlaps; ++j)
+            {
+                bundle_t _obj{ _label };
+                _obj.start();
+                _obj.stop();
+            }
+        });
+    }
+    for(auto& itr : _threads)
+        itr.join();
+
+    EXPECT_GT(tim::storage<monotonic_clock>::parked_count(), 0);
+
+    int64_t _laps = 0;
+    for(auto& itr : tim::storage<monotonic_clock>::instance()->get())
+    {
+        if(itr.prefix().find(_label) != std::string::npos)
+            _laps += itr.data().get_laps();
+    }
+
+    EXPECT_EQ(_laps, nthreads * nlaps);
+    EXPECT_EQ(tim::storage<monotonic_clock>::parked_count(), 0);
+
+    tim::settings::storage_pool_size() = 0;
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(threading_tests, storage_pool_parent)
+{
+    // the second thread adopts the storage parked by the first thread while the master
+    // is in a different region: the regions of each thread must be reported under the
+    // region the master was in when the thread ran
+    using bundle_t = tim::component_tuple<monotonic_raw_clock>;
+
+    auto _name  = details::get_test_name();
+    auto _child = _name + "/child";
+
+    tim::settings::storage_pool_size() = 2;
+
+    auto _run = [&_child](const std::string& _parent) {
+        bundle_t _obj{ _parent };
+        _obj.start();
+        std::thread{ [&_child]() {
+            bundle_t _inner{ _child };
+            _inner.start();
+            _inner.stop();
+        } }.join();
+        _obj.stop();
+    };
+
+    _run(_name + "/parent_a");
+    EXPECT_EQ(tim::storage<monotonic_raw_clock>::parked_count(), 1);
+    _run(_name + "/parent_b");
+    EXPECT_EQ(tim::storage<monotonic_raw_clock>::parked_count(), 1);
+
+    // the results are in pre-order so the children follow their parent
+    std::map<std::string, int64_t> _laps{};
+    std::string                    _parent{};
+    for(auto& itr : tim::storage<monotonic_raw_clock>::instance()->get())
+    {
+        for(const auto* pitr : { "parent_a", "parent_b" })
+        {
+            if(itr.prefix().find(_name + "/" + pitr) != std::string::npos)
+                _parent = pitr;
+        }
+        if(itr.prefix().find(_child) != std::string::npos)
+            _laps[_parent] += itr.data().get_laps();
+    }
+
+    EXPECT_EQ(_laps.size(), 2);
+    EXPECT_EQ(_laps["parent_a"], 1);
+    EXPECT_EQ(_laps["parent_b"], 1);
+    EXPECT_EQ(tim::storage<monotonic_raw_clock>::parked_count(), 0);
+
+    tim::settings::storage_pool_size() = 0;
+}
+
+//--------------------------------------------------------------------------------------//
+
 int
 main(int argc, char** argv)
 {
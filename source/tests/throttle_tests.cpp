@@ -27,6 +27,7 @@
 #include <chrono>
 #include <condition_variable>
 #include <iostream>
+#include <map>
 #include <mutex>
 #include <random>
 #include <thread>
@@ -281,6 +282,216 @@ TEST_F(throttle_tests, tuple_multithreaded)
 
 //--------------------------------------------------------------------------------------//
 
+TEST_F(throttle_tests, bundle)
+{
+    using tuple_t = tim::component_tuple<tim::component::wall_clock>;
+
+    auto _count  = tim::settings::throttle_count();
+    auto _ratio  = tim::settings::throttle_ratio();
+    auto _stride = tim::settings::throttle_stride();
+
+    tim::settings::throttle_count()  = 100;
+    tim::settings::throttle_ratio()  = 2.0;
+    tim::settings::throttle_stride() = 0;
+    tim::throttle::configure();
+
+    auto    name = details::get_test_name();
+    int64_t n    = tim::settings::throttle_count();
+    auto    v    = 2 * tim::settings::throttle_value();
+    tuple_t _obj{ name };
+
+    // the first window is measured, the rest are skipped
+    for(int64_t i = 0; i < 4 * n; ++i)
+    {
+        _obj.start();
+        _obj.stop();
+    }
+    EXPECT_TRUE(tim::throttle::is_throttled(_obj.hash()));
+    EXPECT_EQ(_obj.laps(), n);
+
+    // released once the region becomes expensive
+    for(int64_t i = 0; i < n; ++i)
+    {
+        _obj.start();
+        details::consume(v);
+        _obj.stop();
+    }
+    EXPECT_FALSE(tim::throttle::is_throttled(_obj.hash()));
+    EXPECT_EQ(_obj.laps(), n);
+
+    // down-sampled while throttled
+    tim::settings::throttle_stride() = 10;
+    tim::throttle::configure();
+    for(int64_t i = 0; i < 2 * n; ++i)
+    {
+        _obj.start();
+        _obj.stop();
+    }
+    EXPECT_TRUE(tim::throttle::is_throttled(_obj.hash()));
+    EXPECT_EQ(_obj.laps(), 2 * n + n / 10);
+
+    // other threads evaluate the region independently
+    std::thread{ [&_obj]() {
+        EXPECT_FALSE(tim::throttle::is_throttled(_obj.hash()));
+    } }.join();
+
+    bool _found = false;
+    for(const auto& itr : tim::throttle::get_records())
+    {
+        if(itr.hash != _obj.hash())
+            continue;
+        _found = true;
+        EXPECT_EQ(itr.key, name);
+        EXPECT_EQ(itr.throttled, 2);
+        EXPECT_EQ(itr.released, 1);
+    }
+    EXPECT_TRUE(_found);
+
+    tim::settings::throttle_count()  = _count;
+    tim::settings::throttle_ratio()  = _ratio;
+    tim::settings::throttle_stride() = _stride;
+    tim::throttle::configure();
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(throttle_tests, sampled)
+{
+    using wall_clock = tim::component::wall_clock;
+    using user_t     = tim::component::user_global_bundle;
+    using bundle_t   = tim::component_bundle<TIMEMORY_API, wall_clock>;
+    using light_t    = tim::lightweight_tuple<wall_clock>;
+    using user_obj_t = tim::component_bundle<TIMEMORY_API, user_t>;
+
+    auto _interval = tim::settings::sample_interval();
+
+    tim::settings::sample_interval() = 10;
+    tim::subsample::configure();
+    user_t::reset();
+    user_t::configure<wall_clock>();
+
+    auto     name = details::get_test_name();
+    int64_t  N    = tim::settings::sample_interval();
+    int64_t  n    = 1005;
+    int64_t  m    = 3;
+    bundle_t _obj{ name };
+    bundle_t _few{ name + "/few" };
+    bundle_t _parent{ name + "/parent" };
+    bundle_t _child{ name + "/child" };
+    light_t  _light{ name + "/lightweight" };
+
+    user_obj_t _user{ name + "/user" };
+
+    for(int64_t i = 0; i < n; ++i)
+    {
+        _obj.start();
+        details::consume(1000);
+        _obj.stop();
+    }
+
+    for(int64_t i = 0; i < m; ++i)
+    {
+        _few.start();
+        details::consume(1000);
+        _few.stop();
+    }
+
+    for(int64_t i = 0; i < n; ++i)
+    {
+        _parent.start();
+        _child.start();
+        details::consume(1000);
+        _child.stop();
+        _parent.stop();
+    }
+
+    for(int64_t i = 0; i < n; ++i)
+    {
+        _light.push();
+        _light.start();
+        details::consume(1000);
+        _light.stop();
+        _light.pop();
+    }
+
+    for(int64_t i = 0; i < n; ++i)
+    {
+        _user.start();
+        details::consume(1000);
+        _user.stop();
+    }
+
+    tim::settings::sample_interval() = _interval;
+    tim::subsample::configure();
+    user_t::reset();
+
+    // the first call and then one in every N calls was measured. The child is only
+    // measured when its parent was measured
+    auto _measured = [N](int64_t _n) { return (_n + N - 1) / N; };
+    EXPECT_EQ(_obj.laps(), _measured(n));
+    EXPECT_EQ(_few.laps(), 1);
+    EXPECT_EQ(_parent.laps(), _measured(n));
+    EXPECT_EQ(_child.laps(), _measured(_measured(n)));
+    EXPECT_EQ(_light.laps(), _measured(n));
+    EXPECT_EQ(_user.laps(), _measured(n));
+
+    // the stored laps and values are estimates for every call while the statistics
+    // only contain the measured samples
+    std::map<uint64_t, int64_t> _expected = {
+        { _obj.hash(), _measured(n) },
+        { _few.hash(), 1 },
+        { _parent.hash(), _measured(n) },
+        { _child.hash(), _measured(_measured(n)) },
+        { _light.hash(), _measured(n) },
+        { _user.hash(), _measured(n) }
+    };
+    std::map<uint64_t, int64_t> _found  = {};
+    std::map<uint64_t, int64_t> _depths = {};
+    for(const auto& itr : tim::storage<wall_clock>::instance()->get())
+    {
+        auto eitr = _expected.find(itr.hash());
+        if(eitr == _expected.end())
+            continue;
+        ++_found[itr.hash()];
+        _depths[itr.hash()] = itr.depth();
+        auto _calls         = (itr.hash() == _few.hash()) ? m : n;
+        auto _mean          = itr.data().get_accum() / itr.data().get_laps();
+        EXPECT_EQ(itr.data().get_laps(), _calls) << itr.prefix();
+        EXPECT_GE(_mean, 1000) << itr.prefix();
+        if(itr.stats().get_count() > 0)
+        {
+            EXPECT_EQ(itr.stats().get_count(), eitr->second) << itr.prefix();
+            EXPECT_NEAR(itr.stats().get_population(), _calls, 1.0e-6) << itr.prefix();
+            EXPECT_NEAR(itr.stats().get_sampling_ratio(),
+                        eitr->second / static_cast<double>(_calls), 1.0e-6)
+                << itr.prefix();
+        }
+    }
+
+    // every region has exactly one node and the child is always below its parent
+    EXPECT_EQ(_found.size(), _expected.size());
+    for(const auto& itr : _found)
+        EXPECT_EQ(itr.second, 1) << tim::get_hash_identifier(itr.first);
+    EXPECT_EQ(_depths[_child.hash()], _depths[_parent.hash()] + 1);
+
+    // the number of calls and measurements are recorded for the metadata
+    size_t _records = 0;
+    for(const auto& itr : tim::subsample::get_records())
+    {
+        auto eitr = _expected.find(itr.hash);
+        if(eitr == _expected.end())
+            continue;
+        ++_records;
+        auto _calls = (itr.hash == _few.hash()) ? m : n;
+        EXPECT_EQ(itr.key, tim::get_hash_identifier(itr.hash));
+        EXPECT_EQ(itr.calls, _calls) << itr.key;
+        EXPECT_EQ(itr.measured, eitr->second) << itr.key;
+    }
+    EXPECT_EQ(_records, _expected.size());
+}
+
+//--------------------------------------------------------------------------------------//
+
 int
 main(int argc, char** argv)
 {
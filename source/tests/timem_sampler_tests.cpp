@@ -0,0 +1,147 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "../tools/timem/proc_sampler.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <pthread.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+// this function consumes approximately "n" milliseconds of cpu time
+inline void
+consume(long n)
+{
+    volatile int64_t _v  = 0;
+    auto             now = std::chrono::steady_clock::now();
+    while(std::chrono::steady_clock::now() < (now + std::chrono::milliseconds(n)))
+        ++_v;
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+TEST(timem_sampler_tests, json_escape)
+{
+    EXPECT_EQ(timem::json_escape("main"), "main");
+    EXPECT_EQ(timem::json_escape("a\"b"), "a\\\"b");
+    EXPECT_EQ(timem::json_escape("a\\b"), "a\\\\b");
+    EXPECT_EQ(timem::json_escape("a\tb\n"), "a\\u0009b\\u000a");
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST(timem_sampler_tests, output_filename)
+{
+    EXPECT_EQ(timem::get_timeseries_filename("out.json", 123), "out-123.json");
+    EXPECT_EQ(timem::get_timeseries_filename("out", 123), "out-123.json");
+    EXPECT_EQ(timem::get_timeseries_filename("dir.json/out", 123),
+              "dir.json/out-123.json");
+    EXPECT_EQ(timem::get_timeseries_filename(".json", 123), ".json-123.json");
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST(timem_sampler_tests, thread_name)
+{
+    // the name of a thread is set by the application and is written to the JSON
+    std::thread _thread{ []() {
+        pthread_setname_np(pthread_self(), "a\"b\\c");
+        details::consume(200);
+    } };
+
+    timem::proc_sampler _sampler{ getpid(), 100.0 };
+    _sampler.start();
+    details::consume(100);
+    _sampler.stop();
+    _thread.join();
+
+    std::stringstream _ss{};
+    _sampler.write(_ss);
+
+    EXPECT_GT(_sampler.get_samples().size(), 0u);
+    EXPECT_NE(_ss.str().find("\"name\": \"a\\\"b\\\\c\""), std::string::npos)
+        << _ss.str();
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST(timem_sampler_tests, max_samples)
+{
+    const size_t nmax = 32;
+
+    // a new thread joins after the sampler has started
+    timem::proc_sampler _sampler{ getpid(), 1000.0, nmax };
+    _sampler.start();
+    details::consume(100);
+    std::thread _thread{ []() { details::consume(200); } };
+    details::consume(200);
+    _thread.join();
+    _sampler.stop();
+
+    const auto& _samples = _sampler.get_samples();
+    EXPECT_GT(_samples.size(), nmax / 4);
+    EXPECT_LT(_samples.size(), nmax);
+    EXPECT_LT(_sampler.get_frequency(), 1000.0);
+
+    // the samples are in order and the rates remain relative to the previous sample
+    for(size_t i = 1; i < _samples.size(); ++i)
+    {
+        EXPECT_GT(_samples.at(i).time, _samples.at(i - 1).time) << i;
+        EXPECT_GE(_samples.at(i).cpu_ticks, _samples.at(i - 1).cpu_ticks) << i;
+    }
+
+    std::stringstream _ss{};
+    _sampler.write(_ss);
+    std::stringstream _num{};
+    _num << "\"num_samples\": " << _samples.size() << ",";
+    EXPECT_NE(_ss.str().find(_num.str()), std::string::npos) << _ss.str();
+
+    // the cost per sample is relative to every sample taken, not the ones which were
+    // kept after the decimation
+    EXPECT_GE(_sampler.get_num_taken(), nmax);
+    EXPECT_GT(_sampler.get_num_taken(), _samples.size());
+    EXPECT_GT(_sampler.get_cpu_time(), 0);
+    EXPECT_DOUBLE_EQ(_sampler.get_sample_cost(),
+                     _sampler.get_cpu_time() / 1.0e3 / _sampler.get_num_taken());
+
+    std::stringstream _summary{};
+    _sampler.write_summary(_summary);
+    std::stringstream _cost{};
+    _cost << std::setprecision(3) << _sampler.get_sample_cost() << " usec/sample";
+    EXPECT_NE(_summary.str().find(_cost.str()), std::string::npos) << _summary.str();
+}
+
+//--------------------------------------------------------------------------------------//
@@ -0,0 +1,215 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "gtest/gtest.h"
+
+#include "timemory/library.h"
+#include "timemory/timemory.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// provided by libtimemory-xray
+extern "C"
+{
+    bool timemory_xray_patch(void);
+    bool timemory_xray_unpatch(void);
+    void timemory_xray_finalize(void);
+}
+
+using namespace tim::component;
+using result_t = decltype(tim::storage<wall_clock>::instance()->get());
+
+//--------------------------------------------------------------------------------------//
+// the functions below are instrumented (-fxray-instrument) and static so their names
+// are not in the dynamic symbol table
+//
+static __attribute__((noinline)) long
+xray_fibonacci(long n)
+{
+    return (n < 2) ? n : (xray_fibonacci(n - 1) + xray_fibonacci(n - 2));
+}
+
+static __attribute__((noinline)) long
+xray_tiny(long n)
+{
+    return n + 1;
+}
+
+static __attribute__((noinline)) long
+xray_after(long n)
+{
+    return n - 1;
+}
+
+//--------------------------------------------------------------------------------------//
+
+namespace details
+{
+template <typename FuncT>
+uint64_t
+get_hash(FuncT* _func)
+{
+    return reinterpret_cast<uint64_t>(reinterpret_cast<const void*>(_func));
+}
+
+// the entries of the function, the names are only resolved at finalization. The
+// functions of the storage are instrumented too so the instrumentation is removed while
+// the storage is read
+template <typename FuncT>
+[[clang::xray_never_instrument]] std::vector<typename result_t::value_type>
+get_entries(FuncT* _func)
+{
+    timemory_xray_unpatch();
+    std::vector<typename result_t::value_type> _ret{};
+    for(auto& itr : tim::storage<wall_clock>::instance()->get())
+    {
+        if(itr.hash() == get_hash(_func))
+            _ret.emplace_back(itr);
+    }
+    timemory_xray_patch();
+    return _ret;
+}
+
+template <typename FuncT>
+int64_t
+get_laps(FuncT* _func)
+{
+    int64_t _laps = 0;
+    for(auto& itr : get_entries(_func))
+        _laps += itr.data().get_laps();
+    return _laps;
+}
+}  // namespace details
+
+//--------------------------------------------------------------------------------------//
+
+// the library initializes the tracing when the first instrumented function (main) is
+// entered, TIMEMORY_TRACE_COMPONENTS and the throttling are set by the environment
+class xray_tests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        tim::settings::verbose()     = 0;
+        tim::settings::debug()       = false;
+        tim::settings::json_output() = false;
+        tim::settings::banner()      = false;
+        ASSERT_TRUE(timemory_xray_patch());
+    }
+};
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(xray_tests, recursion)
+{
+    volatile long _n = 8;
+    EXPECT_EQ(xray_fibonacci(_n), 21);
+    EXPECT_EQ(xray_after(_n), 7);
+
+    auto _fib = details::get_entries(&xray_fibonacci);
+    ASSERT_FALSE(_fib.empty());
+
+    // fibonacci(8) is 67 calls nested up to 8 levels deep
+    int64_t _laps  = 0;
+    int64_t _depth = _fib.front().depth();
+    int64_t _max   = _depth;
+    for(auto& itr : _fib)
+    {
+        _laps += itr.data().get_laps();
+        _depth = std::min<int64_t>(_depth, itr.depth());
+        _max   = std::max<int64_t>(_max, itr.depth());
+    }
+    EXPECT_EQ(_laps, 67);
+    EXPECT_EQ(_max - _depth, 7);
+
+    // the entries and exits were balanced: the next function is a sibling of the
+    // outermost call
+    auto _after = details::get_entries(&xray_after);
+    ASSERT_EQ(_after.size(), 1);
+    EXPECT_EQ(_after.front().depth(), _depth);
+    EXPECT_EQ(_after.front().data().get_laps(), 1);
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(xray_tests, throttled)
+{
+    auto _count = tim::settings::throttle_count();
+    ASSERT_TRUE(tim::throttle::enabled());
+
+    volatile long _n = 0;
+    for(size_t i = 0; i < 10 * _count; ++i)
+        _n = xray_tiny(_n);
+    EXPECT_EQ(static_cast<size_t>(_n), 10 * _count);
+
+    // the function is unpatched once it is throttled
+    EXPECT_TRUE(tim::throttle::is_throttled(details::get_hash(&xray_tiny)));
+    EXPECT_GT(details::get_laps(&xray_tiny), 0);
+    EXPECT_LE(details::get_laps(&xray_tiny), static_cast<int64_t>(_count));
+}
+
+//--------------------------------------------------------------------------------------//
+
+TEST_F(xray_tests, names)
+{
+    volatile long _n = 4;
+    EXPECT_EQ(xray_fibonacci(_n), 3);
+    EXPECT_EQ(xray_tiny(_n), 5);
+
+    // the names of the static functions are resolved from the symbol table. The
+    // instrumentation is removed so this test must be the last one
+    timemory_xray_finalize();
+
+    std::vector<std::string> _names{};
+    for(auto& itr : tim::storage<wall_clock>::instance()->get())
+    {
+        if(itr.hash() == details::get_hash(&xray_fibonacci) ||
+           itr.hash() == details::get_hash(&xray_tiny))
+            _names.emplace_back(itr.prefix());
+    }
+
+    ASSERT_FALSE(_names.empty());
+    for(const auto& itr : _names)
+    {
+        EXPECT_TRUE(itr.find("xray_fibonacci") != std::string::npos ||
+                    itr.find("xray_tiny") != std::string::npos)
+            << itr;
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+
+int
+main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+//--------------------------------------------------------------------------------------//
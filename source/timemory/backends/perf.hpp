@@ -0,0 +1,727 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/** \file backends/perf.hpp
+ * \headerfile backends/perf.hpp "timemory/backends/perf.hpp"
+ * Defines the Linux perf_event_open backend: event name parsing and per-thread
+ * counter groups which are read with a single read() (or rdpmc)
+ *
+ */
+
+#pragma once
+
+#include "timemory/macros/os.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_LINUX)
+#    include <linux/perf_event.h>
+#    include <sys/ioctl.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+namespace tim
+{
+namespace perf
+{
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::perf::event_info
+/// \brief Description of a single perf event. Names follow the conventions of
+/// `perf list`, e.g. "task-clock", "instructions", "L1-dcache-load-misses", or a raw
+/// event code such as "r01c2". A ":u" or ":k" suffix restricts counting to user or
+/// kernel mode.
+///
+struct event_info
+{
+    std::string name         = {};
+    std::string units        = {};
+    std::string description  = {};
+    uint32_t    type         = 0;
+    uint64_t    config       = 0;
+    bool        valid        = false;
+    bool        exclude_user = false;
+    bool        exclude_kern = false;
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+namespace impl
+{
+struct named_event
+{
+    const char* name;
+    const char* alias;
+    uint32_t    type;
+    uint64_t    config;
+    const char* units;
+    const char* description;
+};
+//
+#if defined(_LINUX)
+//
+inline const std::vector<named_event>&
+get_named_events()
+{
+    static const std::vector<named_event> _instance = {
+        { "task-clock", "", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, "nsec",
+          "Time the task was running on a CPU" },
+        { "cpu-clock", "", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_CLOCK, "nsec",
+          "Per-CPU high-resolution timer" },
+        { "page-faults", "faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, "",
+          "Number of page faults" },
+        { "minor-faults", "", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MIN, "",
+          "Page faults which did not require disk I/O" },
+        { "major-faults", "", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MAJ, "",
+          "Page faults which required disk I/O" },
+        { "context-switches", "cs", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES,
+          "", "Number of context switches" },
+        { "cpu-migrations", "migrations", PERF_TYPE_SOFTWARE,
+          PERF_COUNT_SW_CPU_MIGRATIONS, "", "Number of migrations to another CPU" },
+        { "alignment-faults", "", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_ALIGNMENT_FAULTS, "",
+          "Number of alignment faults" },
+        { "emulation-faults", "", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_EMULATION_FAULTS, "",
+          "Number of emulation faults" },
+        { "cpu-cycles", "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "",
+          "Total CPU cycles" },
+        { "instructions", "", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "",
+          "Retired instructions" },
+        { "cache-references", "", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES, "",
+          "Last-level cache accesses" },
+        { "cache-misses", "", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, "",
+          "Last-level cache misses" },
+        { "branch-instructions", "branches", PERF_TYPE_HARDWARE,
+          PERF_COUNT_HW_BRANCH_INSTRUCTIONS, "", "Retired branch instructions" },
+        { "branch-misses", "", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "",
+          "Mispredicted branch instructions" },
+        { "bus-cycles", "", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BUS_CYCLES, "",
+          "Bus cycles" },
+        { "stalled-cycles-frontend", "idle-cycles-frontend", PERF_TYPE_HARDWARE,
+          PERF_COUNT_HW_STALLED_CYCLES_FRONTEND, "", "Stalled cycles during issue" },
+        { "stalled-cycles-backend", "idle-cycles-backend", PERF_TYPE_HARDWARE,
+          PERF_COUNT_HW_STALLED_CYCLES_BACKEND, "", "Stalled cycles during retirement" },
+        { "ref-cycles", "", PERF_TYPE_HARDWARE, PERF_COUNT_HW_REF_CPU_CYCLES, "",
+          "Total cycles not affected by CPU frequency scaling" },
+    };
+    return _instance;
+}
+//
+//--------------------------------------------------------------------------------------//
+//  "<cache>-<op>[-misses]", e.g. L1-dcache-loads, LLC-load-misses, dTLB-store-misses
+//
+inline bool
+parse_cache_event(const std::string& _name, event_info& _info)
+{
+    static const std::vector<std::pair<const char*, uint64_t>> _caches = {
+        { "L1-dcache", PERF_COUNT_HW_CACHE_L1D }, { "L1-icache", PERF_COUNT_HW_CACHE_L1I },
+        { "LLC", PERF_COUNT_HW_CACHE_LL },        { "dTLB", PERF_COUNT_HW_CACHE_DTLB },
+        { "iTLB", PERF_COUNT_HW_CACHE_ITLB },     { "branch", PERF_COUNT_HW_CACHE_BPU },
+        { "node", PERF_COUNT_HW_CACHE_NODE },
+    };
+    static const std::vector<std::pair<const char*, uint64_t>> _ops = {
+        { "load", PERF_COUNT_HW_CACHE_OP_READ },
+        { "store", PERF_COUNT_HW_CACHE_OP_WRITE },
+        { "prefetch", PERF_COUNT_HW_CACHE_OP_PREFETCH },
+    };
+
+    for(const auto& citr : _caches)
+    {
+        std::string _prefix = std::string{ citr.first } + "-";
+        if(_name.find(_prefix) != 0)
+            continue;
+        auto _rest = _name.substr(_prefix.length());
+        for(const auto& oitr : _ops)
+        {
+            std::string _op     = oitr.first;
+            std::string _access = (_op == "prefetch") ? "prefetches" : _op + "s";
+            std::string _misses = _op + "-misses";
+            if(_rest != _access && _rest != _misses)
+                continue;
+            bool _miss   = (_rest == _misses);
+            _info.type   = PERF_TYPE_HW_CACHE;
+            _info.config = citr.second | (oitr.second << 8) |
+                           ((_miss) ? PERF_COUNT_HW_CACHE_RESULT_MISS
+                                    : PERF_COUNT_HW_CACHE_RESULT_ACCESS)
+                               << 16;
+            _info.description = std::string{ citr.first } + " " + _op +
+                                ((_miss) ? " misses" : " accesses");
+            _info.valid = true;
+            return true;
+        }
+    }
+    return false;
+}
+//
+#else
+//
+inline const std::vector<named_event>&
+get_named_events()
+{
+    static const std::vector<named_event> _instance = {};
+    return _instance;
+}
+//
+inline bool
+parse_cache_event(const std::string&, event_info&)
+{
+    return false;
+}
+//
+#endif
+}  // namespace impl
+//
+//--------------------------------------------------------------------------------------//
+//
+/// returns an event_info where `valid` is false if the name is not recognized
+inline event_info
+get_event_info(std::string _name)
+{
+    event_info _info{};
+    _info.name = _name;
+
+    // modifiers
+    auto _colon = _name.find(':');
+    if(_colon != std::string::npos)
+    {
+        auto _mods = _name.substr(_colon + 1);
+        _name      = _name.substr(0, _colon);
+        for(auto itr : _mods)
+        {
+            if(itr == 'u')
+                _info.exclude_kern = true;
+            else if(itr == 'k')
+                _info.exclude_user = true;
+            else
+                return _info;
+        }
+        if(_info.exclude_kern && _info.exclude_user)
+            return _info;
+    }
+
+    for(const auto& itr : impl::get_named_events())
+    {
+        if(_name == itr.name || (strlen(itr.alias) > 0 && _name == itr.alias))
+        {
+            _info.type        = itr.type;
+            _info.config      = itr.config;
+            _info.units       = itr.units;
+            _info.description = itr.description;
+            _info.valid       = true;
+            return _info;
+        }
+    }
+
+    if(impl::parse_cache_event(_name, _info))
+        return _info;
+
+#if defined(_LINUX)
+    // raw event code
+    if(_name.length() > 1 && _name[0] == 'r' &&
+       _name.find_first_not_of("0123456789abcdefABCDEF", 1) == std::string::npos)
+    {
+        _info.type        = PERF_TYPE_RAW;
+        _info.config      = std::stoull(_name.substr(1), nullptr, 16);
+        _info.description = "Raw event " + _name;
+        _info.valid       = true;
+    }
+#endif
+
+    return _info;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// parses a comma-, semicolon-, or space-delimited list of event names. Unknown and
+/// duplicate events are reported to `_err` (if non-null) and skipped.
+inline std::vector<event_info>
+get_event_info(const std::string& _spec, std::ostream* _err)
+{
+    std::vector<event_info> _events{};
+    std::string             _token{};
+    auto                    _add = [&]() {
+        if(_token.empty())
+            return;
+        auto _info = get_event_info(_token);
+        if(!_info.valid)
+        {
+            if(_err)
+                *_err << "[perf]> Unknown perf event '" << _token << "'" << std::endl;
+        }
+        else if(std::find_if(_events.begin(), _events.end(), [&](const event_info& e) {
+                    return e.name == _info.name;
+                }) == _events.end())
+        {
+            _events.emplace_back(std::move(_info));
+        }
+        _token.clear();
+    };
+
+    for(auto itr : _spec)
+    {
+        if(itr == ',' || itr == ';' || itr == ' ' || itr == '\t' || itr == '\n')
+            _add();
+        else
+            _token += itr;
+    }
+    _add();
+    return _events;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// names (not aliases) of the predefined software and hardware events
+inline std::vector<std::string>
+get_named_events()
+{
+    std::vector<std::string> _names{};
+    for(const auto& itr : impl::get_named_events())
+        _names.emplace_back(itr.name);
+    return _names;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \class tim::perf::event_group
+/// \brief Counters for the calling thread. Without inheritance, the events are opened
+/// as a single group (PERF_FORMAT_GROUP) so that all the values are obtained from
+/// one read() of the group leader. If rdpmc is enabled and the kernel sets
+/// cap_user_rdpmc for every event, the counters are read in user-space without a
+/// system call. With inheritance, counts include the threads created after the group
+/// was opened but each event must be read individually (the kernel does not support
+/// group reads of inherited events). Events which cannot be opened (e.g. hardware
+/// events inside a virtual machine) are reported and always read as zero.
+///
+class event_group
+{
+public:
+    using value_type = int64_t;
+
+    event_group() = default;
+    ~event_group() { close(); }
+
+    event_group(const event_group&) = delete;
+    event_group& operator=(const event_group&) = delete;
+
+    event_group(event_group&& rhs) noexcept { swap(rhs); }
+    event_group& operator=(event_group&& rhs) noexcept
+    {
+        if(this != &rhs)
+        {
+            close();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    bool open(const std::vector<event_info>& _events, bool _inherit = false,
+              bool _rdpmc = true, std::ostream* _err = &std::cerr);
+    void close();
+
+    /// writes size() values. Returns false if no events are open
+    bool read(value_type* _values) const;
+
+    bool   is_open() const { return m_nopen > 0; }
+    size_t size() const { return m_events.size(); }
+    size_t num_open() const { return m_nopen; }
+    bool   is_grouped() const { return m_leader >= 0 && !m_inherit; }
+    bool   uses_rdpmc() const { return m_rdpmc; }
+
+    const std::vector<event_info>& events() const { return m_events; }
+
+    std::vector<value_type> read() const
+    {
+        std::vector<value_type> _values(size(), 0);
+        read(_values.data());
+        return _values;
+    }
+
+private:
+    void swap(event_group& rhs) noexcept
+    {
+        std::swap(m_inherit, rhs.m_inherit);
+        std::swap(m_rdpmc, rhs.m_rdpmc);
+        std::swap(m_leader, rhs.m_leader);
+        std::swap(m_nopen, rhs.m_nopen);
+        std::swap(m_page_size, rhs.m_page_size);
+        std::swap(m_events, rhs.m_events);
+        std::swap(m_fds, rhs.m_fds);
+        std::swap(m_grouped, rhs.m_grouped);
+        std::swap(m_pages, rhs.m_pages);
+        std::swap(m_buffer, rhs.m_buffer);
+    }
+
+    bool read_group(value_type* _values) const;
+    bool read_single(size_t _idx, value_type* _values) const;
+    bool read_rdpmc(value_type* _values) const;
+
+private:
+    bool                    m_inherit   = false;
+    bool                    m_rdpmc     = false;
+    int                     m_leader    = -1;
+    size_t                  m_nopen     = 0;
+    size_t                  m_page_size = 0;
+    std::vector<event_info> m_events    = {};
+    // file descriptor of each event (-1 if it failed to open)
+    std::vector<int> m_fds = {};
+    // indexes of the events in the group, in the order the kernel reports them
+    std::vector<size_t> m_grouped = {};
+    // user-page of each event when rdpmc is used
+    std::vector<void*> m_pages = {};
+    // scratch space for group reads
+    mutable std::vector<uint64_t> m_buffer = {};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+#if defined(_LINUX)
+//
+namespace impl
+{
+inline int
+perf_event_open(perf_event_attr* _attr, pid_t _pid, int _cpu, int _group_fd,
+                unsigned long _flags)
+{
+    return static_cast<int>(
+        syscall(__NR_perf_event_open, _attr, _pid, _cpu, _group_fd, _flags));
+}
+//
+#    if defined(__x86_64__) || defined(__i386__)
+inline uint64_t
+rdpmc(uint32_t _counter)
+{
+    uint32_t _lo = 0;
+    uint32_t _hi = 0;
+    __asm__ volatile("rdpmc" : "=a"(_lo), "=d"(_hi) : "c"(_counter));
+    return static_cast<uint64_t>(_lo) | (static_cast<uint64_t>(_hi) << 32);
+}
+#        define TIMEMORY_PERF_RDPMC_AVAILABLE 1
+#    endif
+}  // namespace impl
+//
+//--------------------------------------------------------------------------------------//
+//
+inline bool
+event_group::open(const std::vector<event_info>& _events, bool _inherit, bool _rdpmc,
+                  std::ostream* _err)
+{
+    close();
+
+    m_inherit = _inherit;
+    m_events  = _events;
+    m_fds.assign(m_events.size(), -1);
+
+    // kernel profiling is not permitted for unprivileged users when
+    // perf_event_paranoid > 1 so retry while excluding the kernel
+    auto _open = [&](perf_event_attr& _attr, int _group_fd) {
+        int _fd = impl::perf_event_open(&_attr, 0, -1, _group_fd, 0);
+        if(_fd < 0 && (errno == EACCES || errno == EPERM) && !_attr.exclude_kernel)
+        {
+            _attr.exclude_kernel = 1;
+            _fd                  = impl::perf_event_open(&_attr, 0, -1, _group_fd, 0);
+        }
+        return _fd;
+    };
+
+    for(size_t i = 0; i < m_events.size(); ++i)
+    {
+        const auto&     _evt = m_events.at(i);
+        perf_event_attr _attr;
+        memset(&_attr, 0, sizeof(_attr));
+        _attr.size           = sizeof(_attr);
+        _attr.type           = _evt.type;
+        _attr.config         = _evt.config;
+        _attr.disabled       = 0;
+        _attr.inherit        = (_inherit) ? 1 : 0;
+        _attr.exclude_hv     = 1;
+        _attr.exclude_user   = (_evt.exclude_user) ? 1 : 0;
+        _attr.exclude_kernel = (_evt.exclude_kern) ? 1 : 0;
+        _attr.read_format =
+            PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        int _fd = -1;
+        if(!_inherit)
+        {
+            if(m_leader < 0)
+                _attr.read_format |= PERF_FORMAT_GROUP;
+            _fd = _open(_attr, m_leader);
+            if(_fd >= 0)
+            {
+                if(m_leader < 0)
+                    m_leader = _fd;
+                m_grouped.emplace_back(i);
+            }
+        }
+        else
+        {
+            _fd = _open(_attr, -1);
+        }
+
+        if(_fd < 0)
+        {
+            if(_err)
+                *_err << "[perf]> Unable to open perf event '" << _evt.name
+                      << "': " << strerror(errno) << std::endl;
+            continue;
+        }
+
+        m_fds.at(i) = _fd;
+        ++m_nopen;
+    }
+
+    m_buffer.assign(3 + m_grouped.size(), 0);
+
+#    if defined(TIMEMORY_PERF_RDPMC_AVAILABLE)
+    // user-space reads are only valid for the thread which opened the counters and
+    // do not include the counts of inherited threads
+    if(_rdpmc && !_inherit && m_nopen > 0 && m_nopen == m_events.size())
+    {
+        m_page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        m_pages.assign(m_events.size(), nullptr);
+        bool _capable = true;
+        for(size_t i = 0; i < m_fds.size(); ++i)
+        {
+            void* _page = mmap(nullptr, m_page_size, PROT_READ, MAP_SHARED, m_fds.at(i), 0);
+            if(_page == MAP_FAILED)
+            {
+                _capable = false;
+                break;
+            }
+            m_pages.at(i) = _page;
+            auto* _pc     = static_cast<perf_event_mmap_page*>(_page);
+            if(!_pc->cap_user_rdpmc || _pc->index == 0)
+                _capable = false;
+        }
+        m_rdpmc = _capable;
+        if(!m_rdpmc)
+        {
+            for(auto& itr : m_pages)
+            {
+                if(itr)
+                    munmap(itr, m_page_size);
+            }
+            m_pages.clear();
+        }
+    }
+#    else
+    (void) _rdpmc;
+#    endif
+
+    return is_open();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+event_group::close()
+{
+    for(auto& itr : m_pages)
+    {
+        if(itr)
+            munmap(itr, m_page_size);
+    }
+    // close the members before the leader
+    for(auto itr = m_fds.rbegin(); itr != m_fds.rend(); ++itr)
+    {
+        if(*itr >= 0)
+            ::close(*itr);
+    }
+    m_rdpmc  = false;
+    m_leader = -1;
+    m_nopen  = 0;
+    m_events.clear();
+    m_fds.clear();
+    m_grouped.clear();
+    m_pages.clear();
+    m_buffer.clear();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline bool
+event_group::read(value_type* _values) const
+{
+    std::fill(_values, _values + size(), 0);
+    if(m_nopen == 0)
+        return false;
+
+    if(m_rdpmc && read_rdpmc(_values))
+        return true;
+
+    bool _ret = true;
+    if(is_grouped())
+        _ret = read_group(_values);
+    else
+    {
+        for(size_t i = 0; i < m_fds.size(); ++i)
+            _ret = read_single(i, _values) && _ret;
+    }
+    return _ret;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline bool
+event_group::read_group(value_type* _values) const
+{
+    // { nr, time_enabled, time_running, values[nr] }
+    auto _nbytes = m_buffer.size() * sizeof(uint64_t);
+    if(::read(m_leader, m_buffer.data(), _nbytes) < static_cast<ssize_t>(3 * 8))
+        return false;
+
+    auto   _nr      = std::min<uint64_t>(m_buffer.at(0), m_grouped.size());
+    double _enabled = m_buffer.at(1);
+    double _running = m_buffer.at(2);
+    // scale when the group was multiplexed
+    double _scale = (_running > 0.0 && _running < _enabled) ? (_enabled / _running) : 1.0;
+    for(uint64_t i = 0; i < _nr; ++i)
+    {
+        auto _val = m_buffer.at(3 + i);
+        _values[m_grouped.at(i)] =
+            (_scale == 1.0) ? static_cast<value_type>(_val)
+                            : static_cast<value_type>(_val * _scale + 0.5);
+    }
+    return true;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline bool
+event_group::read_single(size_t _idx, value_type* _values) const
+{
+    int _fd = m_fds.at(_idx);
+    if(_fd < 0)
+        return true;
+
+    // { value, time_enabled, time_running }
+    uint64_t _buffer[3] = { 0, 0, 0 };
+    if(::read(_fd, _buffer, sizeof(_buffer)) < static_cast<ssize_t>(sizeof(_buffer)))
+        return false;
+
+    double _enabled = _buffer[1];
+    double _running = _buffer[2];
+    double _scale = (_running > 0.0 && _running < _enabled) ? (_enabled / _running) : 1.0;
+    _values[_idx] = (_scale == 1.0) ? static_cast<value_type>(_buffer[0])
+                                    : static_cast<value_type>(_buffer[0] * _scale + 0.5);
+    return true;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline bool
+event_group::read_rdpmc(value_type* _values) const
+{
+#    if defined(TIMEMORY_PERF_RDPMC_AVAILABLE)
+    for(size_t i = 0; i < m_pages.size(); ++i)
+    {
+        auto*    _pc    = static_cast<volatile perf_event_mmap_page*>(m_pages.at(i));
+        uint32_t _seq   = 0;
+        uint32_t _idx   = 0;
+        int64_t  _count = 0;
+        do
+        {
+            _seq = _pc->lock;
+            __asm__ volatile("" ::: "memory");
+            _idx   = _pc->index;
+            _count = _pc->offset;
+            if(!_pc->cap_user_rdpmc || _idx == 0)
+                return false;
+            auto _width = _pc->pmc_width;
+            auto _pmc   = static_cast<int64_t>(impl::rdpmc(_idx - 1));
+            // sign-extend the counter to 64 bits
+            _pmc <<= (64 - _width);
+            _pmc >>= (64 - _width);
+            _count += _pmc;
+            __asm__ volatile("" ::: "memory");
+        } while(_pc->lock != _seq);
+        _values[i] = _count;
+    }
+    return true;
+#    else
+    (void) _values;
+    return false;
+#    endif
+}
+//
+#else
+//
+//--------------------------------------------------------------------------------------//
+//
+inline bool
+event_group::open(const std::vector<event_info>& _events, bool, bool, std::ostream* _err)
+{
+    close();
+    m_events = _events;
+    if(_err && !_events.empty())
+        *_err << "[perf]> perf events are only supported on Linux" << std::endl;
+    return false;
+}
+//
+inline void
+event_group::close()
+{
+    m_events.clear();
+}
+//
+inline bool
+event_group::read(value_type* _values) const
+{
+    std::fill(_values, _values + size(), 0);
+    return false;
+}
+//
+inline bool
+event_group::read_group(value_type*) const
+{
+    return false;
+}
+//
+inline bool
+event_group::read_single(size_t, value_type*) const
+{
+    return false;
+}
+//
+inline bool
+event_group::read_rdpmc(value_type*) const
+{
+    return false;
+}
+//
+#endif
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace perf
+}  // namespace tim
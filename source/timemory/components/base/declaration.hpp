@@ -59,6 +59,7 @@ struct empty_base
 struct dynamic_base
 {
     TIMEMORY_DEFAULT_OBJECT(dynamic_base)
+    virtual ~dynamic_base() = default;
 
     virtual void          start()                                         = 0;
     virtual void          stop()                                          = 0;
@@ -150,8 +151,10 @@ private:
     static_assert(std::is_pointer<Tp>::value == false, "Error pointer base type");
 
 public:
+    // the destructor is only virtual when trait::dynamic_base provides a polymorphic
+    // base, otherwise components do not carry a vtable pointer
     base();
-    virtual ~base() = default;
+    ~base() = default;
 
     explicit base(const base_type&)     = default;
     explicit base(base_type&&) noexcept = default;
@@ -295,16 +298,19 @@ public:
     static Type dummy();  // create an instance
 
 protected:
+    // the flags and the (possibly empty) accum and last types are declared last so
+    // that they are packed into the tail padding instead of each being padded to the
+    // alignment of the value type
+    value_type     value        = value_type{};
+    int64_t        laps         = 0;
+    graph_iterator graph_itr    = graph_iterator{ nullptr };
+    accum_type     accum        = accum_type{};
+    last_type      last         = last_type{};
     bool           is_running   = false;
     bool           is_on_stack  = false;
     bool           is_transient = false;
     bool           is_flat      = false;
     bool           depth_change = false;
-    int64_t        laps         = 0;
-    value_type     value        = value_type{};
-    accum_type     accum        = accum_type{};
-    last_type      last         = last_type{};
-    graph_iterator graph_itr    = graph_iterator{ nullptr };
 
 public:
     static constexpr bool timing_category_v = trait::is_timing_category<Type>::value;
@@ -404,7 +410,7 @@ private:
 
 public:
     base();
-    virtual ~base()                     = default;
+    ~base()                             = default;
     explicit base(const base_type&)     = default;
     explicit base(base_type&&) noexcept = default;
     base& operator=(const base_type&) = default;
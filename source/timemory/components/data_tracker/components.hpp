@@ -30,6 +30,8 @@
 #pragma once
 
 #include "timemory/components/base.hpp"
+#include "timemory/data/small_vector.hpp"
+#include "timemory/hash/types.hpp"
 #include "timemory/mpl/concepts.hpp"
 #include "timemory/mpl/types.hpp"
 #include "timemory/units.hpp"
@@ -38,11 +40,10 @@
 
 #include <cassert>
 #include <cstdint>
-#include <memory>
 #include <sstream>
 #include <string>
 #include <type_traits>
-#include <unordered_map>
+#include <utility>
 
 //======================================================================================//
 //
@@ -75,13 +76,13 @@ namespace component
 template <typename InpT, typename Tag, typename Handler, typename StoreT>
 struct data_tracker : public base<data_tracker<InpT, Tag, Handler, StoreT>, StoreT>
 {
-    using value_type      = StoreT;
-    using this_type       = data_tracker<InpT, Tag, Handler, StoreT>;
-    using base_type       = base<this_type, value_type>;
-    using handler_type    = Handler;
-    using secondary_map_t = std::unordered_map<std::string, this_type>;
-    using secondary_ptr_t = std::shared_ptr<secondary_map_t>;
-    using string_t        = std::string;
+    using value_type       = StoreT;
+    using this_type        = data_tracker<InpT, Tag, Handler, StoreT>;
+    using base_type        = base<this_type, value_type>;
+    using handler_type     = Handler;
+    using secondary_type   = std::pair<hash_result_type, value_type>;
+    using secondary_data_t = data::small_vector<secondary_type, 4>;
+    using string_t         = std::string;
     using start_t =
         operation::generic_operator<this_type, operation::start<this_type>, Tag>;
     using stop_t =
@@ -180,75 +181,117 @@ struct data_tracker : public base<data_tracker<InpT, Tag, Handler, StoreT>, Stor
 
     void set_value(const value_type& v) { value = v; }
 
+    /// secondary entries are keyed by the hash id of the label. Passing a string
+    /// interns the label via \ref tim::add_hash_id, passing a hash id (e.g. from
+    /// TIMEMORY_LITERAL_HASH_ID) skips the lookup entirely. The first value stored
+    /// for a key is retained. The returned pointer is invalidated by the next call.
     template <typename T,
               enable_if_t<(concepts::is_acceptable_conversion<T, InpT>::value), int> = 0>
-    this_type* add_secondary(const string_t& _key, const T& val)
+    value_type* add_secondary(const string_t& _key, const T& val)
     {
+        return add_secondary(add_hash_id(_key), val);
+    }
+
+    template <typename T,
+              enable_if_t<(concepts::is_acceptable_conversion<T, InpT>::value), int> = 0>
+    value_type* add_secondary(const string_t& _key, handler_type&& h, const T& val)
+    {
+        return add_secondary(add_hash_id(_key), std::forward<handler_type>(h), val);
+    }
+
+    template <typename Func, typename T,
+              enable_if_t<(concepts::is_acceptable_conversion<T, InpT>::value), int> = 0>
+    value_type* add_secondary(const string_t& _key, Func&& f, const T& val)
+    {
+        return add_secondary(add_hash_id(_key), std::forward<Func>(f), val);
+    }
+
+    template <typename Func, typename T,
+              enable_if_t<(concepts::is_acceptable_conversion<T, InpT>::value), int> = 0>
+    value_type* add_secondary(const string_t& _key, handler_type&& h, Func&& f,
+                              const T& val)
+    {
+        return add_secondary(add_hash_id(_key), std::forward<handler_type>(h),
+                             std::forward<Func>(f), val);
+    }
+
+    template <typename T,
+              enable_if_t<(concepts::is_acceptable_conversion<T, InpT>::value), int> = 0>
+    value_type* add_secondary(hash_result_type _key, const T& val)
+    {
+        if(auto* _val = find_secondary(_key))
+            return _val;
         this_type _tmp;
         start_t   _start(_tmp);
         _tmp.store(val);
         stop_t _stop(_tmp);
-        auto&  _map = *get_secondary_map();
-        _map.insert({ _key, _tmp });
-        return &(_map[_key]);
+        return &m_secondary.emplace_back(_key, _tmp.value).second;
     }
 
     template <typename T,
               enable_if_t<(concepts::is_acceptable_conversion<T, InpT>::value), int> = 0>
-    this_type* add_secondary(const string_t& _key, handler_type&& h, const T& val)
+    value_type* add_secondary(hash_result_type _key, handler_type&& h, const T& val)
     {
+        if(auto* _val = find_secondary(_key))
+            return _val;
         this_type _tmp;
         start_t   _start(_tmp);
         _tmp.store(std::forward<handler_type>(h), val);
         stop_t _stop(_tmp);
-        auto&  _map = *get_secondary_map();
-        _map.insert({ _key, _tmp });
-        return &(_map[_key]);
+        return &m_secondary.emplace_back(_key, _tmp.value).second;
     }
 
     template <typename Func, typename T,
               enable_if_t<(concepts::is_acceptable_conversion<T, InpT>::value), int> = 0>
-    this_type* add_secondary(const string_t& _key, Func&& f, const T& val)
+    value_type* add_secondary(hash_result_type _key, Func&& f, const T& val)
     {
-        PRINT_HERE("%s :: adding secondary", demangle<this_type>().c_str());
+        if(auto* _val = find_secondary(_key))
+            return _val;
         this_type _tmp;
         start_t   _start(_tmp);
         _tmp.store(std::forward<Func>(f), val);
         stop_t _stop(_tmp);
-        auto&  _map = *get_secondary_map();
-        _map.insert({ _key, _tmp });
-        return &(_map[_key]);
+        return &m_secondary.emplace_back(_key, _tmp.value).second;
     }
 
     template <typename Func, typename T,
               enable_if_t<(concepts::is_acceptable_conversion<T, InpT>::value), int> = 0>
-    this_type* add_secondary(const string_t& _key, handler_type&& h, Func&& f,
-                             const T& val)
+    value_type* add_secondary(hash_result_type _key, handler_type&& h, Func&& f,
+                              const T& val)
     {
+        if(auto* _val = find_secondary(_key))
+            return _val;
         this_type _tmp;
         start_t   _start(_tmp);
         _tmp.store(std::forward<handler_type>(h), std::forward<Func>(f), val);
         stop_t _stop(_tmp);
-        auto&  _map = *get_secondary_map();
-        _map.insert({ _key, _tmp });
-        return &(_map[_key]);
+        return &m_secondary.emplace_back(_key, _tmp.value).second;
     }
 
     using base_type::get_unit;
     using base_type::load;
     using base_type::value;
 
-    auto get_secondary_map()
+    /// iterable of (hash id, value) pairs. The label of each id is available via
+    /// \ref tim::get_hash_identifier
+    const secondary_data_t& get_secondary() const { return m_secondary; }
+
+    /// secondary values belong to a single measurement, they are cleared by
+    /// \ref tim::operation::pop_node after they were appended to the storage
+    void clear_secondary() { m_secondary.clear(); }
+
+    value_type* find_secondary(hash_result_type _key)
     {
-        if(!m_secondary)
-            m_secondary = std::make_shared<secondary_map_t>();
-        return m_secondary;
+        for(auto& itr : m_secondary)
+        {
+            if(itr.first == _key)
+                return &itr.second;
+        }
+        return nullptr;
     }
 
-    auto get_secondary() { return (m_secondary) ? *m_secondary : secondary_map_t{}; }
-
 private:
-    secondary_ptr_t m_secondary{ nullptr };
+    secondary_data_t m_secondary{};
 };
 //
 //--------------------------------------------------------------------------------------//
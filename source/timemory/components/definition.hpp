@@ -36,6 +36,7 @@
 #include "timemory/components/likwid/components.hpp"
 #include "timemory/components/ompt/components.hpp"
 #include "timemory/components/papi/components.hpp"
+#include "timemory/components/perf/components.hpp"
 #include "timemory/components/roofline/components.hpp"
 #include "timemory/components/rusage/components.hpp"
 #include "timemory/components/tau_marker/components.hpp"
@@ -80,6 +80,12 @@
 //
 //--------------------------------------------------------------------------------------//
 //
+#if defined(TIMEMORY_USE_PERF_EXTERN)
+#    include "timemory/components/perf/extern.hpp"
+#endif
+//
+//--------------------------------------------------------------------------------------//
+//
 #if defined(TIMEMORY_USE_PAPI_EXTERN) || defined(TIMEMORY_USE_CUPTI_EXTERN)
 #    include "timemory/components/roofline/extern.hpp"
 #endif
@@ -69,6 +69,9 @@ private:
     template <size_t, typename Tp>
     friend struct user_bundle;
 
+    template <typename Tp, typename SlotT, typename EntryT, size_t N>
+    friend struct gotcha_thread_table;
+
     friend struct opaque;
 
     static bool& get()
@@ -0,0 +1,815 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/**
+ * \file timemory/components/gotcha/io_gotcha.hpp
+ * \brief Traces the POSIX I/O calls and summarizes the bytes, calls, latencies, and
+ * sizes of each file
+ */
+
+#pragma once
+
+#include "timemory/api.hpp"
+#include "timemory/components/base.hpp"
+#include "timemory/mpl/types.hpp"
+#include "timemory/units.hpp"
+#include "timemory/variadic/types.hpp"
+
+#include "timemory/components/gotcha/backends.hpp"
+#include "timemory/components/gotcha/thread_table.hpp"
+#include "timemory/components/gotcha/types.hpp"
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace tim
+{
+namespace component
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::component::io_gotcha
+/// \brief Records the time the calling thread spends in open, openat, close, read,
+/// write, pread, pwrite, readv, writev, fsync, and fdatasync. The value of the
+/// component is the I/O time of the thread between start() and stop().
+///
+/// The wrappers are activated by the first io_gotcha which is started and remain
+/// active until finalization. The path of each file descriptor is recorded by the open
+/// wrappers and cleared by the close wrapper; descriptors which were not opened through
+/// the wrappers (e.g. stdout, pipes, and sockets) are resolved on their first use. The
+/// device and inode are recorded with the path and checked before the path is reused,
+/// so a descriptor which was closed outside of the wrappers (e.g. by fclose or dup2)
+/// and then reused by pipe, socket, or dup is resolved again. The
+/// wrappers never access the storage: each call is accumulated into the table of the
+/// calling thread (see \ref gotcha_thread_table) which is keyed by the path and the
+/// innermost io_gotcha region of the thread. Every entry holds the calls, bytes, and
+/// time of each kind of call and log2-scaled histograms of the latencies and the
+/// transfer sizes. At finalization, a summary of the files with the most I/O time is
+/// reported (see \ref print_report). Calls made within libc, e.g. by the FILE*
+/// functions, do not go through the wrappers.
+///
+/// \code{.cpp}
+/// using bundle_t = tim::component_tuple<wall_clock, io_gotcha>;
+///
+/// bundle_t _obj{ "checkpoint" };
+/// _obj.start();
+/// write_checkpoint(fname);
+/// _obj.stop();
+/// \endcode
+struct io_gotcha : base<io_gotcha, int64_t>
+{
+    static constexpr size_t wrapper_count  = 14;
+    static constexpr size_t table_size     = 256;
+    static constexpr size_t histogram_size = 32;
+    static constexpr size_t fd_capacity    = 65536;
+
+    using ratio_t     = std::nano;
+    using value_type  = int64_t;
+    using this_type   = io_gotcha;
+    using base_type   = base<this_type, value_type>;
+    using bundle_type = lightweight_tuple<io_gotcha_audit>;
+    using gotcha_type = gotcha<wrapper_count, bundle_type, this_type>;
+    using tool_type   = component_tuple<gotcha_type>;
+
+    template <typename Tp>
+    using histogram_t = std::array<Tp, histogram_size>;
+
+    enum io_kind : int
+    {
+        open_kind = 0,
+        close_kind,
+        read_kind,
+        write_kind,
+        sync_kind,
+        kind_count
+    };
+
+    /// accumulated calls on a file within a region. Bin 0 of the histograms holds the
+    /// zero values and bin N > 0 holds the values in [2^(N-1), 2^N)
+    struct entry
+    {
+        uint64_t                         path        = 0;
+        uint64_t                         region      = 0;
+        std::array<uint64_t, kind_count> calls       = {};
+        uint64_t                         read_bytes  = 0;
+        uint64_t                         write_bytes = 0;
+        uint64_t                         time        = 0;   // nanoseconds
+        histogram_t<uint64_t>            latency     = {};  // nanoseconds
+        histogram_t<uint64_t>            size        = {};  // bytes of reads and writes
+    };
+
+    static std::string label() { return "io_gotcha"; }
+    static std::string description()
+    {
+        return "Time spent in POSIX I/O calls with per-file bytes, latencies, and sizes";
+    }
+
+    static value_type record()
+    {
+        auto* _data = table_type::get_thread_data();
+        return (_data) ? static_cast<value_type>(_data->total.load()) : 0;
+    }
+
+    static void configure();
+    static void enable();
+    static void disable();
+    static void global_finalize();
+
+    /// the accumulated calls of every file and region over all the threads
+    static std::vector<entry> get_entries();
+
+    /// the path of a hash in an \ref entry
+    static std::string get_path(uint64_t _hash);
+
+    /// the region name of a hash in an \ref entry
+    static std::string get_region(uint64_t _hash);
+
+    /// the name of an I/O kind
+    static std::string get_kind(int _kind);
+
+    /// the histogram bin of a value
+    static size_t get_bin(uint64_t _val)
+    {
+        size_t _bin = 0;
+        for(; _val > 0 && _bin + 1 < histogram_size; _val >>= 1)
+            ++_bin;
+        return _bin;
+    }
+
+    /// writes the calls, bytes, and histograms of the files with the most I/O time
+    static void print_report(std::ostream& _os, size_t _limit);
+    static void print_report(std::ostream& _os)
+    {
+        print_report(_os, settings::io_report_limit());
+    }
+
+    /// the path hash of a file descriptor. Invoked by \ref io_gotcha_audit.
+    static uint64_t get_fd_path(int _fd);
+
+    /// records the path of a file descriptor returned by open. Invoked by \ref
+    /// io_gotcha_audit.
+    static uint64_t open_fd(int _fd, const char* _path);
+
+    /// clears the path of a closed file descriptor. Invoked by \ref io_gotcha_audit.
+    static void close_fd(int _fd);
+
+    /// invoked by \ref io_gotcha_audit after each wrapped call
+    static void record_call(int _kind, uint64_t _path, int64_t _ret, uint64_t _time);
+
+public:
+    double get() const noexcept
+    {
+        return static_cast<double>(load()) / ratio_t::den * get_unit();
+    }
+    auto get_display() const noexcept { return get(); }
+
+    void start()
+    {
+        enable();
+        table_type::push_region(m_region);
+        value = record();
+    }
+
+    void stop()
+    {
+        accum += (value = (record() - value));
+        table_type::pop_region(m_region);
+    }
+
+    void set_prefix(const std::string& _prefix);
+
+private:
+    using atomic_t = std::atomic<uint64_t>;
+
+    struct slot
+    {
+        atomic_t                         key{ 0 };  // hash of the path
+        atomic_t                         region{ 0 };
+        std::array<atomic_t, kind_count> calls;
+        atomic_t                         read_bytes{ 0 };
+        atomic_t                         write_bytes{ 0 };
+        atomic_t                         time{ 0 };
+        histogram_t<atomic_t>            latency;
+        histogram_t<atomic_t>            size;
+    };
+
+    using table_type = gotcha_thread_table<this_type, slot, entry, table_size>;
+    friend table_type;
+
+    // the path of a file descriptor and the file it referred to when it was resolved
+    struct fd_entry
+    {
+        atomic_t path{ 0 };
+        atomic_t device{ 0 };
+        atomic_t inode{ 0 };
+    };
+
+    struct persistent_data
+    {
+        std::atomic<bool>           active{ false };
+        std::unique_ptr<fd_entry[]> fds{ new fd_entry[fd_capacity]() };
+        std::shared_ptr<tool_type>  tool = {};
+    };
+
+    static persistent_data& get_persistent_data()
+    {
+        // never deleted because the wrappers can be invoked during the static
+        // destruction
+        static auto* _instance = new persistent_data{};
+        return *_instance;
+    }
+
+    /// the names of the paths are registered with the names of the regions
+    static uint64_t register_path(const std::string& _path);
+
+    static void fold(entry& _entry, const slot& _slot);
+
+private:
+    uint64_t m_region = 0;
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::component::io_gotcha_audit
+/// \brief The component invoked by the \ref io_gotcha wrappers. The incoming audit
+/// records the file and the time of the call and the outgoing audit passes the result
+/// and the latency to \ref io_gotcha::record_call.
+///
+struct io_gotcha_audit : base<io_gotcha_audit, void>
+{
+    using value_type = void;
+    using this_type  = io_gotcha_audit;
+    using base_type  = base<this_type, value_type>;
+
+    static std::string label() { return "io_gotcha_audit"; }
+    static std::string description()
+    {
+        return "Measures the latency of a call wrapped by io_gotcha";
+    }
+
+    /// the kind of I/O of a wrapped function
+    static int get_function_kind(const std::string& _func)
+    {
+        static const std::array<std::pair<const char*, int>, io_gotcha::wrapper_count>
+            _kinds = { { { "open", io_gotcha::open_kind },
+                         { "open64", io_gotcha::open_kind },
+                         { "openat", io_gotcha::open_kind },
+                         { "close", io_gotcha::close_kind },
+                         { "read", io_gotcha::read_kind },
+                         { "pread", io_gotcha::read_kind },
+                         { "pread64", io_gotcha::read_kind },
+                         { "readv", io_gotcha::read_kind },
+                         { "write", io_gotcha::write_kind },
+                         { "pwrite", io_gotcha::write_kind },
+                         { "pwrite64", io_gotcha::write_kind },
+                         { "writev", io_gotcha::write_kind },
+                         { "fsync", io_gotcha::sync_kind },
+                         { "fdatasync", io_gotcha::sync_kind } } };
+        for(const auto& itr : _kinds)
+        {
+            if(_func == itr.first)
+                return itr.second;
+        }
+        return io_gotcha::kind_count;
+    }
+
+    // open and open64
+    void audit(const std::string&, const char* _path, int, mode_t)
+    {
+        begin(io_gotcha::open_kind, -1, _path);
+    }
+
+    // openat
+    void audit(const std::string&, int, const char* _path, int, mode_t)
+    {
+        begin(io_gotcha::open_kind, -1, _path);
+    }
+
+    // read, write, pread, pwrite, readv, and writev
+    template <typename... Args>
+    void audit(const std::string& _func, int _fd, Args...)
+    {
+        begin(get_function_kind(_func), _fd, nullptr);
+    }
+
+    // the file descriptor of close, fsync, and fdatasync or the result of open, close,
+    // fsync, and fdatasync
+    void audit(const std::string& _func, int _val)
+    {
+        if(m_started)
+            end(_val);
+        else
+            begin(get_function_kind(_func), _val, nullptr);
+    }
+
+    // the result of read, write, pread, pwrite, readv, and writev
+    void audit(const std::string&, ssize_t _ret) { end(_ret); }
+
+private:
+    void begin(int _kind, int _fd, const char* _path)
+    {
+        m_started = true;
+        m_kind    = _kind;
+        m_fd      = _fd;
+        m_path    = _path;
+        m_beg     = tim::get_clock_real_now<int64_t, std::nano>();
+    }
+
+    void end(int64_t _ret)
+    {
+        if(!m_started || m_kind >= io_gotcha::kind_count)
+            return;
+        auto _end  = tim::get_clock_real_now<int64_t, std::nano>();
+        auto _time = static_cast<uint64_t>((_end > m_beg) ? (_end - m_beg) : 0);
+        auto _path = (m_kind == io_gotcha::open_kind)
+                         ? io_gotcha::open_fd(static_cast<int>(_ret), m_path)
+                         : io_gotcha::get_fd_path(m_fd);
+
+        m_started = false;
+        io_gotcha::record_call(m_kind, _path, _ret, _time);
+        if(m_kind == io_gotcha::close_kind && _ret == 0)
+            io_gotcha::close_fd(m_fd);
+    }
+
+private:
+    bool        m_started = false;
+    int         m_kind    = io_gotcha::kind_count;
+    int         m_fd      = -1;
+    const char* m_path    = nullptr;
+    int64_t     m_beg     = 0;
+};
+//
+//======================================================================================//
+//
+}  // namespace component
+}  // namespace tim
+//
+//======================================================================================//
+//
+#include "timemory/timemory.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+//
+//======================================================================================//
+//
+inline void
+tim::component::io_gotcha::configure()
+{
+#if defined(TIMEMORY_USE_GOTCHA)
+    gotcha_type::get_default_ready() = true;
+    gotcha_type::get_initializer()   = []() {
+        // open and openat are variadic: the wrappers always forward the mode, which is
+        // ignored unless a file is created
+        gotcha_type::template configure<0, int, const char*, int, mode_t>("open");
+        gotcha_type::template configure<1, int, const char*, int, mode_t>("open64");
+        gotcha_type::template configure<2, int, int, const char*, int, mode_t>("openat");
+        TIMEMORY_C_GOTCHA(gotcha_type, 3, close);
+        TIMEMORY_C_GOTCHA(gotcha_type, 4, read);
+        TIMEMORY_C_GOTCHA(gotcha_type, 5, pread);
+        gotcha_type::template configure<6, ssize_t, int, void*, size_t, off_t>("pread64");
+        TIMEMORY_C_GOTCHA(gotcha_type, 7, readv);
+        TIMEMORY_C_GOTCHA(gotcha_type, 8, write);
+        TIMEMORY_C_GOTCHA(gotcha_type, 9, pwrite);
+        gotcha_type::template configure<10, ssize_t, int, const void*, size_t, off_t>(
+            "pwrite64");
+        TIMEMORY_C_GOTCHA(gotcha_type, 11, writev);
+        TIMEMORY_C_GOTCHA(gotcha_type, 12, fsync);
+        TIMEMORY_C_GOTCHA(gotcha_type, 13, fdatasync);
+    };
+#endif
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::io_gotcha::enable()
+{
+    auto& _pdata = get_persistent_data();
+    if(_pdata.active.load() || _pdata.active.exchange(true))
+        return;
+
+    configure();
+    _pdata.tool = std::make_shared<tool_type>("timemory_io_gotcha");
+    _pdata.tool->start();
+    manager::instance()->add_cleanup("timemory-io-gotcha", &this_type::disable);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::io_gotcha::disable()
+{
+    auto& _pdata = get_persistent_data();
+    if(_pdata.tool)
+    {
+        _pdata.tool->stop();
+        _pdata.tool.reset();
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::io_gotcha::global_finalize()
+{
+    disable();
+
+    if(get_entries().empty())
+        return;
+
+    if(settings::cout_output())
+        print_report(std::cout);
+
+    if(settings::file_output() && settings::text_output())
+    {
+        auto _fname = settings::compose_output_filename(
+            label() + "_report", ".txt", dmp::is_initialized(), dmp::rank());
+        std::ofstream ofs{ _fname };
+        if(ofs)
+        {
+            if(settings::verbose() >= 0)
+                printf("[%s]|%i> Outputting '%s'...\n", label().c_str(), dmp::rank(),
+                       _fname.c_str());
+            print_report(ofs);
+        }
+        else
+        {
+            fprintf(stderr, "[%s]|%i> Error opening '%s'...\n", label().c_str(),
+                    dmp::rank(), _fname.c_str());
+        }
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::io_gotcha::set_prefix(const std::string& _prefix)
+{
+    m_region = add_hash_id(_prefix);
+    table_type::add_name(m_region, _prefix);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline uint64_t
+tim::component::io_gotcha::register_path(const std::string& _path)
+{
+    // the same hash as the regions. The hash is not added to the hash ids of the thread
+    // because this is invoked by the wrappers, including during the thread exit
+    auto _hash = get_hash_id(_path);
+    // zero marks an unused slot and an unknown file descriptor
+    if(_hash == 0)
+        _hash = 1;
+    table_type::add_name(_hash, _path);
+    return _hash;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline uint64_t
+tim::component::io_gotcha::open_fd(int _fd, const char* _path)
+{
+    std::string _name = (_path) ? _path : "";
+#if defined(_LINUX)
+    // the absolute path, which is also correct for relative paths and openat
+    if(_fd >= 0)
+    {
+        char _link[64];
+        char _buff[4096];
+        snprintf(_link, sizeof(_link), "/proc/self/fd/%i", _fd);
+        auto _n = readlink(_link, _buff, sizeof(_buff) - 1);
+        if(_n > 0)
+            _name = std::string{ _buff, static_cast<size_t>(_n) };
+    }
+#endif
+    if(_name.empty())
+        _name = (_fd >= 0) ? std::string{ "fd:" } + std::to_string(_fd) : "(unknown)";
+
+    auto        _hash = register_path(_name);
+    struct stat _stat {};
+    if(_fd >= 0 && static_cast<size_t>(_fd) < fd_capacity && fstat(_fd, &_stat) == 0)
+    {
+        auto& _entry = get_persistent_data().fds[_fd];
+        _entry.device.store(_stat.st_dev, std::memory_order_relaxed);
+        _entry.inode.store(_stat.st_ino, std::memory_order_relaxed);
+        _entry.path.store(_hash, std::memory_order_relaxed);
+    }
+    return _hash;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline uint64_t
+tim::component::io_gotcha::get_fd_path(int _fd)
+{
+    if(_fd < 0)
+        return register_path("(bad file descriptor)");
+
+    // the descriptor may have been closed and reused without the wrappers, e.g. fclose
+    // followed by pipe, so the path is only reused if it still refers to the same file
+    if(static_cast<size_t>(_fd) < fd_capacity)
+    {
+        auto&       _entry = get_persistent_data().fds[_fd];
+        auto        _hash  = _entry.path.load(std::memory_order_relaxed);
+        struct stat _stat {};
+        if(_hash != 0 && fstat(_fd, &_stat) == 0 &&
+           _entry.device.load(std::memory_order_relaxed) ==
+               static_cast<uint64_t>(_stat.st_dev) &&
+           _entry.inode.load(std::memory_order_relaxed) ==
+               static_cast<uint64_t>(_stat.st_ino))
+            return _hash;
+    }
+
+    // descriptors which were not opened through the wrappers or which were reused
+    return open_fd(_fd, nullptr);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::io_gotcha::close_fd(int _fd)
+{
+    if(_fd >= 0 && static_cast<size_t>(_fd) < fd_capacity)
+        get_persistent_data().fds[_fd].path.store(0, std::memory_order_relaxed);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::io_gotcha::record_call(int _kind, uint64_t _path, int64_t _ret,
+                                       uint64_t _time)
+{
+    auto* _data = table_type::get_thread_data();
+    if(!_data)
+        return;
+
+    table_type::increment(_data->total, _time);
+
+    auto* _slot = table_type::get_slot(_data, _path, table_type::get_region(_data),
+                                       [](slot&) {});
+    if(!_slot)
+        return;
+
+    table_type::increment(_slot->calls[_kind], 1);
+    table_type::increment(_slot->time, _time);
+    table_type::increment(_slot->latency[get_bin(_time)], 1);
+    if(_ret >= 0 && (_kind == read_kind || _kind == write_kind))
+    {
+        auto _bytes = static_cast<uint64_t>(_ret);
+        table_type::increment((_kind == read_kind) ? _slot->read_bytes
+                                                   : _slot->write_bytes,
+                              _bytes);
+        table_type::increment(_slot->size[get_bin(_bytes)], 1);
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::io_gotcha::fold(entry& _entry, const slot& _slot)
+{
+    auto _load = [](const atomic_t& _val) {
+        return _val.load(std::memory_order_relaxed);
+    };
+
+    _entry.path   = _load(_slot.key);
+    _entry.region = _load(_slot.region);
+    for(size_t i = 0; i < kind_count; ++i)
+        _entry.calls[i] += _load(_slot.calls[i]);
+    _entry.read_bytes += _load(_slot.read_bytes);
+    _entry.write_bytes += _load(_slot.write_bytes);
+    _entry.time += _load(_slot.time);
+    for(size_t i = 0; i < histogram_size; ++i)
+    {
+        _entry.latency[i] += _load(_slot.latency[i]);
+        _entry.size[i] += _load(_slot.size[i]);
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline std::vector<tim::component::io_gotcha::entry>
+tim::component::io_gotcha::get_entries()
+{
+    return table_type::get_entries();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline std::string
+tim::component::io_gotcha::get_path(uint64_t _hash)
+{
+    return table_type::get_name(_hash);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline std::string
+tim::component::io_gotcha::get_region(uint64_t _hash)
+{
+    return (_hash == 0) ? std::string{ "(no region)" } : table_type::get_name(_hash);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline std::string
+tim::component::io_gotcha::get_kind(int _kind)
+{
+    switch(_kind)
+    {
+        case open_kind: return "open";
+        case close_kind: return "close";
+        case read_kind: return "read";
+        case write_kind: return "write";
+        case sync_kind: return "sync";
+        default: break;
+    }
+    return "unknown";
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::io_gotcha::print_report(std::ostream& _os, size_t _limit)
+{
+    struct file_summary
+    {
+        entry              total   = {};
+        std::vector<entry> regions = {};
+    };
+
+    auto _add = [](entry& _lhs, const entry& _rhs) {
+        for(size_t i = 0; i < kind_count; ++i)
+            _lhs.calls[i] += _rhs.calls[i];
+        _lhs.read_bytes += _rhs.read_bytes;
+        _lhs.write_bytes += _rhs.write_bytes;
+        _lhs.time += _rhs.time;
+        for(size_t i = 0; i < histogram_size; ++i)
+        {
+            _lhs.latency[i] += _rhs.latency[i];
+            _lhs.size[i] += _rhs.size[i];
+        }
+    };
+
+    auto _ncalls = [](const entry& _val) {
+        uint64_t _n = 0;
+        for(auto itr : _val.calls)
+            _n += itr;
+        return _n;
+    };
+
+    std::map<uint64_t, file_summary> _files{};
+    for(auto& itr : get_entries())
+    {
+        auto& _file      = _files[itr.path];
+        _file.total.path = itr.path;
+        _add(_file.total, itr);
+        _file.regions.emplace_back(itr);
+    }
+
+    auto _compare = [](const entry& _lhs, const entry& _rhs) {
+        return _lhs.time > _rhs.time;
+    };
+
+    std::vector<file_summary> _sorted{};
+    for(auto& itr : _files)
+    {
+        std::sort(itr.second.regions.begin(), itr.second.regions.end(), _compare);
+        _sorted.emplace_back(itr.second);
+    }
+    std::sort(_sorted.begin(), _sorted.end(),
+              [&_compare](const file_summary& _lhs, const file_summary& _rhs) {
+                  return _compare(_lhs.total, _rhs.total);
+              });
+    if(_limit > 0 && _sorted.size() > _limit)
+        _sorted.resize(_limit);
+
+    uint64_t _dropped = table_type::get_dropped();
+
+    // the lower bound of a bin in the given units
+    auto _bound = [](size_t _bin, const std::array<const char*, 4>& _units,
+                     double _scale) {
+        auto   _val = (_bin == 0) ? 0.0 : std::ldexp(1.0, static_cast<int>(_bin) - 1);
+        size_t _idx = 0;
+        while(_val >= _scale && _idx + 1 < _units.size())
+        {
+            _val /= _scale;
+            ++_idx;
+        }
+        std::stringstream _ss;
+        _ss << std::fixed << std::setprecision((_idx == 0) ? 0 : 1) << _val << " "
+            << _units.at(_idx);
+        return _ss.str();
+    };
+
+    auto _histogram = [&_bound](std::ostream& _ss, const std::string& _title,
+                                const histogram_t<uint64_t>& _hist,
+                                const std::array<const char*, 4>& _units,
+                                double                            _scale) {
+        uint64_t _max = 0;
+        for(auto itr : _hist)
+            _max = std::max(_max, itr);
+        if(_max == 0)
+            return;
+        _ss << "    " << std::left << std::setw(30) << _title << std::right
+            << std::setw(10) << "calls"
+            << "\n";
+        for(size_t i = 0; i < histogram_size; ++i)
+        {
+            if(_hist.at(i) == 0)
+                continue;
+            std::string _range = "[" + _bound(i, _units, _scale) + ", " +
+                                 ((i + 1 < histogram_size)
+                                      ? (_bound(i + 1, _units, _scale) + ")")
+                                      : std::string{ "..." });
+            auto _width = static_cast<size_t>(40.0 * _hist.at(i) / _max);
+            _ss << "      " << std::left << std::setw(28) << _range << std::right
+                << std::setw(10) << _hist.at(i) << "  "
+                << std::string(std::max<size_t>(_width, 1), '#') << "\n";
+        }
+    };
+
+    static const std::array<const char*, 4> _time_units = { "ns", "us", "ms", "s" };
+    static const std::array<const char*, 4> _size_units = { "B", "KiB", "MiB", "GiB" };
+
+    std::stringstream ss;
+    ss << "[" << label() << "]> I/O summary of the top " << _sorted.size() << " of "
+       << _files.size() << " files";
+    if(_dropped > 0)
+        ss << ", " << _dropped << " calls not recorded because a thread table was full";
+    ss << "\n";
+
+    for(auto& itr : _sorted)
+    {
+        auto& _total = itr.total;
+        ss << "\n" << get_path(_total.path) << "\n";
+        ss << "    " << std::left << std::setw(30) << "region" << std::right
+           << std::setw(10) << "calls" << std::setw(10) << "reads" << std::setw(10)
+           << "writes" << std::setw(16) << "read (bytes)" << std::setw(16)
+           << "write (bytes)" << std::setw(14) << "time (sec)"
+           << "\n";
+
+        auto _row = [&](const std::string& _name, const entry& _val) {
+            ss << "    " << std::left << std::setw(30) << _name << std::right
+               << std::setw(10) << _ncalls(_val) << std::setw(10)
+               << _val.calls.at(read_kind) << std::setw(10) << _val.calls.at(write_kind)
+               << std::setw(16) << _val.read_bytes << std::setw(16) << _val.write_bytes
+               << std::setw(14) << std::fixed << std::setprecision(6)
+               << (static_cast<double>(_val.time) / ratio_t::den) << "\n";
+        };
+
+        _row("(total)", _total);
+        for(auto& ritr : itr.regions)
+            _row(get_region(ritr.region), ritr);
+
+        ss << "    calls:";
+        for(int i = 0; i < kind_count; ++i)
+            ss << " " << get_kind(i) << " = " << _total.calls.at(i)
+               << ((i + 1 < kind_count) ? "," : "");
+        ss << "\n";
+
+        _histogram(ss, "latency", _total.latency, _time_units, 1000.0);
+        _histogram(ss, "size", _total.size, _size_units, 1024.0);
+    }
+    _os << ss.str() << std::flush;
+}
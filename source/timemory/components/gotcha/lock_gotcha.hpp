@@ -0,0 +1,555 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/**
+ * \file timemory/components/gotcha/lock_gotcha.hpp
+ * \brief Measures the time spent blocked in pthread mutex, rwlock, condition variable,
+ * and semaphore calls and reports the most contended locks
+ */
+
+#pragma once
+
+#include "timemory/api.hpp"
+#include "timemory/components/base.hpp"
+#include "timemory/mpl/types.hpp"
+#include "timemory/units.hpp"
+#include "timemory/variadic/types.hpp"
+
+#include "timemory/components/gotcha/backends.hpp"
+#include "timemory/components/gotcha/thread_table.hpp"
+#include "timemory/components/gotcha/types.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+#include <semaphore.h>
+
+namespace tim
+{
+namespace component
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::component::lock_gotcha
+/// \brief Records the time the calling thread spends blocked in pthread_mutex_lock,
+/// pthread_rwlock_{rd,wr}lock, pthread_cond_{wait,timedwait,clockwait}, sem_wait, and
+/// their timed variants (std::mutex, std::shared_timed_mutex, and
+/// std::condition_variable are implemented with these functions). The value of the
+/// component is the blocked time of the thread between start() and stop().
+///
+/// The wrappers are activated by the first lock_gotcha which is started and remain
+/// active until finalization. The wrappers never access the storage: each wrapped call
+/// is accumulated into the table of the calling thread (see \ref gotcha_thread_table)
+/// which is keyed by the address of the lock and the innermost lock_gotcha region of
+/// the thread. A call
+/// is counted as contended when the wait exceeds TIMEMORY_LOCK_WAIT_THRESHOLD. At
+/// finalization, the locks with the most contended calls and the regions which waited
+/// on them are reported (see \ref print_report). As with all gotcha wrappers, a call
+/// which arrives while another thread is in the bookkeeping of the same wrapper is
+/// passed through without being recorded.
+///
+/// \code{.cpp}
+/// using bundle_t = tim::component_tuple<wall_clock, lock_gotcha>;
+///
+/// bundle_t _obj{ "update_cache" };
+/// _obj.start();
+/// {
+///     std::lock_guard<std::mutex> _lk{ cache_mutex };
+///     // ...
+/// }
+/// _obj.stop();
+/// \endcode
+struct lock_gotcha : base<lock_gotcha, int64_t>
+{
+    static constexpr size_t wrapper_count = 11;
+    static constexpr size_t table_size    = 1024;
+
+    using ratio_t     = std::nano;
+    using value_type  = int64_t;
+    using this_type   = lock_gotcha;
+    using base_type   = base<this_type, value_type>;
+    using bundle_type = lightweight_tuple<lock_gotcha_audit>;
+    using gotcha_type = gotcha<wrapper_count, bundle_type, this_type>;
+    using tool_type   = component_tuple<gotcha_type>;
+
+    enum lock_kind : int
+    {
+        mutex_kind = 0,
+        rwlock_kind,
+        condition_kind,
+        semaphore_kind
+    };
+
+    /// accumulated waits of a lock within a region
+    struct entry
+    {
+        const void* address   = nullptr;
+        uint64_t    region    = 0;
+        int         kind      = mutex_kind;
+        uint64_t    count     = 0;
+        uint64_t    contended = 0;
+        uint64_t    wait      = 0;  // nanoseconds
+        uint64_t    max       = 0;  // nanoseconds
+    };
+
+    static std::string label() { return "lock_gotcha"; }
+    static std::string description()
+    {
+        return "Time spent blocked in pthread mutex, rwlock, condition variable, and "
+               "semaphore calls";
+    }
+
+    static value_type record()
+    {
+        auto* _data = table_type::get_thread_data();
+        return (_data) ? static_cast<value_type>(_data->total.load()) : 0;
+    }
+
+    static void configure();
+    static void enable();
+    static void disable();
+    static void global_finalize();
+
+    /// the accumulated waits of every lock and region over all the threads
+    static std::vector<entry> get_entries();
+
+    /// the region name of a hash in an \ref entry
+    static std::string get_region(uint64_t _hash);
+
+    /// the name of a lock kind
+    static std::string get_kind(int _kind);
+
+    /// writes the locks with the most contended calls and the regions which waited on
+    /// them
+    static void print_report(std::ostream& _os, size_t _limit);
+    static void print_report(std::ostream& _os)
+    {
+        print_report(_os, settings::lock_report_limit());
+    }
+
+    /// invoked by \ref lock_gotcha_audit after each wrapped call
+    static void record_wait(const void* _addr, int _kind, uint64_t _wait);
+
+public:
+    double get() const noexcept
+    {
+        return static_cast<double>(load()) / ratio_t::den * get_unit();
+    }
+    auto get_display() const noexcept { return get(); }
+
+    void start()
+    {
+        enable();
+        table_type::push_region(m_region);
+        value = record();
+    }
+
+    void stop()
+    {
+        accum += (value = (record() - value));
+        table_type::pop_region(m_region);
+    }
+
+    void set_prefix(const std::string& _prefix);
+
+private:
+    struct slot
+    {
+        std::atomic<uint64_t> key{ 0 };  // address of the lock
+        std::atomic<uint64_t> region{ 0 };
+        std::atomic<int>      kind{ mutex_kind };
+        std::atomic<uint64_t> count{ 0 };
+        std::atomic<uint64_t> contended{ 0 };
+        std::atomic<uint64_t> wait{ 0 };
+        std::atomic<uint64_t> max{ 0 };
+    };
+
+    using table_type = gotcha_thread_table<this_type, slot, entry, table_size>;
+    friend table_type;
+
+    struct persistent_data
+    {
+        std::atomic<bool>          active{ false };
+        std::atomic<uint64_t>      threshold{ 0 };
+        std::shared_ptr<tool_type> tool = {};
+    };
+
+    static persistent_data& get_persistent_data()
+    {
+        // never deleted because the wrappers can be invoked during the static
+        // destruction
+        static auto* _instance = new persistent_data{};
+        return *_instance;
+    }
+
+    static void fold(entry& _entry, const slot& _slot);
+
+private:
+    uint64_t m_region = 0;
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::component::lock_gotcha_audit
+/// \brief The component invoked by the \ref lock_gotcha wrappers. The incoming audit
+/// records the lock and the time of the call and the outgoing audit passes the wait
+/// to \ref lock_gotcha::record_wait.
+///
+struct lock_gotcha_audit : base<lock_gotcha_audit, void>
+{
+    using value_type = void;
+    using this_type  = lock_gotcha_audit;
+    using base_type  = base<this_type, value_type>;
+
+    static std::string label() { return "lock_gotcha_audit"; }
+    static std::string description()
+    {
+        return "Measures the wait of a call wrapped by lock_gotcha";
+    }
+
+    template <typename... Args>
+    void audit(const std::string&, pthread_mutex_t* _lock, Args...)
+    {
+        begin(_lock, lock_gotcha::mutex_kind);
+    }
+
+    template <typename... Args>
+    void audit(const std::string&, pthread_rwlock_t* _lock, Args...)
+    {
+        begin(_lock, lock_gotcha::rwlock_kind);
+    }
+
+    template <typename... Args>
+    void audit(const std::string&, pthread_cond_t* _cond, Args...)
+    {
+        begin(_cond, lock_gotcha::condition_kind);
+    }
+
+    template <typename... Args>
+    void audit(const std::string&, sem_t* _sem, Args...)
+    {
+        begin(_sem, lock_gotcha::semaphore_kind);
+    }
+
+    void audit(const std::string&, int)
+    {
+        if(!m_addr)
+            return;
+        auto _end = tim::get_clock_real_now<int64_t, std::nano>();
+        lock_gotcha::record_wait(m_addr, m_kind, (_end > m_beg) ? (_end - m_beg) : 0);
+        m_addr = nullptr;
+    }
+
+private:
+    void begin(const void* _addr, int _kind)
+    {
+        m_addr = _addr;
+        m_kind = _kind;
+        m_beg  = tim::get_clock_real_now<int64_t, std::nano>();
+    }
+
+private:
+    const void* m_addr = nullptr;
+    int         m_kind = lock_gotcha::mutex_kind;
+    int64_t     m_beg  = 0;
+};
+//
+//======================================================================================//
+//
+}  // namespace component
+}  // namespace tim
+//
+//======================================================================================//
+//
+#include "timemory/timemory.hpp"
+#include "timemory/utility/symbols.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+//
+//======================================================================================//
+//
+inline void
+tim::component::lock_gotcha::configure()
+{
+#if defined(TIMEMORY_USE_GOTCHA)
+    gotcha_type::get_default_ready() = true;
+    gotcha_type::get_initializer()   = []() {
+        TIMEMORY_C_GOTCHA(gotcha_type, 0, pthread_mutex_lock);
+        TIMEMORY_C_GOTCHA(gotcha_type, 1, pthread_mutex_timedlock);
+        TIMEMORY_C_GOTCHA(gotcha_type, 2, pthread_rwlock_rdlock);
+        TIMEMORY_C_GOTCHA(gotcha_type, 3, pthread_rwlock_wrlock);
+        TIMEMORY_C_GOTCHA(gotcha_type, 4, pthread_rwlock_timedrdlock);
+        TIMEMORY_C_GOTCHA(gotcha_type, 5, pthread_rwlock_timedwrlock);
+        TIMEMORY_C_GOTCHA(gotcha_type, 6, pthread_cond_wait);
+        TIMEMORY_C_GOTCHA(gotcha_type, 7, pthread_cond_timedwait);
+        TIMEMORY_C_GOTCHA(gotcha_type, 8, sem_wait);
+        TIMEMORY_C_GOTCHA(gotcha_type, 9, sem_timedwait);
+#    if defined(__GLIBC__) && (__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 30)
+        // used by std::condition_variable::wait_for and wait_until
+        TIMEMORY_C_GOTCHA(gotcha_type, 10, pthread_cond_clockwait);
+#    endif
+    };
+#endif
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::lock_gotcha::enable()
+{
+    auto& _pdata = get_persistent_data();
+    if(_pdata.active.load() || _pdata.active.exchange(true))
+        return;
+
+    _pdata.threshold.store(settings::lock_wait_threshold());
+    configure();
+    _pdata.tool = std::make_shared<tool_type>("timemory_lock_gotcha");
+    _pdata.tool->start();
+    manager::instance()->add_cleanup("timemory-lock-gotcha", &this_type::disable);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::lock_gotcha::disable()
+{
+    auto& _pdata = get_persistent_data();
+    if(_pdata.tool)
+    {
+        _pdata.tool->stop();
+        _pdata.tool.reset();
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::lock_gotcha::global_finalize()
+{
+    disable();
+
+    if(get_entries().empty())
+        return;
+
+    if(settings::cout_output())
+        print_report(std::cout);
+
+    if(settings::file_output() && settings::text_output())
+    {
+        auto _fname = settings::compose_output_filename(
+            label() + "_report", ".txt", dmp::is_initialized(), dmp::rank());
+        std::ofstream ofs{ _fname };
+        if(ofs)
+        {
+            if(settings::verbose() >= 0)
+                printf("[%s]|%i> Outputting '%s'...\n", label().c_str(), dmp::rank(),
+                       _fname.c_str());
+            print_report(ofs);
+        }
+        else
+        {
+            fprintf(stderr, "[%s]|%i> Error opening '%s'...\n", label().c_str(),
+                    dmp::rank(), _fname.c_str());
+        }
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::lock_gotcha::set_prefix(const std::string& _prefix)
+{
+    m_region = add_hash_id(_prefix);
+    table_type::add_name(m_region, _prefix);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::lock_gotcha::record_wait(const void* _addr, int _kind, uint64_t _wait)
+{
+    auto* _data = table_type::get_thread_data();
+    if(!_addr || !_data)
+        return;
+
+    table_type::increment(_data->total, _wait);
+
+    auto* _slot = table_type::get_slot(
+        _data, reinterpret_cast<uintptr_t>(_addr), table_type::get_region(_data),
+        [_kind](slot& _val) { _val.kind.store(_kind, std::memory_order_relaxed); });
+    if(!_slot)
+        return;
+
+    table_type::increment(_slot->count, 1);
+    table_type::increment(_slot->wait, _wait);
+    if(_wait >= get_persistent_data().threshold.load(std::memory_order_relaxed))
+        table_type::increment(_slot->contended, 1);
+    if(_wait > _slot->max.load(std::memory_order_relaxed))
+        _slot->max.store(_wait, std::memory_order_relaxed);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::lock_gotcha::fold(entry& _entry, const slot& _slot)
+{
+    _entry.address = reinterpret_cast<const void*>(_slot.key.load());
+    _entry.region  = _slot.region.load(std::memory_order_relaxed);
+    _entry.kind    = _slot.kind.load(std::memory_order_relaxed);
+    _entry.count += _slot.count.load(std::memory_order_relaxed);
+    _entry.contended += _slot.contended.load(std::memory_order_relaxed);
+    _entry.wait += _slot.wait.load(std::memory_order_relaxed);
+    _entry.max = std::max(_entry.max, _slot.max.load(std::memory_order_relaxed));
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline std::vector<tim::component::lock_gotcha::entry>
+tim::component::lock_gotcha::get_entries()
+{
+    return table_type::get_entries();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline std::string
+tim::component::lock_gotcha::get_region(uint64_t _hash)
+{
+    return (_hash == 0) ? std::string{ "(no region)" } : table_type::get_name(_hash);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline std::string
+tim::component::lock_gotcha::get_kind(int _kind)
+{
+    switch(_kind)
+    {
+        case mutex_kind: return "mutex";
+        case rwlock_kind: return "rwlock";
+        case condition_kind: return "condition";
+        case semaphore_kind: return "semaphore";
+        default: break;
+    }
+    return "unknown";
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+tim::component::lock_gotcha::print_report(std::ostream& _os, size_t _limit)
+{
+    struct lock_summary
+    {
+        entry              total   = {};
+        std::vector<entry> regions = {};
+    };
+
+    std::map<const void*, lock_summary> _locks{};
+    for(auto& itr : get_entries())
+    {
+        auto& _total   = _locks[itr.address].total;
+        _total.address = itr.address;
+        _total.kind    = itr.kind;
+        _total.count += itr.count;
+        _total.contended += itr.contended;
+        _total.wait += itr.wait;
+        _total.max = std::max(_total.max, itr.max);
+        _locks[itr.address].regions.emplace_back(itr);
+    }
+
+    auto _compare = [](const entry& _lhs, const entry& _rhs) {
+        return (_lhs.contended == _rhs.contended) ? (_lhs.wait > _rhs.wait)
+                                                  : (_lhs.contended > _rhs.contended);
+    };
+
+    std::vector<lock_summary> _sorted{};
+    std::set<const void*>     _addresses{};
+    for(auto& itr : _locks)
+    {
+        std::sort(itr.second.regions.begin(), itr.second.regions.end(), _compare);
+        _sorted.emplace_back(itr.second);
+    }
+    std::sort(_sorted.begin(), _sorted.end(),
+              [&_compare](const lock_summary& _lhs, const lock_summary& _rhs) {
+                  return _compare(_lhs.total, _rhs.total);
+              });
+    if(_limit > 0 && _sorted.size() > _limit)
+        _sorted.resize(_limit);
+    for(auto& itr : _sorted)
+        _addresses.insert(itr.total.address);
+
+    auto _names   = symbols::resolve(_addresses);
+    auto _dropped = table_type::get_dropped();
+
+    auto _seconds = [](uint64_t _val) {
+        return static_cast<double>(_val) / ratio_t::den;
+    };
+
+    std::stringstream ss;
+    ss << "[" << label() << "]> top " << _sorted.size() << " of " << _locks.size()
+       << " locks (contended = wait >= " << get_persistent_data().threshold.load()
+       << " nsec)";
+    if(_dropped > 0)
+        ss << ", " << _dropped << " calls not recorded because a thread table was full";
+    ss << "\n\n";
+    ss << std::setw(4) << "#"
+       << "  " << std::left << std::setw(40) << "lock / region" << std::right
+       << std::setw(11) << "kind" << std::setw(12) << "calls" << std::setw(12)
+       << "contended" << std::setw(14) << "wait (sec)" << std::setw(14) << "max (sec)"
+       << "\n";
+
+    ss << std::fixed << std::setprecision(6);
+    size_t _n = 0;
+    for(auto& itr : _sorted)
+    {
+        auto& _total = itr.total;
+        ss << std::setw(4) << ++_n << "  " << std::left << std::setw(40)
+           << _names[_total.address] << std::right << std::setw(11)
+           << get_kind(_total.kind) << std::setw(12) << _total.count << std::setw(12)
+           << _total.contended << std::setw(14) << _seconds(_total.wait)
+           << std::setw(14) << _seconds(_total.max) << "\n";
+        for(auto& ritr : itr.regions)
+        {
+            ss << std::setw(4) << ""
+               << "    " << std::left << std::setw(38) << get_region(ritr.region)
+               << std::right << std::setw(11) << "" << std::setw(12) << ritr.count
+               << std::setw(12) << ritr.contended << std::setw(14)
+               << _seconds(ritr.wait) << std::setw(14) << _seconds(ritr.max) << "\n";
+        }
+    }
+    _os << ss.str() << std::flush;
+}
@@ -0,0 +1,314 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/**
+ * \file timemory/components/gotcha/thread_table.hpp
+ * \brief The per-thread tables of the gotcha components which accumulate the wrapped
+ * calls without accessing the storage
+ */
+
+#pragma once
+
+#include "timemory/components/gotcha/backends.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tim
+{
+namespace component
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::component::gotcha_thread_table
+/// \brief The lock-free tables which \ref lock_gotcha and \ref io_gotcha use to
+/// accumulate the wrapped calls. Each thread owns an open-addressing table of N
+/// slots which is keyed by a non-zero key (e.g. the address of a lock or the hash of a
+/// path) and the innermost region of the thread. Only the owning thread writes to its
+/// table so the updates are plain loads and stores and the table can be read while the
+/// thread is running. When a thread exits, its table is folded into the process-wide
+/// entries and released.
+///
+/// The component \c Tp provides <tt>static void fold(EntryT&, const SlotT&)</tt>,
+/// which adds a slot to an entry, and the slot \c SlotT has the
+/// <tt>std::atomic<uint64_t></tt> members \c key and \c region.
+///
+template <typename Tp, typename SlotT, typename EntryT, size_t N>
+struct gotcha_thread_table
+{
+    static_assert((N & (N - 1)) == 0, "the size of the table must be a power of two");
+
+    using atomic_t = std::atomic<uint64_t>;
+    using key_type = std::pair<uint64_t, uint64_t>;
+
+    struct thread_data
+    {
+        atomic_t              total{ 0 };
+        atomic_t              dropped{ 0 };
+        std::vector<uint64_t> regions = {};
+        std::array<SlotT, N>  slots;
+    };
+
+    /// the table of the calling thread or nullptr once the thread has exited
+    static thread_data* get_thread_data();
+
+    /// the slot of a key and region in the table of the calling thread, which is
+    /// initialized by \param _init before it is published. Returns nullptr when the
+    /// table is full
+    template <typename FuncT>
+    static SlotT* get_slot(thread_data* _data, uint64_t _key, uint64_t _region,
+                           FuncT&& _init);
+
+    /// the entries of the exited threads and of the running threads
+    static std::vector<EntryT> get_entries();
+
+    /// the number of calls which were not recorded because a table was full
+    static uint64_t get_dropped();
+
+    /// the innermost region of the calling thread
+    static uint64_t get_region(const thread_data* _data)
+    {
+        return (!_data || _data->regions.empty()) ? 0 : _data->regions.back();
+    }
+
+    static void push_region(uint64_t _region)
+    {
+        auto* _data = get_thread_data();
+        if(_data)
+            _data->regions.emplace_back(_region);
+    }
+
+    static void pop_region(uint64_t _region)
+    {
+        auto* _data = get_thread_data();
+        if(!_data)
+            return;
+        auto& _regions = _data->regions;
+        for(auto itr = _regions.rbegin(); itr != _regions.rend(); ++itr)
+        {
+            if(*itr == _region)
+            {
+                _regions.erase(std::next(itr).base());
+                break;
+            }
+        }
+    }
+
+    /// registers the name of a hash (e.g. of a region) once per thread
+    static void add_name(uint64_t _hash, const std::string& _name);
+
+    /// the registered name of a hash
+    static std::string get_name(uint64_t _hash);
+
+    static void increment(atomic_t& _val, uint64_t _n)
+    {
+        _val.store(_val.load(std::memory_order_relaxed) + _n, std::memory_order_relaxed);
+    }
+
+private:
+    struct persistent_data
+    {
+        std::mutex                      mutex   = {};
+        std::set<thread_data*>          threads = {};
+        std::map<key_type, EntryT>      exited  = {};
+        uint64_t                        dropped = 0;
+        std::map<uint64_t, std::string> names   = {};
+    };
+
+    static persistent_data& get_persistent_data()
+    {
+        // never deleted because the wrappers can be invoked during the static
+        // destruction
+        static auto* _instance = new persistent_data{};
+        return *_instance;
+    }
+
+    static void fold(std::map<key_type, EntryT>& _entries, const thread_data& _data)
+    {
+        for(const auto& itr : _data.slots)
+        {
+            auto _key = itr.key.load(std::memory_order_acquire);
+            if(_key == 0)
+                continue;
+            auto _region = itr.region.load(std::memory_order_relaxed);
+            Tp::fold(_entries[key_type{ _key, _region }], itr);
+        }
+    }
+
+    /// folds the table of an exiting thread into the process-wide entries
+    struct exit_guard
+    {
+        thread_data*& data;
+
+        ~exit_guard()
+        {
+            if(!data)
+                return;
+            gotcha_suppression::auto_toggle _suppress{ gotcha_suppression::get() };
+            auto*                           _data  = data;
+            auto&                           _pdata = get_persistent_data();
+            data                                   = nullptr;
+            std::lock_guard<std::mutex> _lk{ _pdata.mutex };
+            fold(_pdata.exited, *_data);
+            _pdata.dropped += _data->dropped.load();
+            _pdata.threads.erase(_data);
+            delete _data;
+        }
+    };
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp, typename SlotT, typename EntryT, size_t N>
+typename gotcha_thread_table<Tp, SlotT, EntryT, N>::thread_data*
+gotcha_thread_table<Tp, SlotT, EntryT, N>::get_thread_data()
+{
+    static thread_local thread_data* _instance  = nullptr;
+    static thread_local bool         _allocated = false;
+    if(!_instance && !_allocated)
+    {
+        // the allocation and the lock of the registry are not recorded
+        gotcha_suppression::auto_toggle _suppress{ gotcha_suppression::get() };
+        auto&                           _pdata = get_persistent_data();
+        _instance                              = new thread_data{};
+        {
+            std::lock_guard<std::mutex> _lk{ _pdata.mutex };
+            _pdata.threads.emplace(_instance);
+        }
+        // the wrappers which are invoked after the guard is destroyed are not recorded
+        static thread_local exit_guard _guard{ _instance };
+        _allocated = true;
+    }
+    return _instance;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp, typename SlotT, typename EntryT, size_t N>
+template <typename FuncT>
+SlotT*
+gotcha_thread_table<Tp, SlotT, EntryT, N>::get_slot(thread_data* _data, uint64_t _key,
+                                                     uint64_t _region, FuncT&& _init)
+{
+    uint64_t _hash = _key ^ (_region * 0x9e3779b97f4a7c15ULL);
+    for(size_t i = 0; i < N; ++i)
+    {
+        auto& _slot = _data->slots[(_hash + i) & (N - 1)];
+        auto  _cur  = _slot.key.load(std::memory_order_relaxed);
+        if(_cur == 0)
+        {
+            // publish the key after the fields so that readers see a complete key
+            _slot.region.store(_region, std::memory_order_relaxed);
+            _init(_slot);
+            _slot.key.store(_key, std::memory_order_release);
+            return &_slot;
+        }
+        if(_cur == _key && _slot.region.load(std::memory_order_relaxed) == _region)
+            return &_slot;
+    }
+
+    increment(_data->dropped, 1);
+    return nullptr;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp, typename SlotT, typename EntryT, size_t N>
+std::vector<EntryT>
+gotcha_thread_table<Tp, SlotT, EntryT, N>::get_entries()
+{
+    gotcha_suppression::auto_toggle _suppress{ gotcha_suppression::get() };
+    auto&                           _pdata = get_persistent_data();
+    std::lock_guard<std::mutex>     _lk{ _pdata.mutex };
+
+    auto _merged = _pdata.exited;
+    for(const auto* itr : _pdata.threads)
+        fold(_merged, *itr);
+
+    std::vector<EntryT> _entries{};
+    _entries.reserve(_merged.size());
+    for(auto& itr : _merged)
+        _entries.emplace_back(std::move(itr.second));
+    return _entries;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp, typename SlotT, typename EntryT, size_t N>
+uint64_t
+gotcha_thread_table<Tp, SlotT, EntryT, N>::get_dropped()
+{
+    gotcha_suppression::auto_toggle _suppress{ gotcha_suppression::get() };
+    auto&                           _pdata = get_persistent_data();
+    std::lock_guard<std::mutex>     _lk{ _pdata.mutex };
+
+    auto _dropped = _pdata.dropped;
+    for(const auto* itr : _pdata.threads)
+        _dropped += itr->dropped.load();
+    return _dropped;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp, typename SlotT, typename EntryT, size_t N>
+void
+gotcha_thread_table<Tp, SlotT, EntryT, N>::add_name(uint64_t           _hash,
+                                                     const std::string& _name)
+{
+    static thread_local std::set<uint64_t> _known{};
+    if(!_known.insert(_hash).second)
+        return;
+
+    gotcha_suppression::auto_toggle _suppress{ gotcha_suppression::get() };
+    auto&                           _pdata = get_persistent_data();
+    std::lock_guard<std::mutex>     _lk{ _pdata.mutex };
+    _pdata.names.emplace(_hash, _name);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp, typename SlotT, typename EntryT, size_t N>
+std::string
+gotcha_thread_table<Tp, SlotT, EntryT, N>::get_name(uint64_t _hash)
+{
+    gotcha_suppression::auto_toggle _suppress{ gotcha_suppression::get() };
+    auto&                           _pdata = get_persistent_data();
+    std::lock_guard<std::mutex>     _lk{ _pdata.mutex };
+    auto                            itr = _pdata.names.find(_hash);
+    return (itr != _pdata.names.end()) ? itr->second : std::to_string(_hash);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace component
+}  // namespace tim
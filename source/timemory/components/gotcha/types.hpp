@@ -43,6 +43,14 @@
 //
 TIMEMORY_DECLARE_COMPONENT(malloc_gotcha)
 //
+TIMEMORY_DECLARE_COMPONENT(lock_gotcha)
+//
+TIMEMORY_DECLARE_COMPONENT(lock_gotcha_audit)
+//
+TIMEMORY_DECLARE_COMPONENT(io_gotcha)
+//
+TIMEMORY_DECLARE_COMPONENT(io_gotcha_audit)
+//
 TIMEMORY_DECLARE_TEMPLATE_COMPONENT(mpip_handle, typename Toolset, typename Tag)
 
 //--------------------------------------------------------------------------------------//
@@ -65,6 +73,14 @@ struct component_apis<component::gotcha<Nt, ComponentsT, DiffT>>
 //
 TIMEMORY_SET_COMPONENT_API(component::malloc_gotcha, tpls::gotcha, category::external,
                            category::memory, os::supports_linux)
+TIMEMORY_SET_COMPONENT_API(component::lock_gotcha, tpls::gotcha, category::external,
+                           category::timing, os::supports_linux)
+TIMEMORY_SET_COMPONENT_API(component::lock_gotcha_audit, tpls::gotcha, category::external,
+                           os::supports_linux)
+TIMEMORY_SET_COMPONENT_API(component::io_gotcha, tpls::gotcha, category::external,
+                           category::io, category::timing, os::supports_linux)
+TIMEMORY_SET_COMPONENT_API(component::io_gotcha_audit, tpls::gotcha, category::external,
+                           os::supports_linux)
 //
 //--------------------------------------------------------------------------------------//
 //
@@ -73,6 +89,8 @@ TIMEMORY_SET_COMPONENT_API(component::malloc_gotcha, tpls::gotcha, category::ext
 //--------------------------------------------------------------------------------------//
 //
 TIMEMORY_STATISTICS_TYPE(component::malloc_gotcha, double)
+TIMEMORY_STATISTICS_TYPE(component::lock_gotcha, double)
+TIMEMORY_STATISTICS_TYPE(component::io_gotcha, double)
 //
 //--------------------------------------------------------------------------------------//
 //
@@ -84,6 +102,10 @@ TIMEMORY_STATISTICS_TYPE(component::malloc_gotcha, double)
 //
 TIMEMORY_DEFINE_CONCRETE_TRAIT(is_available, tpls::gotcha, false_type)
 TIMEMORY_DEFINE_CONCRETE_TRAIT(is_available, component::malloc_gotcha, false_type)
+TIMEMORY_DEFINE_CONCRETE_TRAIT(is_available, component::lock_gotcha, false_type)
+TIMEMORY_DEFINE_CONCRETE_TRAIT(is_available, component::lock_gotcha_audit, false_type)
+TIMEMORY_DEFINE_CONCRETE_TRAIT(is_available, component::io_gotcha, false_type)
+TIMEMORY_DEFINE_CONCRETE_TRAIT(is_available, component::io_gotcha_audit, false_type)
 //
 namespace tim
 {
@@ -125,6 +147,18 @@ TIMEMORY_DEFINE_CONCRETE_TRAIT(uses_memory_units, component::malloc_gotcha, true
 //
 //--------------------------------------------------------------------------------------//
 //
+//                              IS TIMING CATEGORY
+//                              USES TIMING UNITS
+//
+//--------------------------------------------------------------------------------------//
+//
+TIMEMORY_DEFINE_CONCRETE_TRAIT(is_timing_category, component::lock_gotcha, true_type)
+TIMEMORY_DEFINE_CONCRETE_TRAIT(uses_timing_units, component::lock_gotcha, true_type)
+TIMEMORY_DEFINE_CONCRETE_TRAIT(is_timing_category, component::io_gotcha, true_type)
+TIMEMORY_DEFINE_CONCRETE_TRAIT(uses_timing_units, component::io_gotcha, true_type)
+//
+//--------------------------------------------------------------------------------------//
+//
 //                              IS GOTCHA
 //                              START PRIORITY
 //                              STOP PRIORITY
@@ -363,6 +363,23 @@
         }
 #endif
 
+//
+//--------------------------------------------------------------------------------------//
+//
+#if !defined(TIMEMORY_STATISTICS_QUANTILES)
+#    define TIMEMORY_STATISTICS_QUANTILES(COMPONENT, TYPE)                               \
+        TIMEMORY_STATISTICS_TYPE(COMPONENT, TYPE)                                        \
+        namespace tim                                                                    \
+        {                                                                                \
+        namespace policy                                                                 \
+        {                                                                                \
+        template <>                                                                      \
+        struct record_statistics<COMPONENT, TYPE> : record_quantiles<COMPONENT, TYPE>    \
+        {};                                                                              \
+        }                                                                                \
+        }
+#endif
+
 //======================================================================================//
 //
 //      EXTERN TEMPLATE DECLARE AND INSTANTIATE
@@ -0,0 +1,349 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/**
+ * \file timemory/components/perf/components.hpp
+ * \brief Implementation of the perf component(s)
+ */
+
+#pragma once
+
+#include "timemory/components/base.hpp"
+#include "timemory/mpl/apply.hpp"
+#include "timemory/mpl/policy.hpp"
+#include "timemory/mpl/types.hpp"
+#include "timemory/settings/declaration.hpp"
+
+#include "timemory/components/perf/backends.hpp"
+#include "timemory/components/perf/types.hpp"
+
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//======================================================================================//
+//
+namespace tim
+{
+namespace component
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::component::perf_counters
+/// \brief Hardware and software counters collected via the Linux perf_event_open
+/// system call, i.e. without PAPI. The events are configured via `TIMEMORY_PERF_EVENTS`
+/// (comma-delimited, see `perf list`) or `perf_counters::get_initializer()` and are
+/// opened once per thread as a single group so each start/stop is one read() of the
+/// group leader (or a user-space rdpmc when the kernel allows it and
+/// `TIMEMORY_PERF_RDPMC` is enabled). Software events such as "task-clock",
+/// "page-faults", "context-switches", and "cpu-migrations" do not require a PMU and
+/// are available to unprivileged users in containers.
+///
+struct perf_counters : public base<perf_counters, std::vector<int64_t>>
+{
+    using size_type         = size_t;
+    using event_list        = std::vector<std::string>;
+    using value_type        = std::vector<int64_t>;
+    using entry_type        = typename value_type::value_type;
+    using this_type         = perf_counters;
+    using base_type         = base<this_type, value_type>;
+    using storage_type      = typename base_type::storage_type;
+    using get_initializer_t = std::function<event_list()>;
+    using group_type        = perf::event_group;
+
+    static const short precision = 3;
+    static const short width     = 8;
+
+    //----------------------------------------------------------------------------------//
+
+    static std::string label() { return "perf_counters"; }
+    static std::string description()
+    {
+        return "Hardware and software counters via the Linux perf_event_open interface";
+    }
+
+    //----------------------------------------------------------------------------------//
+
+    static get_initializer_t& get_initializer()
+    {
+        static get_initializer_t _instance = []() {
+            event_list _names{};
+            for(const auto& itr :
+                perf::get_event_info(settings::perf_events(), &std::cerr))
+                _names.emplace_back(itr.name);
+            return _names;
+        };
+        return _instance;
+    }
+
+    /// the events collected by every thread. Set when the first thread starts (or
+    /// configure() is called) and fixed afterwards so all instances have the same size
+    static event_list& get_events()
+    {
+        static event_list _instance = get_initializer()();
+        return _instance;
+    }
+
+    /// the counters of the calling thread
+    static group_type& get_group()
+    {
+        static thread_local group_type _instance{};
+        return _instance;
+    }
+
+    static void configure() { get_events() = get_initializer()(); }
+    static void thread_init() { open(); }
+    static void thread_finalize() { get_group().close(); }
+
+    /// opens the counters of the calling thread if they are not already open
+    static bool open()
+    {
+        auto&       _group  = get_group();
+        const auto& _events = get_events();
+        bool        _same   = (_group.size() == _events.size());
+        for(size_t i = 0; _same && i < _events.size(); ++i)
+            _same = (_group.events().at(i).name == _events.at(i));
+        if(_same)
+            return _group.is_open();
+
+        std::vector<perf::event_info> _info{};
+        for(const auto& itr : _events)
+            _info.emplace_back(perf::get_event_info(itr));
+        std::ostream* _err = (settings::verbose() >= 0 || settings::debug())
+                                 ? &std::cerr
+                                 : nullptr;
+        return _group.open(_info, settings::perf_inherit(), settings::perf_rdpmc(), _err);
+    }
+
+    static value_type record()
+    {
+        value_type _value(get_events().size(), 0);
+        if(open())
+            get_group().read(_value.data());
+        return _value;
+    }
+
+    //----------------------------------------------------------------------------------//
+
+    perf_counters()
+    : events(get_events())
+    {
+        value.resize(events.size(), 0);
+        accum.resize(events.size(), 0);
+    }
+
+    ~perf_counters()                            = default;
+    perf_counters(const perf_counters&)         = default;
+    perf_counters(perf_counters&&) noexcept     = default;
+    perf_counters& operator=(const perf_counters&) = default;
+    perf_counters& operator=(perf_counters&&) noexcept = default;
+
+    //----------------------------------------------------------------------------------//
+
+    size_t size() const { return events.size(); }
+
+    void start()
+    {
+        value.resize(events.size(), 0);
+        if(open())
+            get_group().read(value.data());
+    }
+
+    void stop()
+    {
+        // read into per-thread scratch space so stop() does not allocate
+        static thread_local value_type _now{};
+        _now.resize(events.size(), 0);
+        if(open())
+            get_group().read(_now.data());
+
+        accum.resize(events.size(), 0);
+        for(size_type i = 0; i < events.size(); ++i)
+        {
+            value[i] = _now[i] - value[i];
+            accum[i] += value[i];
+        }
+    }
+
+    //----------------------------------------------------------------------------------//
+
+    this_type& operator+=(const this_type& rhs)
+    {
+        using namespace tim::component::operators;
+        value += rhs.value;
+        accum += rhs.accum;
+        if(rhs.is_transient)
+            is_transient = rhs.is_transient;
+        return *this;
+    }
+
+    this_type& operator-=(const this_type& rhs)
+    {
+        using namespace tim::component::operators;
+        value -= rhs.value;
+        accum -= rhs.accum;
+        if(rhs.is_transient)
+            is_transient = rhs.is_transient;
+        return *this;
+    }
+
+    //----------------------------------------------------------------------------------//
+
+    template <typename Tp = double>
+    std::vector<Tp> get() const
+    {
+        std::vector<Tp> _values{};
+        const auto&     _data = (is_transient) ? accum : value;
+        for(const auto& itr : _data)
+            _values.emplace_back(itr);
+        _values.resize(events.size());
+        return _values;
+    }
+
+    entry_type get_display(int idx) const
+    {
+        const auto& _data = (is_transient) ? accum : value;
+        return (static_cast<size_t>(idx) < _data.size()) ? _data[idx] : 0;
+    }
+
+    //----------------------------------------------------------------------------------//
+    // load
+    //
+    template <typename Archive>
+    void CEREAL_LOAD_FUNCTION_NAME(Archive& ar, const unsigned int)
+    {
+        ar(cereal::make_nvp("is_transient", is_transient), cereal::make_nvp("laps", laps),
+           cereal::make_nvp("value", value), cereal::make_nvp("accum", accum),
+           cereal::make_nvp("events", events));
+    }
+
+    //----------------------------------------------------------------------------------//
+    // save
+    //
+    template <typename Archive>
+    void CEREAL_SAVE_FUNCTION_NAME(Archive& ar, const unsigned int) const
+    {
+        auto                sz = events.size();
+        std::vector<double> _disp(sz, 0.0);
+        for(size_type i = 0; i < sz; ++i)
+            _disp[i] = get_display(i);
+        ar(cereal::make_nvp("is_transient", is_transient), cereal::make_nvp("laps", laps),
+           cereal::make_nvp("repr_data", _disp), cereal::make_nvp("value", value),
+           cereal::make_nvp("accum", accum), cereal::make_nvp("display", _disp),
+           cereal::make_nvp("events", events));
+    }
+
+    //----------------------------------------------------------------------------------//
+    // array of labels
+    //
+    std::vector<std::string> label_array() const
+    {
+        std::vector<std::string> arr = events;
+        for(auto& itr : arr)
+        {
+            for(auto& c : itr)
+            {
+                if(c == '-' || c == ':')
+                    c = '_';
+            }
+        }
+        return arr;
+    }
+
+    //----------------------------------------------------------------------------------//
+    // array of descriptions
+    //
+    std::vector<std::string> description_array() const
+    {
+        std::vector<std::string> arr(events.size(), "");
+        for(size_type i = 0; i < events.size(); ++i)
+            arr[i] = perf::get_event_info(events[i]).description;
+        return arr;
+    }
+
+    //----------------------------------------------------------------------------------//
+    // array of units
+    //
+    std::vector<std::string> display_unit_array() const
+    {
+        std::vector<std::string> arr(events.size(), "");
+        for(size_type i = 0; i < events.size(); ++i)
+            arr[i] = perf::get_event_info(events[i]).units;
+        return arr;
+    }
+
+    //----------------------------------------------------------------------------------//
+    // array of unit values
+    //
+    std::vector<int64_t> unit_array() const
+    {
+        return std::vector<int64_t>(events.size(), 1);
+    }
+
+    //----------------------------------------------------------------------------------//
+
+    string_t get_display() const
+    {
+        if(events.empty())
+            return "";
+        auto _prec  = base_type::get_precision();
+        auto _width = base_type::get_width();
+        auto _flags = base_type::get_format_flags();
+
+        std::stringstream ss;
+        for(size_type i = 0; i < events.size(); ++i)
+        {
+            auto              _units = perf::get_event_info(events[i]).units;
+            std::stringstream ssv;
+            ssv.setf(_flags);
+            ssv << std::setw(_width) << std::setprecision(_prec) << get_display(i);
+            if(!_units.empty())
+                ssv << " " << _units;
+            ss << ssv.str() << " " << events[i];
+            if(i + 1 < events.size())
+                ss << ", ";
+        }
+        return ss.str();
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const this_type& obj)
+    {
+        os << obj.get_display();
+        return os;
+    }
+
+    const event_list& get_event_names() const { return events; }
+
+private:
+    event_list events = {};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace component
+}  // namespace tim
@@ -34,6 +34,7 @@
 #include "timemory/components/roofline/types.hpp"
 #include "timemory/components/timing/wall_clock.hpp"
 
+#include "timemory/ert/cache.hpp"
 #include "timemory/ert/configuration.hpp"
 #include "timemory/ert/extern.hpp"
 
@@ -102,6 +103,8 @@ struct cpu_roofline
     using ert_executor_type = ert::executor<device_t, Tp, count_type>;
     template <typename Tp>
     using ert_callback_type = ert::callback<ert_executor_type<Tp>>;
+    template <typename Tp>
+    using ert_cached_executor_type = ert::cache::executor<device_t, Tp, count_type>;
 
     // variadic expansion for ERT types
     using ert_config_t   = std::tuple<ert_config_type<Types>...>;
@@ -109,6 +112,8 @@ struct cpu_roofline
     using ert_executor_t = std::tuple<ert_executor_type<Types>...>;
     using ert_callback_t = std::tuple<ert_callback_type<Types>...>;
 
+    using ert_cached_executor_t = std::tuple<ert_cached_executor_type<Types>...>;
+
     static_assert(std::tuple_size<ert_config_t>::value ==
                       std::tuple_size<types_tuple>::value,
                   "Error! ert_config_t size does not match types_tuple size!");
@@ -290,6 +295,8 @@ struct cpu_roofline
     static void set_executor_callback(FuncT&& f)
     {
         ert_executor_type<Tp>::get_callback() = std::forward<FuncT>(f);
+        // the cache cannot identify custom kernels
+        ert_cached_executor_type<Tp>::bypass() = true;
     }
 
     //----------------------------------------------------------------------------------//
@@ -300,10 +307,11 @@ struct cpu_roofline
         // auto ci = get_env<bool>("CONTINUOUS_INTEGRATION", false);
         if(_store && _store->size() > 0)
         {
-            // run roofline peak generation
+            // run roofline peak generation or reuse the results from a previous run
+            // on the same hardware
             auto ert_config = get_finalizer();
             auto ert_data   = get_ert_data();
-            apply<void>::access<ert_executor_t>(ert_config, ert_data);
+            apply<void>::access<ert_cached_executor_t>(ert_config, ert_data);
             if(ert_data && (settings::verbose() > 1 || settings::debug()))
                 std::cout << *(ert_data) << std::endl;
         }
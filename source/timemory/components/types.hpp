@@ -188,6 +188,7 @@ struct timeline_scope : scope::timeline
 #include "timemory/components/likwid/types.hpp"
 #include "timemory/components/ompt/types.hpp"
 #include "timemory/components/papi/types.hpp"
+#include "timemory/components/perf/types.hpp"
 #include "timemory/components/roofline/types.hpp"
 #include "timemory/components/rusage/types.hpp"
 #include "timemory/components/tau_marker/types.hpp"
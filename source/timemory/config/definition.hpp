@@ -42,6 +42,8 @@
 #    include "timemory/settings/declaration.hpp"
 #    include "timemory/utility/signals.hpp"
 #    include "timemory/utility/utility.hpp"
+#    include "timemory/variadic/subsample.hpp"
+#    include "timemory/variadic/throttle.hpp"
 
 #    include <string>
 
@@ -138,6 +140,8 @@ timemory_init(int argc, char** argv, const std::string& _prefix,
         _settings->get_output_path() = exe_name;
         // allow environment overrides
         settings::parse(_settings);
+        throttle::configure();
+        subsample::configure();
 
         if(_settings->get_enable_signal_handler())
         {
@@ -356,6 +360,9 @@ timemory_argparse(int* argc, char*** argv, argparse::argument_parser* parser,
     if(parser->exists("help"))
         help_action(*parser);
 
+    throttle::configure();
+    subsample::configure();
+
     // cleanup if argparse was not provided
     if(_cleanup_parser)
         delete parser;
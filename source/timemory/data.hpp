@@ -26,5 +26,7 @@
 
 #include "timemory/data/functional.hpp"
 #include "timemory/data/handler.hpp"
+#include "timemory/data/quantile_sketch.hpp"
+#include "timemory/data/small_vector.hpp"
 #include "timemory/data/statistics.hpp"
 #include "timemory/data/stream.hpp"
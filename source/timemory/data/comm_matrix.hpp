@@ -0,0 +1,337 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/** \file timemory/data/comm_matrix.hpp
+ * \headerfile timemory/data/comm_matrix.hpp "timemory/data/comm_matrix.hpp"
+ * Provides a rank-by-rank communication matrix and per-function log2 message-size
+ * histograms which are accumulated in per-thread counters and reduced once
+ *
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------//
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tim
+{
+namespace data
+{
+//======================================================================================//
+//
+/// \class tim::data::comm_matrix
+/// \brief Records the bytes and the number of messages sent from this rank to every
+/// other rank and a histogram of the message sizes of each tracked function. Sizes
+/// are binned by powers of two: bucket zero holds empty messages and bucket `b > 0`
+/// holds sizes in [2^(b-1), 2^b).
+///
+/// Each thread increments its own block of counters so the recording functions never
+/// lock or issue atomic read-modify-write instructions; a mutex is only taken the
+/// first time a thread records into an instance. \ref pack sums the blocks of every
+/// thread into a flat buffer. The concatenation of the packed buffers of all ranks
+/// (e.g. from a single MPI_Gather) is the input to the accessors and \ref write.
+///
+class comm_matrix
+{
+public:
+    using count_type   = uint64_t;
+    using counter_type = std::atomic<count_type>;
+    using buffer_type  = std::vector<count_type>;
+    using strvec_type  = std::vector<std::string>;
+
+    static constexpr size_t num_buckets = 64;
+
+    comm_matrix(size_t _nranks, strvec_type _funcs)
+    : m_id{ get_next_id() }
+    , m_nranks{ _nranks }
+    , m_funcs{ std::move(_funcs) }
+    {
+        for(size_t i = 0; i < m_funcs.size(); ++i)
+            m_index.emplace(m_funcs.at(i), i);
+    }
+
+    ~comm_matrix()                  = default;
+    comm_matrix(const comm_matrix&) = delete;
+    comm_matrix(comm_matrix&&)      = delete;
+    comm_matrix& operator=(const comm_matrix&) = delete;
+    comm_matrix& operator=(comm_matrix&&) = delete;
+
+    size_t             ranks() const { return m_nranks; }
+    const strvec_type& functions() const { return m_funcs; }
+
+    /// number of threads which recorded into this instance
+    size_t num_threads() const
+    {
+        std::lock_guard<std::mutex> _lk{ m_mutex };
+        return m_threads.size();
+    }
+
+    /// index of the function or -1 if it is not tracked
+    int64_t index(const std::string& _func) const
+    {
+        auto itr = m_index.find(_func);
+        return (itr == m_index.end()) ? -1 : static_cast<int64_t>(itr->second);
+    }
+
+    /// histogram bucket of a message of \param _bytes
+    static size_t bucket(count_type _bytes)
+    {
+        size_t _b = 0;
+        while(_bytes > 0 && _b + 1 < num_buckets)
+        {
+            _bytes >>= 1;
+            ++_b;
+        }
+        return _b;
+    }
+
+    /// smallest message size in bucket \param _b
+    static count_type bucket_size(size_t _b)
+    {
+        return (_b == 0) ? 0 : (static_cast<count_type>(1) << (_b - 1));
+    }
+
+    /// a message of \param _bytes from this rank to \param _dst by function \param _func
+    void add_message(size_t _func, size_t _dst, count_type _bytes)
+    {
+        auto* _data = get_thread_data();
+        add_transfer(_data, _dst, _bytes);
+        add_size(_data, _func, _bytes);
+    }
+
+    /// only the matrix entry, e.g. one of the transfers of a collective
+    void add_transfer(size_t _dst, count_type _bytes)
+    {
+        add_transfer(get_thread_data(), _dst, _bytes);
+    }
+
+    /// only the histogram entry, e.g. a receive or a collective whose communication
+    /// pattern is implementation-defined
+    void add_size(size_t _func, count_type _bytes)
+    {
+        add_size(get_thread_data(), _func, _bytes);
+    }
+
+    /// number of entries in the packed buffer of one rank
+    size_t packed_size() const
+    {
+        return 2 * m_nranks + m_funcs.size() * (2 + num_buckets);
+    }
+
+    /// sum of the counters of every thread
+    buffer_type pack() const
+    {
+        buffer_type _buffer(packed_size(), 0);
+        std::lock_guard<std::mutex> _lk{ m_mutex };
+        for(const auto& itr : m_threads)
+        {
+            for(size_t i = 0; i < _buffer.size(); ++i)
+                _buffer[i] += itr[i].load(std::memory_order_relaxed);
+        }
+        return _buffer;
+    }
+
+    /// whether \param _gathered is the packed buffers of every rank
+    bool is_valid(const buffer_type& _gathered) const
+    {
+        return _gathered.size() == m_nranks * packed_size();
+    }
+
+    /// bytes sent from \param _src to \param _dst
+    count_type bytes(const buffer_type& _gathered, size_t _src, size_t _dst) const
+    {
+        return _gathered.at(_src * packed_size() + _dst);
+    }
+
+    /// messages sent from \param _src to \param _dst
+    count_type messages(const buffer_type& _gathered, size_t _src, size_t _dst) const
+    {
+        return _gathered.at(_src * packed_size() + m_nranks + _dst);
+    }
+
+    /// calls to function \param _func summed over the ranks
+    count_type calls(const buffer_type& _gathered, size_t _func) const
+    {
+        return reduce(_gathered, func_offset(_func));
+    }
+
+    /// bytes communicated by function \param _func summed over the ranks
+    count_type total_bytes(const buffer_type& _gathered, size_t _func) const
+    {
+        return reduce(_gathered, func_offset(_func) + 1);
+    }
+
+    /// message-size histogram of function \param _func summed over the ranks
+    buffer_type histogram(const buffer_type& _gathered, size_t _func) const
+    {
+        buffer_type _hist(num_buckets, 0);
+        for(size_t i = 0; i < num_buckets; ++i)
+            _hist[i] = reduce(_gathered, func_offset(_func) + 2 + i);
+        return _hist;
+    }
+
+    /// writes the bytes matrix, the messages matrix, and the non-empty histograms
+    void write(std::ostream& _os, const buffer_type& _gathered) const
+    {
+        if(!is_valid(_gathered))
+        {
+            _os << "# invalid communication matrix data: expected "
+                << m_nranks * packed_size() << " entries, found " << _gathered.size()
+                << '\n';
+            return;
+        }
+
+        auto _write_matrix = [&](const char* _label, size_t _offset) {
+            _os << "#\n# " << _label
+                << " [row = sending rank, column = receiving rank]\n";
+            for(size_t i = 0; i < m_nranks; ++i)
+            {
+                for(size_t j = 0; j < m_nranks; ++j)
+                    _os << ((j == 0) ? "" : " ")
+                        << _gathered.at(i * packed_size() + _offset + j);
+                _os << '\n';
+            }
+        };
+
+        _os << "# timemory MPI communication matrix\n";
+        _os << "# ranks: " << m_nranks << '\n';
+        _write_matrix("bytes sent", 0);
+        _write_matrix("messages sent", m_nranks);
+        _os << "#\n# message sizes [function, calls, bytes, then size:count for each "
+               "non-empty bucket where the bucket holds sizes in [size, 2 * size)]\n";
+        for(size_t i = 0; i < m_funcs.size(); ++i)
+        {
+            auto _calls = calls(_gathered, i);
+            if(_calls == 0)
+                continue;
+            _os << m_funcs.at(i) << ' ' << _calls << ' ' << total_bytes(_gathered, i);
+            auto _hist = histogram(_gathered, i);
+            for(size_t j = 0; j < num_buckets; ++j)
+            {
+                if(_hist.at(j) > 0)
+                    _os << ' ' << bucket_size(j) << ':' << _hist.at(j);
+            }
+            _os << '\n';
+        }
+    }
+
+private:
+    // only the owning thread writes to a counter so a relaxed load and store suffices
+    static void increment(counter_type& _v, count_type _n)
+    {
+        _v.store(_v.load(std::memory_order_relaxed) + _n, std::memory_order_relaxed);
+    }
+
+    static uint64_t get_next_id()
+    {
+        static std::atomic<uint64_t> _id{ 0 };
+        return ++_id;
+    }
+
+    size_t func_offset(size_t _func) const
+    {
+        return 2 * m_nranks + _func * (2 + num_buckets);
+    }
+
+    count_type reduce(const buffer_type& _gathered, size_t _offset) const
+    {
+        count_type _sum = 0;
+        for(size_t i = 0; i < m_nranks; ++i)
+            _sum += _gathered.at(i * packed_size() + _offset);
+        return _sum;
+    }
+
+    void add_transfer(counter_type* _data, size_t _dst, count_type _bytes)
+    {
+        if(_dst >= m_nranks)
+            return;
+        increment(_data[_dst], _bytes);
+        increment(_data[m_nranks + _dst], 1);
+    }
+
+    void add_size(counter_type* _data, size_t _func, count_type _bytes)
+    {
+        if(_func >= m_funcs.size())
+            return;
+        auto* _fdata = _data + func_offset(_func);
+        increment(_fdata[0], 1);
+        increment(_fdata[1], _bytes);
+        increment(_fdata[2 + bucket(_bytes)], 1);
+    }
+
+    // the instance id instead of the address identifies the cached block so a new
+    // instance at the address of a destroyed one does not reuse a dangling block. The
+    // block of the last instance is checked first and the blocks of every instance
+    // the thread recorded into are kept so a thread which alternates between two
+    // instances keeps using one block per instance
+    counter_type* get_thread_data()
+    {
+        using cache_type = std::unordered_map<uint64_t, counter_type*>;
+
+        static thread_local uint64_t      _id    = 0;
+        static thread_local counter_type* _data  = nullptr;
+        static thread_local cache_type    _cache = {};
+        if(_id == m_id && _data)
+            return _data;
+
+        auto& _block = _cache[m_id];
+        if(!_block)
+        {
+            thread_block_t _new{ new counter_type[packed_size()] };
+            for(size_t i = 0; i < packed_size(); ++i)
+                _new[i].store(0, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> _lk{ m_mutex };
+            m_threads.emplace_back(std::move(_new));
+            _block = m_threads.back().get();
+        }
+        _id   = m_id;
+        _data = _block;
+        return _data;
+    }
+
+private:
+    using thread_block_t = std::unique_ptr<counter_type[]>;
+
+    uint64_t                                m_id     = 0;
+    size_t                                  m_nranks = 0;
+    strvec_type                             m_funcs  = {};
+    std::unordered_map<std::string, size_t> m_index  = {};
+    mutable std::mutex                      m_mutex{};
+    std::vector<thread_block_t>             m_threads = {};
+};
+//
+//======================================================================================//
+//
+}  // namespace data
+}  // namespace tim
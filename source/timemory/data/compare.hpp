@@ -0,0 +1,571 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/** \file timemory/data/compare.hpp
+ * \headerfile timemory/data/compare.hpp "timemory/data/compare.hpp"
+ * Provides a component-agnostic comparison of two sets of results (e.g. a baseline
+ * and a nightly run) which flags statistically significant regressions
+ *
+ */
+
+#pragma once
+
+#include "timemory/tpls/cereal/archives.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tim
+{
+namespace data
+{
+namespace compare
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+enum class verdict : short
+{
+    unchanged = 0,
+    improved,
+    regressed,
+    added,
+    removed
+};
+//
+inline const char*
+as_string(verdict _v)
+{
+    switch(_v)
+    {
+        case verdict::unchanged: return "unchanged";
+        case verdict::improved: return "improved";
+        case verdict::regressed: return "regressed";
+        case verdict::added: return "added";
+        case verdict::removed: return "removed";
+    }
+    return "unknown";
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::data::compare::config
+/// \brief Thresholds which must all be exceeded for a difference to be significant
+///
+struct config
+{
+    double  relative         = 0.05;   ///< min relative change of the mean
+    double  absolute         = 0.0;    ///< min absolute change of the mean
+    double  tscore           = 3.0;    ///< min Welch t-score (when variance is known)
+    int64_t min_count        = 1;      ///< entries w/ fewer samples are never flagged
+    bool    higher_is_better = false;  ///< e.g. rates instead of times
+    bool    fail_on_removed  = false;  ///< removed regions count as a failure
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::data::compare::record
+/// \brief The statistics of one node of the call-graph. Multi-valued components
+/// (e.g. hardware counters) have one sum/sqr entry per value
+///
+struct record
+{
+    uint64_t            rolling_hash = 0;
+    int64_t             depth        = 0;
+    int64_t             count        = 0;
+    std::string         prefix       = {};
+    std::vector<double> sum          = {};
+    std::vector<double> sqr          = {};
+
+    size_t size() const { return sum.size(); }
+
+    double mean(size_t i) const
+    {
+        return (count > 0 && i < sum.size()) ? (sum.at(i) / count) : 0.0;
+    }
+
+    double variance(size_t i) const
+    {
+        if(count < 2 || i >= sqr.size() || i >= sum.size())
+            return 0.0;
+        auto _sum = sum.at(i);
+        return std::max<double>((sqr.at(i) - (_sum * _sum) / count) / (count - 1), 0.0);
+    }
+
+    record& operator+=(const record& rhs)
+    {
+        if(sum.size() < rhs.sum.size())
+            sum.resize(rhs.sum.size(), 0.0);
+        if(sqr.size() < rhs.sqr.size())
+            sqr.resize(rhs.sqr.size(), 0.0);
+        for(size_t i = 0; i < rhs.sum.size(); ++i)
+            sum.at(i) += rhs.sum.at(i);
+        for(size_t i = 0; i < rhs.sqr.size(); ++i)
+            sqr.at(i) += rhs.sqr.at(i);
+        count += rhs.count;
+        return *this;
+    }
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::data::compare::result_set
+/// \brief The records of one component, per rank
+///
+struct result_set
+{
+    using record_vector_t = std::vector<record>;
+
+    std::string                  label = {};
+    std::string                  units = {};
+    std::vector<record_vector_t> ranks = {};
+
+    size_t size() const
+    {
+        size_t _n = 0;
+        for(const auto& itr : ranks)
+            _n += itr.size();
+        return _n;
+    }
+
+    /// combine the records of all the ranks into a single rank
+    void merge_ranks();
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::data::compare::entry
+/// \brief The comparison of one metric of one node
+///
+struct entry
+{
+    const record* baseline = nullptr;
+    const record* current  = nullptr;
+    size_t        rank     = 0;
+    size_t        index    = 0;
+    verdict       result   = verdict::unchanged;
+    double        delta    = 0.0;  ///< current mean - baseline mean
+    double        relative = 0.0;  ///< delta / baseline mean
+    double        tscore   = 0.0;  ///< zero when the variance is unknown
+
+    const record* get() const { return (current) ? current : baseline; }
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::data::compare::summary
+/// \brief The result of comparing two result sets
+///
+struct summary
+{
+    std::string        label   = {};
+    std::string        units   = {};
+    std::vector<entry> entries = {};
+
+    size_t count(verdict _v) const
+    {
+        return std::count_if(entries.begin(), entries.end(),
+                             [_v](const entry& itr) { return itr.result == _v; });
+    }
+
+    bool passed(const config& _cfg) const
+    {
+        return count(verdict::regressed) == 0 &&
+               (!_cfg.fail_on_removed || count(verdict::removed) == 0);
+    }
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+namespace impl
+{
+struct key_hash
+{
+    size_t operator()(const std::pair<uint64_t, int64_t>& _key) const
+    {
+        // the rolling hash is already well-distributed, just mix in the depth
+        auto _depth = static_cast<uint64_t>(_key.second) * 0x9e3779b97f4a7c15;
+        return static_cast<size_t>(_key.first ^ _depth);
+    }
+};
+//
+using key_type = std::pair<uint64_t, int64_t>;
+template <typename Tp>
+using map_type = std::unordered_map<key_type, Tp, key_hash>;
+//
+template <typename ValueT>
+void
+read_values(const ValueT& _val, std::vector<double>& _data)
+{
+    _data.clear();
+    if(_val.IsNumber())
+        _data.emplace_back(_val.GetDouble());
+    else if(_val.IsArray())
+    {
+        _data.reserve(_val.Size());
+        for(auto itr = _val.Begin(); itr != _val.End(); ++itr)
+        {
+            if(itr->IsNumber())
+                _data.emplace_back(itr->GetDouble());
+        }
+    }
+}
+//
+template <typename ValueT>
+const ValueT*
+find_member(const ValueT& _val, const char* _key)
+{
+    if(!_val.IsObject())
+        return nullptr;
+    auto itr = _val.FindMember(_key);
+    return (itr == _val.MemberEnd()) ? nullptr : &itr->value;
+}
+//
+template <typename ValueT>
+bool
+read_record(const ValueT& _node, record& _rec)
+{
+    auto* _rhash = find_member(_node, "rolling_hash");
+    auto* _depth = find_member(_node, "depth");
+    if(!_rhash || !_depth || !_rhash->IsUint64() || !_depth->IsInt64())
+        return false;
+
+    _rec.rolling_hash = _rhash->GetUint64();
+    _rec.depth        = _depth->GetInt64();
+
+    auto* _prefix = find_member(_node, "prefix");
+    if(_prefix && _prefix->IsString())
+        _rec.prefix = _prefix->GetString();
+
+    // prefer the statistics since they provide the variance
+    auto* _stats = find_member(_node, "stats");
+    auto* _count = (_stats) ? find_member(*_stats, "count") : nullptr;
+    auto* _sum   = (_stats) ? find_member(*_stats, "sum") : nullptr;
+    auto* _sqr   = (_stats) ? find_member(*_stats, "sqr") : nullptr;
+    if(_count && _sum && _count->IsInt64() && _count->GetInt64() > 0)
+    {
+        _rec.count = _count->GetInt64();
+        read_values(*_sum, _rec.sum);
+        if(_sqr)
+            read_values(*_sqr, _rec.sqr);
+        return true;
+    }
+
+    // fall back to the accumulated value of the component (no variance)
+    auto* _entry = find_member(_node, "entry");
+    auto* _laps  = (_entry) ? find_member(*_entry, "laps") : nullptr;
+    auto* _repr  = (_entry) ? find_member(*_entry, "repr_data") : nullptr;
+    if(_laps && _repr && _laps->IsInt64())
+    {
+        _rec.count = std::max<int64_t>(_laps->GetInt64(), 1);
+        read_values(*_repr, _rec.sum);
+        _rec.sqr.clear();
+        return true;
+    }
+    return false;
+}
+}  // namespace impl
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+result_set::merge_ranks()
+{
+    if(ranks.size() < 2)
+        return;
+
+    record_vector_t          _merged{};
+    impl::map_type<size_t>   _index{};
+    _merged.reserve(ranks.front().size());
+    _index.reserve(ranks.front().size());
+    for(auto& ritr : ranks)
+    {
+        for(auto& itr : ritr)
+        {
+            auto _key = impl::key_type{ itr.rolling_hash, itr.depth };
+            auto _idx = _index.find(_key);
+            if(_idx == _index.end())
+            {
+                _index.emplace(_key, _merged.size());
+                _merged.emplace_back(std::move(itr));
+            }
+            else
+            {
+                _merged.at(_idx->second) += itr;
+            }
+        }
+    }
+    ranks.clear();
+    ranks.emplace_back(std::move(_merged));
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// read the JSON output of a single component (i.e. `<label>.json`)
+///
+inline bool
+read_json(std::istream& _is, result_set& _data, std::ostream* _err = nullptr)
+{
+    namespace json = CEREAL_RAPIDJSON_NAMESPACE;
+
+    std::string _contents{ std::istreambuf_iterator<char>{ _is },
+                           std::istreambuf_iterator<char>{} };
+
+    json::Document _doc{};
+    _doc.Parse(_contents.c_str());
+    if(_doc.HasParseError())
+    {
+        if(_err)
+            *_err << "Error parsing JSON at offset " << _doc.GetErrorOffset() << '\n';
+        return false;
+    }
+
+    const json::Value& _top   = _doc;
+    auto*              _root  = impl::find_member(_top, "timemory");
+    auto*              _ranks = (_root) ? impl::find_member(*_root, "ranks") : nullptr;
+    if(!_ranks || !_ranks->IsArray())
+    {
+        if(_err)
+            *_err << "Error! JSON does not contain 'timemory' -> 'ranks'\n";
+        return false;
+    }
+
+    _data.ranks.clear();
+    _data.ranks.reserve(_ranks->Size());
+    for(auto ritr = _ranks->Begin(); ritr != _ranks->End(); ++ritr)
+    {
+        if(_data.label.empty())
+        {
+            auto* _type = impl::find_member(*ritr, "type");
+            if(_type && _type->IsString())
+                _data.label = _type->GetString();
+        }
+        if(_data.units.empty())
+        {
+            auto* _unit = impl::find_member(*ritr, "unit_repr");
+            if(_unit && _unit->IsString())
+                _data.units = _unit->GetString();
+        }
+
+        _data.ranks.emplace_back();
+        auto* _graph = impl::find_member(*ritr, "graph");
+        if(!_graph || !_graph->IsArray())
+            continue;
+
+        auto& _records = _data.ranks.back();
+        _records.reserve(_graph->Size());
+        for(auto itr = _graph->Begin(); itr != _graph->End(); ++itr)
+        {
+            record _rec{};
+            if(impl::read_record(*itr, _rec))
+                _records.emplace_back(std::move(_rec));
+        }
+    }
+    return true;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline bool
+read_json(const std::string& _fname, result_set& _data, std::ostream* _err = nullptr)
+{
+    std::ifstream _ifs{ _fname };
+    if(!_ifs)
+    {
+        if(_err)
+            *_err << "Error opening '" << _fname << "' for input\n";
+        return false;
+    }
+    return read_json(_ifs, _data, _err);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// evaluate the significance of the difference between two records
+///
+inline entry
+evaluate(const record& _base, const record& _curr, size_t _idx, const config& _cfg)
+{
+    entry _entry{ &_base, &_curr, 0, _idx, verdict::unchanged };
+
+    auto _m0         = _base.mean(_idx);
+    auto _m1         = _curr.mean(_idx);
+    _entry.delta     = _m1 - _m0;
+    _entry.relative  = (_m0 != 0.0) ? (_entry.delta / std::abs(_m0))
+                                    : ((_entry.delta != 0.0)
+                                          ? std::numeric_limits<double>::infinity()
+                                          : 0.0);
+    auto _stderr_sqr = 0.0;
+    if(_base.count > 1 && _curr.count > 1)
+        _stderr_sqr = (_base.variance(_idx) / _base.count) +
+                      (_curr.variance(_idx) / _curr.count);
+    if(_stderr_sqr > 0.0)
+        _entry.tscore = _entry.delta / std::sqrt(_stderr_sqr);
+
+    if(_base.count < _cfg.min_count || _curr.count < _cfg.min_count)
+        return _entry;
+    if(std::abs(_entry.relative) < _cfg.relative)
+        return _entry;
+    if(std::abs(_entry.delta) < _cfg.absolute)
+        return _entry;
+    // without the variance, only the thresholds above can be applied
+    if(_stderr_sqr > 0.0 && std::abs(_entry.tscore) < _cfg.tscore)
+        return _entry;
+
+    bool _worse   = (_cfg.higher_is_better) ? (_entry.delta < 0.0) : (_entry.delta > 0.0);
+    _entry.result = (_worse) ? verdict::regressed : verdict::improved;
+    return _entry;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// hash-join the baseline and current results by (rolling hash, depth) and evaluate
+/// each matched node. Unmatched nodes are reported as added or removed. The entries
+/// of the returned summary reference the records of the result sets so they
+/// must outlive the summary.
+///
+inline summary
+compare(const result_set& _base, const result_set& _curr, const config& _cfg = {})
+{
+    summary _summary{};
+    _summary.label = (_curr.label.empty()) ? _base.label : _curr.label;
+    _summary.units = (_curr.units.empty()) ? _base.units : _curr.units;
+    _summary.entries.reserve(std::max<size_t>(_base.size(), _curr.size()));
+
+    const result_set::record_vector_t _empty{};
+    auto _nranks = std::max<size_t>(_base.ranks.size(), _curr.ranks.size());
+    for(size_t r = 0; r < _nranks; ++r)
+    {
+        const auto& _bvec = (r < _base.ranks.size()) ? _base.ranks.at(r) : _empty;
+        const auto& _cvec = (r < _curr.ranks.size()) ? _curr.ranks.at(r) : _empty;
+
+        impl::map_type<const record*> _index{};
+        _index.reserve(_bvec.size());
+        for(const auto& itr : _bvec)
+            _index.emplace(impl::key_type{ itr.rolling_hash, itr.depth }, &itr);
+
+        for(const auto& itr : _cvec)
+        {
+            auto _found = _index.find(impl::key_type{ itr.rolling_hash, itr.depth });
+            if(_found == _index.end())
+            {
+                _summary.entries.emplace_back(
+                    entry{ nullptr, &itr, r, 0, verdict::added });
+                continue;
+            }
+            auto _n = std::min<size_t>(_found->second->size(), itr.size());
+            for(size_t i = 0; i < _n; ++i)
+            {
+                _summary.entries.emplace_back(evaluate(*_found->second, itr, i, _cfg));
+                _summary.entries.back().rank = r;
+            }
+            _index.erase(_found);
+        }
+
+        // whatever remains in the baseline did not appear in the current results
+        for(const auto& itr : _bvec)
+        {
+            if(_index.count(impl::key_type{ itr.rolling_hash, itr.depth }) > 0)
+                _summary.entries.emplace_back(
+                    entry{ &itr, nullptr, r, 0, verdict::removed });
+        }
+    }
+
+    return _summary;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// write a table of the significant entries (or all entries when `_all` is true)
+///
+inline void
+write(std::ostream& _os, const summary& _summary, bool _all = false)
+{
+    std::vector<const entry*> _entries{};
+    size_t                    _width = 8;
+    for(const auto& itr : _summary.entries)
+    {
+        if(!_all && itr.result == verdict::unchanged)
+            continue;
+        _entries.emplace_back(&itr);
+        _width = std::max<size_t>(_width, itr.get()->prefix.length());
+    }
+
+    // largest relative regressions first
+    std::stable_sort(_entries.begin(), _entries.end(),
+                     [](const entry* _lhs, const entry* _rhs) {
+                         if(_lhs->result != _rhs->result)
+                             return _lhs->result > _rhs->result;
+                         return std::abs(_lhs->relative) > std::abs(_rhs->relative);
+                     });
+
+    std::stringstream _ss{};
+    _ss << "[" << _summary.label << "] regressed: " << _summary.count(verdict::regressed)
+        << ", improved: " << _summary.count(verdict::improved)
+        << ", added: " << _summary.count(verdict::added)
+        << ", removed: " << _summary.count(verdict::removed)
+        << ", unchanged: " << _summary.count(verdict::unchanged) << '\n';
+
+    if(!_entries.empty())
+    {
+        _ss << std::setw(10) << std::left << "VERDICT"
+            << " | " << std::setw(4) << "RANK"
+            << " | " << std::setw(_width) << "LABEL"
+            << " | " << std::setw(12) << std::right << "BASELINE"
+            << " | " << std::setw(12) << "CURRENT"
+            << " | " << std::setw(10) << "CHANGE (%)"
+            << " | " << std::setw(8) << "T-SCORE" << '\n';
+        for(const auto& itr : _entries)
+        {
+            auto _base = (itr->baseline) ? itr->baseline->mean(itr->index) : 0.0;
+            auto _curr = (itr->current) ? itr->current->mean(itr->index) : 0.0;
+            auto _pfx  = itr->get()->prefix;
+            if(itr->get()->size() > 1)
+                _pfx += " [" + std::to_string(itr->index) + "]";
+            _ss << std::setw(10) << std::left << as_string(itr->result) << " | "
+                << std::setw(4) << itr->rank << " | " << std::setw(_width) << _pfx
+                << " | " << std::setw(12) << std::right << std::setprecision(6)
+                << _base << " | " << std::setw(12) << _curr << " | " << std::setw(10)
+                << std::fixed << std::setprecision(2) << (100.0 * itr->relative)
+                << " | " << std::setw(8) << itr->tscore << std::defaultfloat << '\n';
+        }
+    }
+    _os << _ss.str() << std::flush;
+}
+//
+}  // namespace compare
+}  // namespace data
+}  // namespace tim
@@ -0,0 +1,513 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/** \file timemory/data/quantile_sketch.hpp
+ * \headerfile timemory/data/quantile_sketch.hpp "timemory/data/quantile_sketch.hpp"
+ * Provides a mergeable, fixed-memory streaming quantile sketch and a statistics type
+ * which maintains the sketch in addition to the count/sum/sqr/min/max
+ *
+ */
+
+#pragma once
+
+//----------------------------------------------------------------------------//
+
+#include "timemory/data/statistics.hpp"
+#include "timemory/tpls/cereal/cereal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tim
+{
+namespace data
+{
+//======================================================================================//
+//
+/// \class tim::data::quantile_sketch
+/// \brief A DDSketch: values are mapped into logarithmically-sized buckets such that
+/// any quantile estimate is within a relative error of `accuracy` of the true value.
+/// The number of buckets per sign is bounded by `max_bins`. When the bound is exceeded,
+/// the lowest buckets are collapsed, so the accuracy guarantee holds for the upper
+/// quantiles. Sketches with the same accuracy merge exactly.
+///
+class quantile_sketch
+{
+public:
+    using count_type = uint64_t;
+    using bins_type  = std::vector<count_type>;
+
+    static constexpr double  default_accuracy = 0.01;
+    static constexpr int32_t default_max_bins = 2048;
+
+    /// contiguous buckets for one sign, bins[0] corresponds to key == offset
+    struct store
+    {
+        int32_t    offset = 0;
+        count_type count  = 0;
+        bins_type  bins   = {};
+
+        bool    empty() const { return count == 0; }
+        int32_t min_key() const { return offset; }
+        int32_t max_key() const { return offset + static_cast<int32_t>(bins.size()) - 1; }
+
+        /// invokes func(key, count) for every bin
+        template <typename FuncT>
+        void for_each(FuncT&& _func) const
+        {
+            for(size_t i = 0; i < bins.size(); ++i)
+                _func(offset + static_cast<int32_t>(i), bins[i]);
+        }
+
+        void add(int32_t _key, count_type _n, int32_t _max_bins)
+        {
+            if(bins.empty())
+            {
+                bins.assign(1, 0);
+                offset = _key;
+            }
+            else if(_key < min_key() || _key > max_key())
+            {
+                resize(std::min(_key, min_key()), std::max(_key, max_key()), _max_bins);
+            }
+            bins.at(std::max(_key, offset) - offset) += _n;
+            count += _n;
+        }
+
+        void merge(const store& rhs, int32_t _max_bins)
+        {
+            if(rhs.empty())
+                return;
+            if(bins.empty())
+            {
+                *this = rhs;
+                resize(min_key(), max_key(), _max_bins);
+                return;
+            }
+            resize(std::min(min_key(), rhs.min_key()), std::max(max_key(), rhs.max_key()),
+                   _max_bins);
+            rhs.for_each([&](int32_t _key, count_type _n) {
+                bins.at(std::max(_key, offset) - offset) += _n;
+            });
+            count += rhs.count;
+        }
+
+        template <typename Archive>
+        void serialize(Archive& ar, const unsigned int)
+        {
+            ar(cereal::make_nvp("offset", offset), cereal::make_nvp("count", count),
+               cereal::make_nvp("bins", bins));
+        }
+
+    private:
+        // extends the range of keys to [lo, hi] and collapses the lowest keys
+        // into the first bin when the range exceeds max_bins
+        void resize(int32_t _lo, int32_t _hi, int32_t _max_bins)
+        {
+            if(_hi - _lo + 1 > _max_bins)
+                _lo = _hi - _max_bins + 1;
+            if(_lo == offset && _hi == max_key())
+                return;
+            bins_type _bins(_hi - _lo + 1, 0);
+            for(size_t i = 0; i < bins.size(); ++i)
+            {
+                auto _key = std::max<int32_t>(offset + static_cast<int32_t>(i), _lo);
+                _bins.at(_key - _lo) += bins.at(i);
+            }
+            offset = _lo;
+            std::swap(bins, _bins);
+        }
+    };
+
+public:
+    quantile_sketch()
+    : quantile_sketch(default_accuracy, default_max_bins)
+    {}
+
+    explicit quantile_sketch(double _accuracy, int32_t _max_bins = default_max_bins)
+    : m_accuracy(_accuracy)
+    , m_max_bins(std::max<int32_t>(_max_bins, 1))
+    , m_gamma((1.0 + _accuracy) / (1.0 - _accuracy))
+    , m_log_gamma(std::log(m_gamma))
+    {}
+
+    ~quantile_sketch()                          = default;
+    quantile_sketch(const quantile_sketch&)     = default;
+    quantile_sketch(quantile_sketch&&) noexcept = default;
+    quantile_sketch& operator=(const quantile_sketch&) = default;
+    quantile_sketch& operator=(quantile_sketch&&) noexcept = default;
+
+public:
+    double     get_accuracy() const { return m_accuracy; }
+    int32_t    get_max_bins() const { return m_max_bins; }
+    count_type get_count() const { return m_zero + m_positive.count + m_negative.count; }
+    bool       empty() const { return get_count() == 0; }
+    size_t get_size() const { return m_positive.bins.size() + m_negative.bins.size(); }
+
+    void reset() { *this = quantile_sketch{ m_accuracy, m_max_bins }; }
+
+    void insert(double _val, count_type _n = 1)
+    {
+        if(_n == 0 || std::isnan(_val))
+            return;
+        if(_val > min_value())
+            m_positive.add(key(_val), _n, m_max_bins);
+        else if(_val < -min_value())
+            m_negative.add(key(-_val), _n, m_max_bins);
+        else
+            m_zero += _n;
+    }
+
+    /// returns the estimate of the value at quantile q in [0, 1]
+    double get_quantile(double _q) const
+    {
+        auto _count = get_count();
+        if(_count == 0)
+            return 0.0;
+
+        _q         = std::min<double>(std::max<double>(_q, 0.0), 1.0);
+        auto _rank = static_cast<count_type>(_q * (_count - 1));
+
+        // ordering: most negative, ..., zero, ..., most positive
+        count_type _sum = 0;
+        for(size_t i = m_negative.bins.size(); i > 0; --i)
+        {
+            _sum += m_negative.bins.at(i - 1);
+            if(_sum > _rank)
+                return -value(m_negative.offset + static_cast<int32_t>(i - 1));
+        }
+
+        _sum += m_zero;
+        if(_sum > _rank)
+            return 0.0;
+
+        for(size_t i = 0; i < m_positive.bins.size(); ++i)
+        {
+            _sum += m_positive.bins.at(i);
+            if(_sum > _rank)
+                return value(m_positive.offset + static_cast<int32_t>(i));
+        }
+        return value(m_positive.max_key());
+    }
+
+    /// multiplies every value in the sketch by a constant
+    void scale(double _factor)
+    {
+        if(empty() || _factor == 1.0)
+            return;
+        auto _orig = *this;
+        reset();
+        m_zero = _orig.m_zero;
+        _orig.m_positive.for_each([&](int32_t _key, count_type _n) {
+            insert(_factor * _orig.value(_key), _n);
+        });
+        _orig.m_negative.for_each([&](int32_t _key, count_type _n) {
+            insert(-_factor * _orig.value(_key), _n);
+        });
+    }
+
+    quantile_sketch& operator+=(double _val)
+    {
+        insert(_val);
+        return *this;
+    }
+
+    quantile_sketch& operator+=(const quantile_sketch& rhs)
+    {
+        if(rhs.empty())
+            return *this;
+
+        if(rhs.m_accuracy == m_accuracy)
+        {
+            m_zero += rhs.m_zero;
+            m_positive.merge(rhs.m_positive, m_max_bins);
+            m_negative.merge(rhs.m_negative, m_max_bins);
+        }
+        else
+        {
+            // different mappings: re-insert the representative values
+            m_zero += rhs.m_zero;
+            rhs.m_positive.for_each(
+                [&](int32_t _key, count_type _n) { insert(rhs.value(_key), _n); });
+            rhs.m_negative.for_each(
+                [&](int32_t _key, count_type _n) { insert(-rhs.value(_key), _n); });
+        }
+        return *this;
+    }
+
+    friend quantile_sketch operator+(const quantile_sketch& lhs,
+                                     const quantile_sketch& rhs)
+    {
+        return quantile_sketch(lhs) += rhs;
+    }
+
+    template <typename Archive>
+    void save(Archive& ar, const unsigned int) const
+    {
+        ar(cereal::make_nvp("accuracy", m_accuracy),
+           cereal::make_nvp("max_bins", m_max_bins), cereal::make_nvp("zero", m_zero),
+           cereal::make_nvp("positive", m_positive),
+           cereal::make_nvp("negative", m_negative));
+    }
+
+    template <typename Archive>
+    void load(Archive& ar, const unsigned int)
+    {
+        ar(cereal::make_nvp("accuracy", m_accuracy),
+           cereal::make_nvp("max_bins", m_max_bins), cereal::make_nvp("zero", m_zero),
+           cereal::make_nvp("positive", m_positive),
+           cereal::make_nvp("negative", m_negative));
+        m_gamma     = (1.0 + m_accuracy) / (1.0 - m_accuracy);
+        m_log_gamma = std::log(m_gamma);
+    }
+
+private:
+    static constexpr double min_value() { return std::numeric_limits<double>::min(); }
+
+    int32_t key(double _val) const
+    {
+        return static_cast<int32_t>(std::ceil(std::log(_val) / m_log_gamma));
+    }
+
+    /// the value in the middle of bucket (gamma^(key-1), gamma^key] in terms of the
+    /// relative error
+    double value(int32_t _key) const
+    {
+        return 2.0 * std::pow(m_gamma, _key) / (m_gamma + 1.0);
+    }
+
+private:
+    double     m_accuracy  = default_accuracy;
+    int32_t    m_max_bins  = default_max_bins;
+    double     m_gamma     = 1.0;
+    double     m_log_gamma = 0.0;
+    count_type m_zero      = 0;
+    store      m_positive  = {};
+    store      m_negative  = {};
+};
+//
+//======================================================================================//
+//
+}  // namespace data
+//
+//======================================================================================//
+//
+/// \struct tim::quantile_statistics
+/// \brief Extends \ref tim::statistics with a \ref tim::data::quantile_sketch so that
+/// the tail of the distribution (e.g. p99 latency) is available for every node in
+/// fixed memory. Enable for a component via \ref tim::policy::record_quantiles, e.g.
+/// for a component which does not have a statistics type yet:
+/// \code{.cpp}
+/// TIMEMORY_STATISTICS_QUANTILES(component::my_clock, double)
+/// \endcode
+///
+/// The quantiles are only available for the inclusive values: the distribution of the
+/// exclusive values (inclusive minus the children) cannot be derived from the sketches
+/// so the subtraction discards the sketch, \ref has_quantiles returns false, and the
+/// quantiles are omitted from the output.
+///
+template <typename Tp>
+struct quantile_statistics : public statistics<Tp>
+{
+    static_assert(std::is_arithmetic<Tp>::value,
+                  "quantile_statistics requires an arithmetic value type");
+
+public:
+    using base_type     = statistics<Tp>;
+    using value_type    = Tp;
+    using sketch_type   = data::quantile_sketch;
+    using quantile_pair = std::pair<const char*, double>;
+    using quantile_list = std::array<quantile_pair, 4>;
+
+    /// the quantiles which are reported in the text and JSON output
+    static const quantile_list& get_reported_quantiles()
+    {
+        static quantile_list _instance = { { quantile_pair{ "p50", 0.50 },
+                                             quantile_pair{ "p90", 0.90 },
+                                             quantile_pair{ "p99", 0.99 },
+                                             quantile_pair{ "p999", 0.999 } } };
+        return _instance;
+    }
+
+public:
+    quantile_statistics()                               = default;
+    ~quantile_statistics()                              = default;
+    quantile_statistics(const quantile_statistics&)     = default;
+    quantile_statistics(quantile_statistics&&) noexcept = default;
+    quantile_statistics& operator=(const quantile_statistics&) = default;
+    quantile_statistics& operator=(quantile_statistics&&) noexcept = default;
+
+    explicit quantile_statistics(const value_type& val)
+    : base_type(val)
+    {
+        m_sketch.insert(val);
+    }
+
+    quantile_statistics& operator=(const value_type& val)
+    {
+        base_type::operator=(val);
+        m_sketch.reset();
+        m_sketch.insert(val);
+        return *this;
+    }
+
+public:
+    const sketch_type& get_sketch() const { return m_sketch; }
+
+    /// false when there are no values or when the sketch was discarded by a subtraction
+    bool has_quantiles() const { return !m_sketch.empty(); }
+
+    /// estimate of the value at quantile q in [0, 1], bounded by the exact min and max.
+    /// Returns zero when \ref has_quantiles is false
+    value_type get_quantile(double _q) const
+    {
+        if(!has_quantiles())
+            return value_type{};
+        if(_q <= 0.0)
+            return this->get_min();
+        if(_q >= 1.0)
+            return this->get_max();
+        auto _val = m_sketch.get_quantile(_q);
+        _val      = std::max<double>(_val, this->get_min());
+        _val      = std::min<double>(_val, this->get_max());
+        return static_cast<value_type>(_val);
+    }
+
+    void reset()
+    {
+        static_cast<base_type&>(*this) = base_type{};
+        m_sketch.reset();
+    }
+
+public:
+    quantile_statistics& operator+=(const value_type& val)
+    {
+        if(!is_discarded())
+            m_sketch.insert(val);
+        base_type::operator+=(val);
+        return *this;
+    }
+
+    quantile_statistics& operator+=(const quantile_statistics& rhs)
+    {
+        // the sum with a discarded sketch does not have quantiles either
+        bool _discard = (is_discarded() || rhs.is_discarded());
+        base_type::operator+=(rhs);
+        m_sketch += rhs.m_sketch;
+        if(_discard)
+            m_sketch.reset();
+        return *this;
+    }
+
+    // values cannot be removed from a sketch and a distribution cannot be subtracted
+    // from a sketch (e.g. when computing exclusive values) so the sketch is discarded
+    quantile_statistics& operator-=(const value_type& val)
+    {
+        base_type::operator-=(val);
+        m_sketch.reset();
+        return *this;
+    }
+
+    quantile_statistics& operator-=(const quantile_statistics& rhs)
+    {
+        base_type::operator-=(rhs);
+        m_sketch.reset();
+        return *this;
+    }
+
+    quantile_statistics& operator*=(const value_type& val)
+    {
+        base_type::operator*=(val);
+        m_sketch.scale(val);
+        return *this;
+    }
+
+    quantile_statistics& operator/=(const value_type& val)
+    {
+        base_type::operator/=(val);
+        m_sketch.scale(1.0 / val);
+        return *this;
+    }
+
+private:
+    bool is_discarded() const { return this->get_count() > 0 && m_sketch.empty(); }
+
+private:
+    sketch_type m_sketch = {};
+
+public:
+    friend std::ostream& operator<<(std::ostream& os, const quantile_statistics& obj)
+    {
+        os << static_cast<const base_type&>(obj);
+        if(!obj.has_quantiles())
+            return os;
+        for(const auto& itr : get_reported_quantiles())
+            os << " [" << itr.first << ": " << obj.get_quantile(itr.second) << "]";
+        return os;
+    }
+
+    friend quantile_statistics operator+(const quantile_statistics& lhs,
+                                         const quantile_statistics& rhs)
+    {
+        return quantile_statistics(lhs) += rhs;
+    }
+
+    friend quantile_statistics operator-(const quantile_statistics& lhs,
+                                         const quantile_statistics& rhs)
+    {
+        return quantile_statistics(lhs) -= rhs;
+    }
+
+    template <typename Archive>
+    void save(Archive& ar, const unsigned int _version) const
+    {
+        base_type::save(ar, _version);
+        if(has_quantiles())
+        {
+            for(const auto& itr : get_reported_quantiles())
+                ar(cereal::make_nvp(itr.first, get_quantile(itr.second)));
+        }
+        ar(cereal::make_nvp("sketch", m_sketch));
+    }
+
+    template <typename Archive>
+    void load(Archive& ar, const unsigned int _version)
+    {
+        base_type::load(ar, _version);
+        ar(cereal::make_nvp("sketch", m_sketch));
+    }
+};
+//
+//======================================================================================//
+//
+}  // namespace tim
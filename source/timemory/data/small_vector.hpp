@@ -0,0 +1,184 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/** \file timemory/data/small_vector.hpp
+ * \headerfile timemory/data/small_vector.hpp "timemory/data/small_vector.hpp"
+ * Provides a vector which stores the first N elements inline and only allocates
+ * when more than N elements are added
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace tim
+{
+namespace data
+{
+//======================================================================================//
+//
+/// \class tim::data::small_vector
+/// \brief A vector whose first N elements live in an inline array. Elements beyond N
+/// are kept in a std::vector, which does not allocate until it is first used. The
+/// element type must be default-constructible and copyable. Only appending and
+/// clearing are supported, so references to the inline elements remain valid until
+/// the container is cleared or destroyed.
+///
+template <typename Tp, size_t N>
+class small_vector
+{
+public:
+    using value_type      = Tp;
+    using size_type       = size_t;
+    using reference       = Tp&;
+    using const_reference = const Tp&;
+    using this_type       = small_vector<Tp, N>;
+    using inline_type     = std::array<Tp, N>;
+    using overflow_type   = std::vector<Tp>;
+
+    static_assert(N > 0, "small_vector requires an inline capacity > 0");
+
+    template <typename ContainerT, typename ValueT>
+    class iterator_base
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Tp;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = ValueT*;
+        using reference         = ValueT&;
+
+        iterator_base(ContainerT* _obj, size_type _idx)
+        : m_obj{ _obj }
+        , m_idx{ _idx }
+        {}
+
+        reference operator*() const { return (*m_obj)[m_idx]; }
+        pointer   operator->() const { return &(*m_obj)[m_idx]; }
+
+        iterator_base& operator++()
+        {
+            ++m_idx;
+            return *this;
+        }
+
+        iterator_base operator++(int)
+        {
+            auto _tmp = *this;
+            ++m_idx;
+            return _tmp;
+        }
+
+        bool operator==(const iterator_base& rhs) const
+        {
+            return m_obj == rhs.m_obj && m_idx == rhs.m_idx;
+        }
+
+        bool operator!=(const iterator_base& rhs) const { return !(*this == rhs); }
+
+    private:
+        ContainerT* m_obj = nullptr;
+        size_type   m_idx = 0;
+    };
+
+    using iterator       = iterator_base<this_type, Tp>;
+    using const_iterator = iterator_base<const this_type, const Tp>;
+
+public:
+    small_vector()                        = default;
+    ~small_vector()                       = default;
+    small_vector(const small_vector&)     = default;
+    small_vector(small_vector&&) noexcept = default;
+    small_vector& operator=(const small_vector&) = default;
+    small_vector& operator=(small_vector&&) noexcept = default;
+
+    static constexpr size_type inline_capacity() { return N; }
+
+    size_type size() const { return m_size; }
+    bool      empty() const { return m_size == 0; }
+    /// true if none of the elements have spilled into the heap-allocated storage
+    bool is_inline() const { return m_size <= N; }
+
+    reference operator[](size_type _idx)
+    {
+        return (_idx < N) ? m_inline[_idx] : m_overflow[_idx - N];
+    }
+
+    const_reference operator[](size_type _idx) const
+    {
+        return (_idx < N) ? m_inline[_idx] : m_overflow[_idx - N];
+    }
+
+    reference       front() { return m_inline[0]; }
+    const_reference front() const { return m_inline[0]; }
+    reference       back() { return (*this)[m_size - 1]; }
+    const_reference back() const { return (*this)[m_size - 1]; }
+
+    iterator       begin() { return iterator{ this, 0 }; }
+    iterator       end() { return iterator{ this, m_size }; }
+    const_iterator begin() const { return const_iterator{ this, 0 }; }
+    const_iterator end() const { return const_iterator{ this, m_size }; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... _args)
+    {
+        if(m_size < N)
+        {
+            m_inline[m_size] = Tp{ std::forward<Args>(_args)... };
+            return m_inline[m_size++];
+        }
+        m_overflow.emplace_back(std::forward<Args>(_args)...);
+        ++m_size;
+        return m_overflow.back();
+    }
+
+    void push_back(const Tp& _val) { emplace_back(_val); }
+    void push_back(Tp&& _val) { emplace_back(std::move(_val)); }
+
+    /// removes all the elements but retains the heap-allocated capacity. The inline
+    /// elements are overwritten by subsequent insertions
+    void clear()
+    {
+        m_overflow.clear();
+        m_size = 0;
+    }
+
+private:
+    size_type     m_size = 0;
+    inline_type   m_inline{};
+    overflow_type m_overflow{};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace data
+}  // namespace tim
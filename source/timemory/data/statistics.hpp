@@ -88,6 +88,7 @@ public:
     statistics& operator=(const value_type& val)
     {
         m_cnt = 1;
+        m_pop = 0.0;
         m_sum = val;
         m_min = val;
         m_max = val;
@@ -131,6 +132,31 @@ public:
         return compute_type::sqrt(compute_type::abs(get_variance()));
     }
 
+    // Sampling: the samples may represent a larger number of events (e.g. when only
+    // 1 in N calls to a region is measured)
+    inline void   set_population(double _n) { m_pop = _n; }
+    inline double get_population() const { return std::max<double>(m_pop, m_cnt); }
+    inline bool   is_sampled() const { return m_pop > m_cnt; }
+    inline double get_sampling_ratio() const
+    {
+        return (m_cnt > 0) ? (m_cnt / get_population()) : 0.0;
+    }
+
+    // the standard error of the total of the population which is estimated from the
+    // samples, including the finite population correction
+    inline value_type get_standard_error() const
+    {
+        auto _ret = get_stddev();
+        auto _pop = get_population();
+        if(m_cnt < 1 || _pop <= m_cnt)
+        {
+            math::multiply(_ret, 0.0);
+            return _ret;
+        }
+        math::multiply(_ret, _pop / std::sqrt(m_cnt) * std::sqrt(1.0 - m_cnt / _pop));
+        return _ret;
+    }
+
     // Modifications
     inline void reset();
 
@@ -204,6 +230,8 @@ public:
             m_min = compute_type::min(m_min, rhs.m_min);
             m_max = compute_type::max(m_max, rhs.m_max);
         }
+        if(is_sampled() || rhs.is_sampled())
+            m_pop = get_population() + rhs.get_population();
         m_cnt += rhs.m_cnt;
         return *this;
     }
@@ -225,6 +253,7 @@ public:
 private:
     // summation of each history^1
     int64_t    m_cnt = 0;
+    double     m_pop = 0.0;
     value_type m_sum = value_type{};
     value_type m_sqr = value_type{};
     value_type m_min = value_type{};
@@ -260,6 +289,12 @@ public:
            cereal::make_nvp("min", m_min), cereal::make_nvp("max", m_max),
            cereal::make_nvp("sqr", m_sqr), cereal::make_nvp("mean", _mean),
            cereal::make_nvp("stddev", get_stddev()));
+        if(is_sampled())
+        {
+            ar(cereal::make_nvp("population", m_pop),
+               cereal::make_nvp("sampling_ratio", get_sampling_ratio()),
+               cereal::make_nvp("standard_error", get_standard_error()));
+        }
     }
 
     template <typename Archive>
@@ -103,6 +103,7 @@ enum TIMEMORY_NATIVE_COMPONENT
     PAPI_ARRAY,
     PAPI_VECTOR,
     PEAK_RSS,
+    PERF_COUNTERS,
     PRIORITY_CONTEXT_SWITCH,
     PROCESS_CPU_CLOCK,
     PROCESS_CPU_UTIL,
@@ -27,6 +27,7 @@
 #include "timemory/components/timing/ert_timer.hpp"
 #include "timemory/ert/aligned_allocator.hpp"
 #include "timemory/ert/barrier.hpp"
+#include "timemory/ert/cache.hpp"
 #include "timemory/ert/cache_size.hpp"
 #include "timemory/ert/configuration.hpp"
 #include "timemory/ert/counter.hpp"
@@ -0,0 +1,551 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/** \file timemory/ert/cache.hpp
+ * \headerfile timemory/ert/cache.hpp "timemory/ert/cache.hpp"
+ * Provides an on-disk cache of ERT results keyed by a fingerprint of the hardware and
+ * the ERT configuration so that the roofline ceilings are only measured once per
+ * node type
+ *
+ */
+
+#pragma once
+
+#include "timemory/backends/device.hpp"
+#include "timemory/backends/process.hpp"
+#include "timemory/ert/cache_size.hpp"
+#include "timemory/ert/configuration.hpp"
+#include "timemory/ert/data.hpp"
+#include "timemory/ert/topology.hpp"
+#include "timemory/environment/declaration.hpp"
+#include "timemory/macros/os.hpp"
+#include "timemory/settings/declaration.hpp"
+#include "timemory/tpls/cereal/archives.hpp"
+#include "timemory/tpls/cereal/cereal.hpp"
+#include "timemory/utility/utility.hpp"
+#include "timemory/version.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_UNIX)
+#    include <dirent.h>
+#    include <unistd.h>
+#endif
+
+#if defined(_MACOS)
+#    include <sys/sysctl.h>
+#endif
+
+namespace tim
+{
+namespace ert
+{
+namespace cache
+{
+/// incremented whenever the layout of the cache files or the meaning of the stored
+/// values changes so that old entries are ignored
+static constexpr int version = 3;
+//
+//--------------------------------------------------------------------------------------//
+//
+/// the name of the CPU model, e.g. "Intel(R) Xeon(R) Gold 6148 CPU @ 2.40GHz"
+inline std::string
+get_cpu_model()
+{
+    static std::string _value = []() -> std::string {
+#if defined(_MACOS)
+        char   _buf[256];
+        size_t _len = sizeof(_buf);
+        if(sysctlbyname("machdep.cpu.brand_string", _buf, &_len, nullptr, 0) == 0)
+            return std::string{ _buf };
+#elif defined(_LINUX)
+        std::ifstream ifs{ "/proc/cpuinfo" };
+        std::string   _line{};
+        // x86 reports "model name", POWER reports "cpu", and ARM only reports the
+        // implementer and part numbers
+        std::string _implementer{};
+        std::string _part{};
+        while(ifs && std::getline(ifs, _line))
+        {
+            auto _pos = _line.find(':');
+            if(_pos == std::string::npos)
+                continue;
+            auto _key = _line.substr(0, _line.find_last_not_of(" \t", _pos - 1) + 1);
+            auto _val = (_pos + 2 <= _line.length()) ? _line.substr(_pos + 2) : "";
+            if(_key == "model name" || _key == "cpu")
+                return _val;
+            if(_key == "CPU implementer" && _implementer.empty())
+                _implementer = _val;
+            if(_key == "CPU part" && _part.empty())
+                _part = _val;
+        }
+        if(!_implementer.empty() || !_part.empty())
+            return _implementer + ":" + _part;
+#endif
+        return "unknown";
+    }();
+    return _value;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::ert::cache::fingerprint
+/// \brief Everything which affects the result of an ERT run. Cached results are only
+/// reused when every field matches. The timemory version is included because the ERT
+/// kernels may change between releases
+///
+struct fingerprint
+{
+    int         version          = cache::version;
+    std::string timemory_version = TIMEMORY_VERSION_STRING;
+    std::string cpu_model        = {};
+    uint64_t    num_cores        = 0;
+    uint64_t    l1_cache_size    = 0;
+    uint64_t    l2_cache_size    = 0;
+    uint64_t    l3_cache_size    = 0;
+    uint64_t    num_threads      = 0;
+    uint64_t    min_working_size = 0;
+    uint64_t    max_data_size    = 0;
+    uint64_t    alignment        = 0;
+    std::string skip_ops         = {};
+    std::string device           = {};
+    std::string data_type        = {};
+    std::string counter_type     = {};
+    std::string kernels          = {};
+    std::string numa             = {};
+
+    /// canonical representation of all the fields
+    std::string as_string() const
+    {
+        std::stringstream ss;
+        ss << "version=" << version << "|timemory=" << timemory_version
+           << "|cpu=" << cpu_model << "|cores=" << num_cores
+           << "|l1=" << l1_cache_size << "|l2=" << l2_cache_size
+           << "|l3=" << l3_cache_size << "|threads=" << num_threads
+           << "|min_working_size=" << min_working_size
+           << "|max_data_size=" << max_data_size << "|alignment=" << alignment
+           << "|skip_ops=" << skip_ops << "|device=" << device
+           << "|dtype=" << data_type << "|counter=" << counter_type
+           << "|kernels=" << kernels << "|numa=" << numa;
+        return ss.str();
+    }
+
+    /// FNV-1a hash of \ref as_string. std::hash is not used because the value is
+    /// persisted and must be identical across compilers and standard libraries
+    uint64_t hash() const
+    {
+        uint64_t _hash = 0xcbf29ce484222325ULL;
+        for(auto itr : as_string())
+        {
+            _hash ^= static_cast<uint8_t>(itr);
+            _hash *= 0x100000001b3ULL;
+        }
+        return _hash;
+    }
+
+    /// name of the cache file within the cache directory
+    std::string filename() const
+    {
+        std::stringstream ss;
+        ss << "ert-" << std::hex << std::setw(16) << std::setfill('0') << hash()
+           << ".json";
+        return ss.str();
+    }
+
+    bool operator==(const fingerprint& rhs) const
+    {
+        return as_string() == rhs.as_string();
+    }
+
+    bool operator!=(const fingerprint& rhs) const { return !(*this == rhs); }
+
+    template <typename Archive>
+    void serialize(Archive& ar, const unsigned int)
+    {
+        ar(cereal::make_nvp("version", version),
+           cereal::make_nvp("timemory_version", timemory_version),
+           cereal::make_nvp("cpu_model", cpu_model),
+           cereal::make_nvp("num_cores", num_cores),
+           cereal::make_nvp("l1_cache_size", l1_cache_size),
+           cereal::make_nvp("l2_cache_size", l2_cache_size),
+           cereal::make_nvp("l3_cache_size", l3_cache_size),
+           cereal::make_nvp("num_threads", num_threads),
+           cereal::make_nvp("min_working_size", min_working_size),
+           cereal::make_nvp("max_data_size", max_data_size),
+           cereal::make_nvp("alignment", alignment),
+           cereal::make_nvp("skip_ops", skip_ops), cereal::make_nvp("device", device),
+           cereal::make_nvp("data_type", data_type),
+           cereal::make_nvp("counter_type", counter_type),
+           cereal::make_nvp("kernels", kernels), cereal::make_nvp("numa", numa));
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const fingerprint& obj)
+    {
+        std::stringstream ss;
+        ss << obj.cpu_model << " (cores = " << obj.num_cores
+           << ", L1 = " << obj.l1_cache_size << ", L2 = " << obj.l2_cache_size
+           << ", L3 = " << obj.l3_cache_size << "), device = " << obj.device
+           << ", threads = " << obj.num_threads << ", dtype = " << obj.data_type
+           << ", counter = " << obj.counter_type
+           << ", working-set = " << obj.min_working_size
+           << ", max-size = " << obj.max_data_size << ", alignment = " << obj.alignment
+           << ", kernels = " << obj.kernels
+           << ", timemory = " << obj.timemory_version;
+        if(!obj.skip_ops.empty())
+            ss << ", skip-ops = " << obj.skip_ops;
+        if(!obj.numa.empty())
+            ss << ", numa = " << obj.numa;
+        os << ss.str();
+        return os;
+    }
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \fn fingerprint tim::ert::cache::get_fingerprint(const configuration&)
+/// \brief the fingerprint of the ERT run which \ref tim::ert::executor would perform
+/// with the given configuration
+///
+template <typename DeviceT, typename Tp, typename CounterT>
+fingerprint
+get_fingerprint(const configuration<DeviceT, Tp, CounterT>& _config)
+{
+    using config_type   = configuration<DeviceT, Tp, CounterT>;
+    using executor_type = ert::executor<DeviceT, Tp, CounterT>;
+
+    // sorted so the fingerprint does not depend on the hash-set ordering
+    auto              _skip_ops = config_type::get_skip_ops()();
+    std::set<size_t>  _skip_sorted(_skip_ops.begin(), _skip_ops.end());
+    std::stringstream _skip{};
+    for(const auto& itr : _skip_sorted)
+        _skip << ((_skip.str().empty()) ? "" : ",") << itr;
+
+    // some systems (e.g. KNL) do not have every cache level
+    auto _cache_size = [](int _level) -> uint64_t {
+        try
+        {
+            return cache_size::impl::cache_size(_level);
+        } catch(...)
+        {
+            return 0;
+        }
+    };
+
+    fingerprint _fp{};
+    _fp.cpu_model        = get_cpu_model();
+    _fp.num_cores        = std::thread::hardware_concurrency();
+    _fp.l1_cache_size    = _cache_size(1);
+    _fp.l2_cache_size    = _cache_size(2);
+    _fp.l3_cache_size    = _cache_size(3);
+    _fp.num_threads      = _config.num_threads();
+    _fp.min_working_size = _config.min_working_size();
+    _fp.max_data_size    = _config.max_data_size();
+    _fp.alignment        = _config.alignment();
+    _fp.skip_ops         = _skip.str();
+    _fp.device           = (device::is_gpu<DeviceT>::value) ? "gpu" : "cpu";
+    _fp.data_type        = demangle(typeid(Tp).name());
+    _fp.counter_type     = demangle(typeid(CounterT).name());
+    _fp.kernels          = executor_type::get_kernel_set();
+    // the placement of the pinned threads (see TIMEMORY_ERT_NUMA_AWARE)
+    if(!device::is_gpu<DeviceT>::value && settings::ert_numa_aware())
+        _fp.numa = topology::as_string(topology::get_placement(_fp.num_threads));
+    return _fp;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// the directory of the cache files: the TIMEMORY_ERT_CACHE_DIR setting if set,
+/// otherwise $XDG_CACHE_HOME/timemory/ert or $HOME/.cache/timemory/ert
+inline std::string
+get_directory()
+{
+    if(!settings::ert_cache_dir().empty())
+        return settings::ert_cache_dir();
+    auto _xdg = get_env<std::string>("XDG_CACHE_HOME", "");
+    if(!_xdg.empty())
+        return _xdg + "/timemory/ert";
+    auto _home = get_env<std::string>("HOME", "");
+    if(!_home.empty())
+        return _home + "/.cache/timemory/ert";
+    return std::string{};
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline std::string
+get_path(const fingerprint& _fp)
+{
+    auto _dir = get_directory();
+    return (_dir.empty()) ? _dir : _dir + "/" + _fp.filename();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// read the fingerprint of a cache file. Returns false if the file is not readable or
+/// was written by an incompatible version
+inline bool
+read_fingerprint(const std::string& _fname, fingerprint& _fp)
+{
+    std::ifstream ifs{ _fname };
+    if(!ifs)
+        return false;
+    try
+    {
+        cereal::JSONInputArchive ia(ifs);
+        ia.setNextName("timemory");
+        ia.startNode();
+        ia(cereal::make_nvp("fingerprint", _fp));
+        ia.finishNode();
+    } catch(std::exception& e)
+    {
+        if(settings::debug())
+            fprintf(stderr, "[ert::cache]> Error reading '%s': %s\n", _fname.c_str(),
+                    e.what());
+        return false;
+    }
+    return (_fp.version == cache::version);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// load the cached results for the fingerprint into \param _data. Returns false if
+/// there is no entry or the entry does not match the fingerprint exactly
+template <typename CounterT>
+bool
+load(const fingerprint& _fp, exec_data<CounterT>& _data)
+{
+    auto _fname = get_path(_fp);
+    if(_fname.empty())
+        return false;
+
+    std::ifstream ifs{ _fname };
+    if(!ifs)
+        return false;
+
+    try
+    {
+        fingerprint              _stored{};
+        exec_data<CounterT>      _stored_data{};
+        cereal::JSONInputArchive ia(ifs);
+        ia.setNextName("timemory");
+        ia.startNode();
+        ia(cereal::make_nvp("fingerprint", _stored));
+        // guards against hash collisions and stale formats
+        if(_stored != _fp)
+            return false;
+        ia(cereal::make_nvp("roofline", _stored_data));
+        ia.finishNode();
+        if(_stored_data.size() == 0)
+            return false;
+        _data += _stored_data;
+    } catch(std::exception& e)
+    {
+        fprintf(stderr, "[ert::cache]> Ignoring invalid cache file '%s': %s\n",
+                _fname.c_str(), e.what());
+        return false;
+    }
+    return true;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// store the results for the fingerprint. The file is written under a temporary name
+/// and renamed so that concurrent jobs never read a partially written entry
+template <typename CounterT>
+bool
+save(const fingerprint& _fp, const exec_data<CounterT>& _data)
+{
+    auto _dir = get_directory();
+    if(_dir.empty())
+        return false;
+    if(makedir(_dir) != 0)
+        return false;
+
+    auto _fname = get_path(_fp);
+    auto _tmp   = _fname + "." + std::to_string(process::get_id()) + ".tmp";
+
+    {
+        std::ofstream ofs{ _tmp };
+        if(!ofs)
+        {
+            fprintf(stderr, "[ert::cache]> Error opening '%s' for output\n",
+                    _tmp.c_str());
+            return false;
+        }
+        {
+            auto space = cereal::JSONOutputArchive::Options::IndentChar::space;
+            cereal::JSONOutputArchive::Options opt(16, space, 2);
+            cereal::JSONOutputArchive          oa(ofs, opt);
+            oa.setNextName("timemory");
+            oa.startNode();
+            oa(cereal::make_nvp("fingerprint", _fp), cereal::make_nvp("roofline", _data));
+            oa.finishNode();
+        }
+        ofs << std::endl;
+    }
+
+    if(std::rename(_tmp.c_str(), _fname.c_str()) != 0)
+    {
+        std::remove(_tmp.c_str());
+        return false;
+    }
+    return true;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// remove the cache entry for the fingerprint
+inline bool
+invalidate(const fingerprint& _fp)
+{
+    auto _fname = get_path(_fp);
+    return !_fname.empty() && std::remove(_fname.c_str()) == 0;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// the paths of all the cache files in the cache directory
+inline std::vector<std::string>
+list()
+{
+    std::vector<std::string> _files{};
+#if defined(_UNIX)
+    auto _dir = get_directory();
+    if(_dir.empty())
+        return _files;
+    auto* _dp = opendir(_dir.c_str());
+    if(!_dp)
+        return _files;
+    while(auto* _ent = readdir(_dp))
+    {
+        std::string _name = _ent->d_name;
+        if(_name.find("ert-") == 0 && _name.length() > 9 &&
+           _name.substr(_name.length() - 5) == ".json")
+            _files.emplace_back(_dir + "/" + _name);
+    }
+    closedir(_dp);
+#endif
+    return _files;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// remove every cache file. Returns the number of files removed
+inline size_t
+clear()
+{
+    size_t _n = 0;
+    for(const auto& itr : list())
+    {
+        if(std::remove(itr.c_str()) == 0)
+            ++_n;
+    }
+    return _n;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::ert::cache::executor
+/// \brief Drop-in replacement for \ref tim::ert::executor which reuses the cached
+/// results when the fingerprint matches and otherwise runs ERT and stores the results.
+/// The cache is bypassed when the TIMEMORY_ERT_CACHE setting is disabled or when a
+/// custom executor callback is installed (see \ref bypass)
+///
+template <typename DeviceT, typename Tp, typename CounterT>
+struct executor
+{
+    using configuration_type = configuration<DeviceT, Tp, CounterT>;
+    using executor_type      = ert::executor<DeviceT, Tp, CounterT>;
+    using ert_data_t         = exec_data<CounterT>;
+    using ert_data_ptr_t     = std::shared_ptr<ert_data_t>;
+
+    /// when true, the results are measured even if a matching entry exists and the
+    /// entry is replaced
+    static bool& refresh()
+    {
+        static bool _instance = false;
+        return _instance;
+    }
+
+    /// set to true when the kernels are customized, e.g. via a callback, since the
+    /// fingerprint cannot describe them
+    static bool& bypass()
+    {
+        static bool _instance = false;
+        return _instance;
+    }
+
+    executor(configuration_type& _config, ert_data_ptr_t _data)
+    {
+        if(!settings::ert_cache() || bypass() || !_data)
+        {
+            executor_type(_config, _data);
+            return;
+        }
+
+        auto _fp = get_fingerprint(_config);
+        if(!refresh() && load(_fp, *_data))
+        {
+            if(settings::verbose() > 0 || settings::debug())
+                printf("[ert::cache]> Using cached ERT results from '%s' for %s\n",
+                       get_path(_fp).c_str(), _fp.data_type.c_str());
+            m_cached = true;
+            return;
+        }
+
+        auto _result = std::make_shared<ert_data_t>();
+        executor_type(_config, _result);
+        if(_result->size() > 0)
+        {
+            if(save(_fp, *_result) && (settings::verbose() > 0 || settings::debug()))
+                printf("[ert::cache]> Stored ERT results in '%s'\n",
+                       get_path(_fp).c_str());
+            *_data += *_result;
+        }
+    }
+
+    /// whether the results were loaded from the cache
+    bool is_cached() const { return m_cached; }
+
+private:
+    bool m_cached = false;
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace cache
+}  // namespace ert
+}  // namespace tim
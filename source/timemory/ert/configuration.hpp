@@ -37,11 +37,15 @@
 #include "timemory/ert/counter.hpp"
 #include "timemory/ert/data.hpp"
 #include "timemory/ert/kernels.hpp"
+#include "timemory/ert/topology.hpp"
 #include "timemory/ert/types.hpp"
 #include "timemory/settings/declaration.hpp"
 
 #include <cstdint>
 #include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
 
 // default vectorization width
 #if !defined(TIMEMORY_VEC)
@@ -231,6 +235,10 @@ struct configuration
             for(const auto& itr : _skip_ops)
                 _counter.add_skip_ops(itr);
 
+            // pin the threads across the NUMA nodes
+            if(!device::is_gpu<DeviceT>::value && settings::ert_numa_aware())
+                _counter.placement = topology::get_placement(_num_thread);
+
             auto dtype = demangle(typeid(Tp).name());
 
             printf(
@@ -241,6 +249,10 @@ struct configuration
                 (lli) _mws_size, (lli) _max_size, (lli) _num_thread, (lli) _num_stream,
                 (lli) _grid_size, (lli) _block_size, (lli) _align_size, dtype.c_str());
 
+            if(!_counter.placement.empty())
+                printf("[ert::executor]> thread placement (node:cpu) = %s\n",
+                       topology::as_string(_counter.placement).c_str());
+
             return _counter;
         };
         return _instance;
@@ -340,6 +352,27 @@ public:
         return _instance;
     }
 
+    //----------------------------------------------------------------------------------//
+    /// describes the kernels run by \ref execute so that cached results are only reused
+    /// when the same kernels would have been executed
+    static std::string get_kernel_set()
+    {
+        static constexpr const int VEC = TIMEMORY_VEC / (sizeof(Tp) * 8);
+
+        std::vector<int> _user_flops = { TIMEMORY_USER_ERT_FLOPS };
+        auto             _simd       = (simd::is_supported<Tp>::value)
+                             ? simd::fma_kernel{}.target
+                             : simd::isa::scalar;
+
+        std::stringstream ss;
+        ss << "scalar_add[1] vector_fma[" << VEC / 2 << "," << VEC << "," << 2 * VEC
+           << "," << 4 * VEC;
+        for(const auto& itr : _user_flops)
+            ss << "," << itr;
+        ss << "] simd=" << simd::as_string(_simd);
+        return ss.str();
+    }
+
     //----------------------------------------------------------------------------------//
     //
     static void execute(counter_type& _counter)
@@ -373,9 +406,22 @@ public:
 
         // set the label
         _counter.label = "vector_fma";
-        // run the kernels
-        ops_main<VEC / 2, VEC, 2 * VEC, 4 * VEC>(_counter, fma_func, store_func);
-        ops_main<TIMEMORY_USER_ERT_FLOPS>(_counter, fma_func, store_func);
+        // run the kernels with explicit vector instructions when available, otherwise
+        // rely on the compiler to vectorize the scalar function
+        simd::fma_kernel simd_fma_func{};
+        if(simd::is_supported<Tp>::value && simd_fma_func.target != simd::isa::scalar)
+        {
+            if(settings::verbose() > 0 || settings::debug())
+                printf("[%s] Using '%s' ERT kernels...\n", __FUNCTION__,
+                       simd::as_string(simd_fma_func.target));
+            ops_main<VEC / 2, VEC, 2 * VEC, 4 * VEC>(_counter, simd_fma_func, store_func);
+            ops_main<TIMEMORY_USER_ERT_FLOPS>(_counter, simd_fma_func, store_func);
+        }
+        else
+        {
+            ops_main<VEC / 2, VEC, 2 * VEC, 4 * VEC>(_counter, fma_func, store_func);
+            ops_main<TIMEMORY_USER_ERT_FLOPS>(_counter, fma_func, store_func);
+        }
     }
 };
 
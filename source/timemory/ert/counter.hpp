@@ -38,6 +38,7 @@
 #include "timemory/ert/barrier.hpp"
 #include "timemory/ert/cache_size.hpp"
 #include "timemory/ert/data.hpp"
+#include "timemory/ert/topology.hpp"
 #include "timemory/ert/types.hpp"
 #include "timemory/mpl/apply.hpp"
 #include "timemory/settings/declaration.hpp"
@@ -192,30 +193,7 @@ public:
     inline void record(counter_type& _counter, int n, int trials, uint64_t nops,
                        const exec_params& _itrp)
     {
-        uint64_t working_set_size = n * params.nthreads * params.nproc;
-        uint64_t working_set      = working_set_size * bytes_per_element;
-        uint64_t total_bytes      = trials * working_set * memory_accesses_per_element;
-        uint64_t total_ops        = trials * working_set_size * nops;
-
-        std::stringstream ss;
-        ss << label;
-        if(label.length() == 0)
-        {
-            if(nops > 1)
-                ss << "vector_op";
-            else
-                ss << "scalar_op";
-        }
-
-        auto      _label = tim::demangle<Tp>();
-        data_type _data(ss.str(), working_set, trials, total_bytes, total_ops, nops,
-                        _counter, DeviceT::name(), _label, _itrp);
-
-#if !defined(_WINDOWS)
-        using namespace tim::stl::ostream;
-        if(settings::verbose() > 1 || settings::debug())
-            std::cout << "[RECORD]> " << _data << std::endl;
-#endif
+        auto _data = make_entry(_counter, n, trials, nops, _itrp, params.nthreads);
 
         static std::mutex _mutex;
         // std::unique_lock<std::mutex> _lock(_mutex);
@@ -224,6 +202,20 @@ public:
         _mutex.unlock();
     }
 
+    //----------------------------------------------------------------------------------//
+    // record the data from the threads of a NUMA node. The working set only includes
+    // the buffers of the threads on the node
+    //
+    inline void record(counter_type& _counter, int n, int trials, uint64_t nops,
+                       const exec_params& _itrp, const topology::placement& _place)
+    {
+        auto _data = make_entry(_counter, n, trials, nops, _itrp, _place.size);
+
+        static std::mutex            _mutex;
+        std::unique_lock<std::mutex> _lock(_mutex);
+        data->add_numa(_place.node, _place.cpus, _data);
+    }
+
     //----------------------------------------------------------------------------------//
     //
     template <typename FuncT>
@@ -292,10 +284,46 @@ public:
     std::string label                       = "";
     skip_ops_t  skip_ops                    = skip_ops_t();
 
+    // when not empty, thread "i" is pinned according to placement[i]
+    std::vector<topology::placement> placement = {};
+
 protected:
     callback_type configure_callback = [](uint64_t, this_type&) {};
 
 private:
+    //----------------------------------------------------------------------------------//
+    //  create the entry for a working set of "n" elements on each of "nthreads" threads
+    //
+    data_type make_entry(counter_type& _counter, int n, int trials, uint64_t nops,
+                         const exec_params& _itrp, uint64_t _nthreads) const
+    {
+        uint64_t working_set_size = n * _nthreads * params.nproc;
+        uint64_t working_set      = working_set_size * bytes_per_element;
+        uint64_t total_bytes      = trials * working_set * memory_accesses_per_element;
+        uint64_t total_ops        = trials * working_set_size * nops;
+
+        std::stringstream ss;
+        ss << label;
+        if(label.length() == 0)
+        {
+            if(nops > 1)
+                ss << "vector_op";
+            else
+                ss << "scalar_op";
+        }
+
+        auto      _label = tim::demangle<Tp>();
+        data_type _data(ss.str(), working_set, trials, total_bytes, total_ops, nops,
+                        _counter, DeviceT::name(), _label, _itrp);
+
+#if !defined(_WINDOWS)
+        using namespace tim::stl::ostream;
+        if(settings::verbose() > 1 || settings::debug())
+            std::cout << "[RECORD]> " << _data << std::endl;
+#endif
+        return _data;
+    }
+
     //----------------------------------------------------------------------------------//
     //  compute the data size
     //
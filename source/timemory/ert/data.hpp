@@ -42,6 +42,7 @@
 #include "timemory/tpls/cereal/cereal.hpp"
 #include "timemory/utility/macros.hpp"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstddef>
@@ -138,6 +139,16 @@ public:
     using const_iterator = typename value_array::const_iterator;
     using this_type      = exec_data<Tp>;
 
+    /// the results measured by the threads of a single NUMA node
+    struct numa_entry
+    {
+        int64_t     node   = 0;
+        std::string cpus   = {};
+        value_array values = {};
+    };
+
+    using numa_array = std::vector<numa_entry>;
+
     //----------------------------------------------------------------------------------//
     //
     exec_data() {}
@@ -149,12 +160,14 @@ public:
     exec_data(this_type&& rhs)
     : m_labels(std::move(rhs.m_labels))
     , m_values(std::move(rhs.m_values))
+    , m_numa(std::move(rhs.m_numa))
     {}
 
     this_type& operator=(this_type&& rhs)
     {
         m_labels = std::move(rhs.m_labels);
         m_values = std::move(rhs.m_values);
+        m_numa   = std::move(rhs.m_numa);
         return *this;
     }
 
@@ -169,6 +182,22 @@ public:
     iterator       end() { return m_values.end(); }
     const_iterator end() const { return m_values.end(); }
 
+    /// per-NUMA node results, empty unless the threads were pinned
+    const numa_array& get_numa() const { return m_numa; }
+
+    /// add an entry measured by the threads of NUMA node \param _node
+    void add_numa(int64_t _node, const std::string& _cpus, const value_type& _entry)
+    {
+        auto _match = [_node](const numa_entry& _v) { return _v.node == _node; };
+        auto itr    = std::find_if(m_numa.begin(), m_numa.end(), _match);
+        if(itr == m_numa.end())
+        {
+            m_numa.emplace_back(numa_entry{ _node, _cpus, value_array{} });
+            itr = m_numa.end() - 1;
+        }
+        itr->values.emplace_back(_entry);
+    }
+
 public:
     //----------------------------------------------------------------------------------//
     //
@@ -191,6 +220,11 @@ public:
 
         for(const auto& itr : rhs.m_values)
             m_values.push_back(itr);
+        for(const auto& itr : rhs.m_numa)
+        {
+            for(const auto& vitr : itr.values)
+                add_numa(itr.node, itr.cpus, vitr);
+        }
         return *this;
     }
 
@@ -220,16 +254,16 @@ public:
     template <typename Archive>
     void save(Archive& ar, const unsigned int) const
     {
-        constexpr auto sz = std::tuple_size<value_type>::value;
-        ar(cereal::make_nvp("entries", m_values.size()));
+        save_values(ar, m_values);
 
-        ar.setNextName("ert");
+        ar.setNextName("numa");
         ar.startNode();
         ar.makeArray();
-        for(const auto& itr : m_values)
+        for(const auto& itr : m_numa)
         {
             ar.startNode();
-            _save(ar, itr, make_index_sequence<sz>{});
+            ar(cereal::make_nvp("node", itr.node), cereal::make_nvp("cpus", itr.cpus));
+            save_values(ar, itr.values);
             ar.finishNode();
         }
         ar.finishNode();
@@ -240,17 +274,18 @@ public:
     template <typename Archive>
     void load(Archive& ar, const unsigned int)
     {
-        constexpr auto sz    = std::tuple_size<value_type>::value;
-        auto           _size = 0;
-        ar(cereal::make_nvp("entries", _size));
-        m_values.resize(_size);
+        load_values(ar, m_values);
 
-        ar.setNextName("ert");
+        ar.setNextName("numa");
         ar.startNode();
-        for(auto& itr : m_values)
+        cereal::size_type _nnuma = 0;
+        ar.loadSize(_nnuma);
+        m_numa.resize(_nnuma);
+        for(auto& itr : m_numa)
         {
             ar.startNode();
-            _load(ar, itr, make_index_sequence<sz>{});
+            ar(cereal::make_nvp("node", itr.node), cereal::make_nvp("cpus", itr.cpus));
+            load_values(ar, itr.values);
             ar.finishNode();
         }
         ar.finishNode();
@@ -261,8 +296,50 @@ protected:
                                "total-ops", "ops-per-set", "counter", "device", "dtype",
                                "exec-params" } };
     value_array m_values = {};
+    numa_array  m_numa   = {};
 
 private:
+    //----------------------------------------------------------------------------------//
+    //
+    template <typename Archive>
+    void save_values(Archive& ar, const value_array& _values) const
+    {
+        constexpr auto sz = std::tuple_size<value_type>::value;
+        ar(cereal::make_nvp("entries", _values.size()));
+
+        ar.setNextName("ert");
+        ar.startNode();
+        ar.makeArray();
+        for(const auto& itr : _values)
+        {
+            ar.startNode();
+            _save(ar, itr, make_index_sequence<sz>{});
+            ar.finishNode();
+        }
+        ar.finishNode();
+    }
+
+    //----------------------------------------------------------------------------------//
+    //
+    template <typename Archive>
+    void load_values(Archive& ar, value_array& _values)
+    {
+        constexpr auto sz    = std::tuple_size<value_type>::value;
+        auto           _size = 0;
+        ar(cereal::make_nvp("entries", _size));
+        _values.resize(_size);
+
+        ar.setNextName("ert");
+        ar.startNode();
+        for(auto& itr : _values)
+        {
+            ar.startNode();
+            _load(ar, itr, make_index_sequence<sz>{});
+            ar.finishNode();
+        }
+        ar.finishNode();
+    }
+
     //----------------------------------------------------------------------------------//
     //
     template <size_t N>
@@ -35,6 +35,8 @@
 #include "timemory/components/cuda/backends.hpp"
 #include "timemory/ert/counter.hpp"
 #include "timemory/ert/data.hpp"
+#include "timemory/ert/simd.hpp"
+#include "timemory/ert/topology.hpp"
 #include "timemory/mpl/apply.hpp"
 #include "timemory/settings/declaration.hpp"
 #include "timemory/utility/macros.hpp"
@@ -44,6 +46,7 @@
 #include <functional>
 #include <future>
 #include <iomanip>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -61,7 +64,8 @@ namespace ert
 //--------------------------------------------------------------------------------------//
 
 template <size_t Nrep, typename DeviceT, typename Intp, typename Tp, typename OpsFuncT,
-          typename StoreFuncT, device::enable_if_cpu_t<DeviceT> = 0>
+          typename StoreFuncT, device::enable_if_cpu_t<DeviceT> = 0,
+          enable_if_t<!(simd::is_kernel<decay_t<OpsFuncT>>::value)> = 0>
 void
 ops_kernel(Intp ntrials, Intp nsize, Tp* A, OpsFuncT&& ops_func, StoreFuncT&& store_func)
 {
@@ -83,6 +87,22 @@ ops_kernel(Intp ntrials, Intp nsize, Tp* A, OpsFuncT&& ops_func, StoreFuncT&& st
     }
 }
 
+//--------------------------------------------------------------------------------------//
+//
+//      CPU -- multiple trial -- explicit SIMD
+//
+//--------------------------------------------------------------------------------------//
+
+template <size_t Nrep, typename DeviceT, typename Intp, typename Tp, typename OpsFuncT,
+          typename StoreFuncT, device::enable_if_cpu_t<DeviceT> = 0,
+          enable_if_t<(simd::is_kernel<decay_t<OpsFuncT>>::value)> = 0>
+void
+ops_kernel(Intp ntrials, Intp nsize, Tp* A, OpsFuncT&& ops_func, StoreFuncT&&)
+{
+    // the kernel performs the loads, stores, and "Nrep" FLOPs per element
+    ops_func.template execute<Nrep>(ntrials, nsize, A);
+}
+
 //--------------------------------------------------------------------------------------//
 //
 //      GPU -- multiple trial
@@ -187,10 +207,31 @@ ops_main(counter<DeviceT, Tp, CounterT>& _counter, OpsFuncT&& ops_func,
             cuda::stream_create(itr);
     }
 
+    // when the threads are pinned, each NUMA node has a barrier so that the threads of
+    // the node can be timed separately from the threads of the other nodes
+    const auto& _placement = _counter.placement;
+    std::vector<std::unique_ptr<thread_barrier>> nbarriers{};
+    for(const auto& itr : _placement)
+    {
+        if(itr.rank == 0)
+            nbarriers.emplace_back(
+                std::unique_ptr<thread_barrier>(new thread_barrier(itr.size)));
+    }
+
     auto _opfunc = [&](uint64_t tid, thread_barrier* fbarrier, thread_barrier* lbarrier) {
         using opmutex_t = std::mutex;
         using oplock_t  = std::unique_lock<opmutex_t>;
         static opmutex_t opmutex;
+        // pin the thread before the buffer is allocated so that the pages are
+        // first-touched on the NUMA node of the thread
+        const topology::placement* _place = nullptr;
+        if(tid < _placement.size())
+            _place = &_placement.at(tid);
+        auto* nbarrier = (_place) ? nbarriers.at(_place->index).get() : nullptr;
+        bool  _leader  = (_place && _place->rank == 0);
+        if(_place && !topology::set_affinity(_place->cpu) && settings::verbose() > 0)
+            fprintf(stderr, "[%s]> Warning! Unable to pin ERT thread %llu to cpu %lli\n",
+                    __FUNCTION__, (ull) tid, (long long) _place->cpu);
         {
             oplock_t _lock(opmutex);
             // execute the callback
@@ -256,8 +297,12 @@ ops_main(counter<DeviceT, Tp, CounterT>& _counter, OpsFuncT&& ops_func,
 
             // get instance of object measuring something during the calculation
             CounterT ct = _counter.get_counter();
+            // measures the threads of the NUMA node
+            CounterT nct = _counter.get_counter();
             // start the timer or anything else being recorded
             ct.start();
+            if(_leader)
+                nct.start();
 
             // only do this more complicated mess if we need to
             if(nstreams > 1)
@@ -299,6 +344,12 @@ ops_main(counter<DeviceT, Tp, CounterT>& _counter, OpsFuncT&& ops_func,
                     cuda::device_sync();
             }
 
+            // wait for the other threads on the same NUMA node
+            if(nbarrier)
+                nbarrier->spin_wait();
+            if(_leader)
+                nct.stop();
+
             // wait master thread notifies to proceed
             // if(lbarrier)
             //    lbarrier->notify_wait();
@@ -309,12 +360,15 @@ ops_main(counter<DeviceT, Tp, CounterT>& _counter, OpsFuncT&& ops_func,
             ct.stop();
 
             // store the result
-            if(tid == 0)
+            if(tid == 0 || _leader)
             {
                 // ensure there is not a data race if more than one thread somehow
                 // has a tid of 0
                 oplock_t _lock(opmutex);
-                _counter.record(ct, n, ntrials, Nops, _itr_params);
+                if(tid == 0)
+                    _counter.record(ct, n, ntrials, Nops, _itr_params);
+                if(_leader)
+                    _counter.record(nct, n, ntrials, Nops, _itr_params, *_place);
             }
 
             n = ((1.1 * n) == n) ? (n + 1) : (1.1 * n);
@@ -335,7 +389,8 @@ ops_main(counter<DeviceT, Tp, CounterT>& _counter, OpsFuncT&& ops_func,
     if(is_gpu)
         cuda::device_sync();
 
-    if(_counter.params.nthreads > 1)
+    // pinned threads are always spawned so the affinity of the calling thread is intact
+    if(_counter.params.nthreads > 1 || !_placement.empty())
     {
         // create synchronization barriers for the threads
         thread_barrier fbarrier(_counter.params.nthreads);
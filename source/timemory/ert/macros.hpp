@@ -90,3 +90,22 @@
 #        define TIMEMORY_ERT_EXTERN_TEMPLATE_CUDA(...)
 #    endif
 #endif
+//
+//--------------------------------------------------------------------------------------//
+//
+// explicit SIMD kernels are compiled for each instruction set via target attributes
+// and selected at runtime so they are only available for GNU-compatible compilers
+// targeting x86 (NVCC compiles the device kernels)
+#if !defined(TIMEMORY_ERT_USE_SIMD) && !defined(TIMEMORY_ERT_DISABLE_SIMD)
+#    if(defined(_TIMEMORY_GNU) || defined(_TIMEMORY_CLANG)) &&                           \
+        (defined(__x86_64__) || defined(__i386__)) && !defined(_TIMEMORY_NVCC) &&        \
+        !defined(_TIMEMORY_INTEL)
+#        define TIMEMORY_ERT_USE_SIMD
+#    endif
+#endif
+//
+#if defined(TIMEMORY_ERT_USE_SIMD)
+#    define TIMEMORY_ERT_SIMD_TARGET(...) __attribute__((target(__VA_ARGS__)))
+#else
+#    define TIMEMORY_ERT_SIMD_TARGET(...)
+#endif
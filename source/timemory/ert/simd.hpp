@@ -0,0 +1,556 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/** \file timemory/ert/simd.hpp
+ * \headerfile timemory/ert/simd.hpp "timemory/ert/simd.hpp"
+ * Provides ERT kernels which use explicit vector instructions (SSE2, AVX2 + FMA,
+ * AVX-512) selected at runtime via cpuid with a scalar fallback
+ *
+ */
+
+#pragma once
+
+#include "timemory/ert/macros.hpp"
+#include "timemory/settings/declaration.hpp"
+#include "timemory/utility/types.hpp"
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+#if defined(TIMEMORY_ERT_USE_SIMD)
+#    include <immintrin.h>
+#endif
+
+namespace tim
+{
+namespace ert
+{
+namespace simd
+{
+//--------------------------------------------------------------------------------------//
+//
+/// \enum tim::ert::simd::isa
+/// \brief The instruction sets with explicit ERT kernels. The ordering matters: a
+/// larger value implies support for all the smaller values
+///
+enum class isa : short
+{
+    scalar = 0,
+    sse2,
+    avx2,
+    avx512
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+inline const char*
+as_string(isa _isa)
+{
+    switch(_isa)
+    {
+        case isa::scalar: return "scalar";
+        case isa::sse2: return "sse2";
+        case isa::avx2: return "avx2";
+        case isa::avx512: return "avx512";
+    }
+    return "scalar";
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// the widest instruction set supported by the CPU (via cpuid)
+inline isa
+get_supported_isa()
+{
+#if defined(TIMEMORY_ERT_USE_SIMD)
+    static isa _instance = []() {
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f"))
+            return isa::avx512;
+        if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return isa::avx2;
+        if(__builtin_cpu_supports("sse2"))
+            return isa::sse2;
+        return isa::scalar;
+    }();
+    return _instance;
+#else
+    return isa::scalar;
+#endif
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// converts a request ("auto", "scalar", "none", "sse2", "avx2", "avx512") into the
+/// instruction set to use, which is never wider than what is supported
+inline isa
+get_isa(std::string _request)
+{
+    for(auto& itr : _request)
+        itr = std::tolower(itr);
+
+    auto _supported = get_supported_isa();
+    auto _isa       = _supported;
+    if(_request.empty() || _request == "auto")
+        _isa = _supported;
+    else if(_request == "scalar" || _request == "none" || _request == "off")
+        _isa = isa::scalar;
+    else if(_request == "sse2" || _request == "sse")
+        _isa = isa::sse2;
+    else if(_request == "avx2" || _request == "avx")
+        _isa = isa::avx2;
+    else if(_request == "avx512" || _request == "avx512f")
+        _isa = isa::avx512;
+    else
+        fprintf(stderr, "[%s]> Warning! Unknown ERT instruction set '%s'. Using '%s'\n",
+                __FUNCTION__, _request.c_str(), as_string(_supported));
+
+    if(_isa > _supported)
+    {
+        fprintf(stderr, "[%s]> Warning! ERT instruction set '%s' is not supported. "
+                        "Using '%s'\n",
+                __FUNCTION__, as_string(_isa), as_string(_supported));
+        _isa = _supported;
+    }
+    return _isa;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// the instruction set selected via TIMEMORY_ERT_SIMD
+inline isa
+get_isa()
+{
+    return get_isa(settings::ert_simd());
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// kernels are provided for single and double precision
+template <typename Tp>
+struct is_supported
+: std::integral_constant<bool, (std::is_same<Tp, float>::value ||
+                                std::is_same<Tp, double>::value)>
+{};
+//
+//--------------------------------------------------------------------------------------//
+//
+//  Every kernel performs the same work per element as ops_kernel with an FMA
+//  operation: "Nrep / 2" fused multiply-adds and, if Nrep is odd, one add, i.e.
+//  exactly Nrep FLOPs per element per trial:
+//
+//      beta = (Nrep % 2 == 1) ? (A[i] + alpha) : 0.8
+//      for(r = 0; r < Nrep / 2; ++r)
+//          beta = beta * A[i] + alpha
+//      A[i] = beta
+//
+//  The vector kernels process "unroll" independent vectors per iteration so that the
+//  latency of the FMA is hidden and the FMA units are saturated.
+//
+//--------------------------------------------------------------------------------------//
+//
+namespace scalar
+{
+template <size_t Nrep, typename Intp, typename Tp>
+inline void
+ops_kernel(Intp ntrials, Intp nsize, Tp* A, Tp alpha)
+{
+    constexpr size_t NUM_REP = Nrep / 2;
+    constexpr size_t MOD_REP = Nrep % 2;
+
+    for(Intp j = 0; j < ntrials; ++j)
+    {
+        for(Intp i = 0; i < nsize; ++i)
+        {
+            Tp beta = (MOD_REP == 1) ? (A[i] + alpha) : static_cast<Tp>(0.8);
+            for(size_t r = 0; r < NUM_REP; ++r)
+                beta = beta * A[i] + alpha;
+            A[i] = beta;
+        }
+        alpha *= static_cast<Tp>(1.0 - 1.0e-8);
+    }
+}
+}  // namespace scalar
+//
+//--------------------------------------------------------------------------------------//
+//
+#if defined(TIMEMORY_ERT_USE_SIMD)
+//
+//  the independent vectors must be fully unrolled so that they stay in registers
+//
+#    if defined(_TIMEMORY_CLANG)
+#        define TIMEMORY_ERT_SIMD_UNROLL _Pragma("unroll")
+#    elif defined(__GNUC__) && __GNUC__ >= 8
+#        define TIMEMORY_ERT_SIMD_UNROLL _Pragma("GCC unroll 16")
+#    else
+#        define TIMEMORY_ERT_SIMD_UNROLL
+#    endif
+//
+//  Generates the vector kernel for an instruction set from the vector operations
+//  defined in NS::ops<Tp> (which must be compiled with the same target)
+//
+#    define TIMEMORY_ERT_SIMD_KERNEL(NS, ...)                                            \
+        namespace NS                                                                     \
+        {                                                                                \
+        template <size_t Nrep, typename Intp, typename Tp>                               \
+        TIMEMORY_ERT_SIMD_TARGET(__VA_ARGS__)                                            \
+        void ops_kernel(Intp ntrials, Intp nsize, Tp* A, Tp alpha)                       \
+        {                                                                                \
+            using ops_t              = ops<Tp>;                                          \
+            using vec_t              = typename ops_t::type;                             \
+            constexpr size_t NUM_REP = Nrep / 2;                                         \
+            constexpr size_t MOD_REP = Nrep % 2;                                         \
+            constexpr Intp   W       = ops_t::width;                                     \
+            constexpr Intp   U       = ops_t::unroll;                                    \
+                                                                                         \
+            for(Intp j = 0; j < ntrials; ++j)                                            \
+            {                                                                            \
+                const vec_t valpha = ops_t::set1(alpha);                                 \
+                const vec_t vinit  = ops_t::set1(static_cast<Tp>(0.8));                  \
+                Intp        i      = 0;                                                  \
+                for(; i + U * W <= nsize; i += U * W)                                    \
+                {                                                                        \
+                    vec_t a[U];                                                          \
+                    vec_t b[U];                                                          \
+                    TIMEMORY_ERT_SIMD_UNROLL                                             \
+                    for(Intp u = 0; u < U; ++u)                                          \
+                    {                                                                    \
+                        a[u] = ops_t::load(A + i + u * W);                               \
+                        b[u] = (MOD_REP == 1) ? ops_t::add(a[u], valpha) : vinit;        \
+                    }                                                                    \
+                    for(size_t r = 0; r < NUM_REP; ++r)                                  \
+                    {                                                                    \
+                        TIMEMORY_ERT_SIMD_UNROLL                                         \
+                        for(Intp u = 0; u < U; ++u)                                      \
+                            b[u] = ops_t::fma(b[u], a[u], valpha);                       \
+                    }                                                                    \
+                    TIMEMORY_ERT_SIMD_UNROLL                                             \
+                    for(Intp u = 0; u < U; ++u)                                          \
+                        ops_t::store(A + i + u * W, b[u]);                               \
+                }                                                                        \
+                for(; i < nsize; ++i)                                                    \
+                {                                                                        \
+                    Tp beta = (MOD_REP == 1) ? (A[i] + alpha) : static_cast<Tp>(0.8);    \
+                    for(size_t r = 0; r < NUM_REP; ++r)                                  \
+                        beta = ops_t::fma(beta, A[i], alpha);                            \
+                    A[i] = beta;                                                         \
+                }                                                                        \
+                alpha *= static_cast<Tp>(1.0 - 1.0e-8);                                  \
+            }                                                                            \
+        }                                                                                \
+        }
+//
+//--------------------------------------------------------------------------------------//
+//
+namespace sse2
+{
+template <typename Tp>
+struct ops;
+
+template <>
+struct ops<double>
+{
+    using type                      = __m128d;
+    static constexpr int32_t width  = 2;
+    static constexpr int32_t unroll = 4;
+
+    // SSE2 has no FMA so these are separate multiply and add instructions
+    TIMEMORY_ERT_SIMD_TARGET("sse2") static type set1(double v) { return _mm_set1_pd(v); }
+    TIMEMORY_ERT_SIMD_TARGET("sse2") static type load(const double* p)
+    {
+        return _mm_loadu_pd(p);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("sse2") static void store(double* p, type v)
+    {
+        _mm_storeu_pd(p, v);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("sse2") static type add(type a, type b)
+    {
+        return _mm_add_pd(a, b);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("sse2") static type fma(type a, type b, type c)
+    {
+        return _mm_add_pd(_mm_mul_pd(a, b), c);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("sse2") static double fma(double a, double b, double c)
+    {
+        return a * b + c;
+    }
+};
+
+template <>
+struct ops<float>
+{
+    using type                      = __m128;
+    static constexpr int32_t width  = 4;
+    static constexpr int32_t unroll = 4;
+
+    TIMEMORY_ERT_SIMD_TARGET("sse2") static type set1(float v) { return _mm_set1_ps(v); }
+    TIMEMORY_ERT_SIMD_TARGET("sse2") static type load(const float* p)
+    {
+        return _mm_loadu_ps(p);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("sse2") static void store(float* p, type v)
+    {
+        _mm_storeu_ps(p, v);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("sse2") static type add(type a, type b)
+    {
+        return _mm_add_ps(a, b);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("sse2") static type fma(type a, type b, type c)
+    {
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("sse2") static float fma(float a, float b, float c)
+    {
+        return a * b + c;
+    }
+};
+}  // namespace sse2
+//
+//--------------------------------------------------------------------------------------//
+//
+namespace avx2
+{
+template <typename Tp>
+struct ops;
+
+template <>
+struct ops<double>
+{
+    using type                      = __m256d;
+    static constexpr int32_t width  = 4;
+    static constexpr int32_t unroll = 8;
+
+    TIMEMORY_ERT_SIMD_TARGET("avx2,fma") static type set1(double v)
+    {
+        return _mm256_set1_pd(v);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx2,fma") static type load(const double* p)
+    {
+        return _mm256_loadu_pd(p);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx2,fma") static void store(double* p, type v)
+    {
+        _mm256_storeu_pd(p, v);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx2,fma") static type add(type a, type b)
+    {
+        return _mm256_add_pd(a, b);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx2,fma") static type fma(type a, type b, type c)
+    {
+        return _mm256_fmadd_pd(a, b, c);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx2,fma") static double fma(double a, double b, double c)
+    {
+        return _mm_cvtsd_f64(
+            _mm_fmadd_sd(_mm_set_sd(a), _mm_set_sd(b), _mm_set_sd(c)));
+    }
+};
+
+template <>
+struct ops<float>
+{
+    using type                      = __m256;
+    static constexpr int32_t width  = 8;
+    static constexpr int32_t unroll = 8;
+
+    TIMEMORY_ERT_SIMD_TARGET("avx2,fma") static type set1(float v)
+    {
+        return _mm256_set1_ps(v);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx2,fma") static type load(const float* p)
+    {
+        return _mm256_loadu_ps(p);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx2,fma") static void store(float* p, type v)
+    {
+        _mm256_storeu_ps(p, v);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx2,fma") static type add(type a, type b)
+    {
+        return _mm256_add_ps(a, b);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx2,fma") static type fma(type a, type b, type c)
+    {
+        return _mm256_fmadd_ps(a, b, c);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx2,fma") static float fma(float a, float b, float c)
+    {
+        return _mm_cvtss_f32(_mm_fmadd_ss(_mm_set_ss(a), _mm_set_ss(b), _mm_set_ss(c)));
+    }
+};
+}  // namespace avx2
+//
+//--------------------------------------------------------------------------------------//
+//
+namespace avx512
+{
+template <typename Tp>
+struct ops;
+
+template <>
+struct ops<double>
+{
+    using type                      = __m512d;
+    static constexpr int32_t width  = 8;
+    static constexpr int32_t unroll = 8;
+
+    TIMEMORY_ERT_SIMD_TARGET("avx512f,fma") static type set1(double v)
+    {
+        return _mm512_set1_pd(v);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx512f,fma") static type load(const double* p)
+    {
+        return _mm512_loadu_pd(p);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx512f,fma") static void store(double* p, type v)
+    {
+        _mm512_storeu_pd(p, v);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx512f,fma") static type add(type a, type b)
+    {
+        return _mm512_add_pd(a, b);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx512f,fma") static type fma(type a, type b, type c)
+    {
+        return _mm512_fmadd_pd(a, b, c);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx512f,fma")
+    static double fma(double a, double b, double c)
+    {
+        return _mm_cvtsd_f64(
+            _mm_fmadd_sd(_mm_set_sd(a), _mm_set_sd(b), _mm_set_sd(c)));
+    }
+};
+
+template <>
+struct ops<float>
+{
+    using type                      = __m512;
+    static constexpr int32_t width  = 16;
+    static constexpr int32_t unroll = 8;
+
+    TIMEMORY_ERT_SIMD_TARGET("avx512f,fma") static type set1(float v)
+    {
+        return _mm512_set1_ps(v);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx512f,fma") static type load(const float* p)
+    {
+        return _mm512_loadu_ps(p);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx512f,fma") static void store(float* p, type v)
+    {
+        _mm512_storeu_ps(p, v);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx512f,fma") static type add(type a, type b)
+    {
+        return _mm512_add_ps(a, b);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx512f,fma") static type fma(type a, type b, type c)
+    {
+        return _mm512_fmadd_ps(a, b, c);
+    }
+    TIMEMORY_ERT_SIMD_TARGET("avx512f,fma")
+    static float fma(float a, float b, float c)
+    {
+        return _mm_cvtss_f32(_mm_fmadd_ss(_mm_set_ss(a), _mm_set_ss(b), _mm_set_ss(c)));
+    }
+};
+}  // namespace avx512
+//
+//--------------------------------------------------------------------------------------//
+//
+TIMEMORY_ERT_SIMD_KERNEL(sse2, "sse2")
+TIMEMORY_ERT_SIMD_KERNEL(avx2, "avx2,fma")
+TIMEMORY_ERT_SIMD_KERNEL(avx512, "avx512f,fma")
+//
+#endif  // defined(TIMEMORY_ERT_USE_SIMD)
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::ert::simd::fma_kernel
+/// \brief Passed to \ref tim::ert::ops_main in place of the scalar FMA function to
+/// execute the explicitly vectorized kernel for the selected instruction set.
+///
+struct fma_kernel
+{
+    isa target = get_isa();
+
+    /// the number of FLOPs per element per trial for a given number of ops
+    template <size_t Nrep>
+    static constexpr size_t flops_per_element()
+    {
+        return 2 * (Nrep / 2) + (Nrep % 2);
+    }
+
+    template <size_t Nrep, typename Intp, typename Tp,
+              enable_if_t<(is_supported<Tp>::value), int> = 0>
+    void execute(Intp ntrials, Intp nsize, Tp* A,
+                 Tp alpha = static_cast<Tp>(0.5)) const
+    {
+        switch(target)
+        {
+#if defined(TIMEMORY_ERT_USE_SIMD)
+            case isa::avx512:
+                avx512::ops_kernel<Nrep>(ntrials, nsize, A, alpha);
+                return;
+            case isa::avx2: avx2::ops_kernel<Nrep>(ntrials, nsize, A, alpha); return;
+            case isa::sse2: sse2::ops_kernel<Nrep>(ntrials, nsize, A, alpha); return;
+#endif
+            default: break;
+        }
+        scalar::ops_kernel<Nrep>(ntrials, nsize, A, alpha);
+    }
+
+    template <size_t Nrep, typename Intp, typename Tp,
+              enable_if_t<!(is_supported<Tp>::value), int> = 0>
+    void execute(Intp ntrials, Intp nsize, Tp* A,
+                 Tp alpha = static_cast<Tp>(0.5)) const
+    {
+        scalar::ops_kernel<Nrep>(ntrials, nsize, A, alpha);
+    }
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+struct is_kernel : std::false_type
+{};
+
+template <>
+struct is_kernel<fma_kernel> : std::true_type
+{};
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace simd
+}  // namespace ert
+}  // namespace tim
@@ -0,0 +1,273 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/** \file timemory/ert/topology.hpp
+ * \headerfile timemory/ert/topology.hpp "timemory/ert/topology.hpp"
+ * Provides the NUMA topology and the thread placement used by the NUMA-aware CPU ERT
+ *
+ */
+
+#pragma once
+
+#include "timemory/macros/os.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_LINUX)
+#    include <dirent.h>
+#    include <sched.h>
+#endif
+
+namespace tim
+{
+namespace ert
+{
+namespace topology
+{
+using cpu_list_t = std::vector<int64_t>;
+//
+//--------------------------------------------------------------------------------------//
+//
+/// parse a kernel cpu-list, e.g. "0-3,8,10-11"
+inline cpu_list_t
+parse_cpu_list(const std::string& _str)
+{
+    cpu_list_t        _cpus{};
+    std::stringstream _ss{ _str };
+    std::string       _range{};
+    while(std::getline(_ss, _range, ','))
+    {
+        if(_range.find_first_of("0123456789") == std::string::npos)
+            continue;
+        auto _dash = _range.find('-');
+        auto _beg  = std::strtoll(_range.c_str(), nullptr, 10);
+        auto _end  = (_dash == std::string::npos)
+                        ? _beg
+                        : std::strtoll(_range.c_str() + _dash + 1, nullptr, 10);
+        for(auto i = _beg; i <= _end; ++i)
+            _cpus.emplace_back(i);
+    }
+    std::sort(_cpus.begin(), _cpus.end());
+    _cpus.erase(std::unique(_cpus.begin(), _cpus.end()), _cpus.end());
+    return _cpus;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// inverse of \ref parse_cpu_list for a sorted list
+inline std::string
+as_cpu_list(const cpu_list_t& _cpus)
+{
+    std::stringstream _ss{};
+    for(size_t i = 0; i < _cpus.size(); ++i)
+    {
+        auto j = i;
+        while(j + 1 < _cpus.size() && _cpus.at(j + 1) == _cpus.at(j) + 1)
+            ++j;
+        _ss << ((i == 0) ? "" : ",") << _cpus.at(i);
+        if(j > i)
+            _ss << "-" << _cpus.at(j);
+        i = j;
+    }
+    return _ss.str();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// the cpus the process is allowed to run on
+inline cpu_list_t
+get_affinity()
+{
+    cpu_list_t _cpus{};
+#if defined(_LINUX)
+    cpu_set_t _set;
+    CPU_ZERO(&_set);
+    if(sched_getaffinity(0, sizeof(cpu_set_t), &_set) == 0)
+    {
+        for(int i = 0; i < CPU_SETSIZE; ++i)
+        {
+            if(CPU_ISSET(i, &_set))
+                _cpus.emplace_back(i);
+        }
+    }
+#endif
+    if(_cpus.empty())
+    {
+        int64_t _ncpu = std::thread::hardware_concurrency();
+        for(int64_t i = 0; i < _ncpu; ++i)
+            _cpus.emplace_back(i);
+    }
+    return _cpus;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// pin the calling thread to a single cpu. Returns false if not supported or denied
+inline bool
+set_affinity(int64_t _cpu)
+{
+#if defined(_LINUX)
+    if(_cpu < 0 || _cpu >= CPU_SETSIZE)
+        return false;
+    cpu_set_t _set;
+    CPU_ZERO(&_set);
+    CPU_SET(_cpu, &_set);
+    return (sched_setaffinity(0, sizeof(cpu_set_t), &_set) == 0);
+#else
+    (void) _cpu;
+    return false;
+#endif
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::ert::topology::numa_node
+/// \brief A NUMA node and the cpus of the node which the process may run on
+///
+struct numa_node
+{
+    int64_t    id   = 0;
+    cpu_list_t cpus = {};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// the NUMA nodes in \param _root restricted to \param _allowed. Nodes without any
+/// allowed cpus are omitted. When the topology is not available (e.g. not Linux or
+/// NUMA disabled in the kernel), all the allowed cpus are reported as node zero
+inline std::vector<numa_node>
+get_numa_nodes(const std::string& _root    = "/sys/devices/system/node",
+               const cpu_list_t&  _allowed = get_affinity())
+{
+    std::vector<numa_node> _nodes{};
+#if defined(_LINUX)
+    if(auto* _dir = opendir(_root.c_str()))
+    {
+        while(auto* _ent = readdir(_dir))
+        {
+            std::string _name = _ent->d_name;
+            if(_name.find("node") != 0 || _name.length() == 4 ||
+               _name.find_first_not_of("0123456789", 4) != std::string::npos)
+                continue;
+            std::ifstream ifs{ _root + "/" + _name + "/cpulist" };
+            std::string   _cpulist{};
+            if(!ifs || !std::getline(ifs, _cpulist))
+                continue;
+            numa_node _node{};
+            _node.id = std::strtoll(_name.c_str() + 4, nullptr, 10);
+            for(auto itr : parse_cpu_list(_cpulist))
+            {
+                if(std::binary_search(_allowed.begin(), _allowed.end(), itr))
+                    _node.cpus.emplace_back(itr);
+            }
+            if(!_node.cpus.empty())
+                _nodes.emplace_back(_node);
+        }
+        closedir(_dir);
+    }
+#else
+    (void) _root;
+#endif
+    if(_nodes.empty())
+        _nodes.emplace_back(numa_node{ 0, _allowed });
+    std::sort(_nodes.begin(), _nodes.end(),
+              [](const numa_node& lhs, const numa_node& rhs) { return lhs.id < rhs.id; });
+    return _nodes;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::ert::topology::placement
+/// \brief Where an ERT thread runs: the cpu it is pinned to, its NUMA node, the index
+/// of the node among the nodes which have threads, the rank of the thread within the
+/// node and the number of threads on the node
+///
+struct placement
+{
+    int64_t     cpu   = -1;
+    int64_t     node  = 0;
+    uint64_t    index = 0;
+    uint64_t    rank  = 0;
+    uint64_t    size  = 0;
+    std::string cpus  = {};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// distributes \param _nthreads round-robin across the nodes so every node gets an
+/// (almost) equal share, and round-robin across the cpus within each node
+inline std::vector<placement>
+get_placement(uint64_t _nthreads, const std::vector<numa_node>& _nodes = get_numa_nodes())
+{
+    std::vector<placement> _ret{};
+    if(_nodes.empty())
+        return _ret;
+
+    auto _nnodes = std::min<uint64_t>(_nodes.size(), std::max<uint64_t>(_nthreads, 1));
+    std::vector<uint64_t> _sizes(_nnodes, 0);
+    for(uint64_t i = 0; i < _nthreads; ++i)
+        ++_sizes.at(i % _nnodes);
+
+    for(uint64_t i = 0; i < _nthreads; ++i)
+    {
+        const auto& _node = _nodes.at(i % _nnodes);
+        placement   _place{};
+        _place.index = i % _nnodes;
+        _place.rank  = i / _nnodes;
+        _place.size  = _sizes.at(_place.index);
+        _place.node  = _node.id;
+        _place.cpu   = _node.cpus.at(_place.rank % _node.cpus.size());
+        _place.cpus  = as_cpu_list(_node.cpus);
+        _ret.emplace_back(_place);
+    }
+    return _ret;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// canonical description of a placement for fingerprinting: the node and cpu of each
+/// thread, e.g. "n0:0,n1:16,n0:1,n1:17"
+inline std::string
+as_string(const std::vector<placement>& _placement)
+{
+    std::stringstream _ss{};
+    for(size_t i = 0; i < _placement.size(); ++i)
+        _ss << ((i == 0) ? "" : ",") << "n" << _placement.at(i).node << ":"
+            << _placement.at(i).cpu;
+    return _ss.str();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace topology
+}  // namespace ert
+}  // namespace tim
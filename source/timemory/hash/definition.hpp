@@ -98,6 +98,32 @@ add_hash_id(const std::string& prefix)
 //
 //--------------------------------------------------------------------------------------//
 //
+TIMEMORY_HASH_LINKAGE(hash_result_type)
+add_hash_id(const char* prefix)
+{
+    static thread_local auto _hash_map = get_hash_ids();
+    hash_result_type         _hash_id  = get_hash_id(prefix);
+    if(_hash_map && _hash_map->find(_hash_id) == _hash_map->end())
+        add_hash_id(_hash_map, std::string(prefix));
+    return _hash_id;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+#    if TIMEMORY_STRING_VIEW > 0
+TIMEMORY_HASH_LINKAGE(hash_result_type)
+add_hash_id(string_view_t prefix)
+{
+    static thread_local auto _hash_map = get_hash_ids();
+    hash_result_type         _hash_id  = get_hash_id(prefix);
+    if(_hash_map && _hash_map->find(_hash_id) == _hash_map->end())
+        add_hash_id(_hash_map, std::string(prefix));
+    return _hash_id;
+}
+#    endif
+//
+//--------------------------------------------------------------------------------------//
+//
 TIMEMORY_HASH_LINKAGE(void)
 add_hash_id(const graph_hash_map_ptr_t&   _hash_map,
             const graph_hash_alias_ptr_t& _hash_alias, hash_result_type _hash_id,
@@ -26,7 +26,10 @@
 
 #include "timemory/api.hpp"
 #include "timemory/hash/macros.hpp"
+#include "timemory/macros/language.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -57,12 +60,58 @@ get_hash_aliases();
 //
 //--------------------------------------------------------------------------------------//
 //
-template <typename Tp>
-hash_result_type
-get_hash_id(Tp&& prefix)
+//  64-bit FNV-1a. It is a constant expression for string literals, __FUNCTION__, and
+//  __FILE__ and produces the same id at runtime for the same characters so ids computed
+//  at compile-time and ids computed from dynamic strings are interchangeable.
+//
+namespace hash
+{
+static constexpr uint64_t fnv1a_offset_basis = 14695981039346656037ULL;
+static constexpr uint64_t fnv1a_prime        = 1099511628211ULL;
+//
+constexpr hash_result_type
+fnv1a(const char* _str, size_t _len)
+{
+    uint64_t _hash = fnv1a_offset_basis;
+    for(size_t i = 0; i < _len; ++i)
+    {
+        _hash ^= static_cast<uint64_t>(static_cast<unsigned char>(_str[i]));
+        _hash *= fnv1a_prime;
+    }
+    return static_cast<hash_result_type>(_hash);
+}
+//
+constexpr size_t
+length(const char* _str)
+{
+    size_t _len = 0;
+    while(_str && _str[_len] != '\0')
+        ++_len;
+    return _len;
+}
+}  // namespace hash
+//
+//--------------------------------------------------------------------------------------//
+//
+constexpr hash_result_type
+get_hash_id(const char* prefix)
+{
+    return hash::fnv1a(prefix, hash::length(prefix));
+}
+//
+inline hash_result_type
+get_hash_id(const std::string& prefix)
+{
+    return hash::fnv1a(prefix.data(), prefix.length());
+}
+//
+#if TIMEMORY_STRING_VIEW > 0
+constexpr hash_result_type
+get_hash_id(string_view_t prefix)
 {
-    return std::hash<std::string>()(std::forward<Tp>(prefix));
+    return hash::fnv1a(prefix.data(), prefix.length());
 }
+#endif
 //
 //--------------------------------------------------------------------------------------//
 //
@@ -81,6 +130,32 @@ add_hash_id(const std::string& prefix);
 //
 //--------------------------------------------------------------------------------------//
 //
+//  these only construct a std::string the first time the label is seen on a thread
+//
+hash_result_type
+add_hash_id(const char* prefix);
+//
+#if TIMEMORY_STRING_VIEW > 0
+hash_result_type
+add_hash_id(string_view_t prefix);
+#endif
+//
+//--------------------------------------------------------------------------------------//
+//
+//  maps a hash computed at compile-time to its label. The label is only registered the
+//  first time this is called on a thread, e.g. see TIMEMORY_STATIC_HASH_ID
+//
+template <hash_result_type HashV>
+hash_result_type
+add_hash_id(const char* prefix)
+{
+    static thread_local auto _once = (add_hash_id(prefix), true);
+    (void) _once;
+    return HashV;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
 void
 add_hash_id(const graph_hash_map_ptr_t&   _hash_map,
             const graph_hash_alias_ptr_t& _hash_alias, hash_result_type _hash_id,
@@ -126,3 +201,13 @@ get_shared_ptr_pair_master_instance();
 //--------------------------------------------------------------------------------------//
 //
 }  // namespace tim
+//
+//--------------------------------------------------------------------------------------//
+//
+//  hash id of a string literal (or __FUNCTION__) which is computed at compile-time. The
+//  label is only registered the first time this is evaluated on a thread.
+//
+#if !defined(TIMEMORY_LITERAL_HASH_ID)
+#    define TIMEMORY_LITERAL_HASH_ID(LABEL)                                              \
+        ::tim::add_hash_id<::tim::get_hash_id(LABEL)>(LABEL)
+#endif
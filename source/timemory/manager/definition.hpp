@@ -34,6 +34,8 @@
 #include "timemory/manager/macros.hpp"
 #include "timemory/manager/types.hpp"
 #include "timemory/utility/signals.hpp"
+#include "timemory/variadic/subsample.hpp"
+#include "timemory/variadic/throttle.hpp"
 
 //--------------------------------------------------------------------------------------//
 //
@@ -456,6 +458,11 @@ manager::write_metadata(const char* context)
             {
                 env_settings::serialize_environment(*oa);
             }
+            // regions throttled or sampled by the bundles
+            {
+                throttle::serialize_metadata(*oa);
+                subsample::serialize_metadata(*oa);
+            }
             //
             oa->finishNode();
         }
@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include "timemory/macros/language.hpp"
+
 #include <cstddef>
 #include <cstdint>
 #include <tuple>
@@ -351,6 +353,25 @@ struct component_type
     using type = typename T::component_type;
 };
 
+//----------------------------------------------------------------------------------//
+/// \struct tim::concepts::is_string_key
+/// \brief true for character arrays (e.g. string literals) and, when it is not an alias
+/// for std::string, \ref tim::string_view_t. The hash of these keys is computed without
+/// constructing a std::string.
+///
+template <typename T>
+struct is_string_key
+{
+private:
+    using type = std::remove_cv_t<std::remove_reference_t<T>>;
+
+public:
+    static constexpr bool value =
+        (std::is_array<type>::value &&
+         std::is_same<std::remove_cv_t<std::remove_extent_t<type>>, char>::value) ||
+        (TIMEMORY_STRING_VIEW > 0 && std::is_same<type, string_view_t>::value);
+};
+
 //----------------------------------------------------------------------------------//
 
 }  // namespace concepts
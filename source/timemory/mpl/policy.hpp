@@ -31,6 +31,7 @@
 #pragma once
 
 #include "timemory/components/types.hpp"
+#include "timemory/data/quantile_sketch.hpp"
 #include "timemory/data/statistics.hpp"
 #include "timemory/mpl/apply.hpp"
 #include "timemory/mpl/filters.hpp"
@@ -87,6 +88,29 @@ struct record_statistics<CompT, std::tuple<>>
     {}
 };
 
+//--------------------------------------------------------------------------------------//
+//
+template <typename CompT, typename Tp>
+struct record_quantiles
+{
+    using type            = Tp;
+    using this_type       = record_quantiles<CompT, type>;
+    using policy_type     = this_type;
+    using statistics_type = quantile_statistics<type>;
+
+    static void apply(statistics_type& _stat, const CompT& _obj)
+    {
+        using result_type = decltype(std::declval<CompT>().get());
+        static_assert(std::is_same<result_type, Tp>::value,
+                      "Error! 'policy::record_quantiles<Component, T>::apply' requires "
+                      "'T' to be the same type as the return type from "
+                      "'Component::get()'");
+
+        _stat += _obj.get();
+    }
+    static void apply(type&, const CompT&) {}
+};
+
 //======================================================================================//
 
 template <typename Archive, typename Api>
@@ -361,6 +361,15 @@ struct instance_tracker;
 template <typename CompT, typename T = typename trait::statistics<CompT>::type>
 struct record_statistics;
 
+/// \struct tim::policy::record_quantiles
+/// \brief Specification of how to accumulate statistics which also maintains a
+/// fixed-memory quantile sketch per node (see \ref tim::quantile_statistics). Selected
+/// for a component by specializing \ref tim::policy::record_statistics to inherit from
+/// this policy, e.g. via \code{.cpp} TIMEMORY_STATISTICS_QUANTILES(wall_clock, double)
+/// \endcode
+template <typename CompT, typename T = typename trait::statistics<CompT>::type>
+struct record_quantiles;
+
 /// \struct tim::policy::input_archive
 /// \brief Provides a static get() function which returns a shared pointer to an instance
 /// of the given archive format for input. Can also provides static functions for any
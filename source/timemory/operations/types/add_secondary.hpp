@@ -48,8 +48,10 @@ namespace operation
 /// but should be another node entry in the graph. These types
 /// must provide a get_secondary() member function and that member function
 /// must return a pair-wise iterable container, e.g. std::map, of types:
-///     - std::string
+///     - std::string or hash_result_type
 ///     - value_type
+/// Containers keyed by a hash id (see \ref tim::add_hash_id) are appended without
+/// re-hashing the label.
 ///
 //
 //--------------------------------------------------------------------------------------//
@@ -72,9 +74,8 @@ struct add_secondary
            !settings::add_secondary())
             return;
 
-        using secondary_data_t = std::tuple<Iterator, const string_t&, value_type>;
         for(const auto& _data : _rhs.get_secondary())
-            _storage->append(secondary_data_t{ _itr, _data.first, _data.second });
+            append(_storage, _itr, _data.first, _data.second);
     }
 
     //----------------------------------------------------------------------------------//
@@ -97,6 +98,28 @@ struct add_secondary
     }
 
 private:
+    //----------------------------------------------------------------------------------//
+    //  secondary entry keyed by label
+    //
+    template <typename Storage, typename Iterator, typename Vp>
+    static void append(Storage* _storage, Iterator _itr, const string_t& _key,
+                       const Vp& _val)
+    {
+        using secondary_data_t = std::tuple<Iterator, const string_t&, value_type>;
+        _storage->append(secondary_data_t{ _itr, _key, _val });
+    }
+
+    //----------------------------------------------------------------------------------//
+    //  secondary entry keyed by hash id
+    //
+    template <typename Storage, typename Iterator, typename Vp>
+    static void append(Storage* _storage, Iterator _itr, hash_result_type _key,
+                       const Vp& _val)
+    {
+        using secondary_data_t = std::tuple<Iterator, hash_result_type, value_type>;
+        _storage->append(secondary_data_t{ _itr, _key, _val });
+    }
+
     //----------------------------------------------------------------------------------//
     //  If the component has a get_secondary() member function
     //
@@ -108,9 +131,8 @@ private:
            !settings::add_secondary())
             return;
 
-        using secondary_data_t = std::tuple<Iterator, const string_t&, value_type>;
         for(const auto& _data : _rhs.get_secondary())
-            _storage->append(secondary_data_t{ _itr, _data.first, _data.second });
+            append(_storage, _itr, _data.first, _data.second);
     }
 
     //----------------------------------------------------------------------------------//
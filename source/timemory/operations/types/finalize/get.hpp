@@ -38,6 +38,7 @@
 #include "timemory/storage/node.hpp"
 #include "timemory/storage/types.hpp"
 #include "timemory/tpls/cereal/cereal.hpp"
+#include "timemory/variadic/subsample.hpp"
 
 #include <string>
 #include <vector>
@@ -238,6 +239,12 @@ get<Type, true>::operator()(result_type& ret)
     if(!m_storage)
         return ret;
 
+    // the results of exited threads which are waiting to be reused
+    m_storage->merge_pool();
+
+    // the sampled measurements are scaled to the number of calls to each region
+    subsample::update_corrections();
+
     auto& data               = *m_storage;
     bool  _thread_scope_only = trait::thread_scope_only<Type>::value;
     bool  _use_tid_prefix    = (!settings::collapse_threads() || _thread_scope_only);
@@ -392,7 +399,7 @@ get<Type, true>::operator()(result_type& ret)
                     auto _depth     = itr->depth() - (_min + 1);
                     auto _prefix    = _compute_modified_prefix(*itr);
                     auto _rolling   = itr->id();
-                    auto _stats     = itr->stats();
+                    auto _stats     = itr->get_estimate_stats();
                     auto _parent    = graph_type::parent(itr);
                     auto _hierarchy = hierarchy_type{};
                     auto _tid       = itr->tid();
@@ -411,8 +418,9 @@ get<Type, true>::operator()(result_type& ret)
                     if(_hierarchy.size() > 1)
                         std::reverse(_hierarchy.begin(), _hierarchy.end());
                     _hierarchy.push_back(itr->id());
-                    auto&& _entry = result_node(itr->id(), itr->obj(), _prefix, _depth,
-                                                _rolling, _hierarchy, _stats, _tid, _pid);
+                    auto&& _entry =
+                        result_node(itr->id(), itr->get_estimate(), _prefix, _depth,
+                                    _rolling, _hierarchy, _stats, _tid, _pid);
                     _list.push_back(_entry);
                 }
             }
@@ -438,6 +446,9 @@ get<Type, true>::operator()(basic_tree_vector_type& bt)
     if(!m_storage)
         return bt;
 
+    // the sampled measurements are scaled to the number of calls to each region
+    subsample::update_corrections();
+
     auto& data = *m_storage;
     auto& t    = data.graph();
     for(sibling_iterator itr = t.begin(); itr != t.end(); ++itr)
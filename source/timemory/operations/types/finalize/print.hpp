@@ -44,6 +44,7 @@
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace tim
@@ -387,13 +388,23 @@ print<Tp, true>::update_data()
 
         for(size_t i = 0; i < num_ranks; ++i)
         {
+            // index the current results by the rolling hash so that matching
+            // each input node is a lookup instead of a linear search
+            using node_type  = typename value_type::value_type;
+            using index_type = std::unordered_multimap<uint64_t, const node_type*>;
+            index_type _index{};
+            _index.reserve(node_results.at(i).size());
+            for(const auto& ritr : node_results.at(i))
+                _index.emplace(ritr.rolling_hash(), &ritr);
+
             for(auto& iitr : node_input.at(i))
             {
-                for(auto& ritr : node_results.at(i))
+                auto _range = _index.equal_range(iitr.rolling_hash());
+                for(auto ritr = _range.first; ritr != _range.second; ++ritr)
                 {
-                    if(iitr == ritr)
+                    if(iitr == *ritr->second)
                     {
-                        node_delta.at(i).push_back(ritr);
+                        node_delta.at(i).push_back(*ritr->second);
                         node_delta.at(i).back() -= iitr;
                         break;
                     }
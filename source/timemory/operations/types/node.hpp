@@ -36,6 +36,8 @@
 #include "timemory/operations/types/add_secondary.hpp"
 #include "timemory/operations/types/add_statistics.hpp"
 #include "timemory/operations/types/math.hpp"
+#include "timemory/storage/live_view.hpp"
+#include "timemory/variadic/subsample.hpp"
 
 namespace tim
 {
@@ -153,23 +155,19 @@ private:
 
             if(storage_type::is_finalizing())
             {
-                operation::plus<type>(targ, _obj);
-                operation::add_secondary<type>(_storage, _obj.graph_itr, _obj);
-                operation::add_statistics<type>(_obj, stats);
+                update(_obj, targ, stats, _storage);
             }
             else if(_obj.is_flat)
             {
-                operation::plus<type>(targ, _obj);
-                operation::add_secondary<type>(_storage, _obj.graph_itr, _obj);
-                operation::add_statistics<type>(_obj, stats);
+                update(_obj, targ, stats, _storage);
+                live_view::update(_storage, _obj.graph_itr, targ, _obj);
                 _storage->stack_pop(&_obj);
             }
             else
             {
                 auto _beg_depth = _storage->depth();
-                operation::plus<type>(targ, _obj);
-                operation::add_secondary<type>(_storage, _obj.graph_itr, _obj);
-                operation::add_statistics<type>(_obj, stats);
+                update(_obj, targ, stats, _storage);
+                live_view::update(_storage, _obj.graph_itr, targ, _obj);
                 if(_storage)
                 {
                     _storage->pop();
@@ -179,9 +177,36 @@ private:
                 }
             }
             targ.is_running = false;
+            clear_secondary(_obj, 0);
         }
     }
 
+    //  the secondary data belongs to the measurement which was just popped
+    template <typename Up>
+    static auto clear_secondary(Up& _obj, int) -> decltype(_obj.clear_secondary(), void())
+    {
+        _obj.clear_secondary();
+    }
+
+    template <typename Up>
+    static void clear_secondary(Up&, long)
+    {}
+
+    //  a sampled measurement records the number of calls it represents in the node
+    //  and it is scaled when the results are collected
+    template <typename Up, typename StatsT, typename StorageT>
+    static void update(Up& _obj, Up& _targ, StatsT& _stats, StorageT* _storage)
+    {
+        auto _weight = subsample::get_weight();
+        if(_weight < 0.0)
+            return;
+        operation::plus<type>(_targ, _obj);
+        operation::add_secondary<type>(_storage, _obj.graph_itr, _obj);
+        operation::add_statistics<type>(_obj, _stats);
+        if(_weight > 0.0)
+            _obj.graph_itr->add_sample(_weight);
+    }
+
     //  typical resolution: component
     template <typename Up, typename... Args>
     auto sfinae(Up& obj, int, int, int, long, Args&&...)
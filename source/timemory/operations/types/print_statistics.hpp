@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "timemory/data/quantile_sketch.hpp"
 #include "timemory/data/statistics.hpp"
 #include "timemory/data/stream.hpp"
 #include "timemory/environment/declaration.hpp"
@@ -36,8 +37,11 @@
 #include "timemory/operations/declaration.hpp"
 #include "timemory/operations/macros.hpp"
 #include "timemory/operations/types.hpp"
+#include "timemory/settings/declaration.hpp"
 
+#include <cctype>
 #include <cstdint>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -74,6 +78,8 @@ public:
         bool use_max    = get_env<bool>("TIMEMORY_PRINT_MIN", true);
         bool use_var    = get_env<bool>("TIMEMORY_PRINT_VARIANCE", false);
         bool use_stddev = get_env<bool>("TIMEMORY_PRINT_STDDEV", true);
+        bool use_sample = get_env<bool>("TIMEMORY_PRINT_SAMPLING",
+                                        settings::sample_interval() > 1);
 
         if(use_min)
             utility::write_entry(_os, "MIN", _stats.get_min());
@@ -83,6 +89,12 @@ public:
             utility::write_entry(_os, "VAR", _stats.get_variance());
         if(use_stddev)
             utility::write_entry(_os, "STDDEV", _stats.get_stddev());
+        if(use_sample)
+        {
+            utility::write_entry(_os, "RATIO", _stats.get_sampling_ratio());
+            utility::write_entry(_os, "ERROR", _stats.get_standard_error());
+        }
+        write_quantiles(_os, _stats);
     }
 
     template <typename Self, typename Vp, typename Up = Tp,
@@ -98,7 +110,7 @@ public:
 public:
     template <template <typename> class Sp, typename Vp, typename Up = Tp,
               enable_if_t<(stats_enabled<Up, Vp>::value), int> = 0>
-    static void get_header(utility::stream& _os, const Sp<Vp>&)
+    static void get_header(utility::stream& _os, const Sp<Vp>& _stats)
     {
         if(!trait::runtime_enabled<Tp>::get())
             return;
@@ -107,6 +119,8 @@ public:
         bool use_max    = get_env<bool>("TIMEMORY_PRINT_MIN", true);
         bool use_var    = get_env<bool>("TIMEMORY_PRINT_VARIANCE", false);
         bool use_stddev = get_env<bool>("TIMEMORY_PRINT_STDDEV", true);
+        bool use_sample = get_env<bool>("TIMEMORY_PRINT_SAMPLING",
+                                        settings::sample_interval() > 1);
 
         auto _flags = Tp::get_format_flags();
         auto _width = Tp::get_width();
@@ -120,6 +134,12 @@ public:
             utility::write_header(_os, "VAR", _flags, _width, _prec);
         if(use_stddev)
             utility::write_header(_os, "STDDEV", _flags, _width, _prec);
+        if(use_sample)
+        {
+            utility::write_header(_os, "RATIO", _flags, _width, _prec);
+            utility::write_header(_os, "ERROR", _flags, _width, _prec);
+        }
+        write_quantiles_header(_os, _stats);
     }
 
     template <typename Vp, typename Up = Tp,
@@ -128,6 +148,51 @@ public:
     {}
 
     static void get_header(utility::stream&, const statistics<std::tuple<>>&) {}
+
+private:
+    static std::string get_quantile_label(const char* _name)
+    {
+        std::string _label = _name;
+        for(auto& itr : _label)
+            itr = std::toupper(itr);
+        return _label;
+    }
+
+    template <typename Vp>
+    static void write_quantiles(utility::stream&               _os,
+                                const quantile_statistics<Vp>& _stats)
+    {
+        if(!get_env<bool>("TIMEMORY_PRINT_QUANTILES", true))
+            return;
+
+        for(const auto& itr : quantile_statistics<Vp>::get_reported_quantiles())
+            utility::write_entry(_os, get_quantile_label(itr.first),
+                                 _stats.get_quantile(itr.second));
+    }
+
+    template <typename StatsT>
+    static void write_quantiles(utility::stream&, const StatsT&)
+    {}
+
+    template <typename Vp>
+    static void write_quantiles_header(utility::stream& _os,
+                                       const quantile_statistics<Vp>&)
+    {
+        if(!get_env<bool>("TIMEMORY_PRINT_QUANTILES", true))
+            return;
+
+        auto _flags = Tp::get_format_flags();
+        auto _width = Tp::get_width();
+        auto _prec  = Tp::get_precision();
+
+        for(const auto& itr : quantile_statistics<Vp>::get_reported_quantiles())
+            utility::write_header(_os, get_quantile_label(itr.first), _flags, _width,
+                                  _prec);
+    }
+
+    template <typename StatsT>
+    static void write_quantiles_header(utility::stream&, const StatsT&)
+    {}
 };
 //
 //--------------------------------------------------------------------------------------//
@@ -25,3 +25,4 @@
 #pragma once
 
 #include "timemory/sampling/sampler.hpp"
+#include "timemory/sampling/stack_sampler.hpp"
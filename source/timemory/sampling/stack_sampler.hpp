@@ -0,0 +1,839 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include "timemory/components/data_tracker/components.hpp"
+#include "timemory/macros/os.hpp"
+#include "timemory/mpl/type_traits.hpp"
+#include "timemory/mpl/types.hpp"
+#include "timemory/operations/types/node.hpp"
+#include "timemory/settings/declaration.hpp"
+#include "timemory/storage/definition.hpp"
+#include "timemory/utility/symbols.hpp"
+#include "timemory/utility/utility.hpp"
+
+// C++ includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// C includes
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#if defined(_UNIX)
+#    include <execinfo.h>
+#    include <pthread.h>
+#endif
+
+#if defined(_LINUX)
+#    include <sys/syscall.h>
+#    include <ucontext.h>
+#    include <unistd.h>
+#    if !defined(sigev_notify_thread_id)
+#        define sigev_notify_thread_id _sigev_un._tid
+#    endif
+#endif
+
+#if defined(TIMEMORY_USE_LIBUNWIND)
+#    define UNW_LOCAL_ONLY
+#    include <libunwind.h>
+#endif
+
+namespace tim
+{
+namespace sampling
+{
+struct stack_sampler;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+namespace trait
+{
+template <>
+struct supports_flamegraph<component::data_tracker<double, sampling::stack_sampler>>
+: true_type
+{};
+}  // namespace trait
+//
+//--------------------------------------------------------------------------------------//
+//
+namespace sampling
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::sampling::stack_sampler
+/// \brief Statistical call-stack sampling. Each registered thread has a timer which
+/// delivers a signal at the configured frequency (w.r.t. the CPU-time of the thread by
+/// default). The signal handler walks the frame pointers from the interrupted context
+/// (falling back to libunwind when timemory is built with it, otherwise to backtrace)
+/// and copies the program counters into a preallocated per-thread ring buffer. The
+/// handler does not allocate and the samples which do not fit in the buffer are
+/// counted as dropped. The frame-pointer walk and libunwind are async-signal-safe but
+/// the backtrace fallback, which is used when the code is built without frame
+/// pointers and timemory is built without libunwind (the default), is not: the libgcc
+/// unwinder takes the lock of dl_iterate_phdr, so a sample which interrupts a thread
+/// holding that lock (e.g. in dlopen or while unwinding an exception) can deadlock.
+/// Build the code with -fno-omit-frame-pointer or timemory with
+/// TIMEMORY_USE_LIBUNWIND=ON to avoid this. A background thread drains the buffers
+/// and counts the
+/// samples of each unique call-stack. At finalization, the program counters are
+/// symbolized once and the call-graph is added to the storage of the \ref
+/// tim::component::data_tracker for \ref tim::sampling::stack_sampler::tracker_type so
+/// it is reported in the text, JSON, tree, and flamegraph outputs: the value of each
+/// entry is the estimated time (number of samples times the sampling period) and the
+/// laps are the number of samples which contain the function.
+/// \code{.cpp}
+/// tim::sampling::stack_sampler::start();          // samples the calling thread
+///
+/// std::thread t{ []() {
+///     tim::sampling::stack_sampler::register_thread();
+///     ...
+/// } };
+/// ...
+/// t.join();
+/// tim::sampling::stack_sampler::finalize();       // before timemory_finalize()
+/// \endcode
+/// The signal handler remains installed after the sampling is stopped (it returns
+/// immediately) so that a signal which is still pending cannot terminate the process.
+struct stack_sampler
+{
+    using tracker_type = component::data_tracker<double, stack_sampler>;
+    using pc_vector_t  = std::vector<uintptr_t>;
+
+    /// the maximum number of frames of a sample
+    static constexpr size_t max_depth = 256;
+
+    struct config
+    {
+        double frequency = settings::stack_sampling_frequency();
+        size_t depth     = settings::stack_sampling_depth();
+        size_t buffer    = settings::stack_sampling_buffer();
+        bool   cpu_time  = settings::stack_sampling_cpu_time();
+        int    signal    = SIGPROF;
+    };
+
+    /// the cost of the sampling. The time spent in the signal handler is measured on
+    /// every sample, the cost of the signal delivery by the kernel is not included.
+    struct overhead
+    {
+        uint64_t threads       = 0;
+        uint64_t samples       = 0;
+        uint64_t dropped       = 0;
+        uint64_t handler_ns    = 0;
+        uint64_t aggregator_ns = 0;
+        double   frequency     = 0.0;
+
+        /// average number of nanoseconds in the signal handler
+        double per_sample() const
+        {
+            auto _n = samples + dropped;
+            return (_n > 0) ? static_cast<double>(handler_ns) / _n : 0.0;
+        }
+
+        /// fraction of the time of a sampled thread which is spent in the handler
+        double fraction() const { return per_sample() * frequency * 1.0e-9; }
+
+        std::string as_string() const;
+    };
+
+    static bool     start();
+    static bool     start(const config&);
+    static bool     register_thread();
+    static void     unregister_thread();
+    static void     stop();
+    static void     finalize();
+    static bool     is_active() { return get_persistent_data().m_active.load(); }
+    static overhead get_overhead();
+    static config   get_config() { return get_persistent_data().m_config; }
+
+private:
+    struct thread_buffer
+    {
+        thread_buffer(size_t _capacity, size_t _depth)
+        : capacity{ std::max<size_t>(_capacity, 1) }
+        , stride{ ((_depth < 1) ? 1 : (_depth > max_depth) ? max_depth : _depth) + 1 }
+        , data(capacity * stride, 0)
+        {}
+
+        size_t                capacity = 0;
+        size_t                stride   = 0;
+        pc_vector_t           data     = {};
+        std::atomic<uint64_t> head{ 0 };
+        std::atomic<uint64_t> tail{ 0 };
+        std::atomic<uint64_t> samples{ 0 };
+        std::atomic<uint64_t> dropped{ 0 };
+        std::atomic<uint64_t> handler_ns{ 0 };
+        std::atomic<bool>     active{ false };
+        std::atomic<bool>     released{ false };
+        uintptr_t             stack_hi = 0;
+#if defined(_LINUX)
+        timer_t timer     = {};
+        bool    has_timer = false;
+#endif
+    };
+
+    struct stack_record
+    {
+        pc_vector_t pcs   = {};
+        uint64_t    count = 0;
+    };
+
+    using buffer_ptr_t    = std::shared_ptr<thread_buffer>;
+    using buffer_vector_t = std::vector<buffer_ptr_t>;
+    using stack_vector_t  = std::vector<stack_record>;
+    using stack_index_t   = std::unordered_map<uint64_t, size_t>;
+    using sigaction_t     = struct sigaction;
+
+    struct persistent_data
+    {
+        config                  m_config     = {};
+        std::atomic<bool>       m_active     = { false };
+        bool                    m_running    = false;
+        bool                    m_installed  = false;
+        std::mutex              m_mutex      = {};
+        std::condition_variable m_cv         = {};
+        std::thread             m_aggregator = {};
+        buffer_vector_t         m_buffers    = {};
+        stack_vector_t          m_stacks     = {};
+        stack_index_t           m_index      = {};
+        overhead                m_totals     = {};
+    };
+
+    static persistent_data& get_persistent_data()
+    {
+        static auto _instance = new persistent_data{};
+        return *_instance;
+    }
+
+    static thread_buffer*& get_thread_buffer()
+    {
+        static thread_local thread_buffer* _instance = nullptr;
+        return _instance;
+    }
+
+    static uint64_t get_clock_ns()
+    {
+        struct timespec _ts;
+        clock_gettime(CLOCK_MONOTONIC, &_ts);
+        return static_cast<uint64_t>(_ts.tv_sec) * 1000000000ULL + _ts.tv_nsec;
+    }
+
+    static void   execute(int, siginfo_t*, void*);
+    static size_t unwind(void*, uintptr_t*, size_t, const thread_buffer&);
+    static void   aggregate();
+    static void   drain(persistent_data&);
+    static void   retire(persistent_data&);
+    static void   insert(persistent_data&, const uintptr_t*, size_t);
+    static void   release(thread_buffer*);
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+inline std::string
+stack_sampler::overhead::as_string() const
+{
+    char _buff[512];
+    snprintf(_buff, sizeof(_buff),
+             "%llu samples (%llu dropped) from %llu threads at %.0f Hz, %.0f nsec per "
+             "sample in the signal handler = %.4f%% of each thread, %.3f msec in the "
+             "aggregator",
+             (unsigned long long) samples, (unsigned long long) dropped,
+             (unsigned long long) threads, frequency, per_sample(), 100.0 * fraction(),
+             aggregator_ns * 1.0e-6);
+    return std::string{ _buff };
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// starts the sampling with the configuration from the settings
+inline bool
+stack_sampler::start()
+{
+    return start(config{});
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// installs the signal handler, starts the aggregator, and registers the calling
+/// thread. Returns false if the sampling is already active or could not be started
+inline bool
+stack_sampler::start(const config& _cfg)
+{
+    auto& _data = get_persistent_data();
+    if(_cfg.frequency <= 0.0 || _data.m_active.exchange(true))
+        return false;
+
+#if defined(_UNIX)
+    // the first call to backtrace loads the unwinder, it cannot happen in the handler
+    void* _warm[4];
+    backtrace(_warm, 4);
+#endif
+
+    {
+        std::unique_lock<std::mutex> _lk{ _data.m_mutex };
+        drain(_data);
+        retire(_data);
+        _data.m_config           = _cfg;
+        _data.m_config.depth     = (_cfg.depth < 1) ? 1 : _cfg.depth;
+        if(_data.m_config.depth > max_depth)
+            _data.m_config.depth = max_depth;
+        _data.m_totals           = overhead{};
+        _data.m_totals.frequency = _cfg.frequency;
+
+        if(!_data.m_installed)
+        {
+            sigaction_t _sa;
+            memset(&_sa, 0, sizeof(_sa));
+            sigemptyset(&_sa.sa_mask);
+            _sa.sa_flags     = SA_RESTART | SA_SIGINFO;
+            _sa.sa_sigaction = &stack_sampler::execute;
+            if(sigaction(_cfg.signal, &_sa, nullptr) != 0)
+            {
+                fprintf(stderr,
+                        "[stack_sampler]> Error! sigaction failed for signal %i\n",
+                        _cfg.signal);
+                _data.m_active.store(false);
+                return false;
+            }
+            _data.m_installed = true;
+        }
+
+        _data.m_running    = true;
+        _data.m_aggregator = std::thread{ &stack_sampler::aggregate };
+    }
+
+    tracker_type::label()       = "stack_samples";
+    tracker_type::description() = "Call-stack samples";
+
+#if !defined(_LINUX)
+    // process-wide timer, the signal is ignored by the threads which are not registered
+    struct itimerval _it;
+    auto             _usec = static_cast<long>(1.0e6 / _cfg.frequency);
+    _it.it_interval.tv_sec = _it.it_value.tv_sec = _usec / 1000000;
+    _it.it_interval.tv_usec = _it.it_value.tv_usec = std::max<long>(_usec % 1000000, 1);
+    setitimer((_cfg.cpu_time) ? ITIMER_PROF : ITIMER_REAL, &_it, nullptr);
+#endif
+
+    return register_thread();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// allocates the sample buffer of the calling thread and starts its timer. The thread
+/// is unregistered automatically when it exits
+inline bool
+stack_sampler::register_thread()
+{
+    auto& _data = get_persistent_data();
+    if(!_data.m_active.load())
+        return false;
+
+    auto*& _tl_buffer = get_thread_buffer();
+    if(_tl_buffer && _tl_buffer->active.load())
+        return true;
+    // the buffer of a previous sampling session
+    if(_tl_buffer)
+        release(_tl_buffer);
+
+    auto _cfg = get_config();
+    auto _buf = std::make_shared<thread_buffer>(_cfg.buffer, _cfg.depth);
+
+#if defined(_LINUX)
+    pthread_attr_t _attr;
+    if(pthread_getattr_np(pthread_self(), &_attr) == 0)
+    {
+        void*  _addr = nullptr;
+        size_t _size = 0;
+        if(pthread_attr_getstack(&_attr, &_addr, &_size) == 0)
+            _buf->stack_hi = reinterpret_cast<uintptr_t>(_addr) + _size;
+        pthread_attr_destroy(&_attr);
+    }
+#endif
+
+    {
+        std::unique_lock<std::mutex> _lk{ _data.m_mutex };
+        _data.m_buffers.emplace_back(_buf);
+        _data.m_totals.threads += 1;
+    }
+
+    _buf->active.store(true);
+    _tl_buffer = _buf.get();
+
+    // stops the timer before the thread exits
+    struct thread_guard
+    {
+        ~thread_guard() { unregister_thread(); }
+    };
+    static thread_local thread_guard _guard{};
+    consume_parameters(_guard);
+
+#if defined(_LINUX)
+    struct sigevent _sev;
+    memset(&_sev, 0, sizeof(_sev));
+    _sev.sigev_notify           = SIGEV_THREAD_ID;
+    _sev.sigev_signo            = _cfg.signal;
+    _sev.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+    auto _clock = (_cfg.cpu_time) ? CLOCK_THREAD_CPUTIME_ID : CLOCK_MONOTONIC;
+    if(timer_create(_clock, &_sev, &_buf->timer) != 0)
+    {
+        fprintf(stderr, "[stack_sampler]> Error! timer_create failed: %s\n",
+                strerror(errno));
+        return false;
+    }
+    _buf->has_timer = true;
+
+    auto              _nsec = static_cast<long>(1.0e9 / _cfg.frequency);
+    struct itimerspec _its;
+    _its.it_interval.tv_sec = _its.it_value.tv_sec = _nsec / 1000000000L;
+    _its.it_interval.tv_nsec = _its.it_value.tv_nsec =
+        std::max<long>(_nsec % 1000000000L, 1);
+    timer_settime(_buf->timer, 0, &_its, nullptr);
+#endif
+
+    return true;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// stops the timer of the calling thread. The samples in its buffer are still
+/// aggregated
+inline void
+stack_sampler::unregister_thread()
+{
+    auto*& _tl_buffer = get_thread_buffer();
+    if(!_tl_buffer)
+        return;
+    auto* _buf = _tl_buffer;
+    _tl_buffer = nullptr;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    release(_buf);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+stack_sampler::release(thread_buffer* _buf)
+{
+    _buf->active.store(false);
+#if defined(_LINUX)
+    {
+        std::unique_lock<std::mutex> _lk{ get_persistent_data().m_mutex };
+        if(_buf->has_timer)
+        {
+            timer_delete(_buf->timer);
+            _buf->has_timer = false;
+        }
+    }
+#endif
+    if(get_thread_buffer() == _buf)
+        get_thread_buffer() = nullptr;
+    _buf->released.store(true);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// stops the timers of every thread and the aggregator
+inline void
+stack_sampler::stop()
+{
+    auto& _data = get_persistent_data();
+    if(!_data.m_active.exchange(false))
+        return;
+
+#if !defined(_LINUX)
+    struct itimerval _it;
+    memset(&_it, 0, sizeof(_it));
+    setitimer((_data.m_config.cpu_time) ? ITIMER_PROF : ITIMER_REAL, &_it, nullptr);
+#endif
+
+    {
+        std::unique_lock<std::mutex> _lk{ _data.m_mutex };
+        for(auto& itr : _data.m_buffers)
+        {
+            // the buffer is not released here since the thread still refers to it
+            itr->active.store(false);
+#if defined(_LINUX)
+            if(itr->has_timer)
+            {
+                timer_delete(itr->timer);
+                itr->has_timer = false;
+            }
+#endif
+        }
+        _data.m_running = false;
+    }
+    _data.m_cv.notify_all();
+
+    if(_data.m_aggregator.joinable())
+        _data.m_aggregator.join();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// stops the sampling, symbolizes the call-stacks, and adds the call-graph of the
+/// samples to the storage of the calling thread
+inline void
+stack_sampler::finalize()
+{
+    stop();
+
+    auto&          _data = get_persistent_data();
+    stack_vector_t _stacks{};
+    overhead       _overhead = get_overhead();
+    {
+        std::unique_lock<std::mutex> _lk{ _data.m_mutex };
+        drain(_data);
+        retire(_data);
+        std::swap(_stacks, _data.m_stacks);
+        _data.m_index.clear();
+    }
+
+    if(settings::verbose() >= 0)
+        fprintf(stderr, "[stack_sampler]> %s\n", _overhead.as_string().c_str());
+
+    if(_stacks.empty())
+        return;
+
+    // symbolize each unique program counter once
+    std::set<const void*> _pcs{};
+    for(const auto& itr : _stacks)
+    {
+        for(const auto& pitr : itr.pcs)
+            _pcs.insert(reinterpret_cast<const void*>(pitr));
+    }
+    auto _names = symbols::resolve(_pcs, true);
+
+    // call-graph of the functions from the outermost frame to the sampled frame
+    struct graph_node
+    {
+        std::string                   name     = {};
+        uint64_t                      count    = 0;
+        std::map<std::string, size_t> children = {};
+    };
+
+    std::vector<graph_node> _graph(1);
+    for(const auto& itr : _stacks)
+    {
+        size_t _idx = 0;
+        for(auto ritr = itr.pcs.rbegin(); ritr != itr.pcs.rend(); ++ritr)
+        {
+            const auto& _name = _names[reinterpret_cast<const void*>(*ritr)];
+            auto        citr  = _graph.at(_idx).children.find(_name);
+            if(citr == _graph.at(_idx).children.end())
+            {
+                _graph.emplace_back(graph_node{ _name, 0, {} });
+                citr = _graph.at(_idx).children.emplace(_name, _graph.size() - 1).first;
+            }
+            _idx = citr->second;
+            _graph.at(_idx).count += itr.count;
+        }
+    }
+
+    // the entries are pushed and popped like the components of a region
+    auto                        _period = 1.0 / _overhead.frequency;
+    std::function<void(size_t)> _emit   = [&](size_t _idx) {
+        const auto&  _node = _graph.at(_idx);
+        tracker_type _obj{};
+        operation::push_node<tracker_type>(_obj, scope::config{ scope::tree{} },
+                                           add_hash_id(_node.name));
+        for(const auto& itr : _node.children)
+            _emit(itr.second);
+        _obj.set_value(_node.count * _period);
+        _obj.set_laps(_node.count);
+        operation::pop_node<tracker_type> _pop(_obj);
+    };
+
+    for(const auto& itr : _graph.front().children)
+        _emit(itr.second);
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline stack_sampler::overhead
+stack_sampler::get_overhead()
+{
+    auto&                        _data = get_persistent_data();
+    std::unique_lock<std::mutex> _lk{ _data.m_mutex };
+    auto                         _overhead = _data.m_totals;
+    for(const auto& itr : _data.m_buffers)
+    {
+        _overhead.samples += itr->samples.load();
+        _overhead.dropped += itr->dropped.load();
+        _overhead.handler_ns += itr->handler_ns.load();
+    }
+    return _overhead;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+stack_sampler::execute(int, siginfo_t*, void* _ctx)
+{
+    auto* _buf = get_thread_buffer();
+    if(!_buf || !_buf->active.load(std::memory_order_relaxed))
+        return;
+
+    auto _errno = errno;
+    auto _beg   = get_clock_ns();
+    auto _head  = _buf->head.load(std::memory_order_relaxed);
+    if(_head - _buf->tail.load(std::memory_order_acquire) >= _buf->capacity)
+    {
+        _buf->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        auto* _rec = _buf->data.data() + (_head % _buf->capacity) * _buf->stride;
+        _rec[0]    = unwind(_ctx, _rec + 1, _buf->stride - 1, *_buf);
+        _buf->head.store(_head + 1, std::memory_order_release);
+        _buf->samples.fetch_add(1, std::memory_order_relaxed);
+    }
+    _buf->handler_ns.fetch_add(get_clock_ns() - _beg, std::memory_order_relaxed);
+    errno = _errno;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// writes the program counter of the interrupted context followed by the call-sites
+/// of the callers (the return addresses minus one)
+inline size_t
+stack_sampler::unwind(void* _ctx, uintptr_t* _pcs, size_t _max, const thread_buffer& _buf)
+{
+    size_t    _n  = 0;
+    uintptr_t _pc = 0;
+
+#if defined(_LINUX) && (defined(__x86_64__) || defined(__aarch64__))
+    auto* _uc = static_cast<ucontext_t*>(_ctx);
+#    if defined(__x86_64__)
+    _pc     = static_cast<uintptr_t>(_uc->uc_mcontext.gregs[REG_RIP]);
+    auto _fp = static_cast<uintptr_t>(_uc->uc_mcontext.gregs[REG_RBP]);
+    auto _sp = static_cast<uintptr_t>(_uc->uc_mcontext.gregs[REG_RSP]);
+#    else
+    _pc     = static_cast<uintptr_t>(_uc->uc_mcontext.pc);
+    auto _fp = static_cast<uintptr_t>(_uc->uc_mcontext.regs[29]);
+    auto _sp = static_cast<uintptr_t>(_uc->uc_mcontext.sp);
+#    endif
+
+    // a frame record is { frame pointer of the caller, return address } and the
+    // records of the callers are at increasing addresses between the stack pointer and
+    // the top of the stack, which are always mapped
+    _pcs[_n++] = _pc;
+    while(_n < _max && _fp >= _sp && _fp + 2 * sizeof(uintptr_t) <= _buf.stack_hi &&
+          _fp % sizeof(uintptr_t) == 0)
+    {
+        const auto* _frame = reinterpret_cast<const uintptr_t*>(_fp);
+        if(_frame[1] == 0)
+            break;
+        _pcs[_n++] = _frame[1] - 1;
+        if(_frame[0] <= _fp)
+            break;
+        _fp = _frame[0];
+    }
+
+    // the code was built without frame pointers
+    if(_n > 1)
+        return _n;
+    _n = 0;
+#else
+    consume_parameters(_buf);
+#endif
+
+#if defined(TIMEMORY_USE_LIBUNWIND)
+    unw_cursor_t _cursor;
+    if(unw_init_local2(&_cursor, static_cast<unw_context_t*>(_ctx),
+                       UNW_INIT_SIGNAL_FRAME) == 0)
+    {
+        do
+        {
+            unw_word_t _ip = 0;
+            if(unw_get_reg(&_cursor, UNW_REG_IP, &_ip) != 0 || _ip == 0)
+                break;
+            _pcs[_n] = (_n == 0) ? _ip : _ip - 1;
+            ++_n;
+        } while(_n < _max && unw_step(&_cursor) > 0);
+    }
+    return _n;
+#elif defined(_UNIX)
+    // not async-signal-safe, see the documentation of the class. The frames of the
+    // signal handler precede the interrupted frame
+    void* _raw[max_depth + 8];
+    auto  _nraw = backtrace(_raw, static_cast<int>(_max + 8));
+    int   _beg  = (_pc == 0) ? std::min(2, _nraw) : _nraw;
+    for(int i = 0; i < _nraw && _pc != 0; ++i)
+    {
+        if(reinterpret_cast<uintptr_t>(_raw[i]) == _pc)
+        {
+            _beg = i;
+            break;
+        }
+    }
+    for(int i = _beg; i < _nraw && _n < _max; ++i, ++_n)
+        _pcs[_n] = reinterpret_cast<uintptr_t>(_raw[i]) - ((_n == 0) ? 0 : 1);
+    return _n;
+#else
+    consume_parameters(_ctx, _pc);
+    return _n;
+#endif
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+stack_sampler::aggregate()
+{
+#if defined(_UNIX)
+    // the process-wide timer must not interrupt the aggregator
+    sigset_t _mask;
+    sigemptyset(&_mask);
+    sigaddset(&_mask, get_persistent_data().m_config.signal);
+    pthread_sigmask(SIG_BLOCK, &_mask, nullptr);
+#endif
+
+    auto&                        _data = get_persistent_data();
+    std::unique_lock<std::mutex> _lk{ _data.m_mutex };
+    while(_data.m_running)
+    {
+        _data.m_cv.wait_for(_lk, std::chrono::milliseconds{ 50 },
+                            [&]() { return !_data.m_running; });
+        drain(_data);
+    }
+
+#if defined(_UNIX)
+    struct timespec _ts;
+    if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &_ts) == 0)
+        _data.m_totals.aggregator_ns +=
+            static_cast<uint64_t>(_ts.tv_sec) * 1000000000ULL + _ts.tv_nsec;
+#endif
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// copies the samples out of the thread buffers. The mutex must be held
+inline void
+stack_sampler::drain(persistent_data& _data)
+{
+    for(auto itr = _data.m_buffers.begin(); itr != _data.m_buffers.end();)
+    {
+        auto& _buf  = **itr;
+        auto  _head = _buf.head.load(std::memory_order_acquire);
+        auto  _tail = _buf.tail.load(std::memory_order_relaxed);
+        for(; _tail < _head; ++_tail)
+        {
+            const auto* _rec = _buf.data.data() + (_tail % _buf.capacity) * _buf.stride;
+            insert(_data, _rec + 1, std::min<size_t>(_rec[0], _buf.stride - 1));
+        }
+        _buf.tail.store(_tail, std::memory_order_release);
+
+        // the thread no longer refers to the buffer
+        if(_buf.released.load())
+        {
+            _data.m_totals.samples += _buf.samples.load();
+            _data.m_totals.dropped += _buf.dropped.load();
+            _data.m_totals.handler_ns += _buf.handler_ns.load();
+            itr = _data.m_buffers.erase(itr);
+        }
+        else
+        {
+            ++itr;
+        }
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// the inactive buffers of a previous session are still referred to by their threads
+/// until the threads register again or exit, i.e. they cannot be removed. Their
+/// counters are cleared so they are not added to the totals of the next session. The
+/// mutex must be held
+inline void
+stack_sampler::retire(persistent_data& _data)
+{
+    for(auto& itr : _data.m_buffers)
+    {
+        if(itr->active.load())
+            continue;
+        itr->samples.store(0);
+        itr->dropped.store(0);
+        itr->handler_ns.store(0);
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// increments the count of the call-stack, the stacks are deduplicated by the hash of
+/// the program counters. The mutex must be held
+inline void
+stack_sampler::insert(persistent_data& _data, const uintptr_t* _pcs, size_t _n)
+{
+    if(_n == 0)
+        return;
+
+    uint64_t _hash = 14695981039346656037ULL;
+    for(size_t i = 0; i < _n; ++i)
+        _hash = (_hash ^ _pcs[i]) * 1099511628211ULL;
+
+    // a different call-stack with the same hash is placed at the next hash value
+    while(true)
+    {
+        auto itr = _data.m_index.find(_hash);
+        if(itr == _data.m_index.end())
+        {
+            _data.m_index.emplace(_hash, _data.m_stacks.size());
+            _data.m_stacks.emplace_back(stack_record{ pc_vector_t(_pcs, _pcs + _n), 1 });
+            return;
+        }
+
+        auto& _stack = _data.m_stacks.at(itr->second);
+        if(_stack.pcs.size() == _n && std::equal(_pcs, _pcs + _n, _stack.pcs.begin()))
+        {
+            _stack.count += 1;
+            return;
+        }
+        ++_hash;
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace sampling
+}  // namespace tim
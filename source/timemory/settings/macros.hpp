@@ -121,8 +121,7 @@
 #if !defined(TIMEMORY_SETTINGS_MEMBER_IMPL)
 #    define TIMEMORY_SETTINGS_MEMBER_IMPL(TYPE, FUNC, ENV_VAR, DESC, INIT)               \
         m_order.push_back(ENV_VAR);                                                      \
-        m_data.insert(                                                                   \
-            { ENV_VAR, std::make_shared<tsettings<TYPE>>(INIT, #FUNC, ENV_VAR, DESC) });
+        m_data.insert({ ENV_VAR, make_setting<TYPE>(INIT, #FUNC, ENV_VAR, DESC) });
 #endif
 //
 //--------------------------------------------------------------------------------------//
@@ -130,8 +129,8 @@
 #if !defined(TIMEMORY_SETTINGS_MEMBER_ARG_IMPL)
 #    define TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(TYPE, FUNC, ENV_VAR, DESC, INIT, ...)      \
         m_order.push_back(ENV_VAR);                                                      \
-        m_data.insert({ ENV_VAR, std::make_shared<tsettings<TYPE>>(                      \
-                                     INIT, #FUNC, ENV_VAR, DESC, __VA_ARGS__) });
+        m_data.insert(                                                                   \
+            { ENV_VAR, make_setting<TYPE>(INIT, #FUNC, ENV_VAR, DESC, __VA_ARGS__) });
 #endif
 //
 //--------------------------------------------------------------------------------------//
@@ -139,8 +138,7 @@
 #if !defined(TIMEMORY_SETTINGS_REFERENCE_IMPL)
 #    define TIMEMORY_SETTINGS_REFERENCE_IMPL(TYPE, FUNC, ENV_VAR, DESC, INIT)            \
         m_order.push_back(ENV_VAR);                                                      \
-        m_data.insert({ ENV_VAR, std::make_shared<tsettings<TYPE, TYPE&>>(               \
-                                     INIT, #FUNC, ENV_VAR, DESC) });
+        m_data.insert({ ENV_VAR, make_setting<TYPE, TYPE&>(INIT, #FUNC, ENV_VAR, DESC) });
 #endif
 //
 //--------------------------------------------------------------------------------------//
@@ -148,8 +146,8 @@
 #if !defined(TIMEMORY_SETTINGS_REFERENCE_ARG_IMPL)
 #    define TIMEMORY_SETTINGS_REFERENCE_ARG_IMPL(TYPE, FUNC, ENV_VAR, DESC, INIT, ...)   \
         m_order.push_back(ENV_VAR);                                                      \
-        m_data.insert({ ENV_VAR, std::make_shared<tsettings<TYPE, TYPE&>>(               \
-                                     INIT, #FUNC, ENV_VAR, DESC, __VA_ARGS__) });
+        m_data.insert({ ENV_VAR, make_setting<TYPE, TYPE&>(INIT, #FUNC, ENV_VAR, DESC,   \
+                                                           __VA_ARGS__) });
 #endif
 //
 //--------------------------------------------------------------------------------------//
@@ -35,6 +35,8 @@
 #include "timemory/utility/utility.hpp"
 #include "timemory/variadic/macros.hpp"
 
+#include <cstring>
+
 namespace tim
 {
 //
@@ -98,6 +100,46 @@ settings::get_global_environment()
 //--------------------------------------------------------------------------------------//
 //
 TIMEMORY_SETTINGS_INLINE
+settings::strset_t
+settings::get_global_environment_keys(const string_t& _prefix)
+{
+    strset_t _keys{};
+#if defined(_UNIX)
+    if(environ != nullptr)
+    {
+        for(int idx = 0; environ[idx] != nullptr; ++idx)
+        {
+            const char* _entry = environ[idx];
+            if(strncmp(_entry, _prefix.c_str(), _prefix.length()) != 0)
+                continue;
+            const char* _delim = strchr(_entry, '=');
+            if(_delim)
+                _keys.emplace(_entry, _delim - _entry);
+        }
+    }
+#else
+    consume_parameters(_prefix);
+#endif
+    return _keys;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+TIMEMORY_SETTINGS_INLINE
+settings::strvector_t&
+settings::get_environment()
+{
+    if(!m_environ_init)
+    {
+        m_environment  = get_global_environment();
+        m_environ_init = true;
+    }
+    return m_environment;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+TIMEMORY_SETTINGS_INLINE
 std::string
 get_local_datetime(const char* dt_format)
 {
@@ -287,6 +329,10 @@ settings::parse(std::shared_ptr<settings> _settings)
 // way to reparse the environment so that default settings (possibly from previous
 // invocation) can be overwritten
 //
+// The environment is scanned once for the "TIMEMORY_" variables which are set so that
+// the settings which are not set (nearly all of them) do not each search the
+// environment. Settings with any other prefix are always parsed.
+//
 TIMEMORY_SETTINGS_INLINE
 void
 settings::parse(settings* _settings)
@@ -297,8 +343,20 @@ settings::parse(settings* _settings)
     if(_settings->get_suppress_parsing())
         return;
 
+    static const string_t _prefix = "TIMEMORY_";
+
+    auto _keys = get_global_environment_keys(_prefix);
     for(auto& itr : *_settings)
     {
+        if(!itr.second)
+            continue;
+        const auto& _env = itr.second->get_env_name();
+        if(_env.compare(0, _prefix.length(), _prefix) == 0 && _keys.count(_env) == 0)
+        {
+            // record the default value, same as get_env(...) when the variable is unset
+            env_settings::instance()->insert(_env, itr.second->as_string());
+            continue;
+        }
         if(_settings->get_debug() && _settings->get_verbose() > 0)
             std::cerr << "Executing parse callback for: " << itr.first << std::endl;
         itr.second->parse();
@@ -312,6 +370,7 @@ settings::settings(const settings& rhs)
 : m_data(data_type{})
 , m_command_line(rhs.m_command_line)
 , m_environment(rhs.m_environment)
+, m_environ_init(rhs.m_environ_init)
 {
     for(auto& itr : rhs.m_data)
         m_data.insert({ itr.first, itr.second->clone() });
@@ -330,6 +389,7 @@ settings::operator=(const settings& rhs)
         m_data[itr.first] = itr.second->clone();
     m_command_line = rhs.m_command_line;
     m_environment  = rhs.m_environment;
+    m_environ_init = rhs.m_environ_init;
     return *this;
 }
 //
@@ -625,6 +685,12 @@ settings::initialize_parallel()
         " the master thread. Higher values tend to increase the finalization merge time",
         50);
 
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        size_t, storage_pool_size, "TIMEMORY_STORAGE_POOL_SIZE",
+        "Max number of exited threads whose storage is reused by new threads instead of "
+        "merged at thread exit",
+        0, strvector_t({ "--timemory-storage-pool-size" }), 1);
+
     TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
         bool, collapse_threads, "TIMEMORY_COLLAPSE_THREADS",
         "Enable/disable combining thread-specific data", true,
@@ -723,6 +789,21 @@ settings::initialize_tpls()
         "Value at which PAPI hw counters trigger an overflow callback", 0,
         strvector_t({ "--timemory-papi-overflow" }), 1);
 
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        string_t, perf_events, "TIMEMORY_PERF_EVENTS",
+        "Linux perf events to collect, e.g. 'task-clock,page-faults,instructions:u'",
+        "", strvector_t({ "--timemory-perf-events" }));
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        bool, perf_inherit, "TIMEMORY_PERF_INHERIT",
+        "Include the threads created after the perf events were opened in the counts",
+        false, strvector_t({ "--timemory-perf-inherit" }), -1, 1);
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        bool, perf_rdpmc, "TIMEMORY_PERF_RDPMC",
+        "Read the perf hw counters in user-space (rdpmc) when the kernel permits it",
+        true);
+
     TIMEMORY_SETTINGS_MEMBER_IMPL(
         uint64_t, cuda_event_batch_size, "TIMEMORY_CUDA_EVENT_BATCH_SIZE",
         "Batch size for create cudaEvent_t in cuda_event components", 5);
@@ -845,6 +926,105 @@ settings::initialize_miscellaneous()
         "throttling",
         10000, strvector_t({ "--timemory-throttle-value" }), 1);
 
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        double, throttle_ratio, "TIMEMORY_THROTTLE_RATIO",
+        "Bundles skip regions whose mean time < this multiple of the instrumentation cost "
+        "(0 = disabled)",
+        0.0, strvector_t({ "--timemory-throttle-ratio" }), 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        size_t, throttle_stride, "TIMEMORY_THROTTLE_STRIDE",
+        "Every Nth call to a region throttled by the bundles is still measured (0 = none)",
+        0, strvector_t({ "--timemory-throttle-stride" }), 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        size_t, sample_interval, "TIMEMORY_SAMPLE_INTERVAL",
+        "Bundles measure 1 in N calls to a region and scale the results to every call",
+        1, strvector_t({ "--timemory-sample-interval" }), 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        bool, sample_random, "TIMEMORY_SAMPLE_RANDOM",
+        "Measure each call with a probability of 1/N instead of every Nth call", false,
+        strvector_t({ "--timemory-sample-random" }), -1, 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        string_t, telemetry_endpoint, "TIMEMORY_TELEMETRY_ENDPOINT",
+        "Collector which receives the streamed per-region deltas, e.g. "
+        "unix:/tmp/tim.sock or tcp:localhost:9000 (empty = disabled)",
+        "", strvector_t({ "--timemory-telemetry-endpoint" }), 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        double, telemetry_interval, "TIMEMORY_TELEMETRY_INTERVAL",
+        "Minimum number of seconds between two telemetry messages", 1.0,
+        strvector_t({ "--timemory-telemetry-interval" }), 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        size_t, telemetry_queue_size, "TIMEMORY_TELEMETRY_QUEUE_SIZE",
+        "Maximum number of unsent telemetry messages before new messages are dropped", 64,
+        strvector_t({ "--timemory-telemetry-queue-size" }), 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        bool, live_view, "TIMEMORY_LIVE_VIEW",
+        "Publish the per-region counters in shared-memory while running (see "
+        "timemory-top)",
+        false, strvector_t({ "--timemory-live-view" }), -1, 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        string_t, live_view_components, "TIMEMORY_LIVE_VIEW_COMPONENTS",
+        "Components published in the live-view (empty = all)", "",
+        strvector_t({ "--timemory-live-view-components" }));
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        size_t, live_view_capacity, "TIMEMORY_LIVE_VIEW_CAPACITY",
+        "Maximum number of entries in the live-view (one per call-graph entry and "
+        "thread)",
+        4096, strvector_t({ "--timemory-live-view-capacity" }), 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        bool, xray_patch, "TIMEMORY_XRAY_PATCH",
+        "Patch the XRay instrumentation points when the timemory-xray library is loaded",
+        true, strvector_t({ "--timemory-xray-patch" }), -1, 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        bool, xray_unpatch_throttled, "TIMEMORY_XRAY_UNPATCH_THROTTLED",
+        "Unpatch the XRay instrumentation points of functions once they are throttled",
+        true, strvector_t({ "--timemory-xray-unpatch-throttled" }), -1, 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        double, stack_sampling_frequency, "TIMEMORY_STACK_SAMPLING_FREQUENCY",
+        "Number of call-stack samples per second of each thread", 1000.0,
+        strvector_t({ "--timemory-stack-sampling-frequency" }), 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        size_t, stack_sampling_depth, "TIMEMORY_STACK_SAMPLING_DEPTH",
+        "Maximum number of frames in a call-stack sample", 64,
+        strvector_t({ "--timemory-stack-sampling-depth" }), 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        size_t, stack_sampling_buffer, "TIMEMORY_STACK_SAMPLING_BUFFER",
+        "Number of call-stack samples buffered per thread before samples are dropped",
+        1024, strvector_t({ "--timemory-stack-sampling-buffer" }), 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        bool, stack_sampling_cpu_time, "TIMEMORY_STACK_SAMPLING_CPU_TIME",
+        "Sample the call-stack w.r.t. the CPU-time of each thread instead of wall-clock",
+        true, strvector_t({ "--timemory-stack-sampling-cpu-time" }), -1, 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        size_t, lock_wait_threshold, "TIMEMORY_LOCK_WAIT_THRESHOLD",
+        "Minimum wait (in nanoseconds) for a lock or wait call to count as contended",
+        1000, strvector_t({ "--timemory-lock-wait-threshold" }), 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        size_t, lock_report_limit, "TIMEMORY_LOCK_REPORT_LIMIT",
+        "Number of locks listed in the lock contention report", 10,
+        strvector_t({ "--timemory-lock-report-limit" }), 1);
+
+    TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
+        size_t, io_report_limit, "TIMEMORY_IO_REPORT_LIMIT",
+        "Number of files listed in the I/O summary", 20,
+        strvector_t({ "--timemory-io-report-limit" }), 1);
+
     TIMEMORY_SETTINGS_MEMBER_ARG_IMPL(
         bool, enable_signal_handler, "TIMEMORY_ENABLE_SIGNAL_HANDLER",
         "Enable signals in timemory_init", false,
@@ -942,6 +1122,28 @@ settings::initialize_ert()
     TIMEMORY_SETTINGS_MEMBER_IMPL(
         string_t, ert_skip_ops, "TIMEMORY_ERT_SKIP_OPS",
         "Skip these number of ops (i.e. ERT_FLOPS) when were set at compile time", "");
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        string_t, ert_simd, "TIMEMORY_ERT_SIMD",
+        "Instruction set of the CPU ERT kernels: auto, avx512, avx2, sse2, or scalar "
+        "(scalar relies on compiler vectorization)",
+        "auto");
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        bool, ert_cache, "TIMEMORY_ERT_CACHE",
+        "Reuse the ERT results of a previous run on identical hardware and configuration",
+        true);
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        string_t, ert_cache_dir, "TIMEMORY_ERT_CACHE_DIR",
+        "Directory of the ERT cache (default: $XDG_CACHE_HOME/timemory/ert or "
+        "$HOME/.cache/timemory/ert)",
+        "");
+
+    TIMEMORY_SETTINGS_MEMBER_IMPL(
+        bool, ert_numa_aware, "TIMEMORY_ERT_NUMA_AWARE",
+        "Pin the CPU ERT threads across the NUMA nodes and report per-node ceilings",
+        false);
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -43,6 +43,7 @@
 #include "timemory/tpls/cereal/cereal.hpp"
 
 #include <atomic>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
@@ -78,6 +79,7 @@ struct settings
     friend class manager;
     using strvector_t    = std::vector<std::string>;
     using strmap_t       = std::map<std::string, std::string>;
+    using strset_t       = std::set<std::string>;
     using value_type     = std::shared_ptr<vsettings>;
     using data_type      = std::unordered_map<std::string, value_type>;
     using iterator       = typename data_type::iterator;
@@ -154,11 +156,42 @@ struct settings
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, dart_label, "TIMEMORY_DART_LABEL")
     TIMEMORY_SETTINGS_MEMBER_DECL(size_t, max_thread_bookmarks,
                                   "TIMEMORY_MAX_THREAD_BOOKMARKS")
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, storage_pool_size, "TIMEMORY_STORAGE_POOL_SIZE")
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, cpu_affinity, "TIMEMORY_CPU_AFFINITY")
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, stack_clearing, "TIMEMORY_STACK_CLEARING")
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, add_secondary, "TIMEMORY_ADD_SECONDARY")
     TIMEMORY_SETTINGS_MEMBER_DECL(size_t, throttle_count, "TIMEMORY_THROTTLE_COUNT")
     TIMEMORY_SETTINGS_MEMBER_DECL(size_t, throttle_value, "TIMEMORY_THROTTLE_VALUE")
+    TIMEMORY_SETTINGS_MEMBER_DECL(double, throttle_ratio, "TIMEMORY_THROTTLE_RATIO")
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, throttle_stride, "TIMEMORY_THROTTLE_STRIDE")
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, sample_interval, "TIMEMORY_SAMPLE_INTERVAL")
+    TIMEMORY_SETTINGS_MEMBER_DECL(bool, sample_random, "TIMEMORY_SAMPLE_RANDOM")
+    TIMEMORY_SETTINGS_MEMBER_DECL(string_t, telemetry_endpoint,
+                                  "TIMEMORY_TELEMETRY_ENDPOINT")
+    TIMEMORY_SETTINGS_MEMBER_DECL(double, telemetry_interval,
+                                  "TIMEMORY_TELEMETRY_INTERVAL")
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, telemetry_queue_size,
+                                  "TIMEMORY_TELEMETRY_QUEUE_SIZE")
+    TIMEMORY_SETTINGS_MEMBER_DECL(bool, live_view, "TIMEMORY_LIVE_VIEW")
+    TIMEMORY_SETTINGS_MEMBER_DECL(string_t, live_view_components,
+                                  "TIMEMORY_LIVE_VIEW_COMPONENTS")
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, live_view_capacity,
+                                  "TIMEMORY_LIVE_VIEW_CAPACITY")
+    TIMEMORY_SETTINGS_MEMBER_DECL(bool, xray_patch, "TIMEMORY_XRAY_PATCH")
+    TIMEMORY_SETTINGS_MEMBER_DECL(bool, xray_unpatch_throttled,
+                                  "TIMEMORY_XRAY_UNPATCH_THROTTLED")
+    TIMEMORY_SETTINGS_MEMBER_DECL(double, stack_sampling_frequency,
+                                  "TIMEMORY_STACK_SAMPLING_FREQUENCY")
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, stack_sampling_depth,
+                                  "TIMEMORY_STACK_SAMPLING_DEPTH")
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, stack_sampling_buffer,
+                                  "TIMEMORY_STACK_SAMPLING_BUFFER")
+    TIMEMORY_SETTINGS_MEMBER_DECL(bool, stack_sampling_cpu_time,
+                                  "TIMEMORY_STACK_SAMPLING_CPU_TIME")
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, lock_wait_threshold,
+                                  "TIMEMORY_LOCK_WAIT_THRESHOLD")
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, lock_report_limit, "TIMEMORY_LOCK_REPORT_LIMIT")
+    TIMEMORY_SETTINGS_MEMBER_DECL(size_t, io_report_limit, "TIMEMORY_IO_REPORT_LIMIT")
     TIMEMORY_SETTINGS_MEMBER_DECL(string_t, global_components,
                                   "TIMEMORY_GLOBAL_COMPONENTS")
     TIMEMORY_SETTINGS_MEMBER_DECL(string_t, tuple_components, "TIMEMORY_TUPLE_COMPONENTS")
@@ -182,6 +215,9 @@ struct settings
     TIMEMORY_SETTINGS_MEMBER_DECL(string_t, papi_events, "TIMEMORY_PAPI_EVENTS")
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, papi_attach, "TIMEMORY_PAPI_ATTACH")
     TIMEMORY_SETTINGS_MEMBER_DECL(int, papi_overflow, "TIMEMORY_PAPI_OVERFLOW")
+    TIMEMORY_SETTINGS_MEMBER_DECL(string_t, perf_events, "TIMEMORY_PERF_EVENTS")
+    TIMEMORY_SETTINGS_MEMBER_DECL(bool, perf_inherit, "TIMEMORY_PERF_INHERIT")
+    TIMEMORY_SETTINGS_MEMBER_DECL(bool, perf_rdpmc, "TIMEMORY_PERF_RDPMC")
     TIMEMORY_SETTINGS_MEMBER_DECL(uint64_t, cuda_event_batch_size,
                                   "TIMEMORY_CUDA_EVENT_BATCH_SIZE")
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, nvtx_marker_device_sync,
@@ -232,6 +268,10 @@ struct settings
     TIMEMORY_SETTINGS_MEMBER_DECL(uint64_t, ert_max_data_size_gpu,
                                   "TIMEMORY_ERT_MAX_DATA_SIZE_GPU")
     TIMEMORY_SETTINGS_MEMBER_DECL(string_t, ert_skip_ops, "TIMEMORY_ERT_SKIP_OPS")
+    TIMEMORY_SETTINGS_MEMBER_DECL(string_t, ert_simd, "TIMEMORY_ERT_SIMD")
+    TIMEMORY_SETTINGS_MEMBER_DECL(bool, ert_cache, "TIMEMORY_ERT_CACHE")
+    TIMEMORY_SETTINGS_MEMBER_DECL(string_t, ert_cache_dir, "TIMEMORY_ERT_CACHE_DIR")
+    TIMEMORY_SETTINGS_MEMBER_DECL(bool, ert_numa_aware, "TIMEMORY_ERT_NUMA_AWARE")
     TIMEMORY_SETTINGS_MEMBER_DECL(string_t, craypat_categories, "TIMEMORY_CRAYPAT")
     TIMEMORY_SETTINGS_MEMBER_DECL(int32_t, node_count, "TIMEMORY_NODE_COUNT")
     TIMEMORY_SETTINGS_MEMBER_DECL(bool, destructor_report, "TIMEMORY_DESTRUCTOR_REPORT")
@@ -255,10 +295,12 @@ struct settings
     static strvector_t& command_line() TIMEMORY_VISIBILITY("default");
     static strvector_t& environment() TIMEMORY_VISIBILITY("default");
     strvector_t&        get_command_line() { return m_command_line; }
-    strvector_t&        get_environment() { return m_environment; }
+    strvector_t&        get_environment();
 
 public:
     static strvector_t get_global_environment() TIMEMORY_VISIBILITY("default");
+    static strset_t    get_global_environment_keys(const string_t& _prefix)
+        TIMEMORY_VISIBILITY("default");
     static string_t    tolower(string_t str) TIMEMORY_VISIBILITY("default");
     static string_t    toupper(string_t str) TIMEMORY_VISIBILITY("default");
     static string_t    get_global_input_prefix() TIMEMORY_VISIBILITY("default");
@@ -346,6 +388,10 @@ public:
     auto insert(tsetting_pointer_t<Tp, Vp> _ptr, std::string _env = {});
 
 protected:
+    /// allocates a setting from the arena of this instance
+    template <typename Tp, typename Vp = Tp, typename... Args>
+    tsetting_pointer_t<Tp, Vp> make_setting(Args&&... _args);
+
     template <typename Tp>
     using serialize_func_t = std::function<void(Tp&, value_type)>;
     template <typename Tp>
@@ -377,7 +423,11 @@ protected:
     data_type   m_data         = {};
     strvector_t m_order        = {};
     strvector_t m_command_line = {};
-    strvector_t m_environment  = get_global_environment();
+    strvector_t m_environment  = {};
+    bool        m_environ_init = false;
+
+    // the memory of the settings created by this instance
+    std::shared_ptr<vsettings_arena> m_arena = std::make_shared<vsettings_arena>();
 
 private:
     void initialize_core() TIMEMORY_VISIBILITY("hidden");
@@ -498,11 +548,35 @@ settings::deprecated_serialize(Archive& ar, const unsigned int)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_DART_LABEL", dart_label)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_CPU_AFFINITY", cpu_affinity)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_MAX_THREAD_BOOKMARKS", max_thread_bookmarks)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_STORAGE_POOL_SIZE", storage_pool_size)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_TARGET_PID", target_pid)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_STACK_CLEARING", stack_clearing)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_ADD_SECONDARY", add_secondary)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_THROTTLE_COUNT", throttle_count)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_THROTTLE_VALUE", throttle_value)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_THROTTLE_RATIO", throttle_ratio)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_THROTTLE_STRIDE", throttle_stride)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_SAMPLE_INTERVAL", sample_interval)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_SAMPLE_RANDOM", sample_random)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_TELEMETRY_ENDPOINT", telemetry_endpoint)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_TELEMETRY_INTERVAL", telemetry_interval)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_TELEMETRY_QUEUE_SIZE", telemetry_queue_size)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_LIVE_VIEW", live_view)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_LIVE_VIEW_COMPONENTS", live_view_components)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_LIVE_VIEW_CAPACITY", live_view_capacity)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_XRAY_PATCH", xray_patch)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_XRAY_UNPATCH_THROTTLED",
+                                    xray_unpatch_throttled)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_STACK_SAMPLING_FREQUENCY",
+                                    stack_sampling_frequency)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_STACK_SAMPLING_DEPTH", stack_sampling_depth)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_STACK_SAMPLING_BUFFER",
+                                    stack_sampling_buffer)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_STACK_SAMPLING_CPU_TIME",
+                                    stack_sampling_cpu_time)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_LOCK_WAIT_THRESHOLD", lock_wait_threshold)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_LOCK_REPORT_LIMIT", lock_report_limit)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_IO_REPORT_LIMIT", io_report_limit)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_GLOBAL_COMPONENTS", global_components)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_TUPLE_COMPONENTS", tuple_components)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_LIST_COMPONENTS", list_components)
@@ -523,6 +597,9 @@ settings::deprecated_serialize(Archive& ar, const unsigned int)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_PAPI_EVENTS", papi_events)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_PAPI_ATTACH", papi_attach)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_PAPI_OVERFLOW", papi_overflow)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_PERF_EVENTS", perf_events)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_PERF_INHERIT", perf_inherit)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_PERF_RDPMC", perf_rdpmc)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_CUDA_EVENT_BATCH_SIZE",
                                     cuda_event_batch_size)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_NVTX_MARKER_DEVICE_SYNC",
@@ -561,6 +638,10 @@ settings::deprecated_serialize(Archive& ar, const unsigned int)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_ERT_MAX_DATA_SIZE_GPU",
                                     ert_max_data_size_gpu)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_ERT_SKIP_OPS", ert_skip_ops)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_ERT_SIMD", ert_simd)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_ERT_CACHE", ert_cache)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_ERT_CACHE_DIR", ert_cache_dir)
+    TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_ERT_NUMA_AWARE", ert_numa_aware)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_ALLOW_SIGNAL_HANDLER", allow_signal_handler)
     TIMEMORY_SETTINGS_TRY_CATCH_NVP("TIMEMORY_ENABLE_SIGNAL_HANDLER",
                                     enable_signal_handler)
@@ -592,6 +673,7 @@ settings::load(Archive& ar, const unsigned int version)
     }
     ar(cereal::make_nvp("command_line", m_command_line),
        cereal::make_nvp("environment", m_environment));
+    m_environ_init = true;
     for(const auto& itr : _data)
     {
         if(m_data.find(itr.first) != m_data.end())
@@ -622,8 +704,10 @@ settings::save(Archive& ar, const unsigned int) const
         if(mitr != _map.end())
             mitr->second(ar, itr.second);
     }
+    // the environment is only copied when it is first requested
+    auto _environ = (m_environ_init) ? m_environment : get_global_environment();
     ar(cereal::make_nvp("command_line", m_command_line),
-       cereal::make_nvp("environment", m_environment));
+       cereal::make_nvp("environment", _environ));
 }
 //
 //----------------------------------------------------------------------------------//
@@ -721,9 +805,22 @@ settings::insert(const std::string& _env, const std::string& _name,
                   "Error! Data type is not supported. See settings::data_type_list_t");
     set_env(_env, _init, 0);
     m_order.push_back(_env);
-    return m_data.insert(
-        { _env, std::make_shared<tsettings<Tp, Vp>>(_init, _name, _env, _desc,
-                                                    std::forward<Args>(_args)...) });
+    return m_data.insert({ _env, make_setting<Tp, Vp>(_init, _name, _env, _desc,
+                                                      std::forward<Args>(_args)...) });
+}
+//
+//----------------------------------------------------------------------------------//
+//
+template <typename Tp, typename Vp, typename... Args>
+settings::tsetting_pointer_t<Tp, Vp>
+settings::make_setting(Args&&... _args)
+{
+    // a moved-from instance does not have an arena
+    if(!m_arena)
+        m_arena = std::make_shared<vsettings_arena>();
+    using allocator_t = vsettings_allocator<tsettings<Tp, Vp>>;
+    return std::allocate_shared<tsettings<Tp, Vp>>(allocator_t{ m_arena },
+                                                   std::forward<Args>(_args)...);
 }
 //
 //----------------------------------------------------------------------------------//
@@ -28,6 +28,7 @@
 #include "timemory/settings/types.hpp"
 #include "timemory/utility/types.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <iomanip>
 #include <map>
@@ -189,6 +190,90 @@ protected:
     std::vector<std::string> m_choices     = {};
 };
 //
+/// \struct tim::vsettings_arena
+/// \brief Memory for the settings of one \ref tim::settings instance. The settings are
+/// allocated from large blocks instead of one heap allocation each and the blocks are
+/// released when the last setting allocated from them is released
+struct vsettings_arena
+{
+    static constexpr size_t block_size = 16 * 1024;
+
+    void* allocate(size_t _n)
+    {
+        constexpr size_t _align = alignof(std::max_align_t);
+        _n                      = ((_n + _align - 1) / _align) * _align;
+        // an oversized request gets a block of its own
+        if(_n > block_size)
+        {
+            m_blocks.emplace_back(new char[_n]);
+            return m_blocks.back().get();
+        }
+        if(!m_current || m_offset + _n > block_size)
+        {
+            m_blocks.emplace_back(new char[block_size]);
+            m_current = m_blocks.back().get();
+            m_offset  = 0;
+        }
+        void* _ptr = m_current + m_offset;
+        m_offset += _n;
+        return _ptr;
+    }
+
+    size_t num_blocks() const { return m_blocks.size(); }
+
+private:
+    char*                                m_current = nullptr;
+    size_t                               m_offset  = 0;
+    std::vector<std::unique_ptr<char[]>> m_blocks  = {};
+};
+//
+/// \struct tim::vsettings_allocator
+/// \brief Allocator for std::allocate_shared which allocates from a
+/// \ref tim::vsettings_arena. Every shared pointer holds a copy of the allocator so the
+/// arena outlives the settings which reference it
+template <typename Tp>
+struct vsettings_allocator
+{
+    using value_type = Tp;
+    using arena_type = std::shared_ptr<vsettings_arena>;
+
+    explicit vsettings_allocator(arena_type _arena) noexcept
+    : m_arena{ std::move(_arena) }
+    {}
+
+    template <typename Up>
+    vsettings_allocator(const vsettings_allocator<Up>& rhs) noexcept
+    : m_arena{ rhs.get_arena() }
+    {}
+
+    Tp* allocate(size_t _n)
+    {
+        return static_cast<Tp*>(m_arena->allocate(_n * sizeof(Tp)));
+    }
+
+    // the memory is released with the arena
+    void deallocate(Tp*, size_t) noexcept {}
+
+    const arena_type& get_arena() const noexcept { return m_arena; }
+
+private:
+    arena_type m_arena = {};
+};
+//
+template <typename Tp, typename Up>
+bool
+operator==(const vsettings_allocator<Tp>& lhs, const vsettings_allocator<Up>& rhs)
+{
+    return lhs.get_arena() == rhs.get_arena();
+}
+//
+template <typename Tp, typename Up>
+bool
+operator!=(const vsettings_allocator<Tp>& lhs, const vsettings_allocator<Up>& rhs)
+{
+    return !(lhs == rhs);
+}
+//
 }  // namespace tim
 
 #if defined(TIMEMORY_SETTINGS_HEADER_MODE)
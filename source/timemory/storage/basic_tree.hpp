@@ -62,7 +62,7 @@ struct basic_tree
             {
                 if(!itr->is_dummy())
                 {
-                    m_value.exclusive().data() -= itr->data();
+                    m_value.exclusive().data() -= itr->get_estimate();
                     m_value.exclusive().stats() -= itr->stats();
                     m_children.push_back(child_type{}(g, itr));
                 }
@@ -39,10 +39,12 @@
 #include "timemory/mpl/types.hpp"
 #include "timemory/operations/types.hpp"
 #include "timemory/operations/types/cleanup.hpp"
+#include "timemory/storage/flat_table.hpp"
 #include "timemory/storage/graph.hpp"
 #include "timemory/storage/graph_data.hpp"
 #include "timemory/storage/macros.hpp"
 #include "timemory/storage/node.hpp"
+#include "timemory/storage/pool.hpp"
 #include "timemory/storage/types.hpp"
 #include "timemory/tpls/cereal/cereal.hpp"
 #include "timemory/utility/macros.hpp"
@@ -130,6 +132,8 @@ public:
 
     template <typename Vp>
     using secondary_data_t       = std::tuple<iterator, const std::string&, Vp>;
+    template <typename Vp>
+    using secondary_id_data_t    = std::tuple<iterator, hash_result_type, Vp>;
     using iterator_hash_submap_t = uomap_t<int64_t, iterator>;
     using iterator_hash_map_t    = uomap_t<int64_t, iterator_hash_submap_t>;
 
@@ -155,7 +159,13 @@ public:
     static bool& worker_is_finalizing();
     static bool  is_finalizing();
 
+    /// number of storage instances of exited threads waiting to be reused
+    static size_t parked_count() { return pool_type::instance().size(); }
+
 private:
+    using pool_type       = storage_pool<this_type>;
+    using flat_table_type = flat_table<iterator>;
+
     static singleton_t* get_singleton() { return get_storage_singleton<this_type>(); }
     static std::atomic<int64_t>& instance_count();
 
@@ -225,14 +235,24 @@ public:
 
     iterator insert(scope::config scope_data, const Type& obj, uint64_t hash_id);
 
+    // append a value or an instance to the graph. The label is interned and the
+    // entry is forwarded to the hash id overloads below
+    template <typename Vp>
+    iterator append(const secondary_data_t<Vp>& _secondary)
+    {
+        return append(secondary_id_data_t<Vp>{ std::get<0>(_secondary),
+                                               add_hash_id(std::get<1>(_secondary)),
+                                               std::get<2>(_secondary) });
+    }
+
     // append a value to the the graph
     template <typename Vp,
               enable_if_t<!(std::is_same<decay_t<Vp>, Type>::value), int> = 0>
-    iterator append(const secondary_data_t<Vp>& _secondary);
+    iterator append(const secondary_id_data_t<Vp>& _secondary);
 
     // append an instance to the graph
     template <typename Vp, enable_if_t<(std::is_same<decay_t<Vp>, Type>::value), int> = 0>
-    iterator append(const secondary_data_t<Vp>& _secondary);
+    iterator append(const secondary_id_data_t<Vp>& _secondary);
 
     template <typename Archive>
     void serialize(Archive& ar, const unsigned int version);
@@ -251,6 +271,9 @@ protected:
 
     void     merge();
     void     merge(this_type* itr);
+    void     merge_pool();
+    bool     park();
+    void     adopt();
     string_t get_prefix(const graph_node&);
     string_t get_prefix(iterator _node) { return get_prefix(*_node); }
     string_t get_prefix(const uint64_t& _id);
@@ -274,6 +297,8 @@ private:
     uint64_t                   m_timeline_counter    = 1;
     mutable graph_data_t*      m_graph_data_instance = nullptr;
     iterator_hash_map_t        m_node_ids;
+    iterator                   m_flat_parent = {};
+    flat_table_type            m_flat_nodes  = {};
     std::unordered_set<Type*>  m_stack;
     std::shared_ptr<printer_t> m_printer;
     sample_array_t             m_samples;
@@ -288,6 +313,8 @@ storage<Type, true>::reset()
     // have the data graph erase all children of the head node
     if(m_graph_data_instance)
         m_graph_data_instance->reset();
+    // the flat regions are interned again after a reset
+    m_flat_nodes.clear();
     // erase all the cached iterators except for m_node_ids[0][0]
     for(auto& ditr : m_node_ids)
     {
@@ -323,12 +350,20 @@ storage<Type, true>::insert(scope::config scope_data, const Type& obj, uint64_t
 
     auto hash_depth = scope_data.compute_depth(_data().depth());
     auto hash_value = scope_data.compute_hash(hash_id, hash_depth, m_timeline_counter);
-    add_hash_id(hash_id, hash_value);
 
     // even when flat is combined with timeline, it still inserts at depth of 1
-    // so this is easiest check
+    // so this is easiest check. The hash alias of a flat region only needs to be
+    // registered when the region is inserted for the first time
     if(scope_data.is_flat())
+    {
+        auto* _existing = m_flat_nodes.find(hash_value);
+        if(_existing)
+            return *_existing;
+        add_hash_id(hash_id, hash_value);
         return insert_flat(hash_value, obj, hash_depth);
+    }
+
+    add_hash_id(hash_id, hash_value);
 
     // in the case of tree + timeline, timeline will have appropriately modified the
     // depth and hash so it doesn't really matter which check happens first here
@@ -346,7 +381,7 @@ storage<Type, true>::insert(scope::config scope_data, const Type& obj, uint64_t
 template <typename Type>
 template <typename Vp, enable_if_t<!(std::is_same<decay_t<Vp>, Type>::value), int>>
 typename storage<Type, true>::iterator
-storage<Type, true>::append(const secondary_data_t<Vp>& _secondary)
+storage<Type, true>::append(const secondary_id_data_t<Vp>& _secondary)
 {
     insert_init();
 
@@ -355,8 +390,8 @@ storage<Type, true>::append(const secondary_data_t<Vp>& _secondary)
     if(!_data().graph().is_valid(_itr))
         return nullptr;
 
-    // compute hash of prefix
-    auto _hash_id = add_hash_id(std::get<1>(_secondary));
+    // hash of prefix (already registered by the caller)
+    auto _hash_id = std::get<1>(_secondary);
     // compute hash w.r.t. parent iterator (so identical kernels from different
     // call-graph parents do not locate same iterator)
     auto _hash = _hash_id ^ _itr->id();
@@ -398,7 +433,7 @@ storage<Type, true>::append(const secondary_data_t<Vp>& _secondary)
 template <typename Type>
 template <typename Vp, enable_if_t<(std::is_same<decay_t<Vp>, Type>::value), int>>
 typename storage<Type, true>::iterator
-storage<Type, true>::append(const secondary_data_t<Vp>& _secondary)
+storage<Type, true>::append(const secondary_id_data_t<Vp>& _secondary)
 {
     insert_init();
 
@@ -407,8 +442,8 @@ storage<Type, true>::append(const secondary_data_t<Vp>& _secondary)
     if(!_data().graph().is_valid(_itr))
         return nullptr;
 
-    // compute hash of prefix
-    auto _hash_id = add_hash_id(std::get<1>(_secondary));
+    // hash of prefix (already registered by the caller)
+    auto _hash_id = std::get<1>(_secondary);
     // compute hash w.r.t. parent iterator (so identical kernels from different
     // call-graph parents do not locate same iterator)
     auto _hash = _hash_id ^ _itr->id();
@@ -464,30 +499,31 @@ template <typename Type>
 typename storage<Type, true>::iterator
 storage<Type, true>::insert_flat(uint64_t hash_id, const Type& obj, uint64_t hash_depth)
 {
-    static thread_local auto _current = _data().head();
-    static thread_local bool _first   = true;
-    if(_first)
+    auto* _existing = m_flat_nodes.find(hash_id);
+    if(_existing)
+        return *_existing;
+
+    // the parent of the flat regions is selected when the first region is inserted
+    if(m_flat_nodes.empty())
     {
-        _first = false;
-        if(_current.begin())
-            _current = _current.begin();
+        auto _head = _data().head();
+        if(_head.begin())
+            m_flat_parent = _head.begin();
         else
         {
             graph_node_t node(hash_id, obj, hash_depth, m_thread_idx);
-            auto         itr                = _data().emplace_child(_current, node);
+            auto         itr                = _data().emplace_child(_head, node);
             m_node_ids[hash_depth][hash_id] = itr;
-            _current                        = itr;
+            m_flat_nodes.insert(hash_id, itr);
+            m_flat_parent = itr;
             return itr;
         }
     }
 
-    auto _existing = m_node_ids[hash_depth].find(hash_id);
-    if(_existing != m_node_ids[hash_depth].end())
-        return m_node_ids[hash_depth].find(hash_id)->second;
-
     graph_node_t node(hash_id, obj, hash_depth, m_thread_idx);
-    auto         itr                = _data().emplace_child(_current, node);
+    auto         itr                = _data().emplace_child(m_flat_parent, node);
     m_node_ids[hash_depth][hash_id] = itr;
+    m_flat_nodes.insert(hash_id, itr);
     return itr;
 }
 //
@@ -623,7 +659,24 @@ template <typename Type>
 typename storage<Type, true>::pointer
 storage<Type, true>::instance()
 {
-    return get_singleton() ? get_singleton()->instance() : nullptr;
+    auto* _singleton = get_singleton();
+    if(!_singleton)
+        return nullptr;
+
+    // a new worker thread reuses the storage of a thread which has exited. The parked
+    // instance is still registered as a child of the master so no lock is required
+    if(!pool_type::instance().empty() && !singleton_t::is_master_thread() &&
+       !_singleton->smart_instance())
+    {
+        auto* _ptr = pool_type::instance().acquire();
+        if(_ptr)
+        {
+            _ptr->adopt();
+            _singleton->smart_instance().reset(_ptr);
+        }
+    }
+
+    return _singleton->instance();
 }
 //
 //--------------------------------------------------------------------------------------//
@@ -734,6 +787,7 @@ protected:
     void get_shared_manager();
     void merge();
     void merge(this_type* itr);
+    bool park() { return false; }
 
 private:
     template <typename Archive>
@@ -837,6 +891,12 @@ struct storage_deleter : public std::default_delete<StorageType>
 
         // tim::dmp::barrier();
 
+        // hand the storage of an exiting worker thread to the next new thread instead
+        // of merging it into the master under the singleton lock
+        if(ptr && master && ptr != master && this_tid != master_tid &&
+           ptr->StorageType::park())
+            return;
+
         if(ptr && master && ptr != master)
         {
             ptr->StorageType::stack_clear();
@@ -752,7 +752,14 @@ template <typename Type>
 void
 storage<Type, true>::merge()
 {
-    if(!m_is_master || !m_initialized)
+    if(!m_is_master)
+        return;
+
+    // the storage parked by the exited threads is merged even when the master was
+    // never initialized, i.e. when only worker threads used the component
+    merge_pool();
+
+    if(!m_initialized)
         return;
 
     auto m_children = singleton_t::children();
@@ -787,6 +794,96 @@ storage<Type, true>::merge(this_type* itr)
 //--------------------------------------------------------------------------------------//
 //
 template <typename Type>
+void
+storage<Type, true>::merge_pool()
+{
+    if(!m_is_master || pool_type::instance().empty())
+        return;
+
+    // the parked instances are no longer reused once they are merged
+    pool_type::instance().drain([&](this_type* itr) {
+        merge(itr);
+        singleton_t::remove(itr);
+        itr->free_shared_manager();
+        delete itr;
+    });
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+bool
+storage<Type, true>::park()
+{
+    auto _capacity = settings::storage_pool_size();
+    if(_capacity == 0 || m_is_master || is_finalizing())
+        return false;
+
+    stack_clear();
+
+    // the merge (if any) will happen on the master so the graph must be complete
+    if(m_graph_data_instance && !m_graph_data_instance->has_head())
+        return false;
+
+    if(!pool_type::instance().park(this, _capacity))
+        return false;
+
+    // the finalizer belongs to the manager of the exiting thread
+    free_shared_manager();
+    m_manager.reset();
+    return true;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
+void
+storage<Type, true>::adopt()
+{
+    // the hash ids registered by the previous thread(s) are needed to label the data
+    auto _hash_ids     = ::tim::get_hash_ids();
+    auto _hash_aliases = ::tim::get_hash_aliases();
+    if(_hash_ids && m_hash_ids && _hash_ids != m_hash_ids)
+    {
+        for(const auto& itr : *m_hash_ids)
+        {
+            if(_hash_ids->find(itr.first) == _hash_ids->end())
+                _hash_ids->insert({ itr.first, itr.second });
+        }
+        m_hash_ids = _hash_ids;
+    }
+    if(_hash_aliases && m_hash_aliases && _hash_aliases != m_hash_aliases)
+    {
+        for(const auto& itr : *m_hash_aliases)
+        {
+            if(_hash_aliases->find(itr.first) == _hash_aliases->end())
+                _hash_aliases->insert({ itr.first, itr.second });
+        }
+        m_hash_aliases = _hash_aliases;
+    }
+
+    // components with per-thread state (e.g. hw counters) must be initialized again
+    m_thread_idx  = threading::get_id();
+    m_thread_init = false;
+    get_shared_manager();
+
+    // the call-graph of the previous thread(s) is anchored where the master was when
+    // they started. The new thread continues from a new dummy at the current position
+    // of the master and the cached iterators of the previous anchor are discarded
+    if(m_graph_data_instance && master_instance())
+    {
+        auto&       _master = master_instance()->data();
+        auto_lock_t _lk{ singleton_t::get_mutex() };
+        m_graph_data_instance->set_master(&_master);
+        m_graph_data_instance->rebase();
+        m_node_ids.clear();
+        m_node_ids[0][0] = m_graph_data_instance->head();
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Type>
 typename storage<Type, true>::result_array_t
 storage<Type, true>::get()
 {
@@ -876,6 +973,9 @@ storage<Type, true>::internal_print()
 {
     base::storage::stop_profiler();
 
+    // initializes the master when only worker threads used the component
+    merge_pool();
+
     if(!m_initialized && !m_finalized)
         return;
 
@@ -0,0 +1,152 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/**
+ * \file timemory/storage/flat_table.hpp
+ * \brief Direct-indexed table of the regions of a flat call-stack
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tim
+{
+namespace impl
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \class tim::impl::flat_table
+/// \brief Maps the hash of a flat region to a dense region id the first time the
+/// hash is seen and stores one value per region id in a contiguous array. The slots
+/// are an open-addressed, power-of-two sized array which is indexed directly by the
+/// (mixed) bits of the hash so a lookup is typically a single load and compare instead
+/// of the bucket traversal of an unordered_map.
+///
+template <typename ValueT>
+class flat_table
+{
+public:
+    using value_type = ValueT;
+    using size_type  = size_t;
+
+    flat_table()
+    : m_slots(min_slots)
+    {}
+
+    /// returns nullptr if the hash has not been inserted
+    value_type* find(uint64_t _hash)
+    {
+        for(size_type i = index(_hash);; i = (i + 1) & (m_slots.size() - 1))
+        {
+            const auto& _slot = m_slots[i];
+            if(_slot.id == 0)
+                return nullptr;
+            if(_slot.hash == _hash)
+                return &m_data[_slot.id - 1];
+        }
+    }
+
+    /// assigns the next region id to the hash. The hash must not exist already
+    size_type insert(uint64_t _hash, const value_type& _value)
+    {
+        // keep the load factor at or below 1/2 so probe sequences stay short
+        if(2 * (m_data.size() + 1) > m_slots.size())
+            grow();
+        m_data.emplace_back(_value);
+        auto _id = m_data.size();
+        place(_hash, _id);
+        return _id - 1;
+    }
+
+    value_type&       operator[](size_type _id) { return m_data[_id]; }
+    const value_type& operator[](size_type _id) const { return m_data[_id]; }
+
+    size_type size() const { return m_data.size(); }
+    bool      empty() const { return m_data.empty(); }
+
+    auto begin() { return m_data.begin(); }
+    auto end() { return m_data.end(); }
+    auto begin() const { return m_data.begin(); }
+    auto end() const { return m_data.end(); }
+
+    void clear()
+    {
+        m_data.clear();
+        m_slots.assign(min_slots, slot{});
+        m_shift = 64 - min_bits;
+    }
+
+private:
+    struct slot
+    {
+        uint64_t  hash = 0;
+        size_type id   = 0;  // region id + 1, zero is an empty slot
+    };
+
+    static constexpr uint32_t  min_bits  = 6;
+    static constexpr size_type min_slots = (1 << min_bits);
+
+    // fibonacci hashing: the high bits of the product are well-mixed even when
+    // the hashes only differ in a few bits (e.g. the depth or timeline counter)
+    size_type index(uint64_t _hash) const
+    {
+        return static_cast<size_type>((_hash * 0x9E3779B97F4A7C15ULL) >> m_shift) &
+               (m_slots.size() - 1);
+    }
+
+    void place(uint64_t _hash, size_type _id)
+    {
+        auto i = index(_hash);
+        while(m_slots[i].id != 0)
+            i = (i + 1) & (m_slots.size() - 1);
+        m_slots[i] = slot{ _hash, _id };
+    }
+
+    void grow()
+    {
+        auto _old = std::move(m_slots);
+        m_slots   = std::vector<slot>(2 * _old.size());
+        --m_shift;
+        for(const auto& itr : _old)
+        {
+            if(itr.id != 0)
+                place(itr.hash, itr.id);
+        }
+    }
+
+private:
+    uint32_t            m_shift = 64 - min_bits;
+    std::vector<slot>   m_slots;
+    std::vector<ValueT> m_data;
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace impl
+}  // namespace tim
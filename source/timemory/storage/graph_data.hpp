@@ -132,15 +132,38 @@ public:
                          demangle<NodeT>().c_str(), (int) depth(),
                          (int) m_master->depth());
 
+        rebase();
+    }
+
+    /// adds a dummy at the current position of the master and continues from it. The
+    /// existing children remain under the dummy they were inserted at so they are
+    /// merged with the nodes of the master they belonged to
+    inline void rebase()
+    {
+        if(!m_master || !m_master->current())
+            return;
+
         auto _current = m_master->current();
         auto _id      = _current->id();
         auto _depth   = _current->depth();
 
-        NodeT node(_id, NodeT::get_dummy(), _depth, threading::get_id(),
-                   process::get_id(), true);
         m_depth     = _depth;
         m_sea_level = _depth;
-        m_current   = m_graph.insert_after(m_head, node);
+
+        // reuse the dummy if one was already added for this node of the master
+        auto _range = m_dummies.equal_range(_depth);
+        for(auto itr = _range.first; itr != _range.second; ++itr)
+        {
+            if(itr->second && itr->second->id() == _id)
+            {
+                m_current = itr->second;
+                return;
+            }
+        }
+
+        NodeT node(_id, NodeT::get_dummy(), _depth, threading::get_id(),
+                   process::get_id(), true);
+        m_current = m_graph.insert_after(m_head, node);
 
         m_dummies.insert({ m_depth, m_current });
     }
@@ -0,0 +1,183 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/** \file timemory/storage/live_view.hpp
+ * \headerfile timemory/storage/live_view.hpp "timemory/storage/live_view.hpp"
+ * Publishes the call-graph entries of the selected components in a shared-memory
+ * segment while the process is running when TIMEMORY_LIVE_VIEW is enabled. The
+ * segment is created (shm_open) by the first measurement. Afterwards, updating an
+ * entry is a thread-local lookup and a handful of stores into the segment.
+ *
+ */
+
+#pragma once
+
+#include "timemory/backends/process.hpp"
+#include "timemory/backends/threading.hpp"
+#include "timemory/components/properties.hpp"
+#include "timemory/settings/declaration.hpp"
+#include "timemory/utility/live_view.hpp"
+#include "timemory/utility/types.hpp"
+#include "timemory/utility/utility.hpp"
+
+#if defined(_UNIX)
+#    include <pthread.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+namespace tim
+{
+namespace live_view
+{
+//
+/// set in the child after a fork: the segment belongs to the parent
+inline bool&
+is_forked()
+{
+    static bool _value = false;
+    return _value;
+}
+//
+/// the segment of this process or nullptr if the live-view is disabled. The mapping
+/// is never released so that measurements during the static destruction remain
+/// valid, the segment name is removed at exit
+inline segment*
+get_segment()
+{
+    static segment* _instance = []() -> segment* {
+        auto _settings = settings::shared_instance();
+        if(!_settings || !_settings->get_live_view())
+            return nullptr;
+        auto* _seg = new segment{};
+        auto  _cap = std::min<size_t>(_settings->get_live_view_capacity(), UINT32_MAX);
+        if(!_seg->create(process::get_id(), static_cast<uint32_t>(_cap)))
+        {
+            delete _seg;
+            return nullptr;
+        }
+#if defined(_UNIX)
+        pthread_atfork(nullptr, nullptr, []() { is_forked() = true; });
+#endif
+        std::atexit([]() {
+            if(!is_forked())
+                get_segment()->unlink();
+        });
+        return _seg;
+    }();
+    return _instance;
+}
+//
+/// whether the component is published: TIMEMORY_LIVE_VIEW_COMPONENTS is empty or
+/// contains the label or the id of the component
+template <typename Tp>
+bool
+is_enabled()
+{
+    static bool _value = []() {
+        if(!get_segment())
+            return false;
+        auto _settings = settings::shared_instance();
+        auto _comps =
+            (_settings) ? _settings->get_live_view_components() : std::string{};
+        if(_comps.empty())
+            return true;
+        auto _tolower = [](std::string _str) {
+            for(auto& itr : _str)
+                itr = tolower(itr);
+            return _str;
+        };
+        auto _label = _tolower(Tp::get_label());
+        auto _id    = _tolower(component::properties<Tp>::id());
+        for(const auto& itr : delimit(_comps, ",;: "))
+        {
+            auto _val = _tolower(itr);
+            if(_val == _label || _val == _id)
+                return true;
+        }
+        return false;
+    }();
+    return _value && !is_forked();
+}
+//
+namespace impl
+{
+template <typename Tp>
+auto
+get_value(const Tp& _obj, int) -> decltype(as_double(_obj.get()))
+{
+    return as_double(_obj.get());
+}
+//
+template <typename Tp>
+double
+get_value(const Tp&, long)
+{
+    return 0.0;
+}
+//
+struct slot_entry
+{
+    bool     init = false;
+    uint64_t hash = 0;
+    slot*    ptr  = nullptr;
+};
+}  // namespace impl
+//
+/// publish the accumulated value of a call-graph entry and the latest measurement.
+/// Called by the thread which owns the storage after the measurement was added
+template <typename Tp, typename StorageT, typename ItrT>
+void
+update(StorageT* _storage, ItrT _itr, const Tp& _accum, const Tp& _last)
+{
+    if(!is_enabled<Tp>())
+        return;
+
+    static thread_local std::unordered_map<const void*, impl::slot_entry> _slots{};
+
+    // nodes can be released and their address reused, hence the hash check
+    auto& _entry = _slots[&(*_itr)];
+    if(!_entry.init || _entry.hash != _itr->id())
+    {
+        _entry.init  = true;
+        _entry.hash  = _itr->id();
+        _entry.ptr   = get_segment()->claim(
+            Tp::get_label().c_str(), _storage->get_prefix(*_itr), _itr->id(),
+            std::max<int64_t>(_itr->depth() - 1, 0), threading::get_id());
+    }
+
+    if(_entry.ptr)
+        publish(*_entry.ptr, _accum.get_laps(), impl::get_value(_accum, 0),
+                impl::get_value(_last, 0));
+}
+//
+}  // namespace live_view
+}  // namespace tim
@@ -30,6 +30,7 @@
 #include "timemory/mpl/type_traits.hpp"
 #include "timemory/mpl/types.hpp"
 #include "timemory/tpls/cereal/archives.hpp"
+#include "timemory/variadic/subsample.hpp"
 
 #include <cstdint>
 #include <set>
@@ -141,6 +142,8 @@ public:
     {
         obj() += rhs.obj();
         stats() += rhs.stats();
+        m_samples += rhs.m_samples;
+        m_weight += rhs.m_weight;
         return *this;
     }
 
@@ -151,6 +154,25 @@ public:
         return *this;
     }
 
+public:
+    /// records a measurement which represents \param _weight calls (see
+    /// \ref tim::subsample)
+    void add_sample(double _weight)
+    {
+        ++m_samples;
+        m_weight += _weight;
+    }
+
+    uint64_t get_samples() const { return m_samples; }
+    double   get_weight() const { return m_weight; }
+
+    /// the data scaled from the measured calls to every call they represent
+    Tp get_estimate() const;
+
+    /// the statistics of the measured calls along with the number of calls they
+    /// represent
+    stats_type get_estimate_stats() const;
+
 public:
     // data access
     uint64_t&   id() { return std::get<0>(*this); }
@@ -173,6 +195,22 @@ public:
     auto&       hash() { return this->id(); }
     const auto& data() const { return this->obj(); }
     const auto& hash() const { return this->id(); }
+
+private:
+    template <typename StatsT>
+    static auto set_population(StatsT& _stats, double _calls, int)
+        -> decltype(_stats.set_population(_calls), void())
+    {
+        _stats.set_population(_calls);
+    }
+
+    template <typename StatsT>
+    static void set_population(StatsT&, double, long)
+    {}
+
+private:
+    uint64_t m_samples = 0;
+    double   m_weight  = 0.0;
 };
 //
 //--------------------------------------------------------------------------------------//
@@ -377,6 +415,35 @@ graph<Tp>::get_dummy()
 //--------------------------------------------------------------------------------------//
 //
 template <typename Tp>
+Tp
+graph<Tp>::get_estimate() const
+{
+    auto _obj  = obj();
+    auto _laps = _obj.get_laps();
+    if(m_samples == 0 || _laps == 0)
+        return _obj;
+    auto _calls = subsample::get_calls(id(), _laps, m_samples, m_weight);
+    subsample::scale(_obj, _calls / _laps);
+    return _obj;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
+typename graph<Tp>::stats_type
+graph<Tp>::get_estimate_stats() const
+{
+    auto _stats = stats();
+    auto _laps  = obj().get_laps();
+    if(m_samples == 0 || _laps == 0)
+        return _stats;
+    set_population(_stats, subsample::get_calls(id(), _laps, m_samples, m_weight), 0);
+    return _stats;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tp>
 result<Tp>::result(uint64_t _hash, const Tp& _data, const string_t& _prefix,
                    int64_t _depth, uint64_t _rolling, const uintvector_t& _hierarchy,
                    const stats_type& _stats, uint16_t _tid, uint16_t _pid)
@@ -395,8 +462,9 @@ tree<Tp>::tree()
 template <typename Tp>
 tree<Tp>::tree(const graph<Tp>& rhs)
 : base_type(rhs.is_dummy(), rhs.hash(), rhs.depth(), idset_type{ rhs.tid() },
-            idset_type{ rhs.pid() }, entry_type{ rhs.data(), rhs.stats() },
-            entry_type{ rhs.data(), rhs.stats() })
+            idset_type{ rhs.pid() },
+            entry_type{ rhs.get_estimate(), rhs.get_estimate_stats() },
+            entry_type{ rhs.get_estimate(), rhs.get_estimate_stats() })
 {}
 //
 //--------------------------------------------------------------------------------------//
@@ -410,8 +478,8 @@ tree<Tp>::operator=(const graph<Tp>& rhs)
     depth()     = rhs.depth();
     tid()       = { rhs.tid() };
     pid()       = { rhs.pid() };
-    inclusive() = entry_type{ rhs.data(), rhs.stats() };
-    exclusive() = entry_type{ rhs.data(), rhs.stats() };
+    inclusive() = entry_type{ rhs.get_estimate(), rhs.get_estimate_stats() };
+    exclusive() = inclusive();
     return *this;
 }
 //
@@ -0,0 +1,153 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/**
+ * \file timemory/storage/pool.hpp
+ * \brief Lock-free pool of the storage instances of threads which have exited
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(TIMEMORY_STORAGE_POOL_MAX_SIZE)
+#    define TIMEMORY_STORAGE_POOL_MAX_SIZE 256
+#endif
+
+namespace tim
+{
+namespace impl
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \class tim::impl::storage_pool
+/// \brief When a worker thread exits, its storage can be "parked" here instead of
+/// being merged into the master storage (which requires the singleton lock). The
+/// parked storage keeps its call-graph and is handed to the next new thread, which
+/// continues to accumulate into it from the current position of the master (see
+/// graph_data::rebase); the data is merged into the master when the master storage
+/// merges its children. Parking and acquiring are a single atomic exchange on
+/// a fixed set of slots so neither operation blocks and there is no ABA problem.
+///
+template <typename StorageType>
+class storage_pool
+{
+public:
+    using pointer                    = StorageType*;
+    static constexpr size_t max_size = TIMEMORY_STORAGE_POOL_MAX_SIZE;
+
+    /// never destroyed because threads may exit during static destruction
+    static storage_pool& instance()
+    {
+        static auto* _instance = new storage_pool{};
+        return *_instance;
+    }
+
+    storage_pool()
+    {
+        for(auto& itr : m_slots)
+            itr.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~storage_pool()                   = default;
+    storage_pool(const storage_pool&) = delete;
+    storage_pool(storage_pool&&)      = delete;
+    storage_pool& operator=(const storage_pool&) = delete;
+    storage_pool& operator=(storage_pool&&) = delete;
+
+    /// returns false if the first `_capacity` slots are all occupied
+    bool park(pointer _ptr, size_t _capacity)
+    {
+        if(!_ptr)
+            return false;
+        _capacity = (_capacity < max_size) ? _capacity : max_size;
+        for(size_t i = 0; i < _capacity; ++i)
+        {
+            pointer _expected = nullptr;
+            if(m_slots[i].compare_exchange_strong(_expected, _ptr,
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed))
+            {
+                m_size.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// returns nullptr if the pool is empty
+    pointer acquire()
+    {
+        if(m_size.load(std::memory_order_relaxed) <= 0)
+            return nullptr;
+        for(auto& itr : m_slots)
+        {
+            if(itr.load(std::memory_order_relaxed) == nullptr)
+                continue;
+            pointer _ptr = itr.exchange(nullptr, std::memory_order_acquire);
+            if(_ptr)
+            {
+                m_size.fetch_sub(1, std::memory_order_relaxed);
+                return _ptr;
+            }
+        }
+        return nullptr;
+    }
+
+    /// removes every parked instance and invokes `_func` on it
+    template <typename FuncT>
+    size_t drain(FuncT&& _func)
+    {
+        size_t _n = 0;
+        while(auto _ptr = acquire())
+        {
+            _func(_ptr);
+            ++_n;
+        }
+        return _n;
+    }
+
+    /// approximate number of parked instances
+    size_t size() const
+    {
+        auto _n = m_size.load(std::memory_order_relaxed);
+        return (_n > 0) ? static_cast<size_t>(_n) : 0;
+    }
+    bool   empty() const { return size() == 0; }
+
+private:
+    // the counter is updated after the slot so it can briefly be negative
+    std::atomic<int64_t>                       m_size{ 0 };
+    std::array<std::atomic<pointer>, max_size> m_slots;
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace impl
+}  // namespace tim
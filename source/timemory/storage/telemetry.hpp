@@ -0,0 +1,365 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/** \file timemory/storage/telemetry.hpp
+ * \headerfile timemory/storage/telemetry.hpp "timemory/storage/telemetry.hpp"
+ * Periodically streams the per-region changes in the call-graph of the components
+ * to a collector (see timemory-collector)
+ *
+ */
+
+#pragma once
+
+#include "timemory/backends/dmp.hpp"
+#include "timemory/backends/process.hpp"
+#include "timemory/mpl/type_traits.hpp"
+#include "timemory/settings/declaration.hpp"
+#include "timemory/storage/declaration.hpp"
+#include "timemory/utility/telemetry.hpp"
+#include "timemory/utility/types.hpp"
+#include "timemory/utility/utility.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tim
+{
+namespace telemetry
+{
+//
+/// \class tim::telemetry::exporter
+/// \brief Computes the change in the laps and value of every call-graph entry of the
+/// given components since the previous message and hands the message to a
+/// background thread which sends it to the collector. The storage is read on the
+/// calling thread so tick()/collect() must be invoked on the thread which owns the
+/// storage (i.e. the master thread for the main call-graph), e.g. in the main loop
+/// of the application. When the queue to the background thread is full the message
+/// is dropped and the changes are carried over to the next message. The changes of
+/// the messages which the background thread could not send (e.g. the collector is
+/// not running or the connection was lost) are also added to the next message, so
+/// the changes are only lost if more than the queue size of messages fail in a row.
+///
+/// \code{.cpp}
+/// tim::telemetry::exporter<wall_clock, peak_rss> _exporter{};  // settings
+/// while(run)
+/// {
+///     step();
+///     _exporter.tick();  // sends at most once per TIMEMORY_TELEMETRY_INTERVAL
+/// }
+/// \endcode
+///
+template <typename... Types>
+class exporter
+{
+public:
+    using clock_type  = std::chrono::steady_clock;
+    using sender_type = telemetry::sender;
+    using key_type    = std::pair<uint32_t, uint64_t>;  // component, rolling hash
+    using totals_type = std::pair<int64_t, double>;     // laps, value
+    using baseline_t  = std::map<key_type, totals_type>;
+    using staged_t    = std::vector<std::pair<key_type, totals_type>>;
+    using named_t     = std::set<std::pair<uint32_t, uint64_t>>;  // kind, id
+    using carry_t     = std::map<key_type, record>;
+    using unsent_t    = std::map<std::pair<uint32_t, uint64_t>, std::string>;
+
+    struct config
+    {
+        std::string endpoint   = settings::telemetry_endpoint();
+        double      interval   = settings::telemetry_interval();
+        size_t      queue_size = settings::telemetry_queue_size();
+    };
+
+public:
+    explicit exporter(const config& _cfg = config{})
+    : m_interval(std::chrono::duration_cast<clock_type::duration>(
+          std::chrono::duration<double>(std::max<double>(_cfg.interval, 0.0))))
+    , m_last(clock_type::now())
+    {
+        auto _ep = endpoint::parse(_cfg.endpoint);
+        if(_ep)
+            m_sender.reset(new sender_type(_ep, _cfg.queue_size));
+        m_enabled = (m_sender != nullptr);
+    }
+
+    ~exporter() { stop(); }
+
+    exporter(const exporter&) = delete;
+    exporter(exporter&&)      = delete;
+    exporter& operator=(const exporter&) = delete;
+    exporter& operator=(exporter&&) = delete;
+
+    /// no endpoint was provided or stop() was called
+    bool enabled() const { return m_enabled; }
+
+    /// calls collect() if at least the interval elapsed since the last collection
+    bool tick()
+    {
+        if(!m_enabled || clock_type::now() - m_last < m_interval)
+            return false;
+        return collect();
+    }
+
+    /// queue a message with the changes since the last message. Returns false if
+    /// nothing changed or the message was dropped
+    bool collect()
+    {
+        if(!m_enabled)
+            return false;
+
+        m_last = clock_type::now();
+
+        // the names are only sent once per connection
+        auto _generation = m_sender->generation();
+        if(_generation != m_generation)
+            m_named.clear();
+
+        // the changes and the names of the messages which could not be sent
+        for(const auto& itr : m_sender->take_failed())
+            restore(itr);
+
+        message  _msg{};
+        staged_t _staged{};
+        named_t  _names{};
+        _msg.pid       = process::get_id();
+        _msg.rank      = dmp::rank();
+        _msg.sequence  = m_sequence;
+        _msg.timestamp = timestamp();
+        _msg.dropped   = m_sender->dropped() + m_sender->failed();
+
+        TIMEMORY_FOLD_EXPRESSION(collect<Types>(_msg, _staged, _names));
+        merge(_msg, _names);
+
+        if(_msg.records.empty() || !m_sender->submit(encode(_msg)))
+            return false;
+
+        for(auto& itr : _staged)
+            m_baseline[itr.first] = itr.second;
+        m_named.insert(_names.begin(), _names.end());
+        m_carry.clear();
+        m_unsent.clear();
+        m_generation = _generation;
+        ++m_sequence;
+        return true;
+    }
+
+    /// sends the remaining changes (if _collect), waits for the queue to be sent,
+    /// and stops the background thread
+    void stop(bool _collect = true)
+    {
+        if(!m_enabled)
+            return;
+        if(_collect)
+        {
+            // make room in the queue so the final changes are not dropped
+            m_sender->flush();
+            collect();
+        }
+        m_enabled = false;
+        m_sender->stop(true);
+    }
+
+    /// wait for the queued messages to be sent
+    bool flush(std::chrono::milliseconds _timeout = std::chrono::milliseconds{ 1000 })
+    {
+        return (m_sender) ? m_sender->flush(_timeout) : true;
+    }
+
+    uint64_t sequence() const { return m_sequence; }
+    uint64_t sent() const { return (m_sender) ? m_sender->sent() : 0; }
+    uint64_t dropped() const { return (m_sender) ? m_sender->dropped() : 0; }
+    uint64_t failed() const { return (m_sender) ? m_sender->failed() : 0; }
+
+private:
+    /// the baseline was advanced when the message was queued so the changes in a
+    /// message which could not be sent are carried over to the next message
+    void restore(const std::string& _buff)
+    {
+        message _failed{};
+        if(!decode(_buff.data(), _buff.length(), _failed))
+            return;
+
+        for(auto& itr : _failed.names)
+        {
+            auto _name = std::pair<uint32_t, uint64_t>{ itr.kind, itr.id };
+            m_named.erase(_name);
+            m_unsent[_name] = std::move(itr.name);
+        }
+
+        for(const auto& itr : _failed.records)
+        {
+            auto _ret = m_carry.emplace(key_type{ itr.component, itr.hash }, itr);
+            if(!_ret.second)
+            {
+                _ret.first->second.laps += itr.laps;
+                _ret.first->second.value += itr.value;
+            }
+        }
+    }
+
+    /// adds the carried over changes to the records of the message
+    void merge(message& _msg, named_t& _names)
+    {
+        if(m_carry.empty())
+            return;
+
+        std::map<key_type, size_t> _index{};
+        for(size_t i = 0; i < _msg.records.size(); ++i)
+        {
+            const auto& _rec = _msg.records.at(i);
+            _index.emplace(key_type{ _rec.component, _rec.hash }, i);
+        }
+
+        for(const auto& itr : m_carry)
+        {
+            auto _idx = _index.find(itr.first);
+            if(_idx == _index.end())
+            {
+                _msg.records.emplace_back(itr.second);
+                continue;
+            }
+            auto& _rec = _msg.records.at(_idx->second);
+            _rec.laps += itr.second.laps;
+            _rec.value += itr.second.value;
+        }
+
+        // the names which were only in the messages which could not be sent
+        auto _add_name = [&](uint32_t _kind, uint64_t _id) {
+            auto _name = std::pair<uint32_t, uint64_t>{ _kind, _id };
+            auto _itr  = m_unsent.find(_name);
+            if(_itr == m_unsent.end() || m_named.count(_name) > 0 ||
+               _names.count(_name) > 0)
+                return;
+            _msg.names.emplace_back(name_entry{ _kind, _id, _itr->second });
+            _names.insert(_name);
+        };
+
+        for(const auto& itr : m_carry)
+        {
+            _add_name(region_name, itr.second.hash);
+            _add_name(component_name, itr.second.component);
+        }
+    }
+
+    template <typename Tp>
+    static auto get_value(const Tp& _obj, int) -> decltype(as_double(_obj.get()))
+    {
+        return as_double(_obj.get());
+    }
+
+    template <typename Tp>
+    static double get_value(const Tp&, long)
+    {
+        return 0.0;
+    }
+
+    template <typename Tp>
+    void collect(message& _msg, staged_t& _staged, named_t& _names)
+    {
+        if(!trait::runtime_enabled<Tp>::get())
+            return;
+
+        auto* _storage = storage<Tp>::noninit_instance();
+        if(!_storage || _storage->empty())
+            return;
+
+        auto  _label = Tp::get_label();
+        auto  _id    = component_id(_label);
+        auto  _nrec  = _msg.records.size();
+        auto& _graph = _storage->graph();
+
+        // the head node is ignored
+        int64_t _min = std::numeric_limits<int64_t>::max();
+        for(const auto& itr : _graph)
+            _min = std::min<int64_t>(_min, itr.depth());
+
+        std::vector<uint64_t> _rolling{};
+        for(auto itr = _graph.begin(); itr != _graph.end(); ++itr)
+        {
+            if(itr->depth() <= _min)
+                continue;
+
+            auto _depth = itr->depth() - (_min + 1);
+            _rolling.resize(_depth + 1);
+            _rolling.at(_depth) = itr->id();
+            if(_depth > 0)
+                _rolling.at(_depth) += _rolling.at(_depth - 1);
+
+            auto  _key   = key_type{ _id, _rolling.at(_depth) };
+            auto  _laps  = static_cast<int64_t>(itr->obj().get_laps());
+            auto  _value = get_value(itr->obj(), 0);
+            auto& _prev  = m_baseline[_key];
+            if(_laps == _prev.first)
+                continue;
+
+            // the storage was reset since the previous message
+            auto _base = (_laps < _prev.first) ? totals_type{} : _prev;
+
+            _msg.records.emplace_back(record{ _key.second, _id,
+                                              static_cast<uint32_t>(_depth),
+                                              static_cast<uint64_t>(_laps - _base.first),
+                                              _value - _base.second });
+            _staged.emplace_back(_key, totals_type{ _laps, _value });
+
+            auto _name = std::pair<uint32_t, uint64_t>{ region_name, _key.second };
+            if(m_named.count(_name) == 0 && _names.count(_name) == 0)
+            {
+                _msg.names.emplace_back(
+                    name_entry{ region_name, _key.second, _storage->get_prefix(*itr) });
+                _names.insert(_name);
+            }
+        }
+
+        auto _name = std::pair<uint32_t, uint64_t>{ component_name, _id };
+        if(_msg.records.size() > _nrec && m_named.count(_name) == 0)
+        {
+            _msg.names.emplace_back(name_entry{ component_name, _id, _label });
+            _names.insert(_name);
+        }
+    }
+
+private:
+    bool                         m_enabled    = false;
+    uint64_t                     m_sequence   = 0;
+    uint64_t                     m_generation = 0;
+    clock_type::duration         m_interval   = {};
+    clock_type::time_point       m_last       = {};
+    baseline_t                   m_baseline   = {};
+    named_t                      m_named      = {};
+    carry_t                      m_carry      = {};
+    unsent_t                     m_unsent     = {};
+    std::unique_ptr<sender_type> m_sender     = {};
+};
+//
+}  // namespace telemetry
+}  // namespace tim
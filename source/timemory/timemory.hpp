@@ -92,6 +92,7 @@ struct dummy
 #    define TIMEMORY_BLANK_MARKER(...)
 #    define TIMEMORY_BASIC_MARKER(...)
 #    define TIMEMORY_MARKER(...)
+#    define TIMEMORY_LITERAL_MARKER(...)
 
 // define an unique pointer object
 #    define TIMEMORY_BLANK_POINTER(...)
@@ -97,6 +97,7 @@
     component::papi_array_t,                    \
     component::papi_vector,                     \
     component::peak_rss,                        \
+    component::perf_counters,                   \
     component::priority_context_switch,         \
     component::process_cpu_clock,               \
     component::process_cpu_util,                \
@@ -0,0 +1,382 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/** \file timemory/utility/live_view.hpp
+ * \headerfile timemory/utility/live_view.hpp "timemory/utility/live_view.hpp"
+ * Layout of the shared-memory segment which a process publishes its per-region
+ * counters in while running (see timemory/storage/live_view.hpp) and which
+ * timemory-top reads. Every slot has a single writer (the thread owning the
+ * call-graph entry) and is protected by a sequence lock so readers never block the
+ * writer and the writer never makes a system call.
+ *
+ */
+
+#pragma once
+
+#include "timemory/macros/os.hpp"
+
+#if defined(_UNIX)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace tim
+{
+namespace live_view
+{
+//
+static constexpr uint32_t magic          = 0x544d4c56;  // "TMLV"
+static constexpr uint32_t version        = 1;
+static constexpr size_t   component_size = 32;
+static constexpr size_t   name_size      = 112;
+//
+/// segment header (one cache-line), followed by "capacity" slots
+struct header
+{
+    uint32_t              magic     = 0;
+    uint32_t              version   = 0;
+    int32_t               pid       = 0;
+    uint32_t              capacity  = 0;
+    uint64_t              timestamp = 0;  // creation, nanoseconds since the epoch
+    std::atomic<uint32_t> count     = { 0 };  // slots handed out (may exceed capacity)
+    std::atomic<uint32_t> active    = { 1 };  // cleared when the process finalizes
+    uint32_t              reserved[8] = {};
+};
+//
+/// per-region counters. The fields after "sequence" are only consistent when the
+/// sequence number is even and the same before and after reading them. A sequence
+/// number of zero means the slot was claimed but never published
+struct slot
+{
+    std::atomic<uint32_t> sequence = { 0 };
+    uint32_t              tid      = 0;
+    uint64_t              hash     = 0;
+    int64_t               depth    = 0;
+    std::atomic<int64_t>  laps     = { 0 };
+    std::atomic<double>   accum    = { 0.0 };  // accumulated value in display units
+    std::atomic<double>   last     = { 0.0 };  // value of the latest measurement
+    char                  component[component_size] = {};
+    char                  name[name_size]            = {};
+};
+//
+/// a consistent copy of a slot
+struct snapshot
+{
+    uint32_t    tid       = 0;
+    uint64_t    hash      = 0;
+    int64_t     depth     = 0;
+    int64_t     laps      = 0;
+    double      accum     = 0.0;
+    double      last      = 0.0;
+    std::string component = {};
+    std::string name      = {};
+};
+//
+static_assert(std::is_standard_layout<header>::value, "header must be standard layout");
+static_assert(std::is_standard_layout<slot>::value, "slot must be standard layout");
+static_assert(sizeof(header) == 64 && sizeof(slot) % 64 == 0,
+              "header and slots should be multiples of a cache-line");
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "the shared-memory counters require address-free atomics");
+//
+inline size_t
+get_size(uint32_t _capacity)
+{
+    return sizeof(header) + static_cast<size_t>(_capacity) * sizeof(slot);
+}
+//
+inline std::string
+get_name(int32_t _pid)
+{
+    return std::string{ "/timemory-live-" } + std::to_string(_pid);
+}
+//
+/// writer: only called by the thread which owns the slot. Relaxed stores between
+/// the two sequence increments, i.e. plain stores on all common architectures
+inline void
+publish(slot& _slot, int64_t _laps, double _accum, double _last)
+{
+    auto _seq = _slot.sequence.load(std::memory_order_relaxed);
+    _slot.sequence.store(_seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _slot.laps.store(_laps, std::memory_order_relaxed);
+    _slot.accum.store(_accum, std::memory_order_relaxed);
+    _slot.last.store(_last, std::memory_order_relaxed);
+    _slot.sequence.store(_seq + 2, std::memory_order_release);
+}
+//
+/// reader: returns false if the slot was never published or the writer did not
+/// leave it alone for the given number of attempts
+inline bool
+read(const slot& _slot, snapshot& _snap, int _attempts = 16)
+{
+    for(int i = 0; i < _attempts; ++i)
+    {
+        auto _beg = _slot.sequence.load(std::memory_order_acquire);
+        if(_beg == 0)
+            return false;
+        if((_beg & 1) != 0)
+            continue;
+        auto _laps  = _slot.laps.load(std::memory_order_relaxed);
+        auto _accum = _slot.accum.load(std::memory_order_relaxed);
+        auto _last  = _slot.last.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(_slot.sequence.load(std::memory_order_relaxed) != _beg)
+            continue;
+        _snap.tid   = _slot.tid;
+        _snap.hash  = _slot.hash;
+        _snap.depth = _slot.depth;
+        _snap.laps  = _laps;
+        _snap.accum = _accum;
+        _snap.last  = _last;
+        _snap.component =
+            std::string(_slot.component, strnlen(_slot.component, component_size));
+        _snap.name = std::string(_slot.name, strnlen(_slot.name, name_size));
+        return true;
+    }
+    return false;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \class tim::live_view::segment
+/// \brief Owns the mapping of a segment. create() is used by the instrumented process
+/// and removes the segment when destroyed, attach() maps the segment of another
+/// process read-only
+///
+class segment
+{
+public:
+    segment() = default;
+    ~segment() { close(); }
+
+    segment(const segment&) = delete;
+    segment& operator=(const segment&) = delete;
+
+    segment(segment&& rhs) noexcept { swap(rhs); }
+    segment& operator=(segment&& rhs) noexcept
+    {
+        if(this != &rhs)
+        {
+            close();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    bool create(int32_t _pid, uint32_t _capacity)
+    {
+        close();
+#if defined(_UNIX)
+        auto _name = get_name(_pid);
+        auto _size = get_size(_capacity);
+        int  _fd   = shm_open(_name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+        if(_fd < 0)
+            return false;
+        if(ftruncate(_fd, _size) != 0)
+        {
+            ::close(_fd);
+            shm_unlink(_name.c_str());
+            return false;
+        }
+        auto* _addr = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+        ::close(_fd);
+        if(_addr == MAP_FAILED)
+        {
+            shm_unlink(_name.c_str());
+            return false;
+        }
+
+        // the memory is zero-filled by ftruncate so only the header is set
+        auto* _hdr = new(_addr) header{};
+        for(uint32_t i = 0; i < _capacity; ++i)
+            new(static_cast<char*>(_addr) + sizeof(header) + i * sizeof(slot)) slot{};
+        _hdr->pid      = _pid;
+        _hdr->capacity = _capacity;
+        _hdr->timestamp =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        _hdr->version = version;
+        std::atomic_thread_fence(std::memory_order_release);
+        _hdr->magic = magic;
+
+        m_owner = true;
+        m_addr  = _addr;
+        m_size  = _size;
+        m_name  = _name;
+        return true;
+#else
+        (void) _pid;
+        (void) _capacity;
+        return false;
+#endif
+    }
+
+    bool attach(int32_t _pid)
+    {
+        close();
+#if defined(_UNIX)
+        auto _name = get_name(_pid);
+        int  _fd   = shm_open(_name.c_str(), O_RDONLY, 0);
+        if(_fd < 0)
+            return false;
+        struct stat _st;
+        if(fstat(_fd, &_st) != 0 || static_cast<size_t>(_st.st_size) < sizeof(header))
+        {
+            ::close(_fd);
+            return false;
+        }
+        auto _size  = static_cast<size_t>(_st.st_size);
+        auto* _addr = mmap(nullptr, _size, PROT_READ, MAP_SHARED, _fd, 0);
+        ::close(_fd);
+        if(_addr == MAP_FAILED)
+            return false;
+
+        auto* _hdr = static_cast<const header*>(_addr);
+        if(_hdr->magic != magic || _hdr->version != version ||
+           get_size(_hdr->capacity) > _size)
+        {
+            munmap(_addr, _size);
+            return false;
+        }
+
+        m_owner = false;
+        m_addr  = _addr;
+        m_size  = _size;
+        m_name  = _name;
+        return true;
+#else
+        (void) _pid;
+        return false;
+#endif
+    }
+
+    /// marks the segment inactive and removes its name so no new reader can attach.
+    /// The mapping remains valid
+    void unlink()
+    {
+#if defined(_UNIX)
+        if(m_addr && m_owner && !m_name.empty())
+        {
+            get_header()->active.store(0, std::memory_order_release);
+            shm_unlink(m_name.c_str());
+            m_name = {};
+        }
+#endif
+    }
+
+    void close()
+    {
+#if defined(_UNIX)
+        if(m_addr)
+        {
+            unlink();
+            munmap(m_addr, m_size);
+        }
+#endif
+        m_owner = false;
+        m_addr  = nullptr;
+        m_size  = 0;
+        m_name  = {};
+    }
+
+    /// claims a slot without any system call. Returns nullptr when the segment is full
+    slot* claim(const char* _component, const std::string& _name, uint64_t _hash,
+                int64_t _depth, uint32_t _tid)
+    {
+        if(!m_addr || !m_owner)
+            return nullptr;
+        auto* _hdr = get_header();
+        auto  _idx = _hdr->count.fetch_add(1, std::memory_order_relaxed);
+        if(_idx >= _hdr->capacity)
+            return nullptr;
+        auto* _slot  = get_slot(_idx);
+        _slot->tid   = _tid;
+        _slot->hash  = _hash;
+        _slot->depth = _depth;
+        strncpy(_slot->component, _component, component_size - 1);
+        strncpy(_slot->name, _name.c_str(), name_size - 1);
+        return _slot;
+    }
+
+    bool               is_open() const { return m_addr != nullptr; }
+    bool               is_owner() const { return m_owner; }
+    const std::string& name() const { return m_name; }
+
+    header*       get_header() { return static_cast<header*>(m_addr); }
+    const header* get_header() const { return static_cast<const header*>(m_addr); }
+
+    /// number of slots which were handed out and fit in the segment
+    uint32_t size() const
+    {
+        if(!m_addr)
+            return 0;
+        auto _n = get_header()->count.load(std::memory_order_acquire);
+        return (_n < get_header()->capacity) ? _n : get_header()->capacity;
+    }
+
+    slot* get_slot(uint32_t _idx)
+    {
+        return reinterpret_cast<slot*>(static_cast<char*>(m_addr) + sizeof(header) +
+                                       _idx * sizeof(slot));
+    }
+
+    const slot* get_slot(uint32_t _idx) const
+    {
+        return reinterpret_cast<const slot*>(static_cast<const char*>(m_addr) +
+                                             sizeof(header) + _idx * sizeof(slot));
+    }
+
+private:
+    void swap(segment& rhs)
+    {
+        std::swap(m_owner, rhs.m_owner);
+        std::swap(m_addr, rhs.m_addr);
+        std::swap(m_size, rhs.m_size);
+        std::swap(m_name, rhs.m_name);
+    }
+
+private:
+    bool        m_owner = false;
+    void*       m_addr  = nullptr;
+    size_t      m_size  = 0;
+    std::string m_name  = {};
+};
+//
+}  // namespace live_view
+}  // namespace tim
@@ -32,11 +32,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <thread>
 
 //======================================================================================//
@@ -123,22 +125,34 @@ public:
             f_master_instance() = nullptr;
     }
 
-    static list_t children() { return f_children(); }
+    static list_t children()
+    {
+        auto_lock_t l(f_mutex());
+        f_drain_pending();
+        return f_children();
+    }
     static bool   is_master(pointer ptr) { return ptr == master_instance_ptr(); }
     static bool   is_master_thread()
     {
         return std::this_thread::get_id() == f_master_thread();
     }
 
+    // registration is lock-free: the children are pushed onto a list which is
+    // moved into the set the next time the set is accessed (under the lock)
     static void insert(pointer itr)
     {
-        auto_lock_t l(f_mutex());
-        f_children().insert(itr);
+        auto  _node = new pending_child{ itr, nullptr };
+        auto& _head = f_pending();
+        _node->next = _head.load(std::memory_order_relaxed);
+        while(!_head.compare_exchange_weak(_node->next, _node, std::memory_order_release,
+                                           std::memory_order_relaxed))
+        {}
     }
 
     static void remove(pointer itr)
     {
         auto_lock_t l(f_mutex());
+        f_drain_pending();
         for(auto litr = f_children().begin(); litr != f_children().end(); ++litr)
         {
             if(*litr == itr)
@@ -218,6 +232,12 @@ private:
 
 private:
     // Private variables
+    struct pending_child
+    {
+        pointer        value = nullptr;
+        pending_child* next  = nullptr;
+    };
+
     struct persistent_data
     {
         thread_id_t m_master_thread = std::this_thread::get_id();
@@ -225,6 +245,8 @@ private:
         pointer     m_master_instance = nullptr;
         list_t      m_children        = {};
 
+        std::atomic<pending_child*> m_pending{ nullptr };
+
         persistent_data()                       = default;
         ~persistent_data()                      = default;
         persistent_data(const persistent_data&) = delete;
@@ -241,6 +263,13 @@ private:
         {
             m_master_instance = nullptr;
             m_children.clear();
+            auto* _node = m_pending.exchange(nullptr, std::memory_order_acquire);
+            while(_node)
+            {
+                auto* _next = _node->next;
+                delete _node;
+                _node = _next;
+            }
         }
     };
 
@@ -250,6 +279,24 @@ private:
     static pointer&     f_master_instance();
     static list_t&      f_children();
 
+    static std::atomic<pending_child*>& f_pending()
+    {
+        return f_persistent_data().m_pending;
+    }
+
+    // requires the lock to be held
+    static void f_drain_pending()
+    {
+        auto* _node = f_pending().exchange(nullptr, std::memory_order_acquire);
+        while(_node)
+        {
+            f_children().insert(_node->value);
+            auto* _next = _node->next;
+            delete _node;
+            _node = _next;
+        }
+    }
+
     static persistent_data& f_persistent_data()
     {
         static persistent_data _instance;
@@ -0,0 +1,240 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/** \file utility/symbols.hpp
+ * \headerfile utility/symbols.hpp "timemory/utility/symbols.hpp"
+ * Resolves instruction addresses to function names. The dynamic symbol table is
+ * consulted via dladdr and the static functions, which are not in the dynamic symbol
+ * table, are resolved from the ELF symbol table of the module which contains them
+ *
+ */
+
+#pragma once
+
+#include "timemory/macros/os.hpp"
+#include "timemory/utility/utility.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#if defined(_UNIX)
+#    include <dlfcn.h>
+#    include <unistd.h>
+#endif
+
+#if defined(_LINUX)
+#    include <elf.h>
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#endif
+
+namespace tim
+{
+namespace symbols
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+#if defined(_LINUX)
+//
+struct elf_symbol
+{
+    uint64_t    value = 0;
+    uint64_t    size  = 0;
+    std::string name  = {};
+
+    bool operator<(const elf_symbol& rhs) const { return value < rhs.value; }
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::symbols::elf_module
+/// \brief The function symbols of the .symtab section of an ELF module, sorted by
+/// address. For position-independent modules the values are relative to the load
+/// address of the module.
+struct elf_module
+{
+    bool                    relocatable = false;
+    std::vector<elf_symbol> symbols     = {};
+
+    bool read(const std::string& _fname)
+    {
+        auto _fd = ::open(_fname.c_str(), O_RDONLY);
+        if(_fd < 0)
+            return false;
+
+        struct stat _st;
+        void*       _addr = MAP_FAILED;
+        if(fstat(_fd, &_st) == 0 && static_cast<size_t>(_st.st_size) > sizeof(Elf64_Ehdr))
+            _addr = mmap(nullptr, _st.st_size, PROT_READ, MAP_PRIVATE, _fd, 0);
+        ::close(_fd);
+        if(_addr == MAP_FAILED)
+            return false;
+
+        auto        _size = static_cast<size_t>(_st.st_size);
+        const auto* _data = static_cast<const char*>(_addr);
+        const auto* _ehdr = static_cast<const Elf64_Ehdr*>(_addr);
+        if(memcmp(_ehdr->e_ident, ELFMAG, SELFMAG) != 0 ||
+           _ehdr->e_ident[EI_CLASS] != ELFCLASS64 || _ehdr->e_shoff == 0 ||
+           _ehdr->e_shoff + _ehdr->e_shnum * sizeof(Elf64_Shdr) > _size)
+        {
+            munmap(_addr, _size);
+            return false;
+        }
+
+        relocatable = (_ehdr->e_type == ET_DYN);
+        const auto* _shdr =
+            reinterpret_cast<const Elf64_Shdr*>(_data + _ehdr->e_shoff);
+        for(int i = 0; i < _ehdr->e_shnum; ++i)
+        {
+            const auto& _sec = _shdr[i];
+            if(_sec.sh_type != SHT_SYMTAB || _sec.sh_link >= _ehdr->e_shnum)
+                continue;
+            const auto& _str = _shdr[_sec.sh_link];
+            if(_sec.sh_offset + _sec.sh_size > _size ||
+               _str.sh_offset + _str.sh_size > _size)
+                continue;
+            const auto* _syms =
+                reinterpret_cast<const Elf64_Sym*>(_data + _sec.sh_offset);
+            auto _nsyms = _sec.sh_size / sizeof(Elf64_Sym);
+            for(size_t j = 0; j < _nsyms; ++j)
+            {
+                const auto& _sym = _syms[j];
+                if(ELF64_ST_TYPE(_sym.st_info) != STT_FUNC || _sym.st_value == 0 ||
+                   _sym.st_name >= _str.sh_size)
+                    continue;
+                const char* _name = _data + _str.sh_offset + _sym.st_name;
+                symbols.push_back({ _sym.st_value, std::max<uint64_t>(_sym.st_size, 1),
+                                    std::string(_name) });
+            }
+        }
+        munmap(_addr, _size);
+        std::sort(symbols.begin(), symbols.end());
+        return !symbols.empty();
+    }
+
+    const elf_symbol* find(uint64_t _value) const
+    {
+        auto itr = std::upper_bound(symbols.begin(), symbols.end(),
+                                    elf_symbol{ _value, 0, {} });
+        if(itr == symbols.begin())
+            return nullptr;
+        --itr;
+        return (_value < itr->value + itr->size) ? &(*itr) : nullptr;
+    }
+};
+//
+#endif
+//
+//--------------------------------------------------------------------------------------//
+//
+/// resolves all the addresses at once, each module is read at most once. When
+/// \param _pc is false, the addresses are function entry points, e.g. from
+/// -finstrument-functions, and unresolved addresses are reported in hexadecimal. When
+/// \param _pc is true, the addresses are program counters within the functions, e.g.
+/// from a call-stack, the nearest dynamic symbol is accepted and unresolved addresses
+/// are reported by the name of the module which contains them.
+inline std::map<const void*, std::string>
+resolve(const std::set<const void*>& _addresses, bool _pc = false)
+{
+    std::map<const void*, std::string> _names{};
+#if defined(_LINUX)
+    std::map<std::string, elf_module> _modules{};
+#endif
+
+    for(const auto* itr : _addresses)
+    {
+#if defined(_UNIX)
+        Dl_info _info;
+        memset(&_info, 0, sizeof(_info));
+        auto _ok = dladdr(const_cast<void*>(itr), &_info);
+        if(_ok != 0 && _info.dli_sname && _info.dli_saddr == itr)
+        {
+            _names[itr] = demangle(_info.dli_sname);
+            continue;
+        }
+
+#    if defined(_LINUX)
+        if(_ok != 0)
+        {
+            std::string _fname = (_info.dli_fname) ? _info.dli_fname : "";
+            if(_fname.empty() || access(_fname.c_str(), R_OK) != 0)
+                _fname = "/proc/self/exe";
+            auto _mitr = _modules.find(_fname);
+            if(_mitr == _modules.end())
+            {
+                _mitr = _modules.emplace(_fname, elf_module{}).first;
+                _mitr->second.read(_fname);
+            }
+            auto _value = reinterpret_cast<uint64_t>(itr);
+            if(_mitr->second.relocatable)
+                _value -= reinterpret_cast<uint64_t>(_info.dli_fbase);
+            const auto* _sym = _mitr->second.find(_value);
+            if(_sym)
+            {
+                _names[itr] = demangle(_sym->name);
+                continue;
+            }
+        }
+#    endif
+
+        if(_pc && _ok != 0)
+        {
+            if(_info.dli_sname)
+                _names[itr] = demangle(_info.dli_sname);
+            else if(_info.dli_fname)
+            {
+                std::string _fname = _info.dli_fname;
+                _names[itr] = "[" + _fname.substr(_fname.find_last_of('/') + 1) + "]";
+            }
+            if(_names.count(itr) > 0)
+                continue;
+        }
+#endif
+
+        if(_pc)
+        {
+            _names[itr] = "[unknown]";
+            continue;
+        }
+
+        char _buff[64];
+        snprintf(_buff, sizeof(_buff), "%p", itr);
+        _names[itr] = _buff;
+    }
+    return _names;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace symbols
+}  // namespace tim
@@ -0,0 +1,982 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/** \file timemory/utility/telemetry.hpp
+ * \headerfile timemory/utility/telemetry.hpp "timemory/utility/telemetry.hpp"
+ * Provides the binary message format, the asynchronous sender, and the collector
+ * used to stream per-region deltas from running processes over a UNIX domain
+ * socket or TCP. The exporter which reads the storage is in
+ * timemory/storage/telemetry.hpp
+ *
+ */
+
+#pragma once
+
+#include "timemory/macros/os.hpp"
+
+#if defined(_UNIX)
+#    include <arpa/inet.h>
+#    include <netdb.h>
+#    include <netinet/in.h>
+#    include <poll.h>
+#    include <sys/socket.h>
+#    include <sys/un.h>
+#    include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tim
+{
+namespace telemetry
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+//                              MESSAGE FORMAT
+//
+//  All fields are fixed-width and in the byte-order of the sender. A collector on a
+//  host with a different byte-order rejects the messages because the magic number
+//  does not match.
+//
+//  header  : magic (u32), version (u16), flags (u16), size (u32), pid (i32),
+//            rank (i32), sequence (u64), timestamp (u64), dropped (u64),
+//            # names (u32), # records (u32)
+//  names   : kind (u32), id (u64), length (u32), characters
+//  records : hash (u64), component (u32), depth (u32), laps (u64), value (f64)
+//
+//--------------------------------------------------------------------------------------//
+//
+static constexpr uint32_t magic       = 0x544d544c;  // "TMTL"
+static constexpr uint16_t version     = 1;
+static constexpr size_t   header_size = 52;
+static constexpr size_t   record_size = 32;
+//
+enum name_kind : uint32_t
+{
+    region_name    = 0,
+    component_name = 1
+};
+//
+/// a change in a call-graph entry since the previous message
+struct record
+{
+    uint64_t hash      = 0;    // rolling hash of the call-path
+    uint32_t component = 0;    // see component_id()
+    uint32_t depth     = 0;    // depth in the call-graph
+    uint64_t laps      = 0;    // number of new laps
+    double   value     = 0.0;  // change in the value in the display units
+};
+//
+/// maps a region hash or a component id to a string. Only sent once per connection
+struct name_entry
+{
+    uint32_t    kind = region_name;
+    uint64_t    id   = 0;
+    std::string name = {};
+};
+//
+struct message
+{
+    int32_t                 pid       = 0;
+    int32_t                 rank      = 0;
+    uint64_t                sequence  = 0;
+    uint64_t                timestamp = 0;  // nanoseconds since the epoch
+    uint64_t                dropped   = 0;  // messages which were never sent
+    std::vector<name_entry> names     = {};
+    std::vector<record>     records   = {};
+
+    bool empty() const { return names.empty() && records.empty(); }
+    void clear()
+    {
+        names.clear();
+        records.clear();
+    }
+};
+//
+/// FNV-1a of the component label so that the id is the same in every process
+inline uint32_t
+component_id(const std::string& _label)
+{
+    uint32_t _val = 2166136261u;
+    for(const auto& itr : _label)
+    {
+        _val ^= static_cast<uint8_t>(itr);
+        _val *= 16777619u;
+    }
+    return _val;
+}
+//
+inline uint64_t
+timestamp()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+}
+//
+namespace impl
+{
+template <typename Tp>
+inline void
+write(std::string& _buff, const Tp& _val)
+{
+    _buff.append(reinterpret_cast<const char*>(&_val), sizeof(Tp));
+}
+//
+template <typename Tp>
+inline bool
+read(const char*& _data, const char* _end, Tp& _val)
+{
+    if(_end - _data < static_cast<std::ptrdiff_t>(sizeof(Tp)))
+        return false;
+    memcpy(&_val, _data, sizeof(Tp));
+    _data += sizeof(Tp);
+    return true;
+}
+}  // namespace impl
+//
+/// serialize a message into the binary format
+inline std::string
+encode(const message& _msg)
+{
+    size_t _size = header_size + _msg.records.size() * record_size;
+    for(const auto& itr : _msg.names)
+        _size += 16 + itr.name.length();
+
+    std::string _buff{};
+    _buff.reserve(_size);
+    impl::write(_buff, magic);
+    impl::write(_buff, version);
+    impl::write(_buff, uint16_t{ 0 });
+    impl::write(_buff, static_cast<uint32_t>(_size));
+    impl::write(_buff, _msg.pid);
+    impl::write(_buff, _msg.rank);
+    impl::write(_buff, _msg.sequence);
+    impl::write(_buff, _msg.timestamp);
+    impl::write(_buff, _msg.dropped);
+    impl::write(_buff, static_cast<uint32_t>(_msg.names.size()));
+    impl::write(_buff, static_cast<uint32_t>(_msg.records.size()));
+    for(const auto& itr : _msg.names)
+    {
+        impl::write(_buff, itr.kind);
+        impl::write(_buff, itr.id);
+        impl::write(_buff, static_cast<uint32_t>(itr.name.length()));
+        _buff.append(itr.name);
+    }
+    for(const auto& itr : _msg.records)
+    {
+        impl::write(_buff, itr.hash);
+        impl::write(_buff, itr.component);
+        impl::write(_buff, itr.depth);
+        impl::write(_buff, itr.laps);
+        impl::write(_buff, itr.value);
+    }
+    return _buff;
+}
+//
+/// returns the size of the message at the start of the buffer, zero if the header
+/// is incomplete, or -1 if the buffer does not start with a valid header
+inline int64_t
+peek_size(const char* _data, size_t _len)
+{
+    if(_len < 12)
+        return 0;
+    uint32_t _magic   = 0;
+    uint16_t _version = 0;
+    uint32_t _size    = 0;
+    memcpy(&_magic, _data, sizeof(_magic));
+    memcpy(&_version, _data + 4, sizeof(_version));
+    memcpy(&_size, _data + 8, sizeof(_size));
+    if(_magic != magic || _version != version || _size < header_size)
+        return -1;
+    return _size;
+}
+//
+/// deserialize one complete message
+inline bool
+decode(const char* _data, size_t _len, message& _msg)
+{
+    auto _size = peek_size(_data, _len);
+    if(_size <= 0 || static_cast<size_t>(_size) > _len)
+        return false;
+
+    const char* _end    = _data + _size;
+    uint32_t    _nnames = 0;
+    uint32_t    _nrecs  = 0;
+    _data += 12;
+    _msg.clear();
+    if(!impl::read(_data, _end, _msg.pid) || !impl::read(_data, _end, _msg.rank) ||
+       !impl::read(_data, _end, _msg.sequence) ||
+       !impl::read(_data, _end, _msg.timestamp) ||
+       !impl::read(_data, _end, _msg.dropped) || !impl::read(_data, _end, _nnames) ||
+       !impl::read(_data, _end, _nrecs))
+        return false;
+
+    _msg.names.reserve(_nnames);
+    for(uint32_t i = 0; i < _nnames; ++i)
+    {
+        name_entry _entry{};
+        uint32_t   _length = 0;
+        if(!impl::read(_data, _end, _entry.kind) || !impl::read(_data, _end, _entry.id) ||
+           !impl::read(_data, _end, _length) ||
+           static_cast<size_t>(_end - _data) < _length)
+            return false;
+        _entry.name = std::string(_data, _length);
+        _data += _length;
+        _msg.names.emplace_back(std::move(_entry));
+    }
+
+    if(static_cast<size_t>(_end - _data) != _nrecs * record_size)
+        return false;
+
+    _msg.records.resize(_nrecs);
+    for(auto& itr : _msg.records)
+    {
+        impl::read(_data, _end, itr.hash);
+        impl::read(_data, _end, itr.component);
+        impl::read(_data, _end, itr.depth);
+        impl::read(_data, _end, itr.laps);
+        impl::read(_data, _end, itr.value);
+    }
+    return true;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+//                              ENDPOINT
+//
+//  "unix:<path>" or an absolute path is a UNIX domain socket, "tcp:<host>:<port>"
+//  or "<host>:<port>" is TCP. A TCP port of zero in the collector binds to any
+//  available port.
+//
+//--------------------------------------------------------------------------------------//
+//
+struct endpoint
+{
+    enum kind_t : short
+    {
+        none = 0,
+        unix_domain,
+        tcp
+    };
+
+    kind_t      kind = none;
+    std::string path = {};
+    std::string host = {};
+    int         port = 0;
+
+    explicit operator bool() const { return kind != none; }
+
+    static endpoint parse(std::string _str)
+    {
+        endpoint _ret{};
+        if(_str.find("unix:") == 0)
+        {
+            _ret.kind = unix_domain;
+            _ret.path = _str.substr(5);
+        }
+        else if(!_str.empty() && _str.front() == '/')
+        {
+            _ret.kind = unix_domain;
+            _ret.path = _str;
+        }
+        else
+        {
+            if(_str.find("tcp:") == 0)
+                _str = _str.substr(4);
+            auto _pos = _str.find_last_of(':');
+            if(_pos == std::string::npos || _pos + 1 == _str.length())
+                return _ret;
+            try
+            {
+                _ret.port = std::stoi(_str.substr(_pos + 1));
+            } catch(std::exception&)
+            {
+                return _ret;
+            }
+            _ret.kind = tcp;
+            _ret.host = _str.substr(0, _pos);
+            if(_ret.host.empty())
+                _ret.host = "127.0.0.1";
+        }
+        return _ret;
+    }
+
+    std::string as_string() const
+    {
+        switch(kind)
+        {
+            case unix_domain: return std::string{ "unix:" } + path;
+            case tcp: return std::string{ "tcp:" } + host + ":" + std::to_string(port);
+            case none: break;
+        }
+        return std::string{};
+    }
+};
+//
+namespace impl
+{
+#if defined(_UNIX)
+//
+#    if defined(MSG_NOSIGNAL)
+static constexpr int send_flags = MSG_NOSIGNAL;
+#    else
+static constexpr int send_flags = 0;
+#    endif
+//
+inline void
+close(int _fd)
+{
+    if(_fd >= 0)
+        ::close(_fd);
+}
+//
+inline void
+remove(const endpoint& _ep)
+{
+    if(_ep.kind == endpoint::unix_domain && !_ep.path.empty())
+        unlink(_ep.path.c_str());
+}
+//
+inline void
+no_sigpipe(int _fd)
+{
+#    if defined(SO_NOSIGPIPE)
+    int _val = 1;
+    setsockopt(_fd, SOL_SOCKET, SO_NOSIGPIPE, &_val, sizeof(_val));
+#    else
+    (void) _fd;
+#    endif
+}
+//
+inline bool
+make_address(const endpoint& _ep, sockaddr_un& _addr)
+{
+    if(_ep.path.empty() || _ep.path.length() >= sizeof(_addr.sun_path))
+        return false;
+    memset(&_addr, 0, sizeof(_addr));
+    _addr.sun_family = AF_UNIX;
+    strncpy(_addr.sun_path, _ep.path.c_str(), sizeof(_addr.sun_path) - 1);
+    return true;
+}
+//
+/// returns a connected socket or -1
+inline int
+connect(const endpoint& _ep)
+{
+    if(_ep.kind == endpoint::unix_domain)
+    {
+        sockaddr_un _addr{};
+        if(!make_address(_ep, _addr))
+            return -1;
+        int _fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if(_fd < 0)
+            return -1;
+        no_sigpipe(_fd);
+        if(::connect(_fd, (sockaddr*) &_addr, sizeof(_addr)) != 0)
+        {
+            close(_fd);
+            return -1;
+        }
+        return _fd;
+    }
+    else if(_ep.kind == endpoint::tcp)
+    {
+        addrinfo  _hints{};
+        addrinfo* _info = nullptr;
+        _hints.ai_family   = AF_UNSPEC;
+        _hints.ai_socktype = SOCK_STREAM;
+        auto _port         = std::to_string(_ep.port);
+        if(getaddrinfo(_ep.host.c_str(), _port.c_str(), &_hints, &_info) != 0)
+            return -1;
+        int _fd = -1;
+        for(auto* itr = _info; itr; itr = itr->ai_next)
+        {
+            _fd = ::socket(itr->ai_family, itr->ai_socktype, itr->ai_protocol);
+            if(_fd < 0)
+                continue;
+            no_sigpipe(_fd);
+            if(::connect(_fd, itr->ai_addr, itr->ai_addrlen) == 0)
+                break;
+            close(_fd);
+            _fd = -1;
+        }
+        freeaddrinfo(_info);
+        return _fd;
+    }
+    return -1;
+}
+//
+/// returns a listening socket or -1. A TCP port of zero is updated to the bound port
+inline int
+listen(endpoint& _ep)
+{
+    int _fd = -1;
+    if(_ep.kind == endpoint::unix_domain)
+    {
+        sockaddr_un _addr{};
+        if(!make_address(_ep, _addr))
+            return -1;
+        _fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if(_fd < 0)
+            return -1;
+        unlink(_ep.path.c_str());
+        if(::bind(_fd, (sockaddr*) &_addr, sizeof(_addr)) != 0)
+        {
+            close(_fd);
+            return -1;
+        }
+    }
+    else if(_ep.kind == endpoint::tcp)
+    {
+        sockaddr_in _addr{};
+        _addr.sin_family = AF_INET;
+        _addr.sin_port   = htons(_ep.port);
+        if(_ep.host == "*" || _ep.host == "0.0.0.0")
+            _addr.sin_addr.s_addr = INADDR_ANY;
+        else if(inet_pton(AF_INET, _ep.host.c_str(), &_addr.sin_addr) != 1)
+            return -1;
+        _fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if(_fd < 0)
+            return -1;
+        int _val = 1;
+        setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &_val, sizeof(_val));
+        if(::bind(_fd, (sockaddr*) &_addr, sizeof(_addr)) != 0)
+        {
+            close(_fd);
+            return -1;
+        }
+        socklen_t _len = sizeof(_addr);
+        if(getsockname(_fd, (sockaddr*) &_addr, &_len) == 0)
+            _ep.port = ntohs(_addr.sin_port);
+    }
+    else
+    {
+        return -1;
+    }
+
+    if(::listen(_fd, SOMAXCONN) != 0)
+    {
+        close(_fd);
+        return -1;
+    }
+    return _fd;
+}
+//
+inline bool
+send_all(int _fd, const char* _data, size_t _len)
+{
+    while(_len > 0)
+    {
+        auto _n = ::send(_fd, _data, _len, send_flags);
+        if(_n < 0 && errno == EINTR)
+            continue;
+        if(_n <= 0)
+            return false;
+        _data += _n;
+        _len -= _n;
+    }
+    return true;
+}
+//
+#else
+//
+inline void close(int) {}
+inline void remove(const endpoint&) {}
+inline int  connect(const endpoint&) { return -1; }
+inline int  listen(endpoint&) { return -1; }
+inline bool send_all(int, const char*, size_t) { return false; }
+//
+#endif
+}  // namespace impl
+//
+//--------------------------------------------------------------------------------------//
+//
+//                              SENDER
+//
+//  Messages are handed to a background thread through a bounded queue. submit()
+//  never waits on the network: when the queue is full the message is rejected and
+//  counted as dropped. Messages which were dequeued but could not be sent (no
+//  collector, connection lost) are counted as failed and the most recent ones, up to
+//  the capacity of the queue, are returned by take_failed() so that their contents
+//  can be sent again. The connection is (re-)established lazily and at most once per
+//  retry interval.
+//
+//--------------------------------------------------------------------------------------//
+//
+class sender
+{
+public:
+    using clock_type    = std::chrono::steady_clock;
+    using duration_type = std::chrono::milliseconds;
+
+    sender(endpoint _ep, size_t _capacity, duration_type _retry = duration_type{ 100 })
+    : m_endpoint(std::move(_ep))
+    , m_capacity((_capacity > 0) ? _capacity : 1)
+    , m_retry(_retry)
+    {
+        m_thread = std::thread{ [this]() { run(); } };
+    }
+
+    ~sender() { stop(); }
+
+    sender(const sender&) = delete;
+    sender(sender&&)      = delete;
+    sender& operator=(const sender&) = delete;
+    sender& operator=(sender&&) = delete;
+
+    /// returns false (and counts the message as dropped) if the queue is full
+    bool submit(std::string&& _msg)
+    {
+        std::unique_lock<std::mutex> _lk{ m_mutex };
+        if(!m_running || m_queue.size() >= m_capacity)
+        {
+            ++m_dropped;
+            return false;
+        }
+        m_queue.emplace_back(std::move(_msg));
+        _lk.unlock();
+        m_cv.notify_one();
+        return true;
+    }
+
+    /// wait until every queued message was sent or failed
+    bool flush(duration_type _timeout = duration_type{ 1000 })
+    {
+        std::unique_lock<std::mutex> _lk{ m_mutex };
+        return m_idle.wait_for(_lk, _timeout,
+                               [this]() { return m_queue.empty() && !m_busy; });
+    }
+
+    /// stops the thread after sending the queued messages (if flush) and closes the
+    /// connection
+    void stop(bool _flush = true)
+    {
+        {
+            std::unique_lock<std::mutex> _lk{ m_mutex };
+            if(!m_running)
+                return;
+            m_running = false;
+            if(!_flush)
+            {
+                m_dropped += m_queue.size();
+                m_queue.clear();
+            }
+        }
+        m_cv.notify_all();
+        if(m_thread.joinable())
+            m_thread.join();
+    }
+
+    /// the messages which could not be sent since the previous call, oldest first
+    std::deque<std::string> take_failed()
+    {
+        std::deque<std::string>      _ret{};
+        std::unique_lock<std::mutex> _lk{ m_mutex };
+        std::swap(_ret, m_unsent);
+        return _ret;
+    }
+
+    const endpoint& get_endpoint() const { return m_endpoint; }
+    size_t          capacity() const { return m_capacity; }
+    uint64_t        sent() const { return m_sent.load(); }
+    uint64_t        dropped() const { return m_dropped.load(); }
+    uint64_t        failed() const { return m_failed.load(); }
+    /// incremented on every new connection
+    uint64_t generation() const { return m_generation.load(); }
+    bool     connected() const { return m_connected.load(); }
+
+private:
+    void run()
+    {
+        int  _fd   = -1;
+        auto _last = clock_type::now() - m_retry;
+        while(true)
+        {
+            std::string _msg{};
+            {
+                std::unique_lock<std::mutex> _lk{ m_mutex };
+                m_busy = false;
+                m_idle.notify_all();
+                m_cv.wait(_lk, [this]() { return !m_running || !m_queue.empty(); });
+                if(m_queue.empty())
+                    break;
+                _msg = std::move(m_queue.front());
+                m_queue.pop_front();
+                m_busy = true;
+            }
+
+            if(_fd < 0 && clock_type::now() - _last >= m_retry)
+            {
+                _last = clock_type::now();
+                _fd   = impl::connect(m_endpoint);
+                if(_fd >= 0)
+                {
+                    ++m_generation;
+                    m_connected.store(true);
+                }
+            }
+
+            if(_fd >= 0 && impl::send_all(_fd, _msg.data(), _msg.length()))
+            {
+                ++m_sent;
+                continue;
+            }
+
+            ++m_failed;
+            {
+                std::unique_lock<std::mutex> _lk{ m_mutex };
+                m_unsent.emplace_back(std::move(_msg));
+                if(m_unsent.size() > m_capacity)
+                    m_unsent.pop_front();
+            }
+            if(_fd >= 0)
+            {
+                impl::close(_fd);
+                _fd = -1;
+                m_connected.store(false);
+            }
+        }
+        impl::close(_fd);
+        m_connected.store(false);
+    }
+
+private:
+    bool                    m_running    = true;
+    bool                    m_busy       = false;
+    endpoint                m_endpoint   = {};
+    size_t                  m_capacity   = 1;
+    duration_type           m_retry      = duration_type{ 100 };
+    std::atomic<uint64_t>   m_sent       = { 0 };
+    std::atomic<uint64_t>   m_dropped    = { 0 };
+    std::atomic<uint64_t>   m_failed     = { 0 };
+    std::atomic<uint64_t>   m_generation = { 0 };
+    std::atomic<bool>       m_connected  = { false };
+    std::mutex              m_mutex      = {};
+    std::condition_variable m_cv         = {};
+    std::condition_variable m_idle       = {};
+    std::deque<std::string> m_queue      = {};
+    std::deque<std::string> m_unsent     = {};
+    std::thread             m_thread     = {};
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+//                              COLLECTOR
+//
+//  Accepts any number of connections and aggregates the records per source (pid
+//  and rank) and in total. poll() is single-threaded and processes whatever is
+//  available within the timeout.
+//
+//--------------------------------------------------------------------------------------//
+//
+class collector
+{
+public:
+    struct entry
+    {
+        uint32_t depth = 0;
+        uint64_t order = 0;  // first-seen, i.e. call-graph order of the first sender
+        uint64_t laps  = 0;
+        double   value = 0.0;
+    };
+
+    using key_type       = std::pair<uint32_t, uint64_t>;  // component, hash
+    using entry_map_t    = std::map<key_type, entry>;
+    using source_key_t   = std::pair<int32_t, int32_t>;  // pid, rank
+    using region_names_t = std::map<uint64_t, std::string>;
+    using comp_names_t   = std::map<uint32_t, std::string>;
+
+    struct source
+    {
+        uint64_t    messages = 0;
+        uint64_t    records  = 0;
+        uint64_t    dropped  = 0;  // reported by the sender
+        uint64_t    missing  = 0;  // gaps in the sequence numbers
+        uint64_t    sequence = 0;  // next expected sequence number
+        entry_map_t entries  = {};
+    };
+
+    using source_map_t = std::map<source_key_t, source>;
+
+public:
+    collector() = default;
+    ~collector() { close(); }
+
+    collector(const collector&) = delete;
+    collector(collector&&)      = delete;
+    collector& operator=(const collector&) = delete;
+    collector& operator=(collector&&) = delete;
+
+    bool open(const std::string& _endpoint) { return open(endpoint::parse(_endpoint)); }
+
+    bool open(endpoint _ep)
+    {
+        close();
+        m_listen = impl::listen(_ep);
+        if(m_listen < 0)
+            return false;
+        m_endpoint = std::move(_ep);
+        return true;
+    }
+
+    void close()
+    {
+        for(auto& itr : m_clients)
+            impl::close(itr.first);
+        m_clients.clear();
+        if(m_listen >= 0)
+        {
+            impl::close(m_listen);
+            impl::remove(m_endpoint);
+        }
+        m_listen = -1;
+    }
+
+    /// accept connections and process the available data. Returns the number of
+    /// messages processed
+    size_t poll(int _timeout_msec)
+    {
+        size_t _n = 0;
+#if defined(_UNIX)
+        if(m_listen < 0)
+            return _n;
+
+        std::vector<pollfd> _fds{};
+        _fds.reserve(m_clients.size() + 1);
+        _fds.emplace_back(pollfd{ m_listen, POLLIN, 0 });
+        for(const auto& itr : m_clients)
+            _fds.emplace_back(pollfd{ itr.first, POLLIN, 0 });
+
+        if(::poll(_fds.data(), _fds.size(), _timeout_msec) <= 0)
+            return _n;
+
+        for(size_t i = 1; i < _fds.size(); ++i)
+        {
+            if(_fds.at(i).revents == 0)
+                continue;
+            auto  _fd   = _fds.at(i).fd;
+            auto& _buff = m_clients.at(_fd);
+            char  _data[16384];
+            auto  _len  = ::recv(_fd, _data, sizeof(_data), 0);
+            if(_len <= 0)
+            {
+                impl::close(_fd);
+                m_clients.erase(_fd);
+                continue;
+            }
+            _buff.append(_data, _len);
+            _n += process(_buff);
+        }
+
+        if(_fds.front().revents & POLLIN)
+        {
+            int _fd = ::accept(m_listen, nullptr, nullptr);
+            if(_fd >= 0)
+            {
+                m_clients.emplace(_fd, std::string{});
+                ++m_connections;
+            }
+        }
+#else
+        (void) _timeout_msec;
+#endif
+        return _n;
+    }
+
+    /// aggregate a decoded message
+    void process(const message& _msg)
+    {
+        auto& _src = m_sources[source_key_t{ _msg.pid, _msg.rank }];
+        if(_msg.sequence > _src.sequence)
+            _src.missing += _msg.sequence - _src.sequence;
+        _src.sequence = _msg.sequence + 1;
+        _src.dropped  = std::max(_src.dropped, _msg.dropped);
+        _src.records += _msg.records.size();
+        ++_src.messages;
+        ++m_messages;
+
+        for(const auto& itr : _msg.names)
+        {
+            if(itr.kind == component_name)
+                m_comp_names[static_cast<uint32_t>(itr.id)] = itr.name;
+            else
+                m_region_names[itr.id] = itr.name;
+        }
+
+        for(const auto& itr : _msg.records)
+        {
+            auto _key = key_type{ itr.component, itr.hash };
+            for(auto* _map : { &_src.entries, &m_entries })
+            {
+                auto  _order = _map->size();
+                auto& _entry = (*_map)[_key];
+                if(_entry.laps == 0)
+                    _entry.order = _order;
+                _entry.depth = itr.depth;
+                _entry.laps += itr.laps;
+                _entry.value += itr.value;
+            }
+        }
+    }
+
+    const endpoint&       get_endpoint() const { return m_endpoint; }
+    const entry_map_t&    entries() const { return m_entries; }
+    const source_map_t&   sources() const { return m_sources; }
+    const region_names_t& region_names() const { return m_region_names; }
+    const comp_names_t&   component_names() const { return m_comp_names; }
+    uint64_t              messages() const { return m_messages; }
+    uint64_t              connections() const { return m_connections; }
+    uint64_t              errors() const { return m_errors; }
+    size_t                clients() const { return m_clients.size(); }
+
+    std::string get_name(uint64_t _hash) const
+    {
+        auto itr = m_region_names.find(_hash);
+        if(itr != m_region_names.end())
+            return itr->second;
+        return std::string{ "unknown-hash=" } + std::to_string(_hash);
+    }
+
+    std::string get_component(uint32_t _id) const
+    {
+        auto itr = m_comp_names.find(_id);
+        if(itr != m_comp_names.end())
+            return itr->second;
+        return std::string{ "unknown-component=" } + std::to_string(_id);
+    }
+
+    /// write the aggregate of all the sources
+    void write(std::ostream& _os) const
+    {
+        uint64_t _dropped = 0;
+        uint64_t _missing = 0;
+        for(const auto& itr : m_sources)
+        {
+            _dropped += itr.second.dropped;
+            _missing += itr.second.missing;
+        }
+
+        _os << "[telemetry]> " << m_sources.size() << " source(s), " << m_messages
+            << " message(s), " << _dropped << " dropped by the senders, " << _missing
+            << " missing, " << m_errors << " invalid\n";
+
+        std::vector<const entry_map_t::value_type*> _entries{};
+        _entries.reserve(m_entries.size());
+        for(const auto& itr : m_entries)
+            _entries.emplace_back(&itr);
+        std::sort(_entries.begin(), _entries.end(), [](auto _lhs, auto _rhs) {
+            return std::make_pair(_lhs->first.first, _lhs->second.order) <
+                   std::make_pair(_rhs->first.first, _rhs->second.order);
+        });
+
+        uint32_t _last = 0;
+        bool     _init = false;
+        for(const auto* _itr : _entries)
+        {
+            const auto& itr = *_itr;
+            if(!_init || itr.first.first != _last)
+            {
+                _os << "\n"
+                    << std::setw(12) << get_component(itr.first.first) << " | "
+                    << std::setw(12) << "laps"
+                    << " | " << std::setw(14) << "value"
+                    << " | region\n";
+                _init = true;
+                _last = itr.first.first;
+            }
+            std::string _indent(2 * itr.second.depth, ' ');
+            _os << std::setw(12) << "" << " | " << std::setw(12) << itr.second.laps
+                << " | " << std::setw(14) << std::setprecision(6) << itr.second.value
+                << " | " << _indent << get_name(itr.first.second) << "\n";
+        }
+        _os << std::flush;
+    }
+
+private:
+    /// decode the complete messages at the front of the buffer
+    size_t process(std::string& _buff)
+    {
+        size_t _n   = 0;
+        size_t _off = 0;
+        while(_off < _buff.length())
+        {
+            auto _size = peek_size(_buff.data() + _off, _buff.length() - _off);
+            if(_size < 0)
+            {
+                // not a telemetry stream or corrupted: discard the buffered data
+                ++m_errors;
+                _off = _buff.length();
+                break;
+            }
+            if(_size == 0 || static_cast<size_t>(_size) > _buff.length() - _off)
+                break;
+            message _msg{};
+            if(decode(_buff.data() + _off, _size, _msg))
+            {
+                process(_msg);
+                ++_n;
+            }
+            else
+            {
+                ++m_errors;
+            }
+            _off += _size;
+        }
+        _buff.erase(0, _off);
+        return _n;
+    }
+
+private:
+    int                        m_listen       = -1;
+    uint64_t                   m_messages     = 0;
+    uint64_t                   m_connections  = 0;
+    uint64_t                   m_errors       = 0;
+    endpoint                   m_endpoint     = {};
+    entry_map_t                m_entries      = {};
+    source_map_t               m_sources      = {};
+    region_names_t             m_region_names = {};
+    comp_names_t               m_comp_names   = {};
+    std::map<int, std::string> m_clients      = {};
+};
+//
+}  // namespace telemetry
+}  // namespace tim
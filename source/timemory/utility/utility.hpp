@@ -133,6 +133,24 @@ isfinite(const Tp& arg)
 
 //--------------------------------------------------------------------------------------//
 
+/// only scalar values are converted, everything else (arrays, tuples, etc.) is
+/// the fallback value
+template <typename Tp, enable_if_t<std::is_arithmetic<Tp>::value> = 0>
+inline double
+as_double(const Tp& _val, double = 0.0)
+{
+    return static_cast<double>(_val);
+}
+
+template <typename Tp, enable_if_t<!std::is_arithmetic<Tp>::value> = 0>
+inline double
+as_double(const Tp&, double _fallback = 0.0)
+{
+    return _fallback;
+}
+
+//--------------------------------------------------------------------------------------//
+
 using string_t    = std::string;
 using str_list_t  = std::vector<string_t>;
 using mutex_t     = std::recursive_mutex;
@@ -133,6 +133,12 @@ public:
                          bool report_at_exit = settings::destructor_report(),
                          const Init&         = this_type::get_initializer());
 
+    template <typename StrT, typename Init = initializer_type,
+              enable_if_t<concepts::is_string_key<StrT>::value, int> = 0>
+    explicit auto_bundle(StrT&&, scope::config = scope::get_default(),
+                         bool report_at_exit = settings::destructor_report(),
+                         const Init&         = this_type::get_initializer());
+
     explicit auto_bundle(component_type& tmp, scope::config = scope::get_default(),
                          bool            report_at_exit = settings::destructor_report());
 
@@ -471,6 +477,17 @@ auto_bundle<Tag, Types...>::auto_bundle(size_t hash, scope::config _scope,
 
 //--------------------------------------------------------------------------------------//
 
+template <typename Tag, typename... Types>
+template <typename StrT, typename Init,
+          enable_if_t<concepts::is_string_key<StrT>::value, int>>
+auto_bundle<Tag, Types...>::auto_bundle(StrT&& key, scope::config _scope,
+                                        bool report_at_exit, const Init& init_func)
+: auto_bundle((settings::enabled()) ? add_hash_id(key) : 0, _scope, report_at_exit,
+              init_func)
+{}
+
+//--------------------------------------------------------------------------------------//
+
 template <typename Tag, typename... Types>
 auto_bundle<Tag, Types...>::auto_bundle(component_type& tmp, scope::config _scope,
                                         bool report_at_exit)
@@ -31,6 +31,8 @@
 #include "timemory/mpl/types.hpp"
 #include "timemory/operations/types.hpp"
 #include "timemory/settings/declaration.hpp"
+#include "timemory/variadic/subsample.hpp"
+#include "timemory/variadic/throttle.hpp"
 #include "timemory/variadic/types.hpp"
 
 #include <cstdint>
@@ -262,11 +264,14 @@ protected:
 
 protected:
     // objects
-    bool          m_store     = false;
-    bool          m_is_pushed = false;
-    scope::config m_scope     = scope::get_default();
-    int64_t       m_laps      = 0;
-    uint64_t      m_hash      = 0;
+    bool          m_store      = false;
+    bool          m_is_pushed  = false;
+    bool          m_is_skipped = false;
+    bool          m_is_sampled = false;
+    double        m_weight     = 1.0;
+    scope::config m_scope      = scope::get_default();
+    int64_t       m_laps       = 0;
+    uint64_t      m_hash       = 0;
 
 protected:
     struct persistent_data
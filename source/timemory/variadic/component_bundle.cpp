@@ -208,6 +208,18 @@ component_bundle<Tag, Types...>::component_bundle(size_t hash, const bool& store
     }
 }
 
+//--------------------------------------------------------------------------------------//
+//
+template <typename Tag, typename... Types>
+template <typename StrT, typename Func,
+          enable_if_t<concepts::is_string_key<StrT>::value, int>>
+component_bundle<Tag, Types...>::component_bundle(StrT&& key, const bool& store,
+                                                  scope::config _scope,
+                                                  const Func&   init_func)
+: component_bundle((settings::enabled()) ? add_hash_id(key) : 0, store, _scope,
+                   init_func)
+{}
+
 //--------------------------------------------------------------------------------------//
 //
 template <typename Tag, typename... Types>
@@ -282,7 +294,9 @@ component_bundle<Tag, Types...>::pop()
 {
     if(m_is_pushed)
     {
-        // set the current node to the parent node
+        // set the current node to the parent node. A sampled measurement records
+        // the number of calls it represents in the node
+        subsample::scope _sample{ m_weight };
         invoke::pop<Tag>(m_data);
         // avoid pushing/popping when already pushed/popped
         m_is_pushed = false;
@@ -394,12 +408,24 @@ component_bundle<Tag, Types...>::start(Args&&... args)
     if(!trait::runtime_enabled<Tag>::get())
         return;
 
-    // push components into the call-stack
-    if(m_store)
-        push();
+    // skip the measurement when the region is throttled or not sampled
+    auto* _throttle = (m_store) ? throttle::start(m_hash) : nullptr;
+    m_is_sampled    = m_store;
+    m_weight        = (m_is_sampled) ? subsample::start(m_hash) : 1.0;
+    m_is_skipped    = (m_weight == 0.0 || (_throttle && !_throttle->measure()));
 
-    // start components
-    start(mpl::lightweight{}, std::forward<Args>(args)...);
+    if(!m_is_skipped)
+    {
+        // push components into the call-stack
+        if(m_store)
+            push();
+
+        // start components
+        start(mpl::lightweight{}, std::forward<Args>(args)...);
+    }
+
+    if(_throttle)
+        _throttle->started(!m_is_skipped);
 }
 
 //--------------------------------------------------------------------------------------//
@@ -412,12 +438,28 @@ component_bundle<Tag, Types...>::stop(Args&&... args)
     if(!trait::runtime_enabled<Tag>::get())
         return;
 
-    // stop components
-    stop(mpl::lightweight{}, std::forward<Args>(args)...);
+    auto* _throttle = (m_store) ? throttle::stop(m_hash) : nullptr;
 
-    // pop components off of the call-stack stack
-    if(m_store)
-        pop();
+    if(!m_is_skipped)
+    {
+        // the weight also applies to the components popped by nested bundles
+        subsample::scope _sample{ m_weight };
+
+        // stop components
+        stop(mpl::lightweight{}, std::forward<Args>(args)...);
+
+        // pop components off of the call-stack stack
+        if(m_store)
+            pop();
+    }
+
+    if(_throttle)
+        _throttle->stopped(m_hash, !m_is_skipped);
+    if(m_is_sampled)
+        subsample::stop(m_weight);
+    m_is_sampled = false;
+    m_is_skipped = false;
+    m_weight     = 1.0;
 }
 
 //--------------------------------------------------------------------------------------//
@@ -143,6 +143,14 @@ public:
                               scope::config _scope = scope::get_default(),
                               const Func&          = get_initializer());
 
+    /// string literals and string views: the label is hashed in-place and only copied
+    /// into a std::string the first time it is seen on a thread
+    template <typename StrT, typename Func = initializer_type,
+              enable_if_t<concepts::is_string_key<StrT>::value, int> = 0>
+    explicit component_bundle(StrT&& key, const bool& store = true,
+                              scope::config _scope = scope::get_default(),
+                              const Func&          = get_initializer());
+
     ~component_bundle();
 
     //------------------------------------------------------------------------//
@@ -720,9 +728,12 @@ protected:
     // objects
     using bundle_type::m_hash;
     using bundle_type::m_is_pushed;
+    using bundle_type::m_is_sampled;
+    using bundle_type::m_is_skipped;
     using bundle_type::m_laps;
     using bundle_type::m_scope;
     using bundle_type::m_store;
+    using bundle_type::m_weight;
     mutable data_type m_data = data_type{};
 };
 //
@@ -198,7 +198,9 @@ component_list<Types...>::pop()
 {
     if(m_is_pushed)
     {
-        // set the current node to the parent node
+        // set the current node to the parent node. A sampled measurement records
+        // the number of calls it represents in the node
+        subsample::scope _sample{ m_weight };
         invoke::pop(m_data);
         // avoid pushing/popping when already pushed/popped
         m_is_pushed = false;
@@ -237,11 +239,23 @@ template <typename... Args>
 void
 component_list<Types...>::start(Args&&... args)
 {
-    // push components into the call-stack
-    if(m_store)
-        push();
-    assemble(*this);
-    invoke::start(m_data, std::forward<Args>(args)...);
+    // skip the measurement when the region is throttled or not sampled
+    auto* _throttle = (m_store) ? throttle::start(m_hash) : nullptr;
+    m_is_sampled    = m_store;
+    m_weight        = (m_is_sampled) ? subsample::start(m_hash) : 1.0;
+    m_is_skipped    = (m_weight == 0.0 || (_throttle && !_throttle->measure()));
+
+    if(!m_is_skipped)
+    {
+        // push components into the call-stack
+        if(m_store)
+            push();
+        assemble(*this);
+        invoke::start(m_data, std::forward<Args>(args)...);
+    }
+
+    if(_throttle)
+        _throttle->started(!m_is_skipped);
 }
 
 //--------------------------------------------------------------------------------------//
@@ -251,11 +265,26 @@ template <typename... Args>
 void
 component_list<Types...>::stop(Args&&... args)
 {
-    invoke::stop(m_data, std::forward<Args>(args)...);
-    ++m_laps;
-    derive(*this);
-    if(m_store)
-        pop();
+    auto* _throttle = (m_store) ? throttle::stop(m_hash) : nullptr;
+
+    if(!m_is_skipped)
+    {
+        // the weight also applies to the components popped by nested bundles
+        subsample::scope _sample{ m_weight };
+        invoke::stop(m_data, std::forward<Args>(args)...);
+        ++m_laps;
+        derive(*this);
+        if(m_store)
+            pop();
+    }
+
+    if(_throttle)
+        _throttle->stopped(m_hash, !m_is_skipped);
+    if(m_is_sampled)
+        subsample::stop(m_weight);
+    m_is_sampled = false;
+    m_is_skipped = false;
+    m_weight     = 1.0;
 }
 
 //--------------------------------------------------------------------------------------//
@@ -607,9 +607,12 @@ protected:
     // objects
     using bundle_type::m_hash;
     using bundle_type::m_is_pushed;
+    using bundle_type::m_is_sampled;
+    using bundle_type::m_is_skipped;
     using bundle_type::m_laps;
     using bundle_type::m_scope;
     using bundle_type::m_store;
+    using bundle_type::m_weight;
     mutable data_type m_data = data_type();
 };
 
@@ -144,8 +144,11 @@ lightweight_tuple<Types...>::pop()
 {
     if(m_is_pushed)
     {
-        // set the current node to the parent node
+        // set the current node to the parent node. A sampled measurement records
+        // the number of calls it represents in the node
+        subsample::scope _sample{ m_weight };
         invoke::pop(m_data);
+        m_weight = 1.0;
         // avoid pushing/popping when already pushed/popped
         m_is_pushed = false;
     }
@@ -183,7 +186,11 @@ template <typename... Args>
 void
 lightweight_tuple<Types...>::start(Args&&... args)
 {
-    invoke::start(m_data, std::forward<Args>(args)...);
+    // only the measurements which are stored can be sampled
+    m_is_sampled = m_is_pushed;
+    m_weight     = (m_is_sampled) ? subsample::start(m_hash) : 1.0;
+    if(m_weight > 0.0)
+        invoke::start(m_data, std::forward<Args>(args)...);
 }
 
 //--------------------------------------------------------------------------------------//
@@ -193,8 +200,17 @@ template <typename... Args>
 void
 lightweight_tuple<Types...>::stop(Args&&... args)
 {
-    invoke::stop(m_data, std::forward<Args>(args)...);
-    ++m_laps;
+    if(m_weight > 0.0)
+    {
+        subsample::scope _sample{ m_weight };
+        invoke::stop(m_data, std::forward<Args>(args)...);
+        ++m_laps;
+    }
+
+    // the weight is kept until the components are popped
+    if(m_is_sampled)
+        subsample::stop(m_weight);
+    m_is_sampled = false;
 }
 
 //--------------------------------------------------------------------------------------//
@@ -142,6 +142,13 @@ using string = tim::apply<std::string>;
         TIMEMORY_AUTO_TYPE(TYPE)                                                         \
         _TIM_VARIABLE(__LINE__)(TIMEMORY_CAPTURE_ARGS(__VA_ARGS__))
 
+//--------------------------------------------------------------------------------------//
+//  LABEL must be a string literal or __FUNCTION__: the hash is computed at compile-time
+//
+#    define TIMEMORY_LITERAL_MARKER(TYPE, LABEL)                                         \
+        TIMEMORY_AUTO_TYPE(TYPE)                                                         \
+        _TIM_VARIABLE(__LINE__)(TIMEMORY_LITERAL_HASH_ID(LABEL))
+
 //======================================================================================//
 //
 //                      CONDITIONAL MARKER MACROS
@@ -0,0 +1,387 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/**
+ * \file timemory/variadic/subsample.hpp
+ * \brief Deterministic or randomized 1-in-N measurement of the regions recorded by the
+ * bundles
+ */
+
+#pragma once
+
+#include "timemory/hash/types.hpp"
+#include "timemory/settings/declaration.hpp"
+#include "timemory/tpls/cereal/cereal.hpp"
+#include "timemory/utility/types.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace tim
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::subsample
+/// \brief Per-thread, per-hash sub-sampling applied by the bundles when they store into
+/// the call-graph. When settings::sample_interval() is N > 1, the first call to a
+/// region is measured and then one in every N calls (every N-th call, or with a
+/// probability of 1/N when settings::sample_random() is enabled). The other calls only
+/// increment a counter. The decision is made once per call-stack: the regions nested
+/// in a call which was not measured are not measured either, so a measured region is
+/// always inserted below its measured parent.
+///
+/// Every measured call carries the weight of N times the weight of its measured
+/// parent. The call-graph nodes accumulate the raw measurements along with the number
+/// of sampled measurements and their weights, and the values are scaled once when the
+/// results are collected (\ref tim::operation::finalize::get): each node is scaled to
+/// its share of the real number of calls to the region. The statistics keep the
+/// measured samples and report the number of calls they represent, the sampling ratio,
+/// and the standard error of the estimates. Changes to the settings take effect after
+/// \ref tim::subsample::configure(), which is invoked by timemory_init and
+/// timemory_argparse.
+///
+struct subsample
+{
+    /// summary of a sampled region for the metadata
+    struct record
+    {
+        std::string key      = {};
+        uint64_t    hash     = 0;
+        uint64_t    calls    = 0;
+        uint64_t    measured = 0;
+        double      weight   = 0.0;
+
+        template <typename Archive>
+        void serialize(Archive& ar, const unsigned int)
+        {
+            double _ratio = (calls > 0) ? (measured / static_cast<double>(calls)) : 0.0;
+            ar(cereal::make_nvp("key", key), cereal::make_nvp("hash", hash),
+               cereal::make_nvp("calls", calls), cereal::make_nvp("measured", measured),
+               cereal::make_nvp("ratio", _ratio));
+        }
+    };
+
+    using record_map_t     = std::map<uint64_t, record>;
+    using correction_map_t = std::unordered_map<uint64_t, double>;
+
+    /// sets the weight of the measurements which are popped off of the call-graph by
+    /// a bundle on this thread while it is in scope
+    struct scope
+    {
+        explicit scope(double _weight)
+        : m_prev{ get_state().weight }
+        {
+            if(get_state().interval > 1)
+                get_state().weight = (_weight > 0.0) ? _weight : -1.0;
+        }
+
+        ~scope() { get_state().weight = m_prev; }
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+    private:
+        double m_prev = 0.0;
+    };
+
+    /// re-reads the settings on every thread
+    static void configure() { ++get_generation(); }
+
+    static bool enabled() { return get_config().interval > 1; }
+
+    /// returns the weight of this call: zero when it is not measured and one when
+    /// sampling is disabled. Every call must be followed by \ref stop with the
+    /// returned weight
+    static double start(uint64_t _hash)
+    {
+        auto& _state = get_config();
+        if(_state.interval < 2)
+            return 1.0;
+
+        auto& _entry = get_entries().data[_hash];
+        if(_entry.calls++ == 0)
+            _entry.key = get_hash_identifier(_hash);
+
+        // a parent was not measured or the countdown has not expired
+        if(_state.skipped > 0 || _entry.countdown > 1)
+        {
+            if(_state.skipped == 0)
+                --_entry.countdown;
+            ++_state.skipped;
+            return 0.0;
+        }
+
+        auto _parent = (_state.frames.empty()) ? 1.0 : _state.frames.back();
+        auto _weight = _parent * _state.interval;
+        _entry.countdown = next_gap(_state);
+        _entry.weight += _weight;
+        ++_entry.measured;
+        _state.frames.emplace_back(_weight);
+        return _weight;
+    }
+
+    static void stop(double _weight)
+    {
+        auto& _state = get_config();
+        if(_state.interval < 2)
+            return;
+
+        if(_weight > 0.0)
+        {
+            if(!_state.frames.empty())
+                _state.frames.pop_back();
+        }
+        else if(_state.skipped > 0)
+        {
+            --_state.skipped;
+        }
+    }
+
+    /// the weight of the measurements which are popped off of the call-graph: zero
+    /// when they are not sampled and negative when they were not measured
+    static double get_weight() { return get_state().weight; }
+
+    /// the regions which have been sampled on any thread
+    static std::vector<record> get_records()
+    {
+        auto _data = record_map_t{};
+        {
+            std::unique_lock<mutex> _lk{ get_records_mutex() };
+            _data = get_record_map();
+        }
+        get_entries().flush(_data);
+
+        std::vector<record> _ret{};
+        for(auto& itr : _data)
+            _ret.emplace_back(std::move(itr.second));
+        return _ret;
+    }
+
+    /// updates the corrections applied by \ref get_correction from the records
+    static void update_corrections()
+    {
+        correction_map_t _data{};
+        for(const auto& itr : get_records())
+        {
+            if(itr.weight > 0.0)
+                _data.emplace(itr.hash, itr.calls / itr.weight);
+        }
+        std::unique_lock<mutex> _lk{ get_records_mutex() };
+        get_correction_map() = std::move(_data);
+    }
+
+    /// the ratio of the calls to a region and the total weight of its measurements.
+    /// The weights are an unbiased estimate of the calls and this corrects for the
+    /// calls after the last measurement and for the random gaps
+    static double get_correction(uint64_t _hash)
+    {
+        std::unique_lock<mutex> _lk{ get_records_mutex() };
+        auto&                   _data = get_correction_map();
+        auto                    itr   = _data.find(_hash);
+        return (itr == _data.end()) ? 1.0 : itr->second;
+    }
+
+    /// the number of calls represented by the node of a call-graph which had
+    /// \param _laps measurements, \param _sampled of them with a total
+    /// \param _weight
+    static double get_calls(uint64_t _hash, int64_t _laps, uint64_t _sampled,
+                            double _weight)
+    {
+        if(_sampled == 0)
+            return _laps;
+        auto _unsampled = std::max<int64_t>(_laps - _sampled, 0);
+        return _unsampled + _weight * get_correction(_hash);
+    }
+
+    /// scales the value and accumulation of a component, e.g. from the measured calls
+    /// to the calls they represent. Values which are not arithmetic (or containers of
+    /// arithmetic values) are not modified
+    template <typename Tp>
+    static void scale(Tp& _obj, double _factor)
+    {
+        auto _value = _obj.get_value();
+        auto _accum = _obj.get_accum();
+        scale_value(_value, _factor, 0);
+        scale_value(_accum, _factor, 0);
+        _obj.set_value(_value);
+        _obj.set_accum(_accum);
+        _obj.set_laps(std::llround(_obj.get_laps() * _factor));
+    }
+
+    template <typename Archive>
+    static void serialize_metadata(Archive& ar)
+    {
+        auto _data = get_records();
+        if(!_data.empty())
+            ar(cereal::make_nvp("sampled", _data));
+    }
+
+private:
+    using mutex = std::mutex;
+
+    struct state
+    {
+        uint64_t            generation = 0;
+        uint32_t            interval   = 1;
+        bool                random     = false;
+        int64_t             skipped    = 0;
+        double              weight     = 0.0;
+        std::vector<double> frames     = {};
+    };
+
+    struct entry
+    {
+        uint32_t    countdown = 0;
+        uint64_t    calls     = 0;
+        uint64_t    measured  = 0;
+        double      weight    = 0.0;
+        std::string key       = {};
+    };
+
+    /// the entries of a thread are added to the records when the thread exits
+    struct entry_map
+    {
+        ~entry_map()
+        {
+            std::unique_lock<mutex> _lk{ get_records_mutex() };
+            flush(get_record_map());
+        }
+
+        void flush(record_map_t& _records) const
+        {
+            for(const auto& itr : data)
+            {
+                auto& _rec = _records[itr.first];
+                _rec.key   = itr.second.key;
+                _rec.hash  = itr.first;
+                _rec.calls += itr.second.calls;
+                _rec.measured += itr.second.measured;
+                _rec.weight += itr.second.weight;
+            }
+        }
+
+        std::unordered_map<uint64_t, entry> data = {};
+    };
+
+    template <typename Tp>
+    static auto scale_value(Tp& _val, double _factor, int)
+        -> decltype(std::begin(_val), void())
+    {
+        for(auto& itr : _val)
+            scale_value(itr, _factor, 0);
+    }
+
+    template <typename Tp, enable_if_t<std::is_arithmetic<Tp>::value, int> = 0>
+    static void scale_value(Tp& _val, double _factor, long)
+    {
+        _val = static_cast<Tp>(_val * _factor);
+    }
+
+    template <typename Tp>
+    static void scale_value(Tp&, double, ...)
+    {}
+
+    static uint32_t next_gap(const state& _state)
+    {
+        if(!_state.random)
+            return _state.interval;
+        // the number of calls until the next success when each call succeeds with a
+        // probability of 1/N
+        static thread_local std::mt19937_64 _engine{ std::random_device{}() };
+        std::geometric_distribution<uint32_t> _dist{ 1.0 / _state.interval };
+        auto _max = std::numeric_limits<uint32_t>::max() - 1;
+        return std::min<uint32_t>(_dist(_engine), _max) + 1;
+    }
+
+    static std::atomic<uint64_t>& get_generation()
+    {
+        static std::atomic<uint64_t> _instance{ 1 };
+        return _instance;
+    }
+
+    static state& get_state()
+    {
+        static thread_local state _instance{};
+        return _instance;
+    }
+
+    /// the call-stack of the thread is reset when the settings change
+    static state& get_config()
+    {
+        auto& _instance = get_state();
+        auto  _gen      = get_generation().load(std::memory_order_relaxed);
+        if(_instance.generation != _gen)
+        {
+            auto _interval = std::min<size_t>(settings::sample_interval(),
+                                              std::numeric_limits<uint32_t>::max());
+            _instance.generation = _gen;
+            _instance.interval   = std::max<uint32_t>(_interval, 1);
+            _instance.random     = settings::sample_random();
+            _instance.skipped    = 0;
+            _instance.frames.clear();
+        }
+        return _instance;
+    }
+
+    static entry_map& get_entries()
+    {
+        static thread_local entry_map _instance{};
+        return _instance;
+    }
+
+    static mutex& get_records_mutex()
+    {
+        static auto* _instance = new mutex{};
+        return *_instance;
+    }
+
+    static record_map_t& get_record_map()
+    {
+        static auto* _instance = new record_map_t{};
+        return *_instance;
+    }
+
+    static correction_map_t& get_correction_map()
+    {
+        static auto* _instance = new correction_map_t{};
+        return *_instance;
+    }
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace tim
@@ -0,0 +1,304 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+/**
+ * \file timemory/variadic/throttle.hpp
+ * \brief Overhead-based throttling of the regions recorded by the bundles
+ */
+
+#pragma once
+
+#include "timemory/backends/threading.hpp"
+#include "timemory/hash/types.hpp"
+#include "timemory/settings/declaration.hpp"
+#include "timemory/tpls/cereal/cereal.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tim
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct tim::throttle
+/// \brief Per-thread, per-hash throttling applied by the bundles when they store into
+/// the call-graph. Each region is timed with a cheap clock along with the cost of the
+/// instrumentation around it. Every settings::throttle_count() calls, a region whose
+/// mean duration is less than settings::throttle_ratio() times the mean cost of the
+/// instrumentation is throttled: only every settings::throttle_stride() call is
+/// measured (none when the stride is zero). Throttled regions are still timed so they
+/// are released once their mean duration grows. A ratio of zero disables throttling.
+/// Changes to the settings take effect after \ref tim::throttle::configure(), which is
+/// invoked by timemory_init and timemory_argparse.
+///
+struct throttle
+{
+    using clock_type = std::chrono::steady_clock;
+
+    /// summary of a throttled region for the metadata
+    struct record
+    {
+        std::string key       = {};
+        uint64_t    hash      = 0;
+        uint64_t    throttled = 0;
+        uint64_t    released  = 0;
+        int64_t     mean      = 0;
+        int64_t     overhead  = 0;
+
+        template <typename Archive>
+        void serialize(Archive& ar, const unsigned int)
+        {
+            ar(cereal::make_nvp("key", key), cereal::make_nvp("hash", hash),
+               cereal::make_nvp("throttled", throttled),
+               cereal::make_nvp("released", released),
+               cereal::make_nvp("mean_ns", mean),
+               cereal::make_nvp("overhead_ns", overhead));
+        }
+    };
+
+    struct entry
+    {
+        /// increments the call count and returns whether this call is measured
+        bool measure()
+        {
+            auto _n      = calls++;
+            auto _stride = get_config().stride;
+            return !throttled || (_stride > 0 && _n % _stride == 0);
+        }
+
+        /// invoked after the bundle was (or was not) pushed and started
+        void started(bool _measured)
+        {
+            if(depth == 1)
+            {
+                begin = (_measured) ? now() : enter;
+                if(_measured)
+                    cost += begin - enter;
+            }
+        }
+
+        /// invoked after the bundle was (or was not) stopped and popped
+        void stopped(uint64_t _hash, bool _measured)
+        {
+            if(--depth > 0)
+                return;
+            accum += end - begin;
+            if(_measured)
+            {
+                cost += now() - end;
+                ++measured;
+            }
+            if(++count >= get_config().count)
+                update(_hash);
+        }
+
+        bool     throttled = false;
+        uint32_t depth     = 0;
+        uint64_t calls     = 0;
+        uint64_t count     = 0;
+        uint64_t measured  = 0;
+        int64_t  enter     = 0;
+        int64_t  begin     = 0;
+        int64_t  end       = 0;
+        int64_t  accum     = 0;
+        int64_t  cost      = 0;
+        int64_t  overhead  = 0;
+
+    private:
+        void update(uint64_t _hash)
+        {
+            const auto& _cfg = get_config();
+            if(measured > 0)
+                overhead = cost / measured;
+            auto _mean = accum / count;
+            auto _prev = throttled;
+            throttled  = (_mean < _cfg.ratio * overhead);
+            if(throttled != _prev)
+                report(_hash, throttled, _mean, overhead);
+            count    = 0;
+            measured = 0;
+            accum    = 0;
+            cost     = 0;
+        }
+    };
+
+    using entry_map_t  = std::unordered_map<uint64_t, entry>;
+    using record_map_t = std::map<uint64_t, record>;
+
+    static int64_t now() { return clock_type::now().time_since_epoch().count(); }
+
+    /// re-reads the settings on every thread
+    static void configure() { ++get_generation(); }
+
+    static bool enabled() { return get_config().ratio > 0.0; }
+
+    /// returns nullptr when throttling is disabled
+    static entry* start(uint64_t _hash)
+    {
+        if(!enabled())
+            return nullptr;
+        auto& _entry = get_entries()[_hash];
+        if(_entry.depth++ == 0)
+            _entry.enter = now();
+        return &_entry;
+    }
+
+    /// returns nullptr when the region was not started with throttling enabled
+    static entry* stop(uint64_t _hash)
+    {
+        auto& _entries = get_entries();
+        if(_entries.empty())
+            return nullptr;
+        auto itr = _entries.find(_hash);
+        if(itr == _entries.end() || itr->second.depth == 0)
+            return nullptr;
+        if(itr->second.depth == 1)
+            itr->second.end = now();
+        return &itr->second;
+    }
+
+    /// whether the region is throttled on the calling thread
+    static bool is_throttled(uint64_t _hash)
+    {
+        auto& _entries = get_entries();
+        auto  itr      = _entries.find(_hash);
+        return (itr != _entries.end() && itr->second.throttled);
+    }
+
+    /// releases the region on the calling thread and restarts its evaluation
+    static void reset(uint64_t _hash)
+    {
+        auto& _entries = get_entries();
+        auto  itr      = _entries.find(_hash);
+        if(itr != _entries.end() && itr->second.depth == 0)
+            _entries.erase(itr);
+    }
+
+    /// the regions which have been throttled on any thread
+    static std::vector<record> get_records()
+    {
+        std::vector<record>     _data{};
+        std::unique_lock<mutex> _lk{ get_records_mutex() };
+        for(const auto& itr : get_record_map())
+            _data.emplace_back(itr.second);
+        return _data;
+    }
+
+    template <typename Archive>
+    static void serialize_metadata(Archive& ar)
+    {
+        auto _data = get_records();
+        if(!_data.empty())
+            ar(cereal::make_nvp("throttled", _data));
+    }
+
+private:
+    using mutex = std::mutex;
+
+    struct config
+    {
+        uint64_t generation = 0;
+        uint64_t count      = 0;
+        uint64_t stride     = 0;
+        double   ratio      = 0.0;
+    };
+
+    static std::atomic<uint64_t>& get_generation()
+    {
+        static std::atomic<uint64_t> _instance{ 1 };
+        return _instance;
+    }
+
+    static const config& get_config()
+    {
+        static thread_local config _instance{};
+        auto _gen = get_generation().load(std::memory_order_relaxed);
+        if(_instance.generation != _gen)
+        {
+            _instance.generation = _gen;
+            _instance.count      = std::max<uint64_t>(settings::throttle_count(), 1);
+            _instance.stride     = settings::throttle_stride();
+            _instance.ratio      = settings::throttle_ratio();
+        }
+        return _instance;
+    }
+
+    static entry_map_t& get_entries()
+    {
+        static thread_local entry_map_t _instance{};
+        return _instance;
+    }
+
+    static mutex& get_records_mutex()
+    {
+        static auto* _instance = new mutex{};
+        return *_instance;
+    }
+
+    static record_map_t& get_record_map()
+    {
+        static auto* _instance = new record_map_t{};
+        return *_instance;
+    }
+
+    static void report(uint64_t _hash, bool _throttled, int64_t _mean, int64_t _overhead)
+    {
+        auto _key = get_hash_identifier(_hash);
+        {
+            std::unique_lock<mutex> _lk{ get_records_mutex() };
+            auto&                   _rec = get_record_map()[_hash];
+            _rec.key                     = _key;
+            _rec.hash                    = _hash;
+            _rec.mean                    = _mean;
+            _rec.overhead                = _overhead;
+            if(_throttled)
+                ++_rec.throttled;
+            else
+                ++_rec.released;
+        }
+
+        if(settings::debug() || settings::verbose() > 0)
+        {
+            fprintf(stderr,
+                    "[timemory]> %s '%s' on thread %i. mean = %lli ns, instrumentation "
+                    "overhead = %lli ns...\n",
+                    (_throttled) ? "Throttling" : "Releasing", _key.c_str(),
+                    (int) threading::get_id(), (long long) _mean, (long long) _overhead);
+        }
+    }
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+}  // namespace tim
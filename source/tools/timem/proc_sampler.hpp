@@ -0,0 +1,644 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+/** \file timem/proc_sampler.hpp
+ * \brief A high-frequency sampler for timem which runs on a dedicated thread and
+ * reads the /proc filesystem of the target process tree through persistent file
+ * descriptors, i.e. no signals are delivered to timem or the target and no files are
+ * re-opened on each sample
+ */
+
+// C includes
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "timemory/units.hpp"
+
+// C++ includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace timem
+{
+//
+//--------------------------------------------------------------------------------------//
+//
+/// escapes the quotes, backslashes, and control characters of a string (e.g. the
+/// name of a thread, which is set by the application) for the JSON output
+inline std::string
+json_escape(const std::string& _str)
+{
+    std::stringstream _ss{};
+    for(const auto& itr : _str)
+    {
+        auto _c = static_cast<unsigned char>(itr);
+        if(itr == '"' || itr == '\\')
+            _ss << '\\' << itr;
+        else if(_c < 0x20)
+            _ss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                << static_cast<int>(_c) << std::dec;
+        else
+            _ss << itr;
+    }
+    return _ss.str();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// inserts "-<pid>" before the ".json" extension of the output file of the time-series
+/// so that each process writes a separate file
+inline std::string
+get_timeseries_filename(std::string _fname, pid_t _pid)
+{
+    const std::string _ext = ".json";
+    if(_fname.length() > _ext.length() &&
+       _fname.compare(_fname.length() - _ext.length(), _ext.length(), _ext) == 0)
+        _fname = _fname.substr(0, _fname.length() - _ext.length());
+    return _fname + "-" + std::to_string(_pid) + _ext;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct timem::proc_fd
+/// \brief A file in /proc which is opened once and re-read via pread
+///
+struct proc_fd
+{
+    proc_fd() = default;
+    explicit proc_fd(const std::string& _fname)
+    : fd(open(_fname.c_str(), O_RDONLY | O_CLOEXEC))
+    {}
+
+    ~proc_fd() { close(); }
+
+    proc_fd(const proc_fd&) = delete;
+    proc_fd& operator=(const proc_fd&) = delete;
+
+    proc_fd(proc_fd&& rhs) noexcept
+    : fd(rhs.fd)
+    {
+        rhs.fd = -1;
+    }
+
+    proc_fd& operator=(proc_fd&& rhs) noexcept
+    {
+        if(this != &rhs)
+        {
+            close();
+            fd     = rhs.fd;
+            rhs.fd = -1;
+        }
+        return *this;
+    }
+
+    bool is_open() const { return fd >= 0; }
+
+    void close()
+    {
+        if(fd >= 0)
+            ::close(fd);
+        fd = -1;
+    }
+
+    /// returns the number of bytes read or -1 on error (e.g. the process exited)
+    ssize_t read(char* _buf, size_t _len) const
+    {
+        if(fd < 0)
+            return -1;
+        auto _n = pread(fd, _buf, _len - 1, 0);
+        _buf[(_n > 0) ? _n : 0] = '\0';
+        return _n;
+    }
+
+    int fd = -1;
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct timem::proc_sample
+/// \brief A single sample of the entire process tree
+///
+struct proc_sample
+{
+    int64_t  time        = 0;  ///< nanoseconds since the sampler started
+    int64_t  rss         = 0;  ///< resident set size of the tree (bytes)
+    int64_t  cpu_ticks   = 0;  ///< user + system clock ticks of the tree
+    int64_t  read_bytes  = 0;  ///< bytes read from storage by the tree
+    int64_t  write_bytes = 0;  ///< bytes written to storage by the tree
+    uint32_t nprocs      = 0;  ///< number of live processes in the tree
+    uint32_t nthreads    = 0;  ///< number of live threads in the tree
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+/// \struct timem::proc_sampler
+/// \brief Samples /proc/<pid>/{stat,statm,io} and /proc/<pid>/task/<tid>/stat for the
+/// target and all of its descendants from a dedicated thread at a fixed frequency.
+/// When the number of samples reaches the maximum, every other sample is dropped and
+/// the frequency is halved so the memory is bounded and the time-series still spans
+/// the entire run
+///
+struct proc_sampler
+{
+    using clock_type = std::chrono::steady_clock;
+
+    struct thread_data
+    {
+        pid_t              pid      = 0;
+        pid_t              tid      = 0;
+        size_t             first    = 0;   ///< index of the first sample
+        int64_t            prev     = -1;  ///< previous user + system clock ticks
+        std::string        name     = {};
+        proc_fd            stat     = {};
+        std::vector<float> cpu_util = {};  ///< percent of one core
+    };
+
+    struct process_data
+    {
+        pid_t   pid         = 0;
+        int64_t rss         = 0;
+        int64_t read_bytes  = 0;
+        int64_t write_bytes = 0;
+        proc_fd statm       = {};
+        proc_fd io          = {};
+    };
+
+    explicit proc_sampler(pid_t _pid, double _freq, size_t _max_samples = 100000)
+    : m_root(_pid)
+    , m_freq(std::max<double>(_freq, 1.0))
+    , m_max_samples(std::max<size_t>(_max_samples, 16))
+    , m_page_size(sysconf(_SC_PAGESIZE))
+    , m_clock_ticks(sysconf(_SC_CLK_TCK))
+    {}
+
+    ~proc_sampler() { stop(); }
+
+    proc_sampler(const proc_sampler&) = delete;
+    proc_sampler& operator=(const proc_sampler&) = delete;
+
+    void start();
+    void stop();
+
+    const std::vector<proc_sample>& get_samples() const { return m_samples; }
+    int64_t                         get_peak_rss() const { return m_peak_rss; }
+    size_t                          get_num_taken() const { return m_num_taken; }
+    int64_t                         get_cpu_time() const { return m_cpu_time; }
+    double                          get_frequency() const { return m_freq / m_stride; }
+    double                          get_overhead() const;
+    double                          get_sample_cost() const;
+    void                            write(std::ostream& _os) const;
+    void                            write_summary(std::ostream& _os) const;
+
+private:
+    void execute();
+    void sample();
+    void decimate();
+    void update_tree();
+    void add_process(pid_t _pid);
+    void add_thread(pid_t _pid, pid_t _tid);
+
+    static int64_t get_thread_time()
+    {
+        struct timespec _ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &_ts);
+        return (_ts.tv_sec * 1000000000L) + _ts.tv_nsec;
+    }
+
+private:
+    pid_t                         m_root         = 0;
+    double                        m_freq         = 100.0;
+    size_t                        m_max_samples  = 100000;
+    size_t                        m_num_taken    = 0;  ///< including the decimated ones
+    int64_t                       m_stride       = 1;  ///< requested periods per sample
+    int64_t                       m_page_size    = 4096;
+    int64_t                       m_clock_ticks  = 100;
+    int64_t                       m_peak_rss     = 0;
+    int64_t                       m_exited_read  = 0;
+    int64_t                       m_exited_write = 0;
+    int64_t                       m_cpu_time     = 0;  ///< cpu time of the sampler (ns)
+    int64_t                       m_wall_time    = 0;  ///< lifetime of the sampler (ns)
+    std::atomic<bool>             m_running{ false };
+    std::thread                   m_thread{};
+    clock_type::time_point        m_start{};
+    std::vector<proc_sample>      m_samples{};
+    std::map<pid_t, process_data> m_procs{};
+    std::map<pid_t, thread_data>  m_threads{};
+    char                          m_buffer[4096];
+};
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+proc_sampler::start()
+{
+    if(m_running.exchange(true))
+        return;
+    // reserve one minute of samples up front
+    m_samples.reserve(std::min<size_t>(60 * m_freq, m_max_samples));
+    m_start  = clock_type::now();
+    m_thread = std::thread{ &proc_sampler::execute, this };
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+proc_sampler::stop()
+{
+    if(!m_running.exchange(false))
+        return;
+    if(m_thread.joinable())
+        m_thread.join();
+    m_wall_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      clock_type::now() - m_start)
+                      .count();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+proc_sampler::execute()
+{
+    // the signal-based sampler in timem delivers SIGALRM to the process so make sure
+    // it is always handled by the main thread
+    sigset_t _mask;
+    sigfillset(&_mask);
+    pthread_sigmask(SIG_BLOCK, &_mask, nullptr);
+
+    auto _period = [this]() {
+        return std::chrono::nanoseconds(static_cast<int64_t>(1.0e9 / get_frequency()));
+    };
+    // re-scanning the process tree is much more expensive than a sample so it is
+    // done at ~10 Hz
+    auto _nrefresh = std::max<int64_t>(m_freq / 10.0, 1);
+    auto _next     = clock_type::now();
+    auto _cpu_beg  = get_thread_time();
+
+    for(int64_t i = 0; m_running.load(std::memory_order_relaxed); ++i)
+    {
+        if(i % _nrefresh == 0)
+            update_tree();
+        sample();
+        if(m_procs.empty())
+            break;
+        _next += _period();
+        std::this_thread::sleep_until(_next);
+    }
+
+    m_cpu_time = get_thread_time() - _cpu_beg;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+proc_sampler::add_process(pid_t _pid)
+{
+    if(m_procs.find(_pid) != m_procs.end())
+        return;
+
+    auto _base  = std::string{ "/proc/" } + std::to_string(_pid);
+    auto _entry = process_data{};
+    _entry.pid   = _pid;
+    _entry.statm = proc_fd{ _base + "/statm" };
+    _entry.io    = proc_fd{ _base + "/io" };
+    if(!_entry.statm.is_open())
+        return;
+    m_procs.emplace(_pid, std::move(_entry));
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+proc_sampler::add_thread(pid_t _pid, pid_t _tid)
+{
+    if(m_threads.find(_tid) != m_threads.end())
+        return;
+
+    auto _fname =
+        std::string{ "/proc/" } + std::to_string(_pid) + "/task/" + std::to_string(_tid);
+    auto _entry  = thread_data{};
+    _entry.pid   = _pid;
+    _entry.tid   = _tid;
+    _entry.first = m_samples.size();
+    _entry.stat  = proc_fd{ _fname + "/stat" };
+    if(!_entry.stat.is_open())
+        return;
+
+    std::ifstream _ifs{ _fname + "/comm" };
+    if(_ifs)
+        std::getline(_ifs, _entry.name);
+    m_threads.emplace(_tid, std::move(_entry));
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+proc_sampler::update_tree()
+{
+    // depth-first traversal starting from the root via
+    // /proc/<pid>/task/<tid>/children (forked children, MPI ranks, etc.)
+    std::vector<pid_t> _queue = { m_root };
+    std::set<pid_t>    _seen  = {};
+    while(!_queue.empty())
+    {
+        auto _pid = _queue.back();
+        _queue.pop_back();
+        if(!_seen.insert(_pid).second)
+            continue;
+
+        auto  _task = std::string{ "/proc/" } + std::to_string(_pid) + "/task";
+        auto* _dir  = opendir(_task.c_str());
+        if(!_dir)
+            continue;
+
+        add_process(_pid);
+        while(auto* _ent = readdir(_dir))
+        {
+            if(_ent->d_name[0] < '0' || _ent->d_name[0] > '9')
+                continue;
+            auto _tid = static_cast<pid_t>(atol(_ent->d_name));
+            add_thread(_pid, _tid);
+
+            std::ifstream _ifs{ _task + "/" + _ent->d_name + "/children" };
+            pid_t         _child = 0;
+            while(_ifs >> _child)
+                _queue.push_back(_child);
+        }
+        closedir(_dir);
+    }
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+proc_sampler::sample()
+{
+    proc_sample _sample{};
+    _sample.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       clock_type::now() - m_start)
+                       .count();
+
+    auto _dt = (m_samples.empty()) ? 0 : (_sample.time - m_samples.back().time);
+
+    // per-process memory and I/O
+    for(auto itr = m_procs.begin(); itr != m_procs.end();)
+    {
+        auto& _proc = itr->second;
+        if(_proc.statm.read(m_buffer, sizeof(m_buffer)) <= 0)
+        {
+            m_exited_read += _proc.read_bytes;
+            m_exited_write += _proc.write_bytes;
+            itr = m_procs.erase(itr);
+            continue;
+        }
+
+        long _size = 0;
+        long _rss  = 0;
+        if(sscanf(m_buffer, "%ld %ld", &_size, &_rss) == 2)
+            _proc.rss = _rss * m_page_size;
+
+        if(_proc.io.read(m_buffer, sizeof(m_buffer)) > 0)
+        {
+            const char* _rb = strstr(m_buffer, "\nread_bytes:");
+            const char* _wb = strstr(m_buffer, "\nwrite_bytes:");
+            if(_rb)
+                _proc.read_bytes = atoll(_rb + 12);
+            if(_wb)
+                _proc.write_bytes = atoll(_wb + 13);
+        }
+
+        _sample.rss += _proc.rss;
+        _sample.read_bytes += _proc.read_bytes;
+        _sample.write_bytes += _proc.write_bytes;
+        ++_sample.nprocs;
+        ++itr;
+    }
+
+    // per-thread cpu time: fields 14 (utime) and 15 (stime) after the ')' of comm
+    for(auto itr = m_threads.begin(); itr != m_threads.end();)
+    {
+        auto& _thr = itr->second;
+        if(!_thr.stat.is_open() || _thr.stat.read(m_buffer, sizeof(m_buffer)) <= 0)
+        {
+            // thread exited: the last cpu time is kept in the total
+            _thr.stat.close();
+            _sample.cpu_ticks += std::max<int64_t>(_thr.prev, 0);
+            ++itr;
+            continue;
+        }
+
+        int64_t     _ticks = 0;
+        const char* _pos   = strrchr(m_buffer, ')');
+        if(_pos)
+        {
+            unsigned long long _utime = 0;
+            unsigned long long _stime = 0;
+            if(sscanf(_pos + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu",
+                      &_utime, &_stime) == 2)
+                _ticks = static_cast<int64_t>(_utime + _stime);
+        }
+
+        // pad the series of threads which were discovered after the first sample
+        if(_thr.cpu_util.size() + _thr.first < m_samples.size())
+            _thr.cpu_util.resize(m_samples.size() - _thr.first, 0.0f);
+
+        auto _util = (_thr.prev >= 0 && _dt > 0)
+                         ? (100.0 * (_ticks - _thr.prev) * 1.0e9) /
+                               (static_cast<double>(m_clock_ticks) * _dt)
+                         : 0.0;
+        _thr.cpu_util.emplace_back(static_cast<float>(_util));
+        _thr.prev = _ticks;
+
+        _sample.cpu_ticks += _ticks;
+        ++_sample.nthreads;
+        ++itr;
+    }
+
+    // processes which exited keep contributing their totals so the rates are continuous
+    _sample.read_bytes += m_exited_read;
+    _sample.write_bytes += m_exited_write;
+    m_peak_rss = std::max<int64_t>(m_peak_rss, _sample.rss);
+    m_samples.emplace_back(_sample);
+    ++m_num_taken;
+
+    if(m_samples.size() >= m_max_samples)
+        decimate();
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+proc_sampler::decimate()
+{
+    // the odd samples are kept so the last sample, which the next sample is relative
+    // to, is kept. The totals are cumulative so the rates of the remaining samples
+    // are still correct and the utilization of a thread is averaged over the two
+    // periods it now spans
+    size_t _n = 0;
+    for(size_t i = 1; i < m_samples.size(); i += 2)
+        m_samples.at(_n++) = m_samples.at(i);
+    m_samples.resize(_n);
+
+    for(auto& itr : m_threads)
+    {
+        auto&  _thr = itr.second;
+        size_t _m   = 0;
+        for(size_t j = 0; j < _thr.cpu_util.size(); ++j)
+        {
+            if((_thr.first + j) % 2 == 0)
+                continue;
+            auto _util = _thr.cpu_util.at(j);
+            if(j > 0)
+                _util = 0.5f * (_util + _thr.cpu_util.at(j - 1));
+            _thr.cpu_util.at(_m++) = _util;
+        }
+        _thr.cpu_util.resize(_m);
+        _thr.first /= 2;
+    }
+
+    m_stride *= 2;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline double
+proc_sampler::get_overhead() const
+{
+    return (m_wall_time > 0) ? (static_cast<double>(m_cpu_time) / m_wall_time) : 0.0;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline double
+proc_sampler::get_sample_cost() const
+{
+    // usec per sample, relative to every sample taken since the decimated samples
+    // cost the same as the ones which were kept
+    return m_cpu_time / static_cast<double>(std::max<size_t>(m_num_taken, 1)) / 1.0e3;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+proc_sampler::write_summary(std::ostream& _os) const
+{
+    auto _procs = std::set<pid_t>{};
+    for(const auto& itr : m_threads)
+        _procs.insert(itr.second.pid);
+
+    std::stringstream _ss{};
+    _ss << "[timem]> thread sampler: " << m_samples.size() << " samples ("
+        << m_num_taken << " taken) @ " << get_frequency() << " Hz, " << _procs.size()
+        << " processes, " << m_threads.size()
+        << " threads, peak rss = " << std::setprecision(6)
+        << (m_peak_rss / static_cast<double>(tim::units::megabyte)) << " MB\n";
+    _ss << "[timem]> thread sampler overhead: " << std::setprecision(3)
+        << get_sample_cost() << " usec/sample, " << (100.0 * get_overhead())
+        << "% of one core\n";
+    _os << _ss.str() << std::flush;
+}
+//
+//--------------------------------------------------------------------------------------//
+//
+inline void
+proc_sampler::write(std::ostream& _os) const
+{
+    auto _write_array = [&_os](const char* _key, auto&& _func, size_t _n,
+                               bool _last = false) {
+        _os << "      \"" << _key << "\": [";
+        for(size_t i = 0; i < _n; ++i)
+            _os << ((i == 0) ? "" : ",") << _func(i);
+        _os << "]" << ((_last) ? "\n" : ",\n");
+    };
+
+    auto _n = m_samples.size();
+    auto _rate = [&](size_t i, int64_t proc_sample::*_field) {
+        if(i == 0)
+            return 0.0;
+        auto _dt = (m_samples.at(i).time - m_samples.at(i - 1).time) * 1.0e-9;
+        auto _dv = (m_samples.at(i).*_field) - (m_samples.at(i - 1).*_field);
+        return (_dt > 0.0 && _dv > 0) ? (_dv / _dt) : 0.0;
+    };
+    int64_t _peak = 0;
+
+    _os << std::setprecision(6) << "{\n  \"timem_timeseries\": {\n";
+    _os << "    \"pid\": " << m_root << ",\n";
+    _os << "    \"frequency\": " << get_frequency() << ",\n";
+    _os << "    \"num_samples\": " << _n << ",\n";
+    _os << "    \"overhead\": {\n";
+    _os << "      \"num_taken\": " << m_num_taken << ",\n";
+    _os << "      \"cpu_time_sec\": " << (m_cpu_time * 1.0e-9) << ",\n";
+    _os << "      \"wall_time_sec\": " << (m_wall_time * 1.0e-9) << ",\n";
+    _os << "      \"fraction\": " << get_overhead() << "\n    },\n";
+    _os << "    \"process\": {\n";
+    _write_array("time_sec", [&](size_t i) { return m_samples.at(i).time * 1.0e-9; },
+                 _n);
+    _write_array("rss_bytes", [&](size_t i) { return m_samples.at(i).rss; }, _n);
+    _write_array("peak_rss_bytes",
+                 [&](size_t i) { return (_peak = std::max(_peak, m_samples.at(i).rss)); },
+                 _n);
+    _write_array("num_procs", [&](size_t i) { return m_samples.at(i).nprocs; }, _n);
+    _write_array("num_threads", [&](size_t i) { return m_samples.at(i).nthreads; }, _n);
+    _write_array("read_bytes_per_sec",
+                 [&](size_t i) { return _rate(i, &proc_sample::read_bytes); }, _n);
+    _write_array("write_bytes_per_sec",
+                 [&](size_t i) { return _rate(i, &proc_sample::write_bytes); }, _n,
+                 true);
+    _os << "    },\n";
+    _os << "    \"threads\": [";
+    size_t _t = 0;
+    for(const auto& itr : m_threads)
+    {
+        const auto& _thr = itr.second;
+        _os << ((_t++ == 0) ? "\n" : ",\n") << "      { \"pid\": " << _thr.pid
+            << ", \"tid\": " << _thr.tid << ", \"name\": \"" << json_escape(_thr.name)
+            << "\", \"first_sample\": " << _thr.first << ", \"cpu_util_percent\": [";
+        for(size_t i = 0; i < _thr.cpu_util.size(); ++i)
+            _os << ((i == 0) ? "" : ",") << _thr.cpu_util.at(i);
+        _os << "] }";
+    }
+    _os << "\n    ]\n  }\n}\n";
+}
+//
+}  // namespace timem
@@ -31,6 +31,8 @@ void
 childpid_catcher(int);
 void
 parent_process(pid_t pid);
+void
+timeseries_output_process(const timem::proc_sampler&);
 void
       child_process(int argc, char** argv) declare_attribute(noreturn);
 pid_t read_pid(pid_t);
@@ -138,6 +140,39 @@ main(int argc, char** argv)
             if(sample_freq() <= 0.0)
                 use_sample() = false;
         });
+    parser
+        .add_argument({ "-t", "--timeseries" },
+                      "Record a time-series of the memory, per-thread CPU utilization, "
+                      "and I/O of the process tree from a dedicated thread")
+        .count(0)
+        .action([](parser_t&) { use_timeseries() = true; });
+    parser
+        .add_argument({ "--timeseries-freq" },
+                      "Set the frequency of the time-series (samples per second, "
+                      "implies --timeseries) [default: 100]")
+        .count(1)
+        .action([](parser_t& p) {
+            use_timeseries()  = true;
+            timeseries_freq() = p.get<double>("timeseries-freq");
+        });
+    parser
+        .add_argument({ "--timeseries-output" },
+                      "Set the output file of the time-series (implies --timeseries)")
+        .count(1)
+        .action([](parser_t& p) {
+            use_timeseries()    = true;
+            timeseries_output() = p.get<std::string>("timeseries-output");
+        });
+    parser
+        .add_argument({ "--timeseries-max" },
+                      "Set the maximum number of samples in the time-series, the "
+                      "frequency is halved when it is reached (implies --timeseries) "
+                      "[default: 100000]")
+        .count(1)
+        .action([](parser_t& p) {
+            use_timeseries() = true;
+            timeseries_max() = p.get<size_t>("timeseries-max");
+        });
     parser.add_argument({ "--disable-sample" }, "Disable sampling completely")
         .count(0)
         .action([](parser_t&) { use_sample() = false; });
@@ -197,8 +232,9 @@ main(int argc, char** argv)
     // make sure config is instantiated
     tim::consume_parameters(get_config());
 
-    sample_delay() = std::max<double>(sample_delay(), 1.0e-6);
-    sample_freq()  = std::min<double>(sample_freq(), 5000.);
+    sample_delay()    = std::max<double>(sample_delay(), 1.0e-6);
+    sample_freq()     = std::min<double>(sample_freq(), 5000.);
+    timeseries_freq() = std::max<double>(std::min<double>(timeseries_freq(), 5000.), 1.);
 
     if(parser.exists("mpi"))
     {
@@ -428,8 +464,9 @@ main(int argc, char** argv)
         return cond;
     };
 
-    int  ec  = 0;
-    auto ofs = std::unique_ptr<std::ofstream>{};
+    int  ec       = 0;
+    auto ofs      = std::unique_ptr<std::ofstream>{};
+    auto tsampler = std::unique_ptr<timem::proc_sampler>{};
 
     if(failed_fork())
     {
@@ -486,10 +523,31 @@ main(int argc, char** argv)
             get_measure()->set_output(ofs.get());
         }
 
+        /// \variable TIMEM_TIMESERIES
+        /// \brief Environment variable that enables a dedicated thread which reads
+        /// /proc for the target and all of its descendants at TIMEM_TIMESERIES_FREQ
+        /// samples per second and writes the time-series to TIMEM_TIMESERIES_OUTPUT
+        ///
+        if(use_timeseries())
+        {
+            CONDITIONAL_PRINT_HERE((debug() && verbose() > 1), "%s",
+                                   "starting time-series sampler");
+            tsampler = std::make_unique<timem::proc_sampler>(
+                worker_pid(), timeseries_freq(), timeseries_max());
+            tsampler->start();
+        }
+
         CONDITIONAL_PRINT_HERE((debug() && verbose() > 1), "target pid = %i",
                                (int) worker_pid());
         auto status = sampler_t::wait(worker_pid(), verbose(), debug());
 
+        if(tsampler)
+        {
+            CONDITIONAL_PRINT_HERE((debug() && verbose() > 1), "%s",
+                                   "stopping time-series sampler");
+            tsampler->stop();
+        }
+
         if((debug() && verbose() > 1) || verbose() > 2)
             std::cerr << "[BEFORE STOP][" << pid << "]> " << *get_measure() << std::endl;
 
@@ -505,6 +563,9 @@ main(int argc, char** argv)
         CONDITIONAL_PRINT_HERE((debug() && verbose() > 1), "%s", "");
         parent_process(pid);
 
+        if(tsampler)
+            timeseries_output_process(*tsampler);
+
         CONDITIONAL_PRINT_HERE((debug() && verbose() > 1), "exit code = %i", status);
         ec = status;
     }
@@ -640,6 +701,39 @@ parent_process(pid_t pid)
 
 //--------------------------------------------------------------------------------------//
 
+void
+timeseries_output_process(const timem::proc_sampler& _sampler)
+{
+    auto fname = timeseries_output();
+    if(fname.empty())
+        fname = tim::settings::compose_output_filename(
+            TIMEMORY_JOIN("-", "timem-timeseries", worker_pid()), ".json");
+    else if(tim::dmp::size() > 1)
+        fname = timem::get_timeseries_filename(fname, worker_pid());
+
+    auto output_dir = fname.substr(0, fname.find_last_of('/'));
+    if(output_dir != fname)
+        tim::makedir(output_dir);
+
+    std::ofstream ofs(fname.c_str());
+    if(ofs)
+    {
+        if(verbose() > -1)
+            fprintf(stderr, "[timem]> Outputting '%s'...\n", fname.c_str());
+        _sampler.write(ofs);
+    }
+    else
+    {
+        std::cerr << "[timem]> Error opening time-series output file '" << fname
+                  << "'...\n";
+    }
+
+    if(verbose() > -1)
+        _sampler.write_summary(std::cerr);
+}
+
+//--------------------------------------------------------------------------------------//
+
 void
 child_process(int argc, char** argv)
 {
@@ -41,6 +41,8 @@ TIMEMORY_DEFINE_CONCRETE_TRAIT(is_available, component::page_rss, false_type)
 #include "timemory/sampling/sampler.hpp"
 #include "timemory/timemory.hpp"
 
+#include "proc_sampler.hpp"
+
 TIMEMORY_DEFINE_CONCRETE_TRAIT(custom_label_printing, component::papi_array_t, true_type)
 
 // C includes
@@ -575,6 +577,11 @@ struct timem_config
     string_t      output_file  = tim::get_env<string_t>("TIMEM_OUTPUT", "");
     double        sample_freq  = tim::get_env<double>("TIMEM_SAMPLE_FREQ", 1.0);
     double        sample_delay = tim::get_env<double>("TIMEM_SAMPLE_DELAY", 0.001);
+    bool          use_timeseries  = tim::get_env("TIMEM_TIMESERIES", false);
+    double        timeseries_freq = tim::get_env<double>("TIMEM_TIMESERIES_FREQ", 100.0);
+    string_t      timeseries_output =
+        tim::get_env<string_t>("TIMEM_TIMESERIES_OUTPUT", "");
+    size_t        timeseries_max = tim::get_env<size_t>("TIMEM_TIMESERIES_MAX", 100000);
     pid_t         master_pid   = getpid();
     pid_t         worker_pid   = getpid();
     string_t      command      = "";
@@ -606,6 +613,10 @@ TIMEM_CONFIG_FUNCTION(shell_flags)
 TIMEM_CONFIG_FUNCTION(output_file)
 TIMEM_CONFIG_FUNCTION(sample_freq)
 TIMEM_CONFIG_FUNCTION(sample_delay)
+TIMEM_CONFIG_FUNCTION(use_timeseries)
+TIMEM_CONFIG_FUNCTION(timeseries_freq)
+TIMEM_CONFIG_FUNCTION(timeseries_output)
+TIMEM_CONFIG_FUNCTION(timeseries_max)
 TIMEM_CONFIG_FUNCTION(signal_delivered)
 TIMEM_CONFIG_FUNCTION(debug)
 TIMEM_CONFIG_FUNCTION(verbose)
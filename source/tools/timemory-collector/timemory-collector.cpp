@@ -0,0 +1,173 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "timemory/utility/argparse.hpp"
+#include "timemory/utility/telemetry.hpp"
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace telemetry = tim::telemetry;
+
+using parser_t     = tim::argparse::argument_parser;
+using collector_t  = telemetry::collector;
+using clock_type   = std::chrono::steady_clock;
+using seconds_type = std::chrono::duration<double>;
+
+static volatile std::sig_atomic_t is_running = 1;
+
+//--------------------------------------------------------------------------------------//
+
+extern "C" void
+collector_signal_handler(int)
+{
+    is_running = 0;
+}
+
+//--------------------------------------------------------------------------------------//
+
+void
+write_report(const collector_t& _collector, const std::string& _output)
+{
+    if(_output.empty())
+    {
+        _collector.write(std::cout);
+        return;
+    }
+
+    std::ofstream _ofs{ _output.c_str() };
+    if(_ofs)
+        _collector.write(_ofs);
+    else
+        std::cerr << "Error opening output file: " << _output << std::endl;
+}
+
+//--------------------------------------------------------------------------------------//
+
+int
+main(int argc, char** argv)
+{
+    std::string _endpoint = {};
+    std::string _output   = {};
+    double      _duration = 0.0;
+    double      _report   = 0.0;
+    size_t      _sources  = 0;
+
+    parser_t parser("timemory-collector");
+
+    parser.enable_help();
+    parser
+        .add_argument({ "-e", "--endpoint" },
+                      "Endpoint to listen on, e.g. unix:/tmp/timemory.sock, "
+                      "tcp:127.0.0.1:9000, or tcp:*:9000 (all interfaces)")
+        .count(1);
+    parser
+        .add_argument({ "-d", "--duration" },
+                      "Exit after this many seconds (default: until interrupted)")
+        .count(1);
+    parser
+        .add_argument({ "-n", "--sources" },
+                      "Exit once this many sources connected and disconnected")
+        .count(1);
+    parser
+        .add_argument({ "-i", "--interval" },
+                      "Write the aggregated report every N seconds while running")
+        .count(1);
+    parser.add_argument({ "-o", "--output" }, "Write the report to a file").count(1);
+
+    auto err = parser.parse(argc, argv);
+    if(err)
+        std::cerr << err << std::endl;
+
+    if(err || parser.exists("help"))
+    {
+        parser.print_help();
+        return (err) ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    if(!parser.exists("endpoint"))
+    {
+        std::cerr << "Error! An endpoint is required" << std::endl;
+        parser.print_help();
+        return EXIT_FAILURE;
+    }
+
+    _endpoint = parser.get<std::string>("endpoint");
+    if(parser.exists("duration"))
+        _duration = parser.get<double>("duration");
+    if(parser.exists("sources"))
+        _sources = parser.get<size_t>("sources");
+    if(parser.exists("interval"))
+        _report = parser.get<double>("interval");
+    if(parser.exists("output"))
+        _output = parser.get<std::string>("output");
+
+    collector_t _collector{};
+    if(!_collector.open(_endpoint))
+    {
+        std::cerr << "Error! Unable to listen on '" << _endpoint << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "[timemory-collector]> listening on "
+              << _collector.get_endpoint().as_string() << std::endl;
+
+    signal(SIGINT, &collector_signal_handler);
+    signal(SIGTERM, &collector_signal_handler);
+
+    auto _beg  = clock_type::now();
+    auto _last = _beg;
+    while(is_running)
+    {
+        _collector.poll(100);
+
+        auto _now = clock_type::now();
+        if(_duration > 0.0 && seconds_type{ _now - _beg }.count() >= _duration)
+            break;
+        if(_sources > 0 && _collector.sources().size() >= _sources &&
+           _collector.clients() == 0)
+            break;
+        if(_report > 0.0 && seconds_type{ _now - _last }.count() >= _report)
+        {
+            _last = _now;
+            _collector.write(std::cout);
+        }
+    }
+
+    // drain the data which is already buffered
+    while(_collector.poll(0) > 0)
+    {}
+
+    write_report(_collector, _output);
+    _collector.close();
+
+    return EXIT_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------//
@@ -0,0 +1,272 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "timemory/data/compare.hpp"
+#include "timemory/utility/argparse.hpp"
+
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+#include <utility>
+#include <vector>
+
+namespace compare = tim::data::compare;
+
+using parser_t     = tim::argparse::argument_parser;
+using strvector_t  = std::vector<std::string>;
+using strpair_t    = std::pair<std::string, std::string>;
+using filepairs_t  = std::vector<strpair_t>;
+using stringset_t  = std::set<std::string>;
+using compare_cfg  = compare::config;
+using result_set_t = compare::result_set;
+
+// exit codes
+static constexpr int no_regression_exit = EXIT_SUCCESS;
+static constexpr int regression_exit    = 1;
+static constexpr int input_error_exit   = 2;
+
+//--------------------------------------------------------------------------------------//
+
+bool
+is_directory(const std::string& _path)
+{
+    struct stat _buf;
+    return (stat(_path.c_str(), &_buf) == 0 && S_ISDIR(_buf.st_mode));
+}
+
+//--------------------------------------------------------------------------------------//
+// the per-component JSON files in an output directory, i.e. excludes the
+// '.tree.json', '.diff.json', and flamegraph outputs
+//
+stringset_t
+get_json_files(const std::string& _path)
+{
+    auto _ends_with = [](const std::string& _str, const std::string& _sfx) {
+        return _str.length() >= _sfx.length() &&
+               _str.compare(_str.length() - _sfx.length(), _sfx.length(), _sfx) == 0;
+    };
+
+    stringset_t _files{};
+    auto*       _dir = opendir(_path.c_str());
+    if(!_dir)
+        return _files;
+    while(auto* _ent = readdir(_dir))
+    {
+        std::string _name = _ent->d_name;
+        if(!_ends_with(_name, ".json"))
+            continue;
+        if(_ends_with(_name, ".tree.json") || _ends_with(_name, ".diff.json") ||
+           _ends_with(_name, ".flamegraph.json"))
+            continue;
+        _files.insert(_name);
+    }
+    closedir(_dir);
+    return _files;
+}
+
+//--------------------------------------------------------------------------------------//
+
+int
+main(int argc, char** argv)
+{
+    strvector_t _baseline{};
+    strvector_t _current{};
+    compare_cfg _cfg{};
+    bool        _merge  = false;
+    bool        _all    = false;
+    bool        _quiet  = false;
+    std::string _output = {};
+
+    parser_t parser("timemory-compare");
+
+    parser.enable_help();
+    parser
+        .add_argument({ "-b", "--baseline" },
+                      "Baseline JSON output file(s) or output directory")
+        .min_count(1);
+    parser
+        .add_argument({ "-c", "--current" },
+                      "Current JSON output file(s) or output directory (same order as "
+                      "the baseline)")
+        .min_count(1);
+    parser
+        .add_argument({ "-r", "--relative" },
+                      "Minimum relative change of the mean to be significant (fraction)")
+        .count(1);
+    parser
+        .add_argument({ "-a", "--absolute" },
+                      "Minimum absolute change of the mean to be significant (display "
+                      "units of the component)")
+        .count(1);
+    parser
+        .add_argument({ "-t", "--t-score" },
+                      "Minimum Welch t-score to be significant when the variance is "
+                      "available")
+        .count(1);
+    parser
+        .add_argument({ "-n", "--min-count" },
+                      "Entries with fewer samples than this are never flagged")
+        .count(1);
+    parser.add_argument({ "-m", "--merge-ranks" }, "Combine the ranks before comparing")
+        .count(0);
+    parser
+        .add_argument({ "--higher-is-better" },
+                      "An increase is an improvement (e.g. rates instead of times)")
+        .count(0);
+    parser.add_argument({ "--fail-on-removed" }, "Regions which disappeared are failures")
+        .count(0);
+    parser.add_argument({ "-A", "--all" }, "Report unchanged entries too").count(0);
+    parser.add_argument({ "-o", "--output" }, "Write the report to a file").count(1);
+    parser.add_argument({ "-q", "--quiet" }, "Only report via the exit code").count(0);
+
+    auto err = parser.parse(argc, argv);
+    if(err)
+        std::cerr << err << std::endl;
+
+    if(err || parser.exists("help"))
+    {
+        parser.print_help();
+        return (err) ? input_error_exit : no_regression_exit;
+    }
+
+    if(!parser.exists("baseline") || !parser.exists("current"))
+    {
+        std::cerr << "Error! Both a baseline and a current input are required"
+                  << std::endl;
+        parser.print_help();
+        return input_error_exit;
+    }
+
+    _baseline = parser.get<strvector_t>("baseline");
+    _current  = parser.get<strvector_t>("current");
+
+    if(parser.exists("relative"))
+        _cfg.relative = parser.get<double>("relative");
+    if(parser.exists("absolute"))
+        _cfg.absolute = parser.get<double>("absolute");
+    if(parser.exists("t-score"))
+        _cfg.tscore = parser.get<double>("t-score");
+    if(parser.exists("min-count"))
+        _cfg.min_count = parser.get<int64_t>("min-count");
+    if(parser.exists("higher-is-better"))
+        _cfg.higher_is_better = true;
+    if(parser.exists("fail-on-removed"))
+        _cfg.fail_on_removed = true;
+    if(parser.exists("merge-ranks"))
+        _merge = true;
+    if(parser.exists("all"))
+        _all = true;
+    if(parser.exists("quiet"))
+        _quiet = true;
+    if(parser.exists("output"))
+        _output = parser.get<std::string>("output");
+
+    if(_baseline.size() != _current.size())
+    {
+        std::cerr << "Error! Number of baseline inputs (" << _baseline.size()
+                  << ") != number of current inputs (" << _current.size() << ")"
+                  << std::endl;
+        return input_error_exit;
+    }
+
+    // expand directories into the files that exist in both
+    filepairs_t _pairs{};
+    for(size_t i = 0; i < _baseline.size(); ++i)
+    {
+        const auto& _b = _baseline.at(i);
+        const auto& _c = _current.at(i);
+        if(is_directory(_b) && is_directory(_c))
+        {
+            auto _bfiles = get_json_files(_b);
+            auto _cfiles = get_json_files(_c);
+            for(const auto& itr : _cfiles)
+            {
+                if(_bfiles.count(itr) > 0)
+                    _pairs.emplace_back(_b + "/" + itr, _c + "/" + itr);
+                else if(!_quiet)
+                    std::cerr << "Warning! No baseline for '" << _c << "/" << itr << "'"
+                              << std::endl;
+            }
+        }
+        else
+        {
+            _pairs.emplace_back(_b, _c);
+        }
+    }
+
+    if(_pairs.empty())
+    {
+        std::cerr << "Error! No inputs to compare" << std::endl;
+        return input_error_exit;
+    }
+
+    std::ofstream _ofs{};
+    std::ostream* _os = &std::cout;
+    if(!_output.empty())
+    {
+        _ofs.open(_output.c_str());
+        if(_ofs)
+            _os = &_ofs;
+        else
+            std::cerr << "Error opening output file: " << _output << std::endl;
+    }
+
+    int  _ret    = no_regression_exit;
+    bool _passed = true;
+    for(const auto& itr : _pairs)
+    {
+        result_set_t _bdata{};
+        result_set_t _cdata{};
+        if(!compare::read_json(itr.first, _bdata, &std::cerr) ||
+           !compare::read_json(itr.second, _cdata, &std::cerr))
+        {
+            _ret = input_error_exit;
+            continue;
+        }
+
+        if(_merge)
+        {
+            _bdata.merge_ranks();
+            _cdata.merge_ranks();
+        }
+
+        auto _summary = compare::compare(_bdata, _cdata, _cfg);
+        if(_summary.label.empty())
+            _summary.label = itr.second;
+        if(!_quiet)
+            compare::write(*_os, _summary, _all);
+        _passed = _passed && _summary.passed(_cfg);
+    }
+
+    if(_ret == no_regression_exit && !_passed)
+        _ret = regression_exit;
+
+    return _ret;
+}
+
+//--------------------------------------------------------------------------------------//
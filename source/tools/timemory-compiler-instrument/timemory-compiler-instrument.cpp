@@ -0,0 +1,320 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "timemory/compat/library.h"
+#include "timemory/library.h"
+#include "timemory/timemory.hpp"
+#include "timemory/utility/symbols.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#define TIMEMORY_NO_INSTRUMENT __attribute__((no_instrument_function))
+
+using namespace tim::component;
+
+using instr_bundle_t = tim::component_tuple<user_trace_bundle>;
+using mutex_t        = std::mutex;
+using lock_t         = std::unique_lock<mutex_t>;
+using clock_type     = std::chrono::steady_clock;
+
+extern "C"
+{
+    void __cyg_profile_func_enter(void*, void*) TIMEMORY_VISIBILITY("default")
+        TIMEMORY_NO_INSTRUMENT;
+    void __cyg_profile_func_exit(void*, void*) TIMEMORY_VISIBILITY("default")
+        TIMEMORY_NO_INSTRUMENT;
+    void timemory_compiler_instrument_finalize(void) TIMEMORY_VISIBILITY("default")
+        TIMEMORY_NO_INSTRUMENT;
+}
+
+//======================================================================================//
+
+namespace
+{
+//--------------------------------------------------------------------------------------//
+// per-thread state of a function. Similar to the throttling of the timemory-run
+// library: every TIMEMORY_THROTTLE_COUNT calls, a function whose average duration is
+// less than TIMEMORY_THROTTLE_VALUE nanoseconds is throttled and subsequent calls
+// return immediately. Throttling only takes effect when no call of the function is on
+// the call-stack so that the entries and exits stay balanced
+//
+struct function_slot
+{
+    bool     throttled = false;
+    bool     pending   = false;
+    uint32_t depth     = 0;
+    uint64_t count     = 0;
+    int64_t  accum     = 0;
+};
+
+struct stack_entry
+{
+    TIMEMORY_NO_INSTRUMENT stack_entry(const void* _addr, function_slot* _slot)
+    : addr{ _addr }
+    , slot{ _slot }
+    , bundle{ reinterpret_cast<size_t>(_addr) }
+    {}
+
+    const void*    addr   = nullptr;
+    function_slot* slot   = nullptr;
+    int64_t        begin  = 0;
+    instr_bundle_t bundle = {};
+};
+
+struct thread_data
+{
+    using slot_map_t = std::unordered_map<const void*, function_slot>;
+
+    TIMEMORY_NO_INSTRUMENT void unwind()
+    {
+        while(!stack.empty())
+        {
+            stack.back().bundle.stop();
+            stack.pop_back();
+        }
+    }
+
+    bool                    active = false;
+    slot_map_t              slots  = {};
+    std::deque<stack_entry> stack  = {};
+};
+
+// addresses entered on any thread, resolved to names at finalization
+struct global_data
+{
+    mutex_t               mutex     = {};
+    std::set<const void*> addresses = {};
+    std::atomic<bool>     finalized = { false };
+    std::atomic<bool>     init      = { false };
+    std::atomic<uint64_t> throttled = { 0 };
+};
+
+TIMEMORY_NO_INSTRUMENT global_data&
+get_global_data()
+{
+    // leaked so that it is valid during the static destruction
+    static auto* _instance = new global_data{};
+    return *_instance;
+}
+
+// the thread-local data is heap-allocated and released by a thread-local guard so
+// that entries and exits during the destruction of the thread are ignored
+thread_local thread_data* tl_data      = nullptr;
+thread_local bool         tl_destroyed = false;
+
+struct thread_guard
+{
+    TIMEMORY_NO_INSTRUMENT ~thread_guard()
+    {
+        if(tl_data)
+        {
+            tl_data->active = true;
+            tl_data->unwind();
+            delete tl_data;
+        }
+        tl_data      = nullptr;
+        tl_destroyed = true;
+    }
+};
+
+TIMEMORY_NO_INSTRUMENT thread_data*
+get_thread_data()
+{
+    if(tl_data || tl_destroyed)
+        return tl_data;
+    static thread_local thread_guard _guard{};
+    tl_data = new thread_data{};
+    return tl_data;
+}
+
+TIMEMORY_NO_INSTRUMENT int64_t
+now()
+{
+    return clock_type::now().time_since_epoch().count();
+}
+
+TIMEMORY_NO_INSTRUMENT void
+update_throttle(const void* _addr, function_slot& _slot)
+{
+    static auto _throttle_count = std::max<size_t>(tim::settings::throttle_count(), 1);
+    static auto _throttle_value = tim::settings::throttle_value();
+
+    if(_slot.count < _throttle_count)
+        return;
+
+    auto _avg = _slot.accum / static_cast<int64_t>(_slot.count);
+    if(_avg < static_cast<int64_t>(_throttle_value))
+    {
+        _slot.pending = true;
+        ++get_global_data().throttled;
+        if(tim::settings::debug() || tim::settings::verbose() > 1)
+            fprintf(stderr,
+                    "[timemory-compiler-instrument]> Throttling all future calls to %p "
+                    "on thread %i. avg runtime = %lli ns from %llu invocations...\n",
+                    _addr, (int) tim::threading::get_id(), (long long) _avg,
+                    (unsigned long long) _slot.count);
+    }
+    _slot.count = 0;
+    _slot.accum = 0;
+}
+}  // namespace
+
+//======================================================================================//
+
+extern "C"
+{
+    //
+    //----------------------------------------------------------------------------------//
+    //
+    void __cyg_profile_func_enter(void* _fn, void*)
+    {
+        auto* _data = get_thread_data();
+        if(!_data || _data->active)
+            return;
+
+        auto& _global = get_global_data();
+        if(_global.finalized.load(std::memory_order_relaxed))
+            return;
+
+        _data->active = true;
+
+        if(!_global.init.exchange(true))
+        {
+            if(!timemory_trace_is_initialized())
+                timemory_trace_init("", true, "");
+            // runs before the finalization registered by timemory_trace_init
+            std::atexit(&timemory_compiler_instrument_finalize);
+        }
+
+        if(!tim::settings::enabled())
+        {
+            _data->active = false;
+            return;
+        }
+
+        auto _sitr = _data->slots.find(_fn);
+        if(_sitr == _data->slots.end())
+        {
+            _sitr = _data->slots.emplace(_fn, function_slot{}).first;
+            lock_t _lk{ _global.mutex };
+            _global.addresses.insert(_fn);
+        }
+
+        auto& _slot = _sitr->second;
+        if(!_slot.throttled)
+        {
+            ++_slot.depth;
+            _data->stack.emplace_back(_fn, &_slot);
+            auto& _entry = _data->stack.back();
+            _entry.bundle.start();
+            _entry.begin = now();
+        }
+
+        _data->active = false;
+    }
+    //
+    //----------------------------------------------------------------------------------//
+    //
+    void __cyg_profile_func_exit(void* _fn, void*)
+    {
+        auto* _data = get_thread_data();
+        if(!_data || _data->active || _data->stack.empty() ||
+           _data->stack.back().addr != _fn)
+            return;
+
+        _data->active = true;
+
+        auto& _entry = _data->stack.back();
+        auto* _slot  = _entry.slot;
+        auto  _dt    = now() - _entry.begin;
+        _entry.bundle.stop();
+        _data->stack.pop_back();
+
+        --_slot->depth;
+        ++_slot->count;
+        _slot->accum += _dt;
+        if(!_slot->pending)
+            update_throttle(_fn, *_slot);
+        if(_slot->pending && _slot->depth == 0)
+            _slot->throttled = true;
+
+        _data->active = false;
+    }
+    //
+    //----------------------------------------------------------------------------------//
+    //
+    /// stops the functions on the call-stack of the calling thread and adds the names
+    /// of every function which was entered on any thread
+    //
+    void timemory_compiler_instrument_finalize(void)
+    {
+        auto& _global = get_global_data();
+        if(_global.finalized.exchange(true))
+            return;
+
+        auto* _data = get_thread_data();
+        if(_data)
+        {
+            _data->active = true;
+            _data->unwind();
+            _data->active = false;
+        }
+
+        std::set<const void*> _addresses{};
+        {
+            lock_t _lk{ _global.mutex };
+            std::swap(_addresses, _global.addresses);
+        }
+
+        auto  _names    = tim::symbols::resolve(_addresses);
+        auto& _hash_ids = tim::get_hash_ids();
+        if(_hash_ids)
+        {
+            for(const auto& itr : _names)
+                (*_hash_ids)[reinterpret_cast<size_t>(itr.first)] = itr.second;
+        }
+
+        if(tim::settings::verbose() > 0 || tim::settings::debug())
+            fprintf(stderr,
+                    "[timemory-compiler-instrument]> Resolved %lu functions, %llu "
+                    "throttled...\n",
+                    (unsigned long) _names.size(),
+                    (unsigned long long) _global.throttled.load());
+    }
+    //
+    //----------------------------------------------------------------------------------//
+    //
+}  // extern "C"
+
+//======================================================================================//
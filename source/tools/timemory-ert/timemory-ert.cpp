@@ -0,0 +1,237 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "timemory/components/timing/wall_clock.hpp"
+#include "timemory/ert/cache.hpp"
+#include "timemory/ert/configuration.hpp"
+#include "timemory/settings/declaration.hpp"
+#include "timemory/utility/argparse.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ert    = tim::ert;
+namespace cache  = tim::ert::cache;
+namespace device = tim::device;
+
+using settings    = tim::settings;
+using parser_t    = tim::argparse::argument_parser;
+using strvector_t = std::vector<std::string>;
+using intvector_t = std::vector<uint64_t>;
+
+// the cpu_roofline component measures the ERT with the wall-clock timer
+using counter_type = tim::component::wall_clock;
+using ert_data_t   = ert::exec_data<counter_type>;
+
+//--------------------------------------------------------------------------------------//
+
+struct options
+{
+    bool invalidate = false;
+    bool force      = false;
+};
+
+//--------------------------------------------------------------------------------------//
+// runs the ERT for one data type and thread count, or removes its entry
+//
+template <typename Tp>
+bool
+process(const options& _opts)
+{
+    using config_type   = ert::configuration<device::cpu, Tp, counter_type>;
+    using executor_type = cache::executor<device::cpu, Tp, counter_type>;
+
+    config_type _config{};
+    auto        _fp = cache::get_fingerprint(_config);
+
+    if(_opts.invalidate)
+    {
+        bool _removed = cache::invalidate(_fp);
+        std::cout << ((_removed) ? "Removed " : "No entry for ") << _fp << std::endl;
+        return true;
+    }
+
+    auto _data = std::make_shared<ert_data_t>();
+
+    executor_type::refresh() = _opts.force;
+    executor_type _exec{ _config, _data };
+
+    if(_data->size() == 0)
+    {
+        std::cerr << "Error! No ERT results for " << _fp << std::endl;
+        return false;
+    }
+
+    std::cout << ((_exec.is_cached()) ? "Cached   " : "Measured ")
+              << cache::get_path(_fp) << "\n    " << _fp << std::endl;
+    if(settings::verbose() > 1)
+        std::cout << *_data << std::endl;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------//
+
+int
+main(int argc, char** argv)
+{
+    settings::parse();
+
+    options     _opts{};
+    strvector_t _dtypes = { "float", "double" };
+    intvector_t _threads{};
+
+    parser_t parser("timemory-ert");
+
+    parser.enable_help();
+    parser
+        .add_argument({ "-t", "--num-threads" },
+                      "Number of threads to measure the ERT with (default: "
+                      "TIMEMORY_ERT_NUM_THREADS_CPU)")
+        .min_count(1);
+    parser
+        .add_argument({ "-d", "--dtype" },
+                      "Data types to measure the ERT with (float and/or double)")
+        .min_count(1);
+    parser
+        .add_argument({ "-w", "--min-working-size" },
+                      "Minimum working size in bytes (default: "
+                      "TIMEMORY_ERT_MIN_WORKING_SIZE_CPU)")
+        .count(1);
+    parser
+        .add_argument({ "-m", "--max-data-size" },
+                      "Maximum data size in bytes (default: twice the largest cache)")
+        .count(1);
+    parser
+        .add_argument({ "-C", "--cache-dir" },
+                      "Cache directory (default: TIMEMORY_ERT_CACHE_DIR, "
+                      "$XDG_CACHE_HOME/timemory/ert, or $HOME/.cache/timemory/ert)")
+        .count(1);
+    parser
+        .add_argument({ "-N", "--numa-aware" },
+                      "Pin the threads across the NUMA nodes and measure per-node "
+                      "ceilings (default: TIMEMORY_ERT_NUMA_AWARE)")
+        .count(0);
+    parser
+        .add_argument({ "-f", "--force" }, "Re-run the ERT and replace existing entries")
+        .count(0);
+    parser
+        .add_argument({ "-i", "--invalidate" },
+                      "Remove the entries matching this node and configuration")
+        .count(0);
+    parser.add_argument({ "-l", "--list" }, "List the cached entries").count(0);
+    parser.add_argument({ "--clear" }, "Remove all the cached entries").count(0);
+    parser.add_argument({ "-v", "--verbose" }, "Verbosity level").count(1);
+
+    auto err = parser.parse(argc, argv);
+    if(err)
+        std::cerr << err << std::endl;
+
+    if(err || parser.exists("help"))
+    {
+        parser.print_help();
+        return (err) ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    if(parser.exists("cache-dir"))
+        settings::ert_cache_dir() = parser.get<std::string>("cache-dir");
+    if(parser.exists("verbose"))
+        settings::verbose() = parser.get<int>("verbose");
+    if(parser.exists("dtype"))
+        _dtypes = parser.get<strvector_t>("dtype");
+    if(parser.exists("num-threads"))
+        _threads = parser.get<intvector_t>("num-threads");
+    if(parser.exists("min-working-size"))
+        settings::ert_min_working_size() = parser.get<uint64_t>("min-working-size");
+    if(parser.exists("max-data-size"))
+        settings::ert_max_data_size() = parser.get<uint64_t>("max-data-size");
+    if(parser.exists("numa-aware"))
+        settings::ert_numa_aware() = true;
+    _opts.force      = parser.exists("force");
+    _opts.invalidate = parser.exists("invalidate");
+
+    if(cache::get_directory().empty())
+    {
+        std::cerr << "Error! Unable to determine the cache directory. Set "
+                     "TIMEMORY_ERT_CACHE_DIR or use --cache-dir"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if(parser.exists("list"))
+    {
+        for(const auto& itr : cache::list())
+        {
+            cache::fingerprint _fp{};
+            if(cache::read_fingerprint(itr, _fp))
+                std::cout << itr << "\n    " << _fp << std::endl;
+            else
+                std::cout << itr << "\n    (unreadable or incompatible version)"
+                          << std::endl;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if(parser.exists("clear"))
+    {
+        auto _n = cache::clear();
+        std::cout << "Removed " << _n << " entries from " << cache::get_directory()
+                  << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // the cache is always used by this tool, regardless of TIMEMORY_ERT_CACHE
+    settings::ert_cache() = true;
+
+    // an empty list uses the configured default
+    if(_threads.empty())
+        _threads.emplace_back(0);
+
+    bool _success = true;
+    for(auto nthread : _threads)
+    {
+        settings::ert_num_threads() = nthread;
+        for(const auto& itr : _dtypes)
+        {
+            if(itr == "float" || itr == "fp32")
+                _success = process<float>(_opts) && _success;
+            else if(itr == "double" || itr == "fp64")
+                _success = process<double>(_opts) && _success;
+            else
+            {
+                std::cerr << "Error! Unsupported data type '" << itr
+                          << "'. Expected float or double" << std::endl;
+                _success = false;
+            }
+        }
+    }
+
+    return (_success) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//--------------------------------------------------------------------------------------//
@@ -23,18 +23,26 @@
 // SOFTWARE.
 
 #include "timemory/components/gotcha/mpip.hpp"
+#include "timemory/data/comm_matrix.hpp"
 #include "timemory/library.h"
 #include "timemory/timemory.hpp"
 
 #include <dlfcn.h>
 
+#include <atomic>
+#include <cstdio>
+#include <fstream>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 using namespace tim::component;
 
 TIMEMORY_DECLARE_COMPONENT(mpi_comm_data)
+TIMEMORY_DECLARE_COMPONENT(mpi_comm_matrix)
 //
 //--------------------------------------------------------------------------------------//
 //
@@ -52,7 +60,8 @@ TIMEMORY_DEFINE_CONCRETE_TRAIT(is_memory_category, mpi_data_tracker_t, true_type
 //--------------------------------------------------------------------------------------//
 //
 using api_t            = tim::api::native_tag;
-using mpi_toolset_t    = tim::component_tuple<user_mpip_bundle, mpi_comm_data>;
+using mpi_toolset_t =
+    tim::component_tuple<user_mpip_bundle, mpi_comm_data, mpi_comm_matrix>;
 using mpip_handle_t    = mpip_handle<mpi_toolset_t, api_t>;
 uint64_t global_id     = 0;
 void*    libmpi_handle = nullptr;
@@ -301,12 +310,378 @@ private:
         }
     }
 };
+//
+//--------------------------------------------------------------------------------------//
+//
+//  Rank-by-rank communication matrix and message-size histograms. Each message is
+//  recorded once by the sending rank. The counters are per-thread and are reduced
+//  with a single gather to rank 0 when MPI is finalized. The PMPI entry points are
+//  used so that none of the queries are intercepted by the wrappers.
+//
+struct mpi_comm_matrix : base<mpi_comm_matrix, void>
+{
+    using value_type  = void;
+    using this_type   = mpi_comm_matrix;
+    using base_type   = base<this_type, value_type>;
+    using matrix_type = tim::data::comm_matrix;
+    using count_type  = matrix_type::count_type;
+    using rank_map_t  = std::unordered_map<MPI_Comm, std::vector<int>>;
+
+    TIMEMORY_DEFAULT_OBJECT(mpi_comm_matrix)
+
+    static bool& enabled()
+    {
+        static bool _v = tim::get_env("TIMEMORY_MPIP_COMM_MATRIX", false);
+        return _v;
+    }
+
+    static void global_init() { get_matrix(); }
+    static void global_finalize() { write(); }
+
+    void start() { get_matrix(); }
+    void stop() {}
+
+    // MPI_Send, MPI_Bsend, MPI_Ssend, MPI_Rsend
+    void audit(const std::string& _name, const void*, int count, MPI_Datatype datatype,
+               int dst, int, MPI_Comm comm)
+    {
+        add_message(_name, comm, dst, get_size(count, datatype));
+    }
+
+    // MPI_Recv
+    void audit(const std::string& _name, void*, int count, MPI_Datatype datatype, int,
+               int, MPI_Comm, MPI_Status*)
+    {
+        add_size(_name, get_size(count, datatype));
+    }
+
+    // MPI_Isend, MPI_Ibsend, MPI_Issend, MPI_Irsend
+    void audit(const std::string& _name, const void*, int count, MPI_Datatype datatype,
+               int dst, int, MPI_Comm comm, MPI_Request*)
+    {
+        add_message(_name, comm, dst, get_size(count, datatype));
+    }
+
+    // MPI_Irecv
+    void audit(const std::string& _name, void*, int count, MPI_Datatype datatype, int,
+               int, MPI_Comm, MPI_Request*)
+    {
+        add_size(_name, get_size(count, datatype));
+    }
+
+    // MPI_Sendrecv
+    void audit(const std::string& _name, const void*, int sendcount,
+               MPI_Datatype sendtype, int dst, int, void*, int, MPI_Datatype, int, int,
+               MPI_Comm comm, MPI_Status*)
+    {
+        add_message(_name, comm, dst, get_size(sendcount, sendtype));
+    }
+
+    // MPI_Bcast
+    void audit(const std::string& _name, void*, int count, MPI_Datatype datatype,
+               int root, MPI_Comm comm)
+    {
+        auto _bytes = get_size(count, datatype);
+        add_size(_name, _bytes);
+        if(get_rank(comm) == root)
+            add_transfers(comm, root, _bytes);
+    }
+
+    // MPI_Reduce
+    void audit(const std::string& _name, const void*, void*, int count,
+               MPI_Datatype datatype, MPI_Op, int root, MPI_Comm comm)
+    {
+        auto _bytes = get_size(count, datatype);
+        add_size(_name, _bytes);
+        if(get_rank(comm) != root)
+            add_transfer(comm, root, _bytes);
+    }
+
+    // MPI_Allreduce
+    void audit(const std::string& _name, const void*, void*, int count,
+               MPI_Datatype datatype, MPI_Op, MPI_Comm)
+    {
+        add_size(_name, get_size(count, datatype));
+    }
+
+    // MPI_Gather, MPI_Scatter
+    void audit(const std::string& _name, const void* sendbuf, int sendcount,
+               MPI_Datatype sendtype, void*, int recvcount, MPI_Datatype recvtype,
+               int root, MPI_Comm comm)
+    {
+        auto _root = (get_rank(comm) == root);
+        if(_name == "MPI_Scatter")
+        {
+            auto _bytes = (_root) ? get_size(sendcount, sendtype)
+                                  : get_size(recvcount, recvtype);
+            add_size(_name, _bytes);
+            if(_root)
+                add_transfers(comm, root, _bytes);
+        }
+        else
+        {
+            auto _bytes = (sendbuf == MPI_IN_PLACE) ? get_size(recvcount, recvtype)
+                                                    : get_size(sendcount, sendtype);
+            add_size(_name, _bytes);
+            if(!_root)
+                add_transfer(comm, root, _bytes);
+        }
+    }
+
+    // MPI_Allgather, MPI_Alltoall
+    void audit(const std::string& _name, const void* sendbuf, int sendcount,
+               MPI_Datatype sendtype, void*, int recvcount, MPI_Datatype recvtype,
+               MPI_Comm comm)
+    {
+        auto _bytes = (sendbuf == MPI_IN_PLACE) ? get_size(recvcount, recvtype)
+                                                : get_size(sendcount, sendtype);
+        add_size(_name, _bytes);
+        add_transfers(comm, get_rank(comm), _bytes);
+    }
+
+    // MPI_Comm_free, MPI_Comm_disconnect: the handle may be reused for a new
+    // communicator so the cached rank translations are discarded
+    void audit(const std::string&, MPI_Comm*)
+    {
+        get_epoch().fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// gathers the counters of every rank and rank 0 writes the matrix. This is
+    /// collective over MPI_COMM_WORLD and only the first call has any effect.
+    static void write()
+    {
+        static std::atomic<bool> _written{ false };
+        auto*                    _matrix = get_matrix();
+        if(!_matrix || _written.exchange(true))
+            return;
+
+        int _rank = 0;
+        PMPI_Comm_rank(MPI_COMM_WORLD, &_rank);
+        auto _packed = _matrix->pack();
+        auto _size   = static_cast<int>(_packed.size());
+
+        matrix_type::buffer_type _gathered((_rank == 0) ? _matrix->ranks() * _size : 0);
+        PMPI_Gather(_packed.data(), _size, MPI_UINT64_T, _gathered.data(), _size,
+                    MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+        if(_rank != 0)
+            return;
+
+        auto          _fname = get_filename();
+        std::ofstream _ofs{ _fname };
+        if(!_ofs)
+        {
+            fprintf(stderr, "[mpi_comm_matrix]> Error opening '%s'\n", _fname.c_str());
+            return;
+        }
+        if(tim::settings::verbose() >= 0)
+            printf("[mpi_comm_matrix]|0> Outputting '%s'...\n", _fname.c_str());
+        _matrix->write(_ofs, _gathered);
+    }
+
+    static std::string get_filename()
+    {
+        return tim::settings::compose_output_filename("mpi_comm_matrix", ".txt");
+    }
+
+    static std::vector<std::string> get_functions()
+    {
+        return { "MPI_Send",     "MPI_Bsend",     "MPI_Ssend",     "MPI_Rsend",
+                 "MPI_Isend",    "MPI_Ibsend",    "MPI_Issend",    "MPI_Irsend",
+                 "MPI_Recv",     "MPI_Irecv",     "MPI_Sendrecv",  "MPI_Bcast",
+                 "MPI_Reduce",   "MPI_Allreduce", "MPI_Gather",    "MPI_Scatter",
+                 "MPI_Allgather", "MPI_Alltoall" };
+    }
+
+private:
+    // created when MPI is first seen as initialized and intentionally never deleted
+    // because the MPI_Finalize callback may run after the static destructors
+    static matrix_type* get_matrix()
+    {
+        static std::atomic<matrix_type*> _instance{ nullptr };
+        static std::mutex                _mutex{};
+
+        if(!enabled())
+            return nullptr;
+
+        auto* _ptr = _instance.load(std::memory_order_acquire);
+        if(_ptr)
+            return _ptr;
+
+        std::lock_guard<std::mutex> _lk{ _mutex };
+        _ptr = _instance.load(std::memory_order_relaxed);
+        if(_ptr)
+            return _ptr;
+
+        int _init = 0;
+        int _fini = 0;
+        PMPI_Initialized(&_init);
+        PMPI_Finalized(&_fini);
+        if(_init == 0 || _fini != 0)
+            return nullptr;
+
+        int _size = 0;
+        PMPI_Comm_size(MPI_COMM_WORLD, &_size);
+        _ptr = new matrix_type(_size, get_functions());
+
+        // the attributes of MPI_COMM_SELF are deleted at the start of MPI_Finalize,
+        // i.e. while MPI is still usable for the reduction
+        int _key = MPI_KEYVAL_INVALID;
+        PMPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, &finalize_callback, &_key,
+                                nullptr);
+        PMPI_Comm_set_attr(MPI_COMM_SELF, _key, nullptr);
+
+        _instance.store(_ptr, std::memory_order_release);
+        return _ptr;
+    }
+
+    static int finalize_callback(MPI_Comm, int, void*, void*)
+    {
+        write();
+        return MPI_SUCCESS;
+    }
+
+    static std::atomic<uint64_t>& get_epoch()
+    {
+        static std::atomic<uint64_t> _v{ 0 };
+        return _v;
+    }
+
+    static count_type get_size(int count, MPI_Datatype datatype)
+    {
+        int _size = 0;
+        PMPI_Type_size(datatype, &_size);
+        return (count > 0 && _size > 0) ? static_cast<count_type>(count) * _size : 0;
+    }
+
+    static int get_rank(MPI_Comm comm)
+    {
+        int _rank = MPI_UNDEFINED;
+        PMPI_Comm_rank(comm, &_rank);
+        return _rank;
+    }
+
+    static bool is_inter(MPI_Comm comm)
+    {
+        if(comm == MPI_COMM_WORLD)
+            return false;
+        int _flag = 0;
+        PMPI_Comm_test_inter(comm, &_flag);
+        return (_flag != 0);
+    }
+
+    // rank in MPI_COMM_WORLD of each rank in the (remote) group of the communicator
+    static const std::vector<int>& get_world_ranks(MPI_Comm comm)
+    {
+        static thread_local uint64_t   _epoch = 0;
+        static thread_local rank_map_t _cache{};
+
+        auto _curr = get_epoch().load(std::memory_order_relaxed);
+        if(_curr != _epoch)
+        {
+            _cache.clear();
+            _epoch = _curr;
+        }
+
+        auto itr = _cache.find(comm);
+        if(itr != _cache.end())
+            return itr->second;
+
+        MPI_Group _group = MPI_GROUP_NULL;
+        MPI_Group _world = MPI_GROUP_NULL;
+        if(is_inter(comm))
+            PMPI_Comm_remote_group(comm, &_group);
+        else
+            PMPI_Comm_group(comm, &_group);
+        PMPI_Comm_group(MPI_COMM_WORLD, &_world);
+
+        int _size = 0;
+        PMPI_Group_size(_group, &_size);
+        std::vector<int> _ranks(_size, 0);
+        std::vector<int> _world_ranks(_size, MPI_UNDEFINED);
+        std::iota(_ranks.begin(), _ranks.end(), 0);
+        PMPI_Group_translate_ranks(_group, _size, _ranks.data(), _world,
+                                   _world_ranks.data());
+        PMPI_Group_free(&_group);
+        PMPI_Group_free(&_world);
+
+        return _cache.emplace(comm, std::move(_world_ranks)).first->second;
+    }
+
+    static int get_world_rank(MPI_Comm comm, int rank)
+    {
+        if(comm == MPI_COMM_WORLD || rank < 0)
+            return rank;
+        const auto& _ranks = get_world_ranks(comm);
+        return (rank < static_cast<int>(_ranks.size())) ? _ranks.at(rank)
+                                                         : MPI_UNDEFINED;
+    }
+
+    static void add_message(const std::string& _name, MPI_Comm comm, int dst,
+                            count_type _bytes)
+    {
+        auto* _matrix = get_matrix();
+        if(!_matrix)
+            return;
+        auto _idx = _matrix->index(_name);
+        if(_idx < 0)
+            return;
+        auto _dst = get_world_rank(comm, dst);
+        if(_dst >= 0)
+            _matrix->add_message(_idx, _dst, _bytes);
+        else
+            _matrix->add_size(_idx, _bytes);
+    }
+
+    static void add_size(const std::string& _name, count_type _bytes)
+    {
+        auto* _matrix = get_matrix();
+        if(!_matrix)
+            return;
+        auto _idx = _matrix->index(_name);
+        if(_idx >= 0)
+            _matrix->add_size(_idx, _bytes);
+    }
+
+    static void add_transfer(MPI_Comm comm, int dst, count_type _bytes)
+    {
+        auto* _matrix = get_matrix();
+        if(!_matrix || is_inter(comm))
+            return;
+        auto _dst = get_world_rank(comm, dst);
+        if(_dst >= 0)
+            _matrix->add_transfer(_dst, _bytes);
+    }
+
+    // from this rank to every other rank of an intracommunicator
+    static void add_transfers(MPI_Comm comm, int self, count_type _bytes)
+    {
+        auto* _matrix = get_matrix();
+        if(!_matrix || is_inter(comm))
+            return;
+        const auto& _ranks = get_world_ranks(comm);
+        for(size_t i = 0; i < _ranks.size(); ++i)
+        {
+            if(static_cast<int>(i) != self && _ranks.at(i) >= 0)
+                _matrix->add_transfer(_ranks.at(i), _bytes);
+        }
+    }
+};
 }  // namespace component
 }  // namespace tim
 //
 //--------------------------------------------------------------------------------------//
 //
+extern "C"
+{
+    void timemory_mpip_write_comm_matrix() { mpi_comm_matrix::write(); }
+    void timemory_mpip_write_comm_matrix_() { timemory_mpip_write_comm_matrix(); }
+}  // extern "C"
+//
+//--------------------------------------------------------------------------------------//
+//
 TIMEMORY_STORAGE_INITIALIZER(mpi_comm_data, mpi_comm_data)
+TIMEMORY_STORAGE_INITIALIZER(mpi_comm_matrix, mpi_comm_matrix)
 TIMEMORY_STORAGE_INITIALIZER(mpi_data_tracker_t, mpi_data_tracker_t)
 //
 //--------------------------------------------------------------------------------------//
@@ -1181,7 +1181,7 @@ main(int argc, char** argv)
                 continue;
             }
 
-            hash_ids.push_back({ std::hash<string_t>()(name.get()), name.get() });
+            hash_ids.push_back({ tim::get_hash_id(name.get()), name.get() });
             available_module_functions.insert(module_function(mod, itr));
             instrumented_module_functions.insert(module_function(mod, itr));
 
@@ -1189,7 +1189,7 @@ main(int argc, char** argv)
                 verbprintf(0, "Instrumenting |> [ %s ] -> [ %s ]\n", modname,
                            name.m_name.c_str());
                 auto _name       = name.get();
-                auto _hash       = std::hash<string_t>()(_name);
+                auto _hash       = tim::get_hash_id(_name);
                 auto _trace_entr = (entr_hash) ? timemory_call_expr(_hash)
                                                : timemory_call_expr(_name.c_str());
                 auto _trace_exit = (exit_hash) ? timemory_call_expr(_hash)
@@ -1216,7 +1216,7 @@ main(int argc, char** argv)
                 {
                     auto lname  = get_loop_file_line_info(mod, itr, flow, litr);
                     auto _lname = lname.get();
-                    auto _lhash = std::hash<string_t>()(_lname);
+                    auto _lhash = tim::get_hash_id(_lname);
                     hash_ids.push_back({ _lhash, _lname });
                     auto _lf = [=]() {
                         auto _ltrace_entr = (entr_hash)
@@ -0,0 +1,268 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "timemory/utility/argparse.hpp"
+#include "timemory/utility/live_view.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <signal.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace live_view = tim::live_view;
+
+using parser_t     = tim::argparse::argument_parser;
+using clock_type   = std::chrono::steady_clock;
+using seconds_type = std::chrono::duration<double>;
+using snapshot_t   = live_view::snapshot;
+using key_type     = std::tuple<std::string, uint64_t, uint32_t>;  // component, hash, tid
+
+static volatile std::sig_atomic_t is_running = 1;
+
+//--------------------------------------------------------------------------------------//
+
+extern "C" void
+top_signal_handler(int)
+{
+    is_running = 0;
+}
+
+//--------------------------------------------------------------------------------------//
+
+struct row
+{
+    snapshot_t data = {};
+    double     rate = 0.0;  // change in the accumulated value per second
+};
+
+//--------------------------------------------------------------------------------------//
+// read every published slot, optionally combining the threads
+std::vector<snapshot_t>
+read_segment(const live_view::segment& _seg, bool _merge, const std::string& _comp)
+{
+    std::map<key_type, snapshot_t> _data{};
+    for(uint32_t i = 0; i < _seg.size(); ++i)
+    {
+        snapshot_t _snap{};
+        if(!live_view::read(*_seg.get_slot(i), _snap))
+            continue;
+        if(!_comp.empty() && _snap.component != _comp)
+            continue;
+        auto _key = key_type{ _snap.component, _snap.hash, (_merge) ? 0 : _snap.tid };
+        auto itr  = _data.find(_key);
+        if(itr == _data.end())
+        {
+            if(_merge)
+                _snap.tid = 0;
+            _data.emplace(_key, _snap);
+        }
+        else
+        {
+            itr->second.laps += _snap.laps;
+            itr->second.accum += _snap.accum;
+            itr->second.last = _snap.last;
+        }
+    }
+
+    std::vector<snapshot_t> _ret{};
+    _ret.reserve(_data.size());
+    for(auto& itr : _data)
+        _ret.emplace_back(std::move(itr.second));
+    return _ret;
+}
+
+//--------------------------------------------------------------------------------------//
+
+void
+render(std::ostream& _os, int32_t _pid, const std::vector<row>& _rows, size_t _top,
+       const std::string& _sort, bool _clear)
+{
+    std::stringstream _ss{};
+    if(_clear)
+        _ss << "\033[2J\033[H";
+    _ss << "timemory-top - pid " << _pid << " - " << _rows.size()
+        << " entries - sorted by " << _sort << "\n\n";
+    _ss << std::setw(12) << "component"
+        << " " << std::setw(6) << "tid"
+        << " " << std::setw(12) << "laps"
+        << " " << std::setw(14) << "accum"
+        << " " << std::setw(14) << "last"
+        << " " << std::setw(12) << "rate/sec"
+        << "  region\n";
+    for(size_t i = 0; i < _rows.size() && i < _top; ++i)
+    {
+        const auto& itr = _rows.at(i);
+        _ss << std::setw(12) << itr.data.component << " " << std::setw(6) << itr.data.tid
+            << " " << std::setw(12) << itr.data.laps << " " << std::setw(14)
+            << std::setprecision(6) << itr.data.accum << " " << std::setw(14)
+            << itr.data.last << " " << std::setw(12) << itr.rate << "  "
+            << std::string(2 * itr.data.depth, ' ') << itr.data.name << "\n";
+    }
+    _os << _ss.str() << std::flush;
+}
+
+//--------------------------------------------------------------------------------------//
+
+int
+main(int argc, char** argv)
+{
+    int32_t     _pid      = 0;
+    size_t      _top      = 20;
+    double      _interval = 0.1;
+    int64_t     _count    = 0;
+    bool        _merge    = false;
+    std::string _sort     = "accum";
+    std::string _comp     = {};
+
+    parser_t parser("timemory-top");
+
+    parser.enable_help();
+    parser
+        .add_argument({ "-p", "--pid" },
+                      "Process to attach to (run with TIMEMORY_LIVE_VIEW=ON)")
+        .count(1);
+    parser.add_argument({ "-n", "--top" }, "Number of regions to display (default: 20)")
+        .count(1);
+    parser
+        .add_argument({ "-i", "--interval" },
+                      "Seconds between two updates (default: 0.1, i.e. 10 Hz)")
+        .count(1);
+    parser
+        .add_argument({ "-s", "--sort" },
+                      "Sort by 'accum', 'laps', 'last', or 'rate' (default: accum)")
+        .count(1);
+    parser.add_argument({ "-c", "--component" }, "Only display this component").count(1);
+    parser.add_argument({ "-m", "--merge-threads" }, "Combine the threads").count(0);
+    parser
+        .add_argument({ "-N", "--iterations" },
+                      "Exit after this many updates and do not clear the screen "
+                      "(default: until interrupted)")
+        .count(1);
+
+    auto err = parser.parse(argc, argv);
+    if(err)
+        std::cerr << err << std::endl;
+
+    if(err || parser.exists("help"))
+    {
+        parser.print_help();
+        return (err) ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    if(!parser.exists("pid"))
+    {
+        std::cerr << "Error! A pid is required" << std::endl;
+        parser.print_help();
+        return EXIT_FAILURE;
+    }
+
+    _pid = parser.get<int32_t>("pid");
+    if(parser.exists("top"))
+        _top = parser.get<size_t>("top");
+    if(parser.exists("interval"))
+        _interval = std::max<double>(parser.get<double>("interval"), 0.01);
+    if(parser.exists("sort"))
+        _sort = parser.get<std::string>("sort");
+    if(parser.exists("component"))
+        _comp = parser.get<std::string>("component");
+    if(parser.exists("merge-threads"))
+        _merge = true;
+    if(parser.exists("iterations"))
+        _count = parser.get<int64_t>("iterations");
+
+    if(_sort != "accum" && _sort != "laps" && _sort != "last" && _sort != "rate")
+    {
+        std::cerr << "Error! Invalid sort key '" << _sort << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    live_view::segment _seg{};
+    if(!_seg.attach(_pid))
+    {
+        std::cerr << "Error! No live-view for pid " << _pid
+                  << " (is TIMEMORY_LIVE_VIEW enabled and has it started measuring?)"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    signal(SIGINT, &top_signal_handler);
+    signal(SIGTERM, &top_signal_handler);
+
+    std::map<key_type, double> _previous{};
+    auto                       _last = clock_type::now();
+    for(int64_t n = 0; is_running && (_count <= 0 || n < _count); ++n)
+    {
+        auto _now     = clock_type::now();
+        auto _elapsed = seconds_type{ _now - _last }.count();
+        _last         = _now;
+
+        std::vector<row> _rows{};
+        for(auto& itr : read_segment(_seg, _merge, _comp))
+        {
+            auto _key  = key_type{ itr.component, itr.hash, itr.tid };
+            auto _prev = _previous.find(_key);
+            auto _rate = (_prev != _previous.end() && _elapsed > 0.0)
+                             ? (itr.accum - _prev->second) / _elapsed
+                             : 0.0;
+            _previous[_key] = itr.accum;
+            _rows.emplace_back(row{ std::move(itr), _rate });
+        }
+
+        std::sort(_rows.begin(), _rows.end(), [&_sort](const row& _lhs, const row& _rhs) {
+            if(_sort == "laps")
+                return _lhs.data.laps > _rhs.data.laps;
+            if(_sort == "last")
+                return _lhs.data.last > _rhs.data.last;
+            if(_sort == "rate")
+                return _lhs.rate > _rhs.rate;
+            return _lhs.data.accum > _rhs.data.accum;
+        });
+
+        render(std::cout, _pid, _rows, _top, _sort, _count <= 0);
+
+        // the process finalized or exited
+        if(_seg.get_header()->active.load() == 0 || kill(_pid, 0) != 0)
+        {
+            std::cout << "\n[timemory-top]> process " << _pid << " exited" << std::endl;
+            break;
+        }
+
+        std::this_thread::sleep_for(seconds_type{ _interval });
+    }
+
+    return EXIT_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------//
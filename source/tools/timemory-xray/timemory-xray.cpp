@@ -0,0 +1,414 @@
+// MIT License
+//
+// Copyright (c) 2020, The Regents of the University of California,
+// through Lawrence Berkeley National Laboratory (subject to receipt of any
+// required approvals from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "timemory/compat/library.h"
+#include "timemory/library.h"
+#include "timemory/timemory.hpp"
+#include "timemory/utility/symbols.hpp"
+
+#include <xray/xray_interface.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+// the handler must not be instrumented, regardless of the flags it was compiled with
+#define TIMEMORY_XRAY_NEVER_INSTRUMENT [[clang::xray_never_instrument]]
+
+// the XRay runtime is linked into the instrumented executable, these are resolved
+// at runtime and are null when the executable was not built with -fxray-instrument
+#pragma weak __xray_set_handler
+#pragma weak __xray_remove_handler
+#pragma weak __xray_patch
+#pragma weak __xray_unpatch
+#pragma weak __xray_patch_function
+#pragma weak __xray_unpatch_function
+#pragma weak __xray_function_address
+#pragma weak __xray_max_function_id
+
+using namespace tim::component;
+
+using xray_bundle_t = tim::component_tuple<user_trace_bundle>;
+using mutex_t       = std::mutex;
+using lock_t        = std::unique_lock<mutex_t>;
+
+extern "C"
+{
+    TIMEMORY_XRAY_NEVER_INSTRUMENT void timemory_xray_init(void)
+        TIMEMORY_VISIBILITY("default");
+    TIMEMORY_XRAY_NEVER_INSTRUMENT void timemory_xray_finalize(void)
+        TIMEMORY_VISIBILITY("default");
+    TIMEMORY_XRAY_NEVER_INSTRUMENT bool timemory_xray_patch(void)
+        TIMEMORY_VISIBILITY("default");
+    TIMEMORY_XRAY_NEVER_INSTRUMENT bool timemory_xray_unpatch(void)
+        TIMEMORY_VISIBILITY("default");
+}
+
+//======================================================================================//
+
+namespace
+{
+// state of a function in the instrumentation map
+enum : uint8_t
+{
+    function_default   = 0,
+    function_throttled = 1
+};
+
+// the functions are identified by their address, which is used as the hash id. The
+// names of the functions which were entered are resolved at finalization
+struct xray_state
+{
+    bool                                    available        = false;
+    bool                                    patched          = false;
+    bool                                    unpatch_throttle = true;
+    size_t                                  max_id           = 0;
+    mutex_t                                 mutex            = {};
+    std::unique_ptr<std::atomic<uint8_t>[]> status           = {};
+    std::unique_ptr<std::atomic<bool>[]>    entered          = {};
+    std::atomic<bool>                       finalized        = { false };
+    std::atomic<bool>                       initialized      = { false };
+};
+
+struct xray_entry
+{
+    TIMEMORY_XRAY_NEVER_INSTRUMENT xray_entry(int32_t _fid, uint64_t _hash)
+    : fid{ _fid }
+    , bundle{ _hash }
+    {}
+
+    int32_t       fid    = 0;
+    xray_bundle_t bundle = {};
+};
+
+// per-thread function id to hash id map and call-stack. Entries whose exit was never
+// observed (e.g. the function was unpatched while it was running) are stopped when a
+// caller exits or when the thread exits
+struct xray_thread_data
+{
+    TIMEMORY_XRAY_NEVER_INSTRUMENT ~xray_thread_data() { unwind(0); }
+
+    TIMEMORY_XRAY_NEVER_INSTRUMENT void unwind(size_t _n)
+    {
+        while(stack.size() > _n)
+        {
+            stack.back().bundle.stop();
+            stack.pop_back();
+        }
+    }
+
+    bool                   active = false;
+    std::vector<uint64_t>  hashes = {};
+    std::deque<xray_entry> stack  = {};
+};
+
+TIMEMORY_XRAY_NEVER_INSTRUMENT xray_state&
+get_state()
+{
+    // leaked so that it is valid during the static destruction
+    static auto* _instance = new xray_state{};
+    return *_instance;
+}
+
+TIMEMORY_XRAY_NEVER_INSTRUMENT xray_thread_data&
+get_thread_data()
+{
+    static thread_local xray_thread_data _instance{};
+    return _instance;
+}
+
+//--------------------------------------------------------------------------------------//
+// the hash id of a function is its address. The first time a function is entered on a
+// thread it is flagged for the resolution of its name at finalization
+//
+TIMEMORY_XRAY_NEVER_INSTRUMENT uint64_t
+get_function_hash(xray_state& _state, xray_thread_data& _data, int32_t _fid)
+{
+    if(static_cast<size_t>(_fid) >= _data.hashes.size())
+        _data.hashes.resize(_fid + 1, 0);
+    auto& _hash = _data.hashes[_fid];
+    if(_hash == 0)
+    {
+        _hash = __xray_function_address(_fid);
+        _state.entered[_fid].store(true, std::memory_order_relaxed);
+    }
+    return _hash;
+}
+
+//--------------------------------------------------------------------------------------//
+// the names of the functions which were entered on any thread are resolved at once
+//
+TIMEMORY_XRAY_NEVER_INSTRUMENT size_t
+resolve_function_names(xray_state& _state)
+{
+    std::set<const void*> _addresses{};
+    for(size_t i = 1; i <= _state.max_id; ++i)
+    {
+        if(!_state.entered[i].load())
+            continue;
+        auto _addr = __xray_function_address(i);
+        if(_addr != 0)
+            _addresses.insert(reinterpret_cast<const void*>(_addr));
+    }
+
+    auto  _names    = tim::symbols::resolve(_addresses);
+    auto& _hash_ids = tim::get_hash_ids();
+    if(_hash_ids)
+    {
+        for(const auto& itr : _names)
+            (*_hash_ids)[reinterpret_cast<size_t>(itr.first)] = itr.second;
+    }
+    return _names.size();
+}
+
+//--------------------------------------------------------------------------------------//
+
+TIMEMORY_XRAY_NEVER_INSTRUMENT void
+unpatch_function(int32_t _fid)
+{
+    auto& _state  = get_state();
+    auto& _status = _state.status[_fid];
+    if(_status.exchange(function_throttled) == function_throttled)
+        return;
+
+    lock_t _lk{ _state.mutex };
+    if(_state.patched)
+        __xray_unpatch_function(_fid);
+
+    if(tim::settings::debug() || tim::settings::verbose() > 0)
+        fprintf(stderr, "[timemory-xray]> Unpatched throttled function %i [0x%lx]...\n",
+                (int) _fid, (unsigned long) __xray_function_address(_fid));
+}
+
+//--------------------------------------------------------------------------------------//
+
+TIMEMORY_XRAY_NEVER_INSTRUMENT void
+xray_handler(int32_t _fid, XRayEntryType _type)
+{
+    auto& _state = get_state();
+    auto& _data  = get_thread_data();
+
+    // guard against the instrumentation calling instrumented functions
+    if(_data.active || _state.finalized.load(std::memory_order_relaxed) || _fid <= 0 ||
+       static_cast<size_t>(_fid) > _state.max_id)
+        return;
+
+    _data.active = true;
+
+    switch(_type)
+    {
+        case XRayEntryType::ENTRY:
+        case XRayEntryType::LOG_ARGS_ENTRY:
+        {
+            if(!timemory_trace_is_initialized())
+            {
+                timemory_trace_init("", true, "");
+                // runs before the finalization registered by timemory_trace_init
+                std::atexit(&timemory_xray_finalize);
+            }
+
+            if(!tim::settings::enabled())
+            {
+                // disabled: remove the instrumentation entirely until re-patched
+                _data.active = false;
+                timemory_xray_unpatch();
+                return;
+            }
+
+            auto _hash = get_function_hash(_state, _data, _fid);
+            if(_hash == 0)
+                break;
+
+            _data.stack.emplace_back(_fid, _hash);
+            _data.stack.back().bundle.start();
+            break;
+        }
+        case XRayEntryType::EXIT:
+        case XRayEntryType::TAIL:
+        {
+            // find the matching entry, exits of nested entries which were not
+            // observed are implied
+            auto _n = _data.stack.size();
+            while(_n > 0 && _data.stack[_n - 1].fid != _fid)
+                --_n;
+            if(_n == 0)
+                break;
+
+            _data.unwind(_n);
+            auto _hash = _data.hashes[_fid];
+            _data.stack.back().bundle.stop();
+            _data.stack.pop_back();
+
+            if(_state.unpatch_throttle && tim::throttle::enabled() &&
+               tim::throttle::is_throttled(_hash))
+                unpatch_function(_fid);
+            break;
+        }
+        default: break;
+    }
+
+    _data.active = false;
+}
+}  // namespace
+
+//======================================================================================//
+
+extern "C"
+{
+    //
+    //----------------------------------------------------------------------------------//
+    //
+    /// installs the handler and, unless TIMEMORY_XRAY_PATCH=OFF, patches every
+    /// instrumented function. Invoked when the library is loaded
+    //
+    TIMEMORY_XRAY_NEVER_INSTRUMENT void timemory_xray_init(void)
+    {
+        auto& _state = get_state();
+        if(_state.initialized.exchange(true))
+            return;
+
+        if(!&__xray_set_handler || !&__xray_max_function_id)
+        {
+            if(tim::settings::verbose() > 0 || tim::settings::debug())
+                fprintf(stderr, "[timemory-xray]> XRay runtime not found. Build the "
+                                "executable with -fxray-instrument...\n");
+            return;
+        }
+
+        {
+            lock_t _lk{ _state.mutex };
+            _state.available        = true;
+            _state.max_id           = __xray_max_function_id();
+            _state.unpatch_throttle = tim::settings::xray_unpatch_throttled();
+            _state.status.reset(new std::atomic<uint8_t>[_state.max_id + 1]);
+            _state.entered.reset(new std::atomic<bool>[_state.max_id + 1]);
+            for(size_t i = 0; i <= _state.max_id; ++i)
+            {
+                _state.status[i].store(function_default);
+                _state.entered[i].store(false);
+            }
+        }
+
+        __xray_set_handler(&xray_handler);
+
+        if(tim::settings::xray_patch() && tim::settings::enabled())
+            timemory_xray_patch();
+    }
+    //
+    //----------------------------------------------------------------------------------//
+    //
+    /// patches every instrumented function except the throttled functions
+    //
+    TIMEMORY_XRAY_NEVER_INSTRUMENT bool timemory_xray_patch(void)
+    {
+        auto& _state = get_state();
+        if(!_state.available || _state.finalized)
+            return false;
+
+        lock_t _lk{ _state.mutex };
+        if(_state.patched)
+            return true;
+
+        auto _ret = __xray_patch();
+        if(_ret != XRayPatchingStatus::SUCCESS)
+        {
+            fprintf(stderr, "[timemory-xray]> Patching failed with status %i...\n",
+                    (int) _ret);
+            return false;
+        }
+
+        for(size_t i = 1; i <= _state.max_id; ++i)
+        {
+            if(_state.status[i].load() == function_throttled)
+                __xray_unpatch_function(i);
+        }
+        _state.patched = true;
+
+        if(tim::settings::verbose() > 1 || tim::settings::debug())
+            fprintf(stderr, "[timemory-xray]> Patched %lu functions...\n",
+                    (unsigned long) _state.max_id);
+        return true;
+    }
+    //
+    //----------------------------------------------------------------------------------//
+    //
+    /// removes the instrumentation of every function, the overhead afterwards is
+    /// that of the unpatched sleds (a jump over a few bytes)
+    //
+    TIMEMORY_XRAY_NEVER_INSTRUMENT bool timemory_xray_unpatch(void)
+    {
+        auto& _state = get_state();
+        if(!_state.available)
+            return false;
+
+        lock_t _lk{ _state.mutex };
+        if(!_state.patched)
+            return true;
+
+        auto _ret      = __xray_unpatch();
+        _state.patched = false;
+        return (_ret == XRayPatchingStatus::SUCCESS);
+    }
+    //
+    //----------------------------------------------------------------------------------//
+    //
+    /// removes the instrumentation, stops the functions on the call-stack of the
+    /// calling thread and adds the names of every function which was entered
+    //
+    TIMEMORY_XRAY_NEVER_INSTRUMENT void timemory_xray_finalize(void)
+    {
+        auto& _state = get_state();
+        if(!_state.available || _state.finalized.exchange(true))
+            return;
+
+        timemory_xray_unpatch();
+        __xray_remove_handler();
+        get_thread_data().unwind(0);
+
+        auto _n = resolve_function_names(_state);
+        if(tim::settings::verbose() > 0 || tim::settings::debug())
+            fprintf(stderr, "[timemory-xray]> Resolved %lu functions...\n",
+                    (unsigned long) _n);
+    }
+    //
+    //----------------------------------------------------------------------------------//
+    //
+}  // extern "C"
+
+//======================================================================================//
+
+namespace
+{
+// install the handler when the library is loaded
+bool xray_library_ctor = (timemory_xray_init(), true);
+}  // namespace
+
+//======================================================================================//
@@ -0,0 +1,179 @@
+#!@PYTHON_EXECUTABLE@
+# MIT License
+#
+# Copyright (c) 2018, The Regents of the University of California,
+# through Lawrence Berkeley National Laboratory (subject to receipt of any
+# required approvals from the U.S. Dept. of Energy).  All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+from __future__ import absolute_import
+
+__author__ = "Jonathan Madsen"
+__copyright__ = "Copyright 2020, The Regents of the University of California"
+__credits__ = ["Jonathan Madsen"]
+__license__ = "MIT"
+__version__ = "@PROJECT_VERSION@"
+__maintainer__ = "Jonathan Madsen"
+__email__ = "jrmadsen@lbl.gov"
+__status__ = "Development"
+
+import time
+import unittest
+import timemory as tim
+from timemory.bundle import marker
+from timemory.libpytimemory import component_decorator, component_handle
+
+# --------------------------- test setup variables ----------------------------------- #
+
+ncalls = 20000
+ndepth = 3
+components = [tim.component.wall_clock]
+
+# --------------------------- helper functions ----------------------------------------- #
+
+
+@marker(components=["wall_clock"])
+def handle_noop():
+    pass
+
+
+@marker(components=["wall_clock"])
+def handle_recursive(n):
+    if n > 1:
+        handle_recursive(n - 1)
+
+
+# the per-call construction the decorators used before the call-site handle
+def legacy_noop():
+    t = component_decorator(components, "legacy_noop")
+    del t
+
+
+# the total laps and the number of entries in the call-graph whose prefix ends with key
+def get_laps(key):
+    arrays, strings = tim.get_arrays()
+    laps = {}
+    for row in arrays["wall"]:
+        if strings[row["prefix"]].endswith(key):
+            laps[int(row["depth"])] = laps.get(int(row["depth"]), 0) + row["laps"]
+    return laps
+
+
+# returns the elapsed time per call in microseconds
+def measure(func, n=ncalls):
+    beg = time.perf_counter()
+    for i in range(n):
+        func()
+    end = time.perf_counter()
+    return 1.0e6 * (end - beg) / n
+
+
+# ------------------------------ Handle Tests set ------------------------------------- #
+# Handle tests class
+class TimemoryHandleTests(unittest.TestCase):
+    # setup class: timemory settings
+    @classmethod
+    def setUpClass(self):
+        tim.settings.verbose = 0
+        tim.settings.debug = False
+        tim.settings.json_output = True
+        tim.settings.mpi_thread = False
+        tim.settings.banner = False
+        tim.settings.flat_profile = False
+        tim.settings.parse()
+
+    # Tear down class: finalize
+    @classmethod
+    def tearDownClass(self):
+        pass
+
+    # ---------------------------------------------------------------------------------- #
+    # test the pooled bundles record every call
+    def test_laps(self):
+        """laps"""
+
+        n = 100
+        for i in range(n):
+            handle_noop()
+
+        laps = get_laps("handle_noop")
+        self.assertEqual(sum(laps.values()), n)
+
+        # explicit handle with a start/stop token
+        _handle = component_handle(components, "explicit_handle")
+        for i in range(n):
+            _idx = _handle.start()
+            self.assertEqual(_idx, 0)
+            _handle.stop(_idx)
+
+        self.assertEqual(len(_handle), 1)
+        self.assertEqual(sum(get_laps("explicit_handle").values()), n)
+
+    # ---------------------------------------------------------------------------------- #
+    # test recursion grows the pool and nests the entries
+    def test_recursion(self):
+        """recursion"""
+
+        n = 10
+        for i in range(n):
+            handle_recursive(ndepth)
+
+        laps = get_laps("handle_recursive")
+        self.assertEqual(len(laps), ndepth)
+        for itr in laps.values():
+            self.assertEqual(itr, n)
+
+        _handle = component_handle(components, "nested_handle")
+        _idx = [_handle.start() for i in range(ndepth)]
+        for itr in reversed(_idx):
+            _handle.stop(itr)
+        self.assertEqual(len(_handle), ndepth)
+
+    # ---------------------------------------------------------------------------------- #
+    # microbenchmark of a decorated no-op
+    def test_overhead(self):
+        """overhead"""
+
+        # warm-up creates the handle and the storage
+        handle_noop()
+        legacy_noop()
+
+        handle_time = measure(handle_noop)
+        legacy_time = measure(legacy_noop)
+
+        print(
+            "\n[{}] {} calls of a decorated no-op\n    handle : {:.3f} usec/call"
+            "\n    legacy : {:.3f} usec/call\n".format(
+                self.shortDescription(), ncalls, handle_time, legacy_time
+            )
+        )
+
+        self.assertLess(handle_time, legacy_time)
+
+
+# ----------------------------- main test runner ---------------------------------------- #
+# main runner
+def run():
+    # run all tests
+    unittest.main()
+
+
+if __name__ == "__main__":
+    run()
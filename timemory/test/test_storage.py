@@ -0,0 +1,188 @@
+#!@PYTHON_EXECUTABLE@
+# MIT License
+#
+# Copyright (c) 2018, The Regents of the University of California,
+# through Lawrence Berkeley National Laboratory (subject to receipt of any
+# required approvals from the U.S. Dept. of Energy).  All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+from __future__ import absolute_import
+
+__author__ = "Jonathan Madsen"
+__copyright__ = "Copyright 2020, The Regents of the University of California"
+__credits__ = ["Jonathan Madsen"]
+__license__ = "MIT"
+__version__ = "@PROJECT_VERSION@"
+__maintainer__ = "Jonathan Madsen"
+__email__ = "jrmadsen@lbl.gov"
+__status__ = "Development"
+
+import time
+import unittest
+import tracemalloc
+import numpy as np
+import timemory as tim
+from timemory.bundle import marker
+
+# --------------------------- test setup variables ----------------------------------- #
+
+nregions = 500
+ndepth = 4
+
+# --------------------------- helper functions ----------------------------------------- #
+
+# creates nregions * ndepth entries in the call-graph
+def create_regions(name):
+    def _nested(i, depth):
+        with marker(components=["wall_clock"], key="{}_{}".format(name, i)):
+            if depth > 1:
+                _nested(i, depth - 1)
+
+    for i in range(nregions):
+        _nested(i, ndepth)
+
+
+# the graph entries of the JSON from tim.get() for a component label
+def get_json_graph(data, label):
+    graph = []
+    if isinstance(data, dict):
+        if data.get("type", None) == label and "graph" in data:
+            graph += data["graph"]
+        else:
+            for itr in data.values():
+                graph += get_json_graph(itr, label)
+    elif isinstance(data, list):
+        for itr in data:
+            graph += get_json_graph(itr, label)
+    return graph
+
+
+# returns the result of the function, the elapsed time, and the peak python memory
+def measure(func):
+    tracemalloc.start()
+    beg = time.perf_counter()
+    ret = func()
+    end = time.perf_counter()
+    _, peak = tracemalloc.get_traced_memory()
+    tracemalloc.stop()
+    return [ret, end - beg, peak]
+
+
+# ------------------------------ Storage Tests set ------------------------------------ #
+# Storage tests class
+class TimemoryStorageTests(unittest.TestCase):
+    # setup class: timemory settings
+    @classmethod
+    def setUpClass(self):
+        tim.settings.verbose = 0
+        tim.settings.debug = False
+        tim.settings.json_output = True
+        tim.settings.mpi_thread = False
+        tim.settings.banner = False
+        tim.settings.flat_profile = False
+        tim.settings.parse()
+        create_regions("storage")
+
+    # Tear down class: finalize
+    @classmethod
+    def tearDownClass(self):
+        pass
+
+    # ---------------------------------------------------------------------------------- #
+    # test the arrays have the same content as the JSON
+    def test_content(self):
+        """content"""
+
+        arrays, strings = tim.get_arrays()
+        graph = get_json_graph(tim.get(), "wall")
+
+        self.assertTrue("wall" in arrays)
+        data = arrays["wall"]
+
+        self.assertTrue(isinstance(data, np.ndarray))
+        self.assertGreaterEqual(len(data), nregions * ndepth)
+        self.assertEqual(len(data), len(graph))
+
+        for field in [
+            "hash",
+            "rolling_hash",
+            "prefix",
+            "depth",
+            "laps",
+            "value",
+            "accum",
+        ]:
+            self.assertTrue(field in data.dtype.names)
+
+        for row, entry in zip(data, graph):
+            self.assertEqual(row["hash"], entry["hash"])
+            self.assertEqual(row["depth"], entry["depth"])
+            self.assertEqual(strings[row["prefix"]], entry["prefix"])
+            self.assertEqual(row["laps"], entry["entry"]["laps"])
+            self.assertEqual(row["value"], entry["entry"]["value"])
+            self.assertEqual(row["accum"], entry["entry"]["accum"])
+
+        # the string table is shared and holds each prefix once
+        self.assertEqual(len(strings), len(set(strings)))
+
+        # the array references the C++ buffer
+        self.assertFalse(data.flags["OWNDATA"])
+
+    # ---------------------------------------------------------------------------------- #
+    # compare the time and memory against the JSON
+    def test_overhead(self):
+        """overhead"""
+
+        arrays, arr_time, arr_peak = measure(lambda: tim.get_arrays())
+        graph, json_time, json_peak = measure(
+            lambda: get_json_graph(tim.get(), "wall")
+        )
+
+        arr_bytes = sum([itr.nbytes for itr in arrays[0].values()])
+        nentries = len(arrays[0]["wall"])
+
+        print(
+            "\n[{}] entries: {}\n    get_arrays(): {:.6f} sec, {} bytes python peak, "
+            "{} bytes of arrays\n    get()       : {:.6f} sec, {} bytes python "
+            "peak\n".format(
+                self.shortDescription(),
+                nentries,
+                arr_time,
+                arr_peak,
+                arr_bytes,
+                json_time,
+                json_peak,
+            )
+        )
+
+        self.assertEqual(nentries, len(graph))
+        self.assertLess(arr_peak + arr_bytes, json_peak)
+        self.assertLess(arr_time, json_time)
+
+
+# ----------------------------- main test runner ---------------------------------------- #
+# main runner
+def run():
+    # run all tests
+    unittest.main()
+
+
+if __name__ == "__main__":
+    run()
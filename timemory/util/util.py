@@ -39,6 +39,7 @@ from functools import wraps
 
 from ..common import FILE, FUNC, LINE, FRAME
 from ..libpytimemory import settings, timer_decorator, component_decorator
+from ..libpytimemory import component_handle
 from ..libpytimemory import timer, rss_usage, component
 
 __author__ = "Jonathan Madsen"
@@ -533,9 +534,20 @@ class marker(base_decorator):
         """
         _file = FILE(3)
         _line = LINE(2)
+        # when the arguments are not part of the label, the label is the same
+        # for every call so the handle (hash id, components, and a pool of
+        # bundles) is created on the first call and reused afterwards
+        _handle = []
 
         @wraps(func)
         def function_wrapper(*args, **kwargs):
+            if _handle:
+                _idx = _handle[0].start()
+                try:
+                    return func(*args, **kwargs)
+                finally:
+                    _handle[0].stop(_idx)
+
             self.parse_wrapped(func, args, kwargs)
             self.determine_signature(
                 is_decorator=True, is_context_manager=False
@@ -555,6 +567,14 @@ class marker(base_decorator):
                 )
             _key = _key.strip("/")
 
+            if not self.add_args:
+                _handle.append(component_handle(self.components, _key))
+                _idx = _handle[0].start()
+                try:
+                    return func(*args, **kwargs)
+                finally:
+                    _handle[0].stop(_idx)
+
             t = component_decorator(self.components, _key)
             ret = func(*args, **kwargs)
             del t